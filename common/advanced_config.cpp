@@ -62,6 +62,8 @@ namespace AC_KEYS
 {
 
 static const wxChar IncrementalConnectivity[] = wxT( "IncrementalConnectivity" );
+static const wxChar VerifyIncrementalConnectivity[] = wxT( "VerifyIncrementalConnectivity" );
+static const wxChar IndexSymbolLibraries[] = wxT( "IndexSymbolLibraries" );
 static const wxChar Use3DConnexionDriver[] = wxT( "3DConnexionDriver" );
 static const wxChar ExtraFillMargin[] = wxT( "ExtraFillMargin" );
 static const wxChar DRCEpsilon[] = wxT( "DRCEpsilon" );
@@ -79,6 +81,9 @@ static const wxChar DrawArcCenterStartEndMaxAngle[] = wxT( "DrawArcCenterStartEn
 static const wxChar MaxTangentTrackAngleDeviation[] = wxT( "MaxTangentTrackAngleDeviation" );
 static const wxChar MaxTrackLengthToKeep[] = wxT( "MaxTrackLengthToKeep" );
 static const wxChar StrokeTriangulation[] = wxT( "StrokeTriangulation" );
+static const wxChar EnableGalInstancing[] = wxT( "EnableGalInstancing" );
+static const wxChar EnableFrameTracing[] = wxT( "EnableFrameTracing" );
+static const wxChar FrameTraceZones[] = wxT( "FrameTraceZones" );
 static const wxChar ExtraZoneDisplayModes[] = wxT( "ExtraZoneDisplayModes" );
 static const wxChar MinPlotPenWidth[] = wxT( "MinPlotPenWidth" );
 static const wxChar DebugZoneFiller[] = wxT( "DebugZoneFiller" );
@@ -207,6 +212,9 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_MaxTrackLengthToKeep      = 0.0005;
     m_ExtraZoneDisplayModes     = false;
     m_DrawTriangulationOutlines = false;
+    m_EnableGalInstancing       = true;
+    m_EnableFrameTracing        = false;
+    m_FrameTraceZones           = 262144;
 
     m_ExtraClearance            = 0.0005;
     m_DRCEpsilon                = 0.0005;   // 0.5um is small enough not to materially violate
@@ -250,6 +258,8 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_Use3DConnexionDriver      = true;
 
     m_IncrementalConnectivity   = true;
+    m_VerifyIncrementalConnectivity = false;
+    m_IndexSymbolLibraries      = false;
 
     m_DisambiguationMenuDelay   = 500;
 
@@ -375,6 +385,17 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                 &m_DrawTriangulationOutlines,
                                                 m_DrawTriangulationOutlines ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::EnableGalInstancing,
+                                                &m_EnableGalInstancing,
+                                                m_EnableGalInstancing ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::EnableFrameTracing,
+                                                &m_EnableFrameTracing, m_EnableFrameTracing ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::FrameTraceZones,
+                                               &m_FrameTraceZones, m_FrameTraceZones,
+                                               1024, 16777216 ) );
+
     configParams.push_back( new PARAM_CFG_DOUBLE( true, AC_KEYS::MinPlotPenWidth,
                                                   &m_MinPlotPenWidth, m_MinPlotPenWidth,
                                                   0.0, 1.0 ) );
@@ -438,6 +459,14 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                 &m_IncrementalConnectivity,
                                                 m_IncrementalConnectivity ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::VerifyIncrementalConnectivity,
+                                                &m_VerifyIncrementalConnectivity,
+                                                m_VerifyIncrementalConnectivity ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IndexSymbolLibraries,
+                                                &m_IndexSymbolLibraries,
+                                                m_IndexSymbolLibraries ) );
+
     configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::DisambiguationTime,
                                                &m_DisambiguationMenuDelay,
                                                m_DisambiguationMenuDelay,
@@ -58,6 +58,15 @@ void CALLBACK_GAL::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTotal
             }
         }
     }
+    else if( aGlyph.IsSharedOutline() )
+    {
+        const auto& shared = static_cast<const KIFONT::SHARED_OUTLINE_GLYPH&>( aGlyph );
+
+        if( m_triangulate )
+            shared.Triangulate( m_triangleCallback );
+        else
+            DrawGlyph( *shared.Instantiate(), aNth, aTotal );
+    }
     else if( aGlyph.IsOutline() )
     {
         if( m_triangulate )
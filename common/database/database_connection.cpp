@@ -313,8 +313,6 @@ std::string DATABASE_CONNECTION::columnsFor( const std::string& aTable )
     return ret;
 }
 
-//next step, make SelectOne take from the SelectAll cache if the SelectOne cache is missing.
-//To do this, need to build a map of PK->ROW for the cache result.
 bool DATABASE_CONNECTION::SelectOne( const std::string& aTable,
                                      const std::pair<std::string, std::string>& aWhere,
                                      DATABASE_CONNECTION::ROW& aResult )
@@ -337,7 +335,9 @@ bool DATABASE_CONNECTION::SelectOne( const std::string& aTable,
     const std::string& tableName = tableMapIter->first;
     DB_CACHE_TYPE::CACHE_VALUE cacheEntry;
 
-    if( m_cache->Get( tableName, cacheEntry ) )
+    bool cached = m_cache->Get( tableName, cacheEntry );
+
+    if( cached )
     {
         if( cacheEntry.count( aWhere.second ) )
         {
@@ -366,6 +366,34 @@ bool DATABASE_CONNECTION::SelectOne( const std::string& aTable,
 
     const std::string& columnName = columnCacheIter->first;
 
+    if( !cached && m_cache->GetMaxSize() > 0 )
+    {
+        // Fetching the whole table costs a single round-trip, and the rows are then cached for
+        // the next lookups (for instance all the symbols of a schematic being loaded)
+        std::vector<ROW> rows;
+
+        if( SelectAll( tableName, aWhere.first, rows ) )
+        {
+            for( ROW& row : rows )
+            {
+                if( std::any_cast<std::string>( row.at( aWhere.first ) ) == aWhere.second )
+                {
+                    aResult = std::move( row );
+                    return true;
+                }
+            }
+
+            // The database may still match the key in ways a string comparison does not, such
+            // as case insensitive collations, padded CHAR columns or numeric keys
+            wxLogTrace( traceDatabase, wxT( "SelectOne: `%s` with parameter `%s` - not found "
+                                            "in table rows, querying" ),
+                        tableName, aWhere.second );
+        }
+
+        if( !m_conn->connected() )
+            return false;
+    }
+
     std::string cacheKey = fmt::format( "{}{}{}", tableName, columnName, aWhere.second );
 
     std::string queryStr = fmt::format( "SELECT {} FROM {}{}{} WHERE {}{}{} = ?",
@@ -642,7 +670,18 @@ bool DATABASE_CONNECTION::SelectAll( const std::string& aTable, const std::strin
     wxLogTrace( traceDatabase, wxT( "SelectAll from %s completed in %0.1f ms" ), aTable,
                 timer.msecs() );
 
-    for( const ROW& row : aResults )
+    CacheRows( aTable, aKey, aResults );
+
+    return true;
+}
+
+
+void DATABASE_CONNECTION::CacheRows( const std::string& aTable, const std::string& aKey,
+                                     const std::vector<ROW>& aRows )
+{
+    DB_CACHE_TYPE::CACHE_VALUE cacheEntry;
+
+    for( const ROW& row : aRows )
     {
         wxASSERT( row.count( aKey ) );
         std::string keyStr = std::any_cast<std::string>( row.at( aKey ) );
@@ -650,6 +689,103 @@ bool DATABASE_CONNECTION::SelectAll( const std::string& aTable, const std::strin
     }
 
     m_cache->Put( aTable, cacheEntry );
+}
+
+
+bool DATABASE_CONNECTION::SelectCount( const std::string& aTable, size_t& aCount )
+{
+    if( !m_conn )
+    {
+        wxLogTrace( traceDatabase, wxT( "Called SelectCount without valid connection!" ) );
+        return false;
+    }
+
+    if( !m_tables.count( aTable ) )
+    {
+        wxLogTrace( traceDatabase, wxT( "SelectCount: requested table %s not found in cache" ),
+                    aTable );
+        return false;
+    }
+
+    std::string result;
+
+    if( !selectScalar( fmt::format( "SELECT COUNT(*) FROM {}{}{}", m_quoteChar, aTable,
+                                    m_quoteChar ),
+                       result ) )
+    {
+        return false;
+    }
+
+    try
+    {
+        aCount = std::stoull( result );
+    }
+    catch( std::exception& )
+    {
+        wxLogTrace( traceDatabase, wxT( "SelectCount: invalid row count `%s`" ), result );
+        return false;
+    }
+
+    return true;
+}
+
+
+bool DATABASE_CONNECTION::SelectMax( const std::string& aTable, const std::string& aColumn,
+                                     std::string& aResult )
+{
+    if( !m_conn )
+    {
+        wxLogTrace( traceDatabase, wxT( "Called SelectMax without valid connection!" ) );
+        return false;
+    }
+
+    if( !m_columnCache.count( aTable ) || !m_columnCache.at( aTable ).count( aColumn ) )
+    {
+        wxLogTrace( traceDatabase,
+                    wxT( "SelectMax: requested column %s not found in cache for %s" ),
+                    aColumn, aTable );
+        return false;
+    }
+
+    return selectScalar( fmt::format( "SELECT MAX({}{}{}) FROM {}{}{}",
+                                      m_quoteChar, aColumn, m_quoteChar,
+                                      m_quoteChar, aTable, m_quoteChar ),
+                         aResult );
+}
+
+
+bool DATABASE_CONNECTION::selectScalar( const std::string& aQuery, std::string& aResult )
+{
+    nanodbc::statement statement( *m_conn );
+    nanodbc::string query = fromUTF8( aQuery );
+
+    wxLogTrace( traceDatabase, wxT( "selectScalar: `%s`" ), aQuery );
+
+    try
+    {
+        statement.prepare( query );
+
+        nanodbc::result results = nanodbc::execute( statement );
+
+        if( !results.first() )
+        {
+            wxLogTrace( traceDatabase, wxT( "selectScalar: no results returned from query" ) );
+            return false;
+        }
+
+        aResult = toUTF8( results.get<nanodbc::string>( 0, NANODBC_TEXT( "" ) ) );
+    }
+    catch( nanodbc::database_error& e )
+    {
+        m_lastError = e.what();
+        wxLogTrace( traceDatabase, wxT( "Exception while executing query `%s`: %s" ), aQuery,
+                    m_lastError );
+
+        // Exception may be due to a connection error; nanodbc won't auto-reconnect
+        m_conn->disconnect();
+
+        return false;
+    }
 
     return true;
 }
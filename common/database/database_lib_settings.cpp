@@ -84,6 +84,7 @@ DATABASE_LIB_SETTINGS::DATABASE_LIB_SETTINGS( const std::string& aFilename ) :
                 table.key_col        = entry["key"].get<std::string>();
                 table.symbols_col    = entry["symbols"].get<std::string>();
                 table.footprints_col = entry["footprints"].get<std::string>();
+                table.modified_col   = fetchOrDefault<std::string>( entry, "modified" );
 
                 // Sanitize library display names; currently only `/` is removed because we use it
                 // as a separator and allow it in symbol names.
@@ -138,6 +139,8 @@ DATABASE_LIB_SETTINGS::DATABASE_LIB_SETTINGS( const std::string& aFilename ) :
 
     m_params.emplace_back( new PARAM<int>( "cache.max_age", &m_Cache.max_age, 10 ) );
 
+    m_params.emplace_back( new PARAM<bool>( "cache.snapshot", &m_Cache.snapshot, false ) );
+
     registerMigration( 0, 1,
                        [&]() -> bool
                        {
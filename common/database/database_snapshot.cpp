@@ -0,0 +1,198 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/wfstream.h>
+#include <wx/stdstream.h>
+
+#include <json_common.h>
+
+#include <database/database_snapshot.h>
+#include <paths.h>
+
+
+/// Version of the snapshot file format; snapshots written with another version are ignored
+static const int snapshotVersion = 1;
+
+
+bool DATABASE_SNAPSHOT::Load()
+{
+    m_tables.clear();
+
+    if( !wxFileName::FileExists( m_fileName ) )
+        return false;
+
+    try
+    {
+        wxFFileInputStream fp( m_fileName, wxT( "rb" ) );
+        wxStdInputStream   fstream( fp );
+
+        if( !fp.IsOk() )
+            return false;
+
+        nlohmann::json js = nlohmann::json::parse( fstream );
+
+        if( js.value( "version", 0 ) != snapshotVersion || !js["tables"].is_object() )
+        {
+            wxLogTrace( traceDatabase, wxT( "Ignoring snapshot %s from another version" ),
+                        m_fileName );
+            return false;
+        }
+
+        for( const auto& [ tableName, tableJson ] : js["tables"].items() )
+        {
+            TABLE table;
+
+            table.key   = tableJson.at( "key" ).get<std::string>();
+            table.count = tableJson.at( "count" ).get<size_t>();
+            table.stamp = tableJson.at( "stamp" ).get<std::string>();
+
+            for( const nlohmann::json& column : tableJson.at( "columns" ) )
+                table.columns.insert( column.get<std::string>() );
+
+            for( const nlohmann::json& rowJson : tableJson.at( "rows" ) )
+            {
+                DATABASE_CONNECTION::ROW& row = table.rows.emplace_back();
+
+                for( const auto& [ column, value ] : rowJson.items() )
+                    row[column] = value.get<std::string>();
+            }
+
+            m_tables[tableName] = std::move( table );
+        }
+    }
+    catch( std::exception& e )
+    {
+        wxLogTrace( traceDatabase, wxT( "Error reading snapshot %s: %s" ), m_fileName, e.what() );
+        m_tables.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool DATABASE_SNAPSHOT::Save() const
+{
+    nlohmann::json tables = nlohmann::json::object();
+
+    for( const auto& [ tableName, table ] : m_tables )
+    {
+        nlohmann::json rows = nlohmann::json::array();
+
+        for( const DATABASE_CONNECTION::ROW& row : table.rows )
+        {
+            nlohmann::json rowJson = nlohmann::json::object();
+
+            // Rows read from the database only hold strings
+            for( const auto& [ column, value ] : row )
+            {
+                if( const std::string* str = std::any_cast<std::string>( &value ) )
+                    rowJson[column] = *str;
+            }
+
+            rows.push_back( std::move( rowJson ) );
+        }
+
+        tables[tableName] = { { "key", table.key },
+                              { "columns", table.columns },
+                              { "count", table.count },
+                              { "stamp", table.stamp },
+                              { "rows", std::move( rows ) } };
+    }
+
+    nlohmann::json js = { { "version", snapshotVersion }, { "tables", std::move( tables ) } };
+
+    wxFileName fn( m_fileName );
+
+    if( !fn.DirExists() && !wxFileName::Mkdir( fn.GetPath(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+    {
+        wxLogTrace( traceDatabase, wxT( "Could not create directory for snapshot %s" ),
+                    m_fileName );
+        return false;
+    }
+
+    // Write to a temporary file first, so that other instances never read a partial snapshot.
+    // Its name is unique, as several instances (or a background refresh) can save at once.
+    wxString    tempFileName = wxFileName::CreateTempFileName( m_fileName );
+    std::string buffer = js.dump();
+
+    if( tempFileName.IsEmpty() )
+    {
+        wxLogTrace( traceDatabase, wxT( "Could not create a temporary file for snapshot %s" ),
+                    m_fileName );
+        return false;
+    }
+
+    {
+        wxFFileOutputStream fileStream( tempFileName, "wb" );
+
+        if( !fileStream.IsOk() || !fileStream.WriteAll( buffer.c_str(), buffer.size() ) )
+        {
+            wxLogTrace( traceDatabase, wxT( "Could not write snapshot %s" ), tempFileName );
+            fileStream.Close();
+            wxRemoveFile( tempFileName );
+            return false;
+        }
+    }
+
+    if( !wxRenameFile( tempFileName, m_fileName, true ) )
+    {
+        wxLogTrace( traceDatabase, wxT( "Could not replace snapshot %s" ), m_fileName );
+        wxRemoveFile( tempFileName );
+        return false;
+    }
+
+    return true;
+}
+
+
+const DATABASE_SNAPSHOT::TABLE* DATABASE_SNAPSHOT::GetTable( const std::string& aTable ) const
+{
+    auto it = m_tables.find( aTable );
+
+    return it != m_tables.end() ? &it->second : nullptr;
+}
+
+
+void DATABASE_SNAPSHOT::SetTable( const std::string& aTable, TABLE aData )
+{
+    m_tables[aTable] = std::move( aData );
+}
+
+
+wxString DATABASE_SNAPSHOT::GetFileNameFor( const wxString& aLibraryPath )
+{
+    wxFileName fn( PATHS::GetUserCachePath(), wxEmptyString );
+    fn.AppendDir( wxS( "dblib" ) );
+
+    // Libraries with the same name may be found in different places
+    size_t hash = std::hash<std::string>()( std::string( aLibraryPath.ToUTF8() ) );
+
+    fn.SetName( wxString::Format( wxS( "%s-%llx" ), wxFileName( aLibraryPath ).GetName(),
+                                  static_cast<unsigned long long>( hash ) ) );
+    fn.SetExt( wxS( "json" ) );
+
+    return fn.GetFullPath();
+}
@@ -52,6 +52,7 @@
 #include <kiplatform/ui.h>
 
 #include <core/profile.h>
+#include <frame_tracer.h>
 
 #include <pgm_base.h>
 
@@ -220,6 +221,8 @@ bool EDA_DRAW_PANEL_GAL::DoRePaint()
 
     SCOPED_SET_RESET<bool> drawing( m_drawing, true );
 
+    KI_TRACE_ZONE( "EDA_DRAW_PANEL_GAL::DoRePaint", "frame" );
+
     ( *m_PaintEventCounter )++;
 
     wxASSERT( m_painter );
@@ -135,6 +135,11 @@ EDA_TEXT::EDA_TEXT( const EDA_TEXT& aText ) :
             m_render_cache.emplace_back( std::make_unique<KIFONT::OUTLINE_GLYPH>( *outline ) );
         else if( KIFONT::STROKE_GLYPH* stroke = dynamic_cast<KIFONT::STROKE_GLYPH*>( glyph.get() ) )
             m_render_cache.emplace_back( std::make_unique<KIFONT::STROKE_GLYPH>( *stroke ) );
+        else if( auto* shared = dynamic_cast<KIFONT::SHARED_OUTLINE_GLYPH*>( glyph.get() ) )
+        {
+            m_render_cache.emplace_back(
+                    std::make_unique<KIFONT::SHARED_OUTLINE_GLYPH>( *shared ) );
+        }
     }
 
     m_bounding_box_cache_valid = aText.m_bounding_box_cache_valid;
@@ -171,6 +176,11 @@ EDA_TEXT& EDA_TEXT::operator=( const EDA_TEXT& aText )
             m_render_cache.emplace_back( std::make_unique<KIFONT::OUTLINE_GLYPH>( *outline ) );
         else if( KIFONT::STROKE_GLYPH* stroke = dynamic_cast<KIFONT::STROKE_GLYPH*>( glyph.get() ) )
             m_render_cache.emplace_back( std::make_unique<KIFONT::STROKE_GLYPH>( *stroke ) );
+        else if( auto* shared = dynamic_cast<KIFONT::SHARED_OUTLINE_GLYPH*>( glyph.get() ) )
+        {
+            m_render_cache.emplace_back(
+                    std::make_unique<KIFONT::SHARED_OUTLINE_GLYPH>( *shared ) );
+        }
     }
 
     m_bounding_box_cache_valid = aText.m_bounding_box_cache_valid;
@@ -445,6 +455,8 @@ void EDA_TEXT::Offset( const VECTOR2I& aOffset )
     {
         if( KIFONT::OUTLINE_GLYPH* outline = dynamic_cast<KIFONT::OUTLINE_GLYPH*>( glyph.get() ) )
             outline->Move( aOffset );
+        else if( auto* shared = dynamic_cast<KIFONT::SHARED_OUTLINE_GLYPH*>( glyph.get() ) )
+            shared->Move( aOffset );
         else if( KIFONT::STROKE_GLYPH* stroke = dynamic_cast<KIFONT::STROKE_GLYPH*>( glyph.get() ) )
             glyph = stroke->Transform( { 1.0, 1.0 }, aOffset, 0, ANGLE_0, false, { 0, 0 } );
     }
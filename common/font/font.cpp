@@ -26,6 +26,7 @@
 
 #include <list>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include <macros.h>
@@ -127,6 +128,7 @@ private:
 
 static MARKUP_CACHE s_markupCache( 1024 );
 static std::mutex s_markupCacheMutex;
+static std::shared_mutex s_fontMapMutex;
 
 
 FONT::FONT()
@@ -136,6 +138,7 @@ FONT::FONT()
 
 FONT* FONT::getDefaultFont()
 {
+    // Must be called with s_fontMapMutex held exclusively
     if( !s_defaultFont )
         s_defaultFont = STROKE_FONT::LoadFont( wxEmptyString );
 
@@ -145,15 +148,38 @@ FONT* FONT::getDefaultFont()
 
 FONT* FONT::GetFont( const wxString& aFontName, bool aBold, bool aItalic )
 {
+    // Fonts are also looked up by items created or drawn on worker threads.  They are nearly
+    // always found, so only loading a font takes the lock exclusively.
     if( aFontName.empty() || aFontName.StartsWith( KICAD_FONT_NAME ) )
+    {
+        {
+            std::shared_lock<std::shared_mutex> readLock( s_fontMapMutex );
+
+            if( s_defaultFont )
+                return s_defaultFont;
+        }
+
+        std::unique_lock<std::shared_mutex> writeLock( s_fontMapMutex );
         return getDefaultFont();
+    }
 
     std::tuple<wxString, bool, bool> key = { aFontName, aBold, aItalic };
 
+    {
+        std::shared_lock<std::shared_mutex> readLock( s_fontMapMutex );
+        auto                                it = s_fontMap.find( key );
+
+        if( it != s_fontMap.end() && it->second )
+            return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> writeLock( s_fontMapMutex );
+
+    // Another thread may have loaded the font in the meantime
     FONT* font = nullptr;
 
-    if( s_fontMap.find( key ) != s_fontMap.end() )
-        font = s_fontMap[key];
+    if( auto it = s_fontMap.find( key ); it != s_fontMap.end() )
+        font = it->second;
 
     if( !font )
         font = OUTLINE_FONT::LoadFont( aFontName, aBold, aItalic );
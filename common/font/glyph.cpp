@@ -162,6 +162,80 @@ void OUTLINE_GLYPH::CacheTriangulation( bool aPartition, bool aSimplify )
 }
 
 
+BOX2D SHARED_OUTLINE_GLYPH::BoundingBox()
+{
+    // Holes are inside the outlines, and a rotated box would not be tight
+    BOX2D bbox;
+    bool  first = true;
+
+    for( int ii = 0; ii < m_glyph->OutlineCount(); ii++ )
+    {
+        for( const VECTOR2I& pt : m_glyph->COutline( ii ).CPoints() )
+        {
+            VECTOR2D mapped = m_transform * VECTOR2D( pt );
+
+            if( first )
+                bbox = BOX2D( mapped );
+            else
+                bbox.Merge( mapped );
+
+            first = false;
+        }
+    }
+
+    return bbox;
+}
+
+
+std::unique_ptr<OUTLINE_GLYPH> SHARED_OUTLINE_GLYPH::Instantiate() const
+{
+    std::unique_ptr<OUTLINE_GLYPH> glyph = std::make_unique<OUTLINE_GLYPH>();
+
+    auto transformed =
+            [&]( const SHAPE_LINE_CHAIN& aChain )
+            {
+                SHAPE_LINE_CHAIN chain;
+
+                chain.ReservePoints( aChain.PointCount() );
+
+                for( const VECTOR2I& pt : aChain.CPoints() )
+                    chain.Append( Transform( pt ) );
+
+                chain.SetClosed( true );
+                return chain;
+            };
+
+    for( int ii = 0; ii < m_glyph->OutlineCount(); ii++ )
+    {
+        int outline = glyph->AddOutline( transformed( m_glyph->COutline( ii ) ) );
+
+        for( int jj = 0; jj < m_glyph->HoleCount( ii ); jj++ )
+            glyph->AddHole( transformed( m_glyph->CHole( ii, jj ) ), outline );
+    }
+
+    return glyph;
+}
+
+
+void SHARED_OUTLINE_GLYPH::Triangulate( std::function<void( const VECTOR2I& aPt1,
+                                                            const VECTOR2I& aPt2,
+                                                            const VECTOR2I& aPt3 )> aCallback ) const
+{
+    // Shared glyphs are triangulated when they enter the cache
+    for( unsigned int i = 0; i < m_glyph->TriangulatedPolyCount(); i++ )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* polygon = m_glyph->TriangulatedPolygon( i );
+
+        for( size_t j = 0; j < polygon->GetTriangleCount(); j++ )
+        {
+            VECTOR2I a, b, c;
+            polygon->GetTriangle( j, a, b, c );
+            aCallback( Transform( a ), Transform( b ), Transform( c ) );
+        }
+    }
+}
+
+
 std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> OUTLINE_GLYPH::GetTriangulationData() const
 {
     std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> data;
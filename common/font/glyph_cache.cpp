@@ -0,0 +1,176 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <font/glyph_cache.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include <hash.h>
+
+
+using namespace KIFONT;
+
+
+std::size_t GLYPH_CACHE_KEY_HASH::operator()( const GLYPH_CACHE_KEY& aKey ) const
+{
+    std::size_t seed = 0;
+
+    hash_combine( seed, aKey.m_face, aKey.m_glyphIndex, aKey.m_charSize, aKey.m_fakeItalic,
+                  aKey.m_fakeBold );
+
+    return seed;
+}
+
+
+GLYPH_CACHE& GLYPH_CACHE::Instance()
+{
+    static GLYPH_CACHE cache;
+    return cache;
+}
+
+
+std::shared_ptr<const OUTLINE_GLYPH>
+GLYPH_CACHE::Get( const GLYPH_CACHE_KEY&                                   aKey,
+                  const std::function<std::unique_ptr<OUTLINE_GLYPH>()>& aBuilder )
+{
+    {
+        std::shared_lock<std::shared_mutex> lock( m_mutex );
+
+        auto it = m_glyphs.find( aKey );
+
+        if( it != m_glyphs.end() )
+        {
+            m_hits++;
+            return it->second;
+        }
+    }
+
+    m_misses++;
+
+    std::shared_ptr<const OUTLINE_GLYPH> glyph = aBuilder();
+    std::unique_lock<std::shared_mutex>  lock( m_mutex );
+
+    auto [it, inserted] = m_glyphs.emplace( aKey, glyph );
+
+    if( inserted )
+    {
+        m_bytes += GlyphBytes( *glyph );
+
+        // The new glyph is also held by glyph, so it survives the purge
+        if( m_bytes > m_purgeAbove )
+        {
+            purgeUnlocked();
+
+            // If most glyphs are in use, don't scan them again on every new glyph
+            m_purgeAbove = std::max( MAX_BYTES, 2 * m_bytes );
+        }
+
+        return glyph;
+    }
+
+    return it->second;
+}
+
+
+void GLYPH_CACHE::Purge()
+{
+    std::unique_lock<std::shared_mutex> lock( m_mutex );
+
+    purgeUnlocked();
+    m_purgeAbove = MAX_BYTES;
+}
+
+
+void GLYPH_CACHE::purgeUnlocked()
+{
+    // Texts only get glyphs through the cache, so a glyph held by the cache alone cannot gain
+    // new users while the lock is held.
+    for( auto it = m_glyphs.begin(); it != m_glyphs.end(); )
+    {
+        if( it->second.use_count() == 1 )
+        {
+            m_bytes -= GlyphBytes( *it->second );
+            m_purged++;
+            it = m_glyphs.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
+void GLYPH_CACHE::Clear()
+{
+    std::unique_lock<std::shared_mutex> lock( m_mutex );
+
+    m_glyphs.clear();
+    m_bytes = 0;
+    m_purgeAbove = MAX_BYTES;
+}
+
+
+GLYPH_CACHE_STATS GLYPH_CACHE::GetStats() const
+{
+    std::shared_lock<std::shared_mutex> lock( m_mutex );
+    GLYPH_CACHE_STATS                   stats;
+
+    stats.m_glyphs = m_glyphs.size();
+    stats.m_bytes = m_bytes;
+    stats.m_hits = m_hits;
+    stats.m_misses = m_misses;
+    stats.m_purged = m_purged;
+
+    return stats;
+}
+
+
+size_t GLYPH_CACHE::GlyphBytes( const OUTLINE_GLYPH& aGlyph )
+{
+    size_t bytes = sizeof( OUTLINE_GLYPH );
+
+    for( int ii = 0; ii < aGlyph.OutlineCount(); ii++ )
+    {
+        for( int jj = 0; jj < aGlyph.HoleCount( ii ) + 1; jj++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = jj ? aGlyph.CHole( ii, jj - 1 ) : aGlyph.COutline( ii );
+
+            // Each point also has its arc indices
+            bytes += sizeof( SHAPE_LINE_CHAIN )
+                     + chain.PointCount() * ( sizeof( VECTOR2I ) + 2 * sizeof( ssize_t ) );
+        }
+    }
+
+    for( unsigned int ii = 0; ii < aGlyph.TriangulatedPolyCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* poly = aGlyph.TriangulatedPolygon( ii );
+
+        bytes += sizeof( SHAPE_POLY_SET::TRIANGULATED_POLYGON )
+                 + poly->GetVertexCount() * sizeof( VECTOR2I )
+                 + poly->GetTriangleCount() * sizeof( SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI );
+    }
+
+    return bytes;
+}
@@ -29,6 +29,7 @@
 #include <geometry/shape_poly_set.h>
 #include <font/fontconfig.h>
 #include <font/outline_font.h>
+#include <font/glyph_cache.h>
 #include FT_GLYPH_H
 #include FT_BBOX_H
 #include <trigo.h>
@@ -256,34 +257,102 @@ VECTOR2I OUTLINE_FONT::getTextAsGlyphs( BOX2I* aBBox, std::vector<std::unique_pt
 }
 
 
-struct GLYPH_CACHE_KEY {
-    FT_Face        face;
-    hb_codepoint_t codepoint;
-    bool           fakeItalic;
-    bool           fakeBold;
-    bool           mirror;
-    EDA_ANGLE      angle;
+std::unique_ptr<OUTLINE_GLYPH> OUTLINE_FONT::makeGlyph( FT_Face aFace, unsigned int aGlyphIndex,
+                                                       double aAdvance, double aScaler,
+                                                       const GLYPH_CACHE_KEY& aKey ) const
+{
+    // All the outlines in the glyph; for example the 'o' glyph generally contains 2 contours,
+    // one for the glyph outline and one for the hole
+    std::vector<CONTOUR> contours;
 
-    bool operator==(const GLYPH_CACHE_KEY& rhs ) const
+    if( aKey.m_fakeItalic )
     {
-        return face == rhs.face && codepoint == rhs.codepoint
-                   && fakeItalic == rhs.fakeItalic && fakeBold == rhs.fakeBold
-                   && mirror == rhs.mirror && angle == rhs.angle;
+        FT_Matrix matrix;
+        // Create a 12 degree slant
+        const float angle = (float)( -M_PI * 12.0f ) / 180.0f;
+        matrix.xx = (FT_Fixed) ( cos( angle ) * 0x10000L );
+        matrix.xy = (FT_Fixed) ( -sin( angle ) * 0x10000L );
+        matrix.yx = (FT_Fixed) ( 0 * 0x10000L );  // Don't rotate in the y direction
+        matrix.yy = (FT_Fixed) ( 1 * 0x10000L );
+
+        FT_Set_Transform( aFace, &matrix, nullptr );
     }
-};
 
-namespace std
-{
-    template <>
-    struct hash<GLYPH_CACHE_KEY>
+    FT_Load_Glyph( aFace, aGlyphIndex, FT_LOAD_NO_BITMAP );
+
+    if( aKey.m_fakeBold )
+        FT_Outline_Embolden( &aFace->glyph->outline, 1 << 6 );
+
+    OUTLINE_DECOMPOSER decomposer( aFace->glyph->outline );
+
+    if( !decomposer.OutlineToSegments( &contours ) )
+    {
+        BOX2D tofuBox( { aScaler * 0.03, 0.0 }, { aAdvance - aScaler * 0.02, aScaler * 0.72 } );
+
+        contours.clear();
+
+        CONTOUR outline;
+        outline.m_Winding = 1;
+        outline.m_Orientation = FT_ORIENTATION_TRUETYPE;
+        outline.m_Points.push_back( tofuBox.GetPosition() );
+        outline.m_Points.push_back( { tofuBox.GetSize().x, tofuBox.GetPosition().y } );
+        outline.m_Points.push_back( tofuBox.GetSize() );
+        outline.m_Points.push_back( { tofuBox.GetPosition().x, tofuBox.GetSize().y } );
+        contours.push_back( outline );
+
+        CONTOUR hole;
+        tofuBox.Move( { aScaler * 0.06, aScaler * 0.06 } );
+        tofuBox.SetSize( { tofuBox.GetWidth() - aScaler * 0.06,
+                           tofuBox.GetHeight() - aScaler * 0.06 } );
+        hole.m_Winding = 1;
+        hole.m_Orientation = FT_ORIENTATION_NONE;
+        hole.m_Points.push_back( tofuBox.GetPosition() );
+        hole.m_Points.push_back( { tofuBox.GetSize().x, tofuBox.GetPosition().y } );
+        hole.m_Points.push_back( tofuBox.GetSize() );
+        hole.m_Points.push_back( { tofuBox.GetPosition().x, tofuBox.GetSize().y } );
+        contours.push_back( hole );
+    }
+
+    // The glyph is cached in font units (premultiplied to keep their precision as integers);
+    // texts map it to their size, mirroring, rotation and position when drawing it.
+    std::unique_ptr<OUTLINE_GLYPH> glyph = std::make_unique<OUTLINE_GLYPH>();
+    std::vector<SHAPE_LINE_CHAIN>  holes;
+
+    for( CONTOUR& c : contours )
     {
-        std::size_t operator()( const GLYPH_CACHE_KEY& k ) const
+        SHAPE_LINE_CHAIN shape;
+
+        shape.ReservePoints( c.m_Points.size() );
+
+        for( const VECTOR2D& v : c.m_Points )
+            shape.Append( KiROUND( v.x * GLYPH_CACHE_SCALE ), KiROUND( v.y * GLYPH_CACHE_SCALE ) );
+
+        shape.SetClosed( true );
+
+        if( contourIsHole( c ) )
+            holes.push_back( std::move( shape ) );
+        else
+            glyph->AddOutline( std::move( shape ) );
+    }
+
+    for( SHAPE_LINE_CHAIN& hole : holes )
+    {
+        if( hole.PointCount() )
         {
-            return hash<const void*>()( k.face ) ^ hash<unsigned>()( k.codepoint )
-                        ^ hash<int>()( k.fakeItalic ) ^ hash<int>()( k.fakeBold )
-                        ^ hash<int>()( k.mirror ) ^ hash<int>()( k.angle.AsTenthsOfADegree() );
+            for( int ii = 0; ii < glyph->OutlineCount(); ++ii )
+            {
+                if( glyph->Outline( ii ).PointInside( hole.GetPoint( 0 ) ) )
+                {
+                    glyph->AddHole( std::move( hole ), ii );
+                    break;
+                }
+            }
         }
-    };
+    }
+
+    glyph->CacheTriangulation( false, false );
+
+    return glyph;
 }
 
 
@@ -327,9 +396,12 @@ VECTOR2I OUTLINE_FONT::getTextAsGlyphsUnlocked( BOX2I* aBBox,
     if( aGlyphs )
         aGlyphs->reserve( glyphCount );
 
-    // GLYPH_DATA is a collection of all outlines in the glyph; for example the 'o' glyph
-    // generally contains 2 contours, one for the glyph outline and one for the hole
-    static std::unordered_map<GLYPH_CACHE_KEY, GLYPH_DATA> s_glyphCache;
+    double verticalOffset = 0.0;
+
+    if( IsSubscript( aTextStyle ) )
+        verticalOffset = m_subscriptVerticalOffset * scaler;
+    else if( IsSuperscript( aTextStyle ) )
+        verticalOffset = m_superscriptVerticalOffset * scaler;
 
     for( unsigned int i = 0; i < glyphCount; i++ )
     {
@@ -339,128 +411,54 @@ VECTOR2I OUTLINE_FONT::getTextAsGlyphsUnlocked( BOX2I* aBBox,
 
         if( aGlyphs )
         {
-            GLYPH_CACHE_KEY key = { face, glyphInfo[i].codepoint, m_fakeItal, m_fakeBold,
-                                    aMirror, aAngle };
-            GLYPH_DATA&     glyphData = s_glyphCache[ key ];
-
-            if( glyphData.m_Contours.empty() )
-            {
-                if( m_fakeItal )
-                {
-                    FT_Matrix matrix;
-                    // Create a 12 degree slant
-                    const float angle = (float)( -M_PI * 12.0f ) / 180.0f;
-                    matrix.xx = (FT_Fixed) ( cos( angle ) * 0x10000L );
-                    matrix.xy = (FT_Fixed) ( -sin( angle ) * 0x10000L );
-                    matrix.yx = (FT_Fixed) ( 0 * 0x10000L );  // Don't rotate in the y direction
-                    matrix.yy = (FT_Fixed) ( 1 * 0x10000L );
-
-                    FT_Set_Transform( face, &matrix, nullptr );
-                }
-
-                FT_Load_Glyph( face, glyphInfo[i].codepoint, FT_LOAD_NO_BITMAP );
-
-                if( m_fakeBold )
-                    FT_Outline_Embolden( &face->glyph->outline, 1 << 6 );
-
-                OUTLINE_DECOMPOSER decomposer( face->glyph->outline );
-
-                if( !decomposer.OutlineToSegments( &glyphData.m_Contours ) )
-                {
-                    double  hb_advance = glyphPos[i].x_advance * GLYPH_SIZE_SCALER;
-                    BOX2D   tofuBox( { scaler * 0.03, 0.0 },
-                                     { hb_advance - scaler * 0.02, scaler * 0.72 } );
-
-                    glyphData.m_Contours.clear();
-
-                    CONTOUR outline;
-                    outline.m_Winding = 1;
-                    outline.m_Orientation = FT_ORIENTATION_TRUETYPE;
-                    outline.m_Points.push_back( tofuBox.GetPosition() );
-                    outline.m_Points.push_back( { tofuBox.GetSize().x, tofuBox.GetPosition().y } );
-                    outline.m_Points.push_back( tofuBox.GetSize() );
-                    outline.m_Points.push_back( { tofuBox.GetPosition().x, tofuBox.GetSize().y } );
-                    glyphData.m_Contours.push_back( outline );
-
-                    CONTOUR hole;
-                    tofuBox.Move( { scaler * 0.06, scaler * 0.06 } );
-                    tofuBox.SetSize( { tofuBox.GetWidth() - scaler * 0.06,
-                                       tofuBox.GetHeight() - scaler * 0.06 } );
-                    hole.m_Winding = 1;
-                    hole.m_Orientation = FT_ORIENTATION_NONE;
-                    hole.m_Points.push_back( tofuBox.GetPosition() );
-                    hole.m_Points.push_back( { tofuBox.GetSize().x, tofuBox.GetPosition().y } );
-                    hole.m_Points.push_back( tofuBox.GetSize() );
-                    hole.m_Points.push_back( { tofuBox.GetPosition().x, tofuBox.GetSize().y } );
-                    glyphData.m_Contours.push_back( hole );
-                }
-            }
+            GLYPH_CACHE_KEY key = { face, glyphInfo[i].codepoint, KiROUND( scaler ), m_fakeItal,
+                                    m_fakeBold };
 
-            std::unique_ptr<OUTLINE_GLYPH> glyph = std::make_unique<OUTLINE_GLYPH>();
-            std::vector<SHAPE_LINE_CHAIN>  holes;
-
-            for( CONTOUR& c : glyphData.m_Contours )
-            {
-                std::vector<VECTOR2D> points = c.m_Points;
-                SHAPE_LINE_CHAIN      shape;
-
-                shape.ReservePoints( points.size() );
-
-                for( const VECTOR2D& v : points )
-                {
-                    VECTOR2D pt( v + cursor );
+            std::shared_ptr<const OUTLINE_GLYPH> glyph = GLYPH_CACHE::Instance().Get( key,
+                    [&]()
+                    {
+                        return makeGlyph( face, glyphInfo[i].codepoint,
+                                          glyphPos[i].x_advance * GLYPH_SIZE_SCALER, scaler,
+                                          key );
+                    } );
+
+            // Map the cached glyph as its contour points would have been transformed: scaled,
+            // mirrored and rotated around the origin, then placed
+            auto linear =
+                    [&]( VECTOR2D aVec )
+                    {
+                        aVec *= scaleFactor;
 
-                    if( IsSubscript( aTextStyle ) )
-                        pt.y += m_subscriptVerticalOffset * scaler;
-                    else if( IsSuperscript( aTextStyle ) )
-                        pt.y += m_superscriptVerticalOffset * scaler;
+                        if( aMirror )
+                            aVec.x = -aVec.x;
 
-                    pt *= scaleFactor;
-                    pt += aPosition;
+                        if( !aAngle.IsZero() )
+                            RotatePoint( aVec, aAngle );
 
-                    if( aMirror )
-                        pt.x = aOrigin.x - ( pt.x - aOrigin.x );
+                        return aVec;
+                    };
 
-                    if( !aAngle.IsZero() )
-                        RotatePoint( pt, aOrigin, aAngle );
+            VECTOR2D xAxis = linear( { 1.0 / GLYPH_CACHE_SCALE, 0.0 } );
+            VECTOR2D yAxis = linear( { 0.0, 1.0 / GLYPH_CACHE_SCALE } );
+            VECTOR2D pt( cursor );
 
-                    shape.Append( pt.x, pt.y );
-                }
+            pt *= scaleFactor;
+            pt += aPosition;
 
-                shape.SetClosed( true );
+            if( aMirror )
+                pt.x = aOrigin.x - ( pt.x - aOrigin.x );
 
-                if( contourIsHole( c ) )
-                    holes.push_back( std::move( shape ) );
-                else
-                    glyph->AddOutline( std::move( shape ) );
-            }
+            if( !aAngle.IsZero() )
+                RotatePoint( pt, aOrigin, aAngle );
 
-            for( SHAPE_LINE_CHAIN& hole : holes )
-            {
-                if( hole.PointCount() )
-                {
-                    for( int ii = 0; ii < glyph->OutlineCount(); ++ii )
-                    {
-                        if( glyph->Outline( ii ).PointInside( hole.GetPoint( 0 ) ) )
-                        {
-                            glyph->AddHole( std::move( hole ), ii );
-                            break;
-                        }
-                    }
-                }
-            }
+            pt += linear( { 0.0, verticalOffset } );
 
-            if( glyphData.m_TriangulationData.empty() )
-            {
-                glyph->CacheTriangulation( false, false );
-                glyphData.m_TriangulationData = glyph->GetTriangulationData();
-            }
-            else
-            {
-                glyph->CacheTriangulation( glyphData.m_TriangulationData );
-            }
+            MATRIX3x3D transform( xAxis.x, yAxis.x, pt.x,
+                                  xAxis.y, yAxis.y, pt.y,
+                                  0.0,     0.0,     1.0 );
 
-            aGlyphs->push_back( std::move( glyph ) );
+            aGlyphs->push_back( std::make_unique<SHARED_OUTLINE_GLYPH>( std::move( glyph ),
+                                                                        transform ) );
         }
 
         hb_glyph_position_t& pos = glyphPos[i];
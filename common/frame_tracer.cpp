@@ -0,0 +1,228 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include <nlohmann/json.hpp>
+#include <wx/ffile.h>
+#include <wx/string.h>
+
+#include <advanced_config.h>
+#include <frame_tracer.h>
+
+
+static std::atomic<uint32_t> s_nextThread( 0 );
+
+
+/**
+ * A small number for the calling thread, easier to read in trace viewers than native ids.
+ */
+static uint32_t currentThread()
+{
+    thread_local uint32_t thread = s_nextThread++;
+
+    return thread;
+}
+
+
+static int64_t steadyMicroSecs()
+{
+    using namespace std::chrono;
+
+    return duration_cast<microseconds>( steady_clock::now().time_since_epoch() ).count();
+}
+
+
+FRAME_TRACER::FRAME_TRACER( size_t aCapacity ) :
+        m_enabled( false ),
+        m_capacity( std::max<size_t>( 1, aCapacity ) ),
+        m_zones( nullptr ),
+        m_next( 0 ),
+        m_first( 0 ),
+        m_epoch( steadyMicroSecs() )
+{
+}
+
+
+void FRAME_TRACER::Enable( bool aEnable )
+{
+    if( aEnable && !m_zones.load( std::memory_order_acquire ) )
+    {
+        std::lock_guard<std::mutex> lock( m_allocMutex );
+
+        if( !m_ring )
+        {
+            m_ring.reset( new ZONE[m_capacity] );
+
+            for( size_t ii = 0; ii < m_capacity; ++ii )
+                m_ring[ii].m_sequence.store( 0, std::memory_order_relaxed );
+
+            m_zones.store( m_ring.get(), std::memory_order_release );
+        }
+    }
+
+    // Zones seeing the tracer enabled also see its ring buffer
+    m_enabled.store( aEnable, std::memory_order_release );
+}
+
+
+FRAME_TRACER& FRAME_TRACER::Instance()
+{
+    // Never deleted, zones may still be recorded by threads outliving static destruction
+    static FRAME_TRACER* tracer =
+            []()
+            {
+                const ADVANCED_CFG& cfg = ADVANCED_CFG::GetCfg();
+                FRAME_TRACER*       newTracer = new FRAME_TRACER( cfg.m_FrameTraceZones );
+
+                newTracer->Enable( cfg.m_EnableFrameTracing );
+                return newTracer;
+            }();
+
+    return *tracer;
+}
+
+
+int64_t FRAME_TRACER::Now() const
+{
+    return steadyMicroSecs() - m_epoch;
+}
+
+
+void FRAME_TRACER::Record( const char* aName, const char* aCategory, int64_t aStart,
+                           int64_t aEnd )
+{
+    ZONE* zones = m_zones.load( std::memory_order_acquire );
+
+    if( !zones )
+        return;
+
+    uint64_t index = m_next.fetch_add( 1, std::memory_order_relaxed );
+    ZONE&    zone = zones[index % m_capacity];
+
+    // A seqlock per zone: readers skip the zones being written, or overwritten while read
+    zone.m_sequence.store( 2 * index + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    zone.m_name.store( aName, std::memory_order_relaxed );
+    zone.m_category.store( aCategory, std::memory_order_relaxed );
+    zone.m_start.store( aStart, std::memory_order_relaxed );
+    zone.m_duration.store( aEnd - aStart, std::memory_order_relaxed );
+    zone.m_thread.store( currentThread(), std::memory_order_relaxed );
+
+    zone.m_sequence.store( 2 * index + 2, std::memory_order_release );
+}
+
+
+void FRAME_TRACER::Clear()
+{
+    m_first.store( m_next.load( std::memory_order_acquire ), std::memory_order_release );
+}
+
+
+template <typename FUNC>
+void FRAME_TRACER::forEachZone( FUNC aFunc ) const
+{
+    const ZONE* zones = m_zones.load( std::memory_order_acquire );
+
+    if( !zones )
+        return;
+
+    uint64_t end = m_next.load( std::memory_order_acquire );
+    uint64_t begin = std::max( m_first.load( std::memory_order_acquire ),
+                               end > m_capacity ? end - m_capacity : 0 );
+
+    for( uint64_t index = begin; index < end; ++index )
+    {
+        const ZONE& zone = zones[index % m_capacity];
+        uint64_t    sequence = zone.m_sequence.load( std::memory_order_acquire );
+
+        if( sequence != 2 * index + 2 )
+            continue;
+
+        const char* name = zone.m_name.load( std::memory_order_relaxed );
+        const char* category = zone.m_category.load( std::memory_order_relaxed );
+        int64_t     start = zone.m_start.load( std::memory_order_relaxed );
+        int64_t     duration = zone.m_duration.load( std::memory_order_relaxed );
+        uint32_t    thread = zone.m_thread.load( std::memory_order_relaxed );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+
+        if( zone.m_sequence.load( std::memory_order_relaxed ) != sequence )
+            continue;
+
+        aFunc( name, category, start, duration, thread );
+    }
+}
+
+
+size_t FRAME_TRACER::GetCount() const
+{
+    size_t count = 0;
+
+    forEachZone(
+            [&]( const char*, const char*, int64_t, int64_t, uint32_t )
+            {
+                count++;
+            } );
+
+    return count;
+}
+
+
+std::string FRAME_TRACER::ToChromeTrace() const
+{
+    nlohmann::json events = nlohmann::json::array();
+
+    forEachZone(
+            [&]( const char* aName, const char* aCategory, int64_t aStart, int64_t aDuration,
+                 uint32_t aThread )
+            {
+                // Complete events: a begin time and a duration
+                events.push_back( { { "name", aName },
+                                    { "cat", aCategory },
+                                    { "ph", "X" },
+                                    { "ts", aStart },
+                                    { "dur", aDuration },
+                                    { "pid", 1 },
+                                    { "tid", aThread } } );
+            } );
+
+    nlohmann::json trace = { { "traceEvents", events }, { "displayTimeUnit", "ms" } };
+
+    return trace.dump();
+}
+
+
+bool FRAME_TRACER::SaveChromeTrace( const wxString& aFileName ) const
+{
+    wxFFile file( aFileName, wxS( "wb" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    std::string trace = ToChromeTrace();
+
+    return file.Write( trace.data(), trace.size() ) == trace.size() && file.Close();
+}
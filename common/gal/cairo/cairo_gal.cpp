@@ -1826,10 +1826,8 @@ void CAIRO_GAL_BASE::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTota
         for( const std::vector<VECTOR2D>& pointList : glyph )
             drawPoly( pointList );
     }
-    else if( aGlyph.IsOutline() )
+    else if( aGlyph.IsOutline() || aGlyph.IsSharedOutline() )
     {
-        const KIFONT::OUTLINE_GLYPH& glyph = static_cast<const KIFONT::OUTLINE_GLYPH&>( aGlyph );
-
         if( aNth == 0 )
         {
             cairo_close_path( m_currentContext );
@@ -1844,7 +1842,7 @@ void CAIRO_GAL_BASE::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTota
         // but as bitmaps with antialiasing, this is just a stopgap measure
         // of getting some form of outline font display
 
-        glyph.Triangulate(
+        auto drawTriangle =
                 [&]( const VECTOR2D& aVertex1, const VECTOR2D& aVertex2, const VECTOR2D& aVertex3 )
                 {
                     syncLineWidth();
@@ -1860,7 +1858,12 @@ void CAIRO_GAL_BASE::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTota
                     cairo_set_fill_rule( m_currentContext, CAIRO_FILL_RULE_EVEN_ODD );
                     flushPath();
                     cairo_fill( m_currentContext );
-                } );
+                };
+
+        if( aGlyph.IsSharedOutline() )
+            static_cast<const KIFONT::SHARED_OUTLINE_GLYPH&>( aGlyph ).Triangulate( drawTriangle );
+        else
+            static_cast<const KIFONT::OUTLINE_GLYPH&>( aGlyph ).Triangulate( drawTriangle );
 
         if( aNth == aTotal - 1 )
         {
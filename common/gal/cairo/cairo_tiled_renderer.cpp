@@ -0,0 +1,486 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <atomic>
+
+#include <wx/image.h>
+
+#include <core/profile.h>
+#include <core/thread_pool.h>
+#include <gal/cairo/cairo_tiled_renderer.h>
+#include <gal/painter.h>
+#include <gal/recording_gal.h>
+#include <trace_helpers.h>
+#include <view/view.h>
+#include <view/view_item.h>
+
+using namespace KIGFX;
+
+
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
+        CAIRO_GAL_BASE( aDisplayOptions )
+{
+}
+
+
+void CAIRO_IMAGE_GAL::SetImageRegion( unsigned char* aImage, int aStride, const VECTOR2I& aOrigin,
+                                      const VECTOR2I& aSize )
+{
+    if( m_context )
+        cairo_destroy( m_context );
+
+    if( m_surface )
+        cairo_surface_destroy( m_surface );
+
+    unsigned char* region = aImage + static_cast<size_t>( aOrigin.y ) * aStride
+                                   + static_cast<size_t>( aOrigin.x ) * 4;
+
+    m_surface = cairo_image_surface_create_for_data( region, CAIRO_FORMAT_ARGB32, aSize.x,
+                                                     aSize.y, aStride );
+
+    // Draw in whole image coordinates, the region clips the rest
+    cairo_surface_set_device_offset( m_surface, -aOrigin.x, -aOrigin.y );
+
+    m_context = m_currentContext = cairo_create( m_surface );
+}
+
+
+void CAIRO_IMAGE_GAL::EndDrawing()
+{
+    CAIRO_GAL_BASE::EndDrawing();
+
+    cairo_surface_flush( m_surface );
+}
+
+
+void CAIRO_IMAGE_GAL::StartDiffLayer()
+{
+    Flush();
+    cairo_push_group( m_currentContext );
+}
+
+
+void CAIRO_IMAGE_GAL::EndDiffLayer()
+{
+    popLayer( CAIRO_OPERATOR_ADD );
+}
+
+
+void CAIRO_IMAGE_GAL::StartNegativesLayer()
+{
+    Flush();
+    cairo_push_group( m_currentContext );
+}
+
+
+void CAIRO_IMAGE_GAL::EndNegativesLayer()
+{
+    popLayer( CAIRO_OPERATOR_OVER );
+}
+
+
+void CAIRO_IMAGE_GAL::popLayer( cairo_operator_t aOperator )
+{
+    Flush();
+
+    // Negative shapes cleared the group only, the lower layers show through them
+    cairo_pop_group_to_source( m_currentContext );
+    cairo_set_operator( m_currentContext, aOperator );
+    cairo_paint( m_currentContext );
+    cairo_set_operator( m_currentContext, CAIRO_OPERATOR_OVER );
+}
+
+
+CAIRO_TILED_RENDERER::CAIRO_TILED_RENDERER( VIEW& aView ) :
+        m_view( aView ),
+        m_tileSize( 256 ),
+        m_backgroundColor( COLOR4D::BLACK )
+{
+}
+
+
+wxImage CAIRO_TILED_RENDERER::Render( const BOX2D& aArea, const VECTOR2I& aSize )
+{
+    GAL*     viewGal = m_view.GetGAL();
+    PAINTER* painter = m_view.GetPainter();
+
+    wxCHECK( viewGal && painter, wxImage() );
+    wxCHECK( aSize.x > 0 && aSize.y > 0, wxImage() );
+    wxCHECK( aArea.GetWidth() > 0 && aArea.GetHeight() > 0, wxImage() );
+
+    PROF_TIMER   timer;
+    thread_pool& tp = GetKiCadThreadPool();
+    size_t       threads = std::max<size_t>( 1, tp.get_thread_count() );
+
+    // The screen DPI is folded in the world unit length, keeping the world scale of the view
+    // for a given zoom factor
+    double unitScale = viewGal->GetWorldScale() / viewGal->GetZoomFactor();
+    double worldScale = std::min( aSize.x / std::abs( aArea.GetWidth() ),
+                                  aSize.y / std::abs( aArea.GetHeight() ) );
+    double zoom = worldScale / unitScale;
+
+    int    tilesX = ( aSize.x + m_tileSize - 1 ) / m_tileSize;
+    int    tilesY = ( aSize.y + m_tileSize - 1 ) / m_tileSize;
+    size_t tileCount = static_cast<size_t>( tilesX ) * tilesY;
+    size_t workers = std::min( threads, tileCount );
+
+    // GALs subscribe to the display options, so they are all created on this thread
+    std::vector<std::unique_ptr<CAIRO_IMAGE_GAL>> gals;
+
+    for( size_t ii = 0; ii < workers; ++ii )
+    {
+        std::unique_ptr<CAIRO_IMAGE_GAL> gal = std::make_unique<CAIRO_IMAGE_GAL>( m_options );
+
+        gal->SetWorldUnitLength( unitScale );
+        gal->SetScreenDPI( 1.0 );
+        gal->SetZoomFactor( zoom );
+        gal->SetLookAtPoint( aArea.Centre() );
+        gal->SetFlip( viewGal->IsFlippedX(), viewGal->IsFlippedY() );
+        gal->SetClearColor( m_backgroundColor );
+        gal->ResizeScreen( aSize.x, aSize.y );
+        gal->ComputeWorldScreenMatrix();
+
+        gals.push_back( std::move( gal ) );
+    }
+
+    CAIRO_IMAGE_GAL& mainGal = *gals.front();
+    BOX2D            extents = mainGal.GetVisibleWorldExtents();
+
+    extents.Normalize();
+
+    BOX2I queryArea( KiROUND( extents.GetOrigin() ), KiROUND( extents.GetSize() ) );
+    std::vector<VIEW::LAYER_ITEM_PAIR> found;
+
+    queryArea.Inflate( 1 );
+    m_view.Query( queryArea, found );
+
+    struct DRAWING
+    {
+        VIEW_ITEM*               m_item;
+        int                      m_layer;
+        bool                     m_drawn;
+        RECORDING_GAL::RECORDING m_recording;
+    };
+
+    std::vector<DRAWING> drawings;
+
+    // The query returns the top layer first: draw the layers bottom first, keeping the item
+    // order of each layer
+    for( size_t end = found.size(); end > 0; )
+    {
+        size_t begin = end - 1;
+
+        while( begin > 0 && found[begin - 1].second == found[end - 1].second )
+            --begin;
+
+        for( size_t ii = begin; ii < end; ++ii )
+        {
+            auto [item, layer] = found[ii];
+
+            if( !m_view.areRequiredLayersEnabled( layer ) )
+                continue;
+
+            if( m_view.IsVisible( item ) && item->ViewGetLOD( layer, &m_view ) < zoom )
+                drawings.push_back( { item, layer, false, {} } );
+        }
+
+        end = begin;
+    }
+
+    auto drawItem =
+            []( PAINTER* aPainter, const DRAWING& aDrawing, double aZoom )
+            {
+                if( aPainter->GetLODScale( aDrawing.m_item, aDrawing.m_layer ) > aZoom
+                        && aPainter->DrawLOD( aDrawing.m_item, aDrawing.m_layer ) )
+                {
+                    return true;
+                }
+
+                return aPainter->Draw( aDrawing.m_item, aDrawing.m_layer );
+            };
+
+    // Record the items drawn by copies of the painter on the thread pool
+    std::vector<std::unique_ptr<RECORDING_GAL>> recorders;
+    std::vector<std::unique_ptr<PAINTER>>       painters;
+    std::vector<size_t>                         concurrent;
+
+    for( size_t ii = 0; ii < threads; ++ii )
+    {
+        recorders.push_back( std::make_unique<RECORDING_GAL>( mainGal ) );
+        painters.push_back( painter->Clone( recorders.back().get() ) );
+
+        if( !painters.back() )
+            break;
+    }
+
+    if( painters.back() )
+    {
+        for( size_t ii = 0; ii < drawings.size(); ++ii )
+        {
+            if( painter->CanDrawConcurrently( drawings[ii].m_item, drawings[ii].m_layer ) )
+                concurrent.push_back( ii );
+        }
+    }
+
+    // All layers of an item are drawn by the same worker, as painters may cache data in the
+    // items they draw
+    std::stable_sort( concurrent.begin(), concurrent.end(),
+                      [&]( size_t a, size_t b )
+                      {
+                          return drawings[a].m_item < drawings[b].m_item;
+                      } );
+
+    std::vector<size_t> itemStarts;
+
+    for( size_t ii = 0; ii < concurrent.size(); ++ii )
+    {
+        if( ii == 0 || drawings[concurrent[ii]].m_item != drawings[concurrent[ii - 1]].m_item )
+            itemStarts.push_back( ii );
+    }
+
+    itemStarts.push_back( concurrent.size() );
+
+    std::atomic<size_t> nextItem( 0 );
+
+    auto recordItems =
+            [&]( size_t aWorker )
+            {
+                for( size_t item = nextItem++; item + 1 < itemStarts.size(); item = nextItem++ )
+                {
+                    for( size_t ii = itemStarts[item]; ii < itemStarts[item + 1]; ++ii )
+                    {
+                        DRAWING& drawing = drawings[concurrent[ii]];
+
+                        drawing.m_drawn = drawItem( painters[aWorker].get(), drawing, zoom );
+                        drawing.m_recording = recorders[aWorker]->TakeRecording();
+                    }
+                }
+            };
+
+    std::vector<std::future<void>> returns;
+
+    if( !concurrent.empty() )
+    {
+        for( size_t ii = 0; ii < threads; ++ii )
+            returns.emplace_back( tp.submit( recordItems, ii ) );
+    }
+
+    // The view painter records the other items once the workers are done, as it may draw
+    // other layers of the items they are drawing
+    for( std::future<void>& ret : returns )
+        ret.wait();
+
+    std::vector<char> isConcurrent( drawings.size(), false );
+    RECORDING_GAL     recorder( mainGal );
+
+    for( size_t ii : concurrent )
+        isConcurrent[ii] = true;
+
+    painter->SetGAL( &recorder );
+
+    for( size_t ii = 0; ii < drawings.size(); ++ii )
+    {
+        if( !isConcurrent[ii] )
+        {
+            drawings[ii].m_drawn = drawItem( painter, drawings[ii], zoom );
+            drawings[ii].m_recording = recorder.TakeRecording();
+        }
+    }
+
+    // Items the painters cannot draw fall back to ViewDraw() with the view GAL, swapped for the
+    // recorder without the side effects of VIEW::SetGAL()
+    m_view.m_gal = &recorder;
+
+    for( DRAWING& drawing : drawings )
+    {
+        if( !drawing.m_drawn )
+        {
+            drawing.m_item->ViewDraw( drawing.m_layer, &m_view );
+            drawing.m_recording = recorder.TakeRecording();
+        }
+    }
+
+    m_view.m_gal = viewGal;
+    painter->SetGAL( viewGal );
+
+    double recordTime = timer.msecs( true );
+
+    // Sort the drawings into the tiles they overlap, in drawing order
+    const MATRIX3x3D&                worldScreen = mainGal.GetWorldScreenMatrix();
+    std::vector<std::vector<size_t>> tileDrawings( tileCount );
+
+    for( size_t ii = 0; ii < drawings.size(); ++ii )
+    {
+        if( drawings[ii].m_recording.empty() )
+            continue;
+
+        BOX2I bbox = drawings[ii].m_item->ViewBBox();
+        BOX2D screen;
+
+        screen.SetOrigin( worldScreen * VECTOR2D( bbox.GetOrigin() ) );
+        screen.SetEnd( worldScreen * VECTOR2D( bbox.GetEnd() ) );
+        screen.Normalize();
+
+        // Leave room for antialiasing
+        screen.Inflate( 2.0 );
+
+        auto tileIndex =
+                [&]( double aCoord, int aCount )
+                {
+                    return static_cast<int>( std::clamp( aCoord / m_tileSize, 0.0, aCount - 1.0 ) );
+                };
+
+        int x0 = tileIndex( screen.GetLeft(), tilesX );
+        int y0 = tileIndex( screen.GetTop(), tilesY );
+        int x1 = tileIndex( screen.GetRight(), tilesX );
+        int y1 = tileIndex( screen.GetBottom(), tilesY );
+
+        for( int y = y0; y <= y1; ++y )
+        {
+            for( int x = x0; x <= x1; ++x )
+                tileDrawings[static_cast<size_t>( y ) * tilesX + x].push_back( ii );
+        }
+    }
+
+    // Differential layers also work for the negatives, both are composited over the lower
+    // layers of each tile, as in VIEW::redrawRect()
+    auto startLayer =
+            [&]( CAIRO_IMAGE_GAL& aGal, int aLayer )
+            {
+                if( m_view.m_layers[aLayer].diffLayer )
+                    aGal.StartDiffLayer();
+                else if( m_view.m_layers[aLayer].hasNegatives )
+                    aGal.StartNegativesLayer();
+            };
+
+    auto endLayer =
+            [&]( CAIRO_IMAGE_GAL& aGal, int aLayer )
+            {
+                if( aLayer < 0 )
+                    return;
+
+                if( m_view.m_layers[aLayer].diffLayer )
+                    aGal.EndDiffLayer();
+                else if( m_view.m_layers[aLayer].hasNegatives )
+                    aGal.EndNegativesLayer();
+            };
+
+    // Tiles are disjoint regions of the same image: there is nothing to composite afterwards
+    int                        stride = cairo_format_stride_for_width( CAIRO_FORMAT_ARGB32,
+                                                                       aSize.x );
+    std::vector<unsigned char> pixels( static_cast<size_t>( stride ) * aSize.y );
+    std::atomic<size_t>        nextTile( 0 );
+
+    auto drawTiles =
+            [&]( size_t aWorker )
+            {
+                CAIRO_IMAGE_GAL* gal = gals[aWorker].get();
+                bool             isFill = gal->GetIsFill();
+                bool             isStroke = gal->GetIsStroke();
+                COLOR4D          fillColor = gal->GetFillColor();
+                COLOR4D          strokeColor = gal->GetStrokeColor();
+                float            lineWidth = gal->GetLineWidth();
+
+                for( size_t tile = nextTile++; tile < tileCount; tile = nextTile++ )
+                {
+                    VECTOR2I origin( static_cast<int>( tile % tilesX ) * m_tileSize,
+                                     static_cast<int>( tile / tilesX ) * m_tileSize );
+                    VECTOR2I size( std::min( m_tileSize, aSize.x - origin.x ),
+                                   std::min( m_tileSize, aSize.y - origin.y ) );
+
+                    gal->SetImageRegion( pixels.data(), stride, origin, size );
+                    gal->BeginDrawing();
+
+                    int layer = -1;
+
+                    for( size_t ii : tileDrawings[tile] )
+                    {
+                        if( drawings[ii].m_layer != layer )
+                        {
+                            endLayer( *gal, layer );
+                            layer = drawings[ii].m_layer;
+                            startLayer( *gal, layer );
+                        }
+
+                        // Recordings start from the state the recorders were created with
+                        gal->SetIsFill( isFill );
+                        gal->SetIsStroke( isStroke );
+                        gal->SetFillColor( fillColor );
+                        gal->SetStrokeColor( strokeColor );
+                        gal->SetLineWidth( lineWidth );
+
+                        RECORDING_GAL::Replay( drawings[ii].m_recording, *gal );
+                    }
+
+                    endLayer( *gal, layer );
+                    gal->EndDrawing();
+                }
+            };
+
+    returns.clear();
+
+    for( size_t ii = 0; ii < workers; ++ii )
+        returns.emplace_back( tp.submit( drawTiles, ii ) );
+
+    for( std::future<void>& ret : returns )
+        ret.wait();
+
+    double drawTime = timer.msecs( true );
+
+    // Cairo stores premultiplied native endian ARGB words
+    wxImage image( aSize.x, aSize.y, false );
+
+    image.InitAlpha();
+
+    unsigned char* rgb = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>( &pixels[y * stride] );
+
+        for( int x = 0; x < aSize.x; ++x )
+        {
+            uint32_t pixel = row[x];
+            uint32_t a = pixel >> 24;
+
+            for( int shift = 16; shift >= 0; shift -= 8 )
+            {
+                uint32_t c = ( pixel >> shift ) & 0xff;
+
+                *rgb++ = a ? std::min<uint32_t>( 255, ( c * 255 + a / 2 ) / a ) : 0;
+            }
+
+            *alpha++ = a;
+        }
+    }
+
+    KI_TRACE( traceGalProfile,
+              wxS( "CAIRO_TILED_RENDERER::Render(): %zu drawings (%zu concurrent), %zu tiles, "
+                   "%zu workers: record %.1f ms, draw %.1f ms, convert %.1f ms\n" ),
+              drawings.size(), concurrent.size(), tileCount, workers, recordTime, drawTime,
+              timer.msecs( true ) );
+
+    return image;
+}
@@ -150,6 +150,20 @@ bool GAL::updatedGalDisplayOptions( const GAL_DISPLAY_OPTIONS& aOptions )
 }
 
 
+void GAL::DrawTriangles( const std::vector<VECTOR2F>& aVertices )
+{
+    VECTOR2D triangle[3];
+
+    for( size_t i = 0; i + 2 < aVertices.size(); i += 3 )
+    {
+        for( int j = 0; j < 3; ++j )
+            triangle[j] = VECTOR2D( aVertices[i + j].x, aVertices[i + j].y );
+
+        DrawPolygon( triangle, 3 );
+    }
+}
+
+
 void GAL::ResetTextAttributes()
 {
      // Tiny but non-zero - this will always need setting
@@ -39,6 +39,7 @@
 #include <list>
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #ifdef __WIN32__
 #include <excpt.h>
@@ -56,10 +57,13 @@ CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
         m_item( nullptr ),
         m_chunkSize( 0 ),
         m_chunkOffset( 0 ),
-        m_maxIndex( 0 )
+        m_maxIndex( 0 ),
+        m_defragmentations( 0 ),
+        m_compactedVertices( 0 )
 {
     // In the beginning there is only free space
-    m_freeChunks.insert( std::make_pair( aSize, 0 ) );
+    m_freeSpace = 0;
+    addFreeChunk( 0, aSize );
 }
 
 
@@ -81,22 +85,20 @@ void CACHED_CONTAINER::FinishItem()
     assert( m_item != nullptr );
 
     unsigned int itemSize = m_item->GetSize();
+    unsigned int itemOffset = m_item->GetOffset();
 
     // Finishing the previously edited item
     if( itemSize < m_chunkSize )
     {
         // There is some not used but reserved memory left, so we should return it to the pool
-        int itemOffset = m_item->GetOffset();
-
-        // Add the not used memory back to the pool
         addFreeChunk( itemOffset + itemSize, m_chunkSize - itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
-
-        m_maxIndex = std::max( itemOffset + itemSize, m_maxIndex );
     }
 
     if( itemSize > 0 )
-        m_items.insert( m_item );
+    {
+        m_items[itemOffset] = m_item;
+        m_maxIndex = std::max( itemOffset + itemSize, m_maxIndex );
+    }
 
     m_item = nullptr;
     m_chunkSize = 0;
@@ -152,7 +154,6 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
 void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 {
     assert( aItem != nullptr );
-    assert( m_items.find( aItem ) != m_items.end() || aItem->GetSize() == 0 );
 
     int size = aItem->GetSize();
 
@@ -161,13 +162,15 @@ void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 
     int offset = aItem->GetOffset();
 
+    assert( m_items.count( offset ) && m_items.at( offset ) == aItem );
+
     // Insert a free memory chunk entry in the place where item was stored
     addFreeChunk( offset, size );
 
     // Indicate that the item is not stored in the container anymore
     aItem->setSize( 0 );
 
-    m_items.erase( aItem );
+    m_items.erase( offset );
 
 #if CACHED_CONTAINER_TEST > 0
     test();
@@ -192,20 +195,121 @@ void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 
 void CACHED_CONTAINER::Clear()
 {
-    m_freeSpace = m_currentSize;
     m_maxIndex = 0;
     m_failed = false;
 
     // Set the size of all the stored VERTEX_ITEMs to 0, so it is clear that they are not held
     // in the container anymore
-    for( ITEMS::iterator it = m_items.begin(); it != m_items.end(); ++it )
-        ( *it )->setSize( 0 );
+    for( const auto& [offset, item] : m_items )
+        item->setSize( 0 );
 
     m_items.clear();
 
     // Now there is only free space left
     m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, 0 ) );
+
+    for( std::set<unsigned int>& sizeClass : m_freeClasses )
+        sizeClass.clear();
+
+    m_freeSpace = 0;
+    addFreeChunk( 0, m_currentSize );
+}
+
+
+unsigned int CACHED_CONTAINER::Compact( unsigned int aMaxVertices )
+{
+    if( !IsMapped() || m_item || m_failed )
+        return 0;
+
+    unsigned int moved = 0;
+
+    // A few holes are not worth moving data around: they are filled by new items soon enough
+    while( !m_items.empty() && moved < aMaxVertices && m_maxIndex - usedSpace() > usedSpace() / 8 )
+    {
+        // Preferably move the last item to a hole before it, which lowers the high water mark
+        // at once
+        ITEMS::iterator          item = std::prev( m_items.end() );
+        FREE_CHUNK_MAP::iterator target = findFreeChunk( item->second->GetSize(), item->first );
+
+        // Otherwise slide the item following the first hole into it, which moves the hole
+        // towards the end of the container, where it merges with the free space
+        if( target == m_freeChunks.end() )
+        {
+            target = m_freeChunks.begin();
+            item = m_items.find( target->first + target->second );
+
+            if( item == m_items.end() )
+                break;
+        }
+
+        unsigned int offset = item->first;
+        unsigned int size = item->second->GetSize();
+        unsigned int targetOffset = target->first;
+        unsigned int targetSize = target->second;
+
+        if( moved > 0 && moved + size > aMaxVertices )
+            break;
+
+        removeFreeChunk( target );
+        m_freeSpace -= targetSize;
+
+        // The item may overlap its target when slid
+        memmove( &m_vertices[targetOffset], &m_vertices[offset], size * VERTEX_SIZE );
+
+        VERTEX_ITEM* movedItem = item->second;
+
+        m_items.erase( item );
+        m_items[targetOffset] = movedItem;
+        movedItem->setOffset( targetOffset );
+
+        if( targetSize > size )
+            addFreeChunk( targetOffset + size, targetSize - size );
+
+        addFreeChunk( std::max( offset, targetOffset + size ),
+                      offset + size - std::max( offset, targetOffset + size ) );
+
+        moved += size;
+    }
+
+    if( moved > 0 )
+    {
+        m_compactedVertices += moved;
+        m_dirty = true;
+    }
+
+#if CACHED_CONTAINER_TEST > 0
+    test();
+#endif
+
+    return moved;
+}
+
+
+VERTEX_CACHE_STATS CACHED_CONTAINER::GetStats() const
+{
+    VERTEX_CACHE_STATS stats;
+
+    stats.m_size = m_currentSize;
+    stats.m_used = usedSpace();
+    stats.m_highWater = m_maxIndex;
+    stats.m_freeChunks = m_freeChunks.size();
+    stats.m_defragmentations = m_defragmentations;
+    stats.m_compactedVertices = m_compactedVertices;
+
+    // The largest chunk is in the highest non-empty size class
+    for( int ii = SIZE_CLASSES - 1; ii >= 0; --ii )
+    {
+        for( unsigned int offset : m_freeClasses[ii] )
+        {
+            stats.m_largestFreeChunk = std::max( stats.m_largestFreeChunk,
+                                                 m_freeChunks.at( offset ) );
+        }
+
+        if( !m_freeClasses[ii].empty() )
+            break;
+    }
+
+    return stats;
 }
 
 
@@ -216,8 +320,23 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
 
     unsigned int itemSize = m_item->GetSize();
 
+    // Grow in place if the current chunk is followed by enough free space
+    if( itemSize > 0 )
+    {
+        FREE_CHUNK_MAP::iterator next = m_freeChunks.find( m_chunkOffset + m_chunkSize );
+
+        if( next != m_freeChunks.end() && m_chunkSize + next->second >= aSize )
+        {
+            m_chunkSize += next->second;
+            m_freeSpace -= next->second;
+            removeFreeChunk( next );
+
+            return true;
+        }
+    }
+
     // Find a free space chunk >= aSize
-    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
+    FREE_CHUNK_MAP::iterator newChunk = findFreeChunk( aSize, m_currentSize );
 
     // Is there enough space to store vertices?
     if( newChunk == m_freeChunks.end() )
@@ -239,31 +358,38 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
         if( !result )
             return false;
 
-        newChunk = m_freeChunks.lower_bound( aSize );
+        newChunk = findFreeChunk( aSize, m_currentSize );
         assert( newChunk != m_freeChunks.end() );
     }
 
     // Parameters of the allocated chunk
-    unsigned int newChunkSize = getChunkSize( *newChunk );
-    unsigned int newChunkOffset = getChunkOffset( *newChunk );
+    unsigned int newChunkOffset = newChunk->first;
+    unsigned int newChunkSize = newChunk->second;
 
     assert( newChunkSize >= aSize );
     assert( newChunkOffset < m_currentSize );
 
+    // Remove the new allocated chunk from the free space pool, before the previous chunk is
+    // freed and possibly merged with it
+    removeFreeChunk( newChunk );
+    m_freeSpace -= newChunkSize;
+
     // Check if the item was previously stored in the container
     if( itemSize > 0 )
     {
         // The item was reallocated, so we have to copy all the old data to the new place
         memcpy( &m_vertices[newChunkOffset], &m_vertices[m_chunkOffset], itemSize * VERTEX_SIZE );
 
+        // The item is stored again by FinishItem(), at its new offset
+        ITEMS::iterator stored = m_items.find( m_chunkOffset );
+
+        if( stored != m_items.end() && stored->second == m_item )
+            m_items.erase( stored );
+
         // Free the space used by the previous chunk
         addFreeChunk( m_chunkOffset, m_chunkSize );
     }
 
-    // Remove the new allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
-    m_freeSpace -= newChunkSize;
-
     m_chunkSize = newChunkSize;
     m_chunkOffset = newChunkOffset;
 
@@ -276,8 +402,8 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
 void CACHED_CONTAINER::defragment( VERTEX* aTarget )
 {
     // Defragmentation
-    ITEMS::iterator it, it_end;
-    int             newOffset = 0;
+    ITEMS newItems;
+    int   newOffset = 0;
 
     [&]()
     {
@@ -290,9 +416,12 @@ void CACHED_CONTAINER::defragment( VERTEX* aTarget )
     #endif
 #endif
         {
-            for( VERTEX_ITEM* item : m_items )
+            for( const auto& [itemOffset, item] : m_items )
             {
-                int itemOffset = item->GetOffset();
+                // The current item is placed last
+                if( item == m_item )
+                    continue;
+
                 int itemSize = item->GetSize();
 
                 // Move an item to the new container
@@ -300,6 +429,7 @@ void CACHED_CONTAINER::defragment( VERTEX* aTarget )
 
                 // Update new offset
                 item->setOffset( newOffset );
+                newItems.emplace_hint( newItems.end(), newOffset, item );
 
                 // Move to the next free space
                 newOffset += itemSize;
@@ -330,71 +460,119 @@ void CACHED_CONTAINER::defragment( VERTEX* aTarget )
 #endif
     }();
 
+    m_items.swap( newItems );
     m_maxIndex = usedSpace();
 }
 
 
-void CACHED_CONTAINER::mergeFreeChunks()
+void CACHED_CONTAINER::resetFreeChunks()
 {
-    if( m_freeChunks.size() <= 1 ) // There are no chunks that can be merged
-        return;
+    m_freeChunks.clear();
 
-#ifdef KICAD_GAL_PROFILE
-    PROF_TIMER totalTime;
-#endif /* KICAD_GAL_PROFILE */
+    for( std::set<unsigned int>& sizeClass : m_freeClasses )
+        sizeClass.clear();
+
+    // Now there is only one big chunk of free memory
+    unsigned int freeSpace = m_freeSpace;
 
-    // Reversed free chunks map - this one stores chunk size with its offset as the key
-    std::list<CHUNK> freeChunks;
+    m_freeSpace = 0;
+    m_maxIndex = m_currentSize - freeSpace;
 
-    FREE_CHUNK_MAP::const_iterator it, it_end;
+    if( freeSpace > 0 )
+        addFreeChunk( m_currentSize - freeSpace, freeSpace );
+
+    m_defragmentations++;
+}
 
-    for( it = m_freeChunks.begin(), it_end = m_freeChunks.end(); it != it_end; ++it )
+
+void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    assert( aOffset + aSize <= m_currentSize );
+    assert( aSize > 0 );
+
+    m_freeSpace += aSize;
+
+    // Merge with the free chunk just after this one
+    FREE_CHUNK_MAP::iterator next = m_freeChunks.find( aOffset + aSize );
+
+    if( next != m_freeChunks.end() )
     {
-        freeChunks.emplace_back( it->second, it->first );
+        aSize += next->second;
+        removeFreeChunk( next );
     }
 
-    m_freeChunks.clear();
-    freeChunks.sort();
-
-    std::list<CHUNK>::const_iterator itf, itf_end;
-    unsigned int                     offset = freeChunks.front().first;
-    unsigned int                     size = freeChunks.front().second;
-    freeChunks.pop_front();
+    // And with the one just before
+    FREE_CHUNK_MAP::iterator prev = m_freeChunks.lower_bound( aOffset );
 
-    for( itf = freeChunks.begin(), itf_end = freeChunks.end(); itf != itf_end; ++itf )
+    if( prev != m_freeChunks.begin() )
     {
-        if( itf->first == offset + size )
-        {
-            // These chunks can be merged, so just increase the current chunk size and go on
-            size += itf->second;
-        }
-        else
+        --prev;
+
+        if( prev->first + prev->second == aOffset )
         {
-            // These chunks cannot be merged
-            // So store the previous one
-            m_freeChunks.insert( std::make_pair( size, offset ) );
-            // and let's check the next chunk
-            offset = itf->first;
-            size = itf->second;
+            aOffset = prev->first;
+            aSize += prev->second;
+            removeFreeChunk( prev );
         }
     }
 
-    // Add the last one
-    m_freeChunks.insert( std::make_pair( size, offset ) );
+    m_freeChunks.emplace( aOffset, aSize );
+    m_freeClasses[sizeClass( aSize )].insert( aOffset );
 
-#if CACHED_CONTAINER_TEST > 0
-    test();
-#endif
+    // Nothing is stored past a free chunk reaching the end of the container
+    if( aOffset + aSize == m_currentSize )
+        m_maxIndex = std::min( m_maxIndex, aOffset );
 }
 
 
-void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
+CACHED_CONTAINER::FREE_CHUNK_MAP::iterator
+CACHED_CONTAINER::findFreeChunk( unsigned int aSize, unsigned int aMaxOffset )
+{
+    int minClass = sizeClass( aSize );
+
+    // Any chunk of a class above the one of aSize is large enough.  Take one of the smallest
+    // ones, so large chunks are kept for large items, and the lowest of them, to keep the data
+    // packed at the beginning of the container.
+    for( int ii = minClass + 1; ii < SIZE_CLASSES; ++ii )
+    {
+        if( !m_freeClasses[ii].empty() && *m_freeClasses[ii].begin() < aMaxOffset )
+            return m_freeChunks.find( *m_freeClasses[ii].begin() );
+    }
+
+    // Chunks of the same class as aSize may be too small, so they are only searched as a last
+    // resort
+    for( unsigned int offset : m_freeClasses[minClass] )
+    {
+        if( offset >= aMaxOffset )
+            break;
+
+        FREE_CHUNK_MAP::iterator chunk = m_freeChunks.find( offset );
+
+        if( chunk->second >= aSize )
+            return chunk;
+    }
+
+    return m_freeChunks.end();
+}
+
+
+void CACHED_CONTAINER::removeFreeChunk( FREE_CHUNK_MAP::iterator aChunk )
+{
+    m_freeClasses[sizeClass( aChunk->second )].erase( aChunk->first );
+    m_freeChunks.erase( aChunk );
+}
+
+
+int CACHED_CONTAINER::sizeClass( unsigned int aSize )
 {
-    assert( aOffset + aSize <= m_currentSize );
     assert( aSize > 0 );
 
-    m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
-    m_freeSpace += aSize;
+    int sizeClass = 0;
+
+    while( aSize >>= 1 )
+        sizeClass++;
+
+    return sizeClass;
 }
 
 
@@ -412,20 +590,25 @@ void CACHED_CONTAINER::test()
 {
 #ifdef KICAD_GAL_PROFILE
     // Free space check
-    unsigned int             freeSpace = 0;
-    FREE_CHUNK_MAP::iterator itf;
+    unsigned int freeSpace = 0;
 
-    for( itf = m_freeChunks.begin(); itf != m_freeChunks.end(); ++itf )
-        freeSpace += getChunkSize( *itf );
+    for( const auto& [offset, size] : m_freeChunks )
+    {
+        freeSpace += size;
+
+        assert( m_freeClasses[sizeClass( size )].count( offset ) );
+    }
 
     assert( freeSpace == m_freeSpace );
 
     // Used space check
-    unsigned int    used_space = 0;
-    ITEMS::iterator itr;
+    unsigned int used_space = 0;
 
-    for( itr = m_items.begin(); itr != m_items.end(); ++itr )
-        used_space += ( *itr )->GetSize();
+    for( const auto& [offset, item] : m_items )
+    {
+        assert( item->GetOffset() == offset );
+        used_space += item->GetSize();
+    }
 
     // If we have a chunk assigned, then there must be an item edited
     assert( m_chunkSize == 0 || m_item );
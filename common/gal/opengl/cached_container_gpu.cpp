@@ -35,6 +35,7 @@
 #include <list>
 
 #include <core/profile.h>
+#include <frame_tracer.h>
 #include <trace_helpers.h>
 
 using namespace KIGFX;
@@ -107,6 +108,8 @@ void CACHED_CONTAINER_GPU::Unmap()
 {
     wxCHECK( IsMapped(), /*void*/ );
 
+    KI_TRACE_ZONE( "CACHED_CONTAINER_GPU::Unmap", "gal upload" );
+
     // This gets called from ~CACHED_CONTAINER_GPU.  To avoid throwing an exception from
     // the dtor, catch it here instead.
     try
@@ -164,15 +167,17 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, nullptr, GL_DYNAMIC_DRAW );
     checkGlError( "creating buffer during defragmentation", __FILE__, __LINE__ );
 
-    ITEMS::iterator it, it_end;
-    int             newOffset = 0;
+    ITEMS newItems;
+    int   newOffset = 0;
 
     // Defragmentation
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
+    for( const auto& [itemOffset, item] : m_items )
     {
-        VERTEX_ITEM* item = *it;
-        int          itemOffset = item->GetOffset();
-        int          itemSize = item->GetSize();
+        // The current item is placed last
+        if( item == m_item )
+            continue;
+
+        int itemSize = item->GetSize();
 
         // Move an item to the new container
         glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, itemOffset * VERTEX_SIZE,
@@ -180,11 +185,14 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
 
         // Update new offset
         item->setOffset( newOffset );
+        newItems.emplace_hint( newItems.end(), newOffset, item );
 
         // Move to the next free space
         newOffset += itemSize;
     }
 
+    m_items.swap( newItems );
+
     // Move the current item and place it at the end
     if( m_item->GetSize() > 0 )
     {
@@ -222,9 +230,7 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
 
     KI_TRACE( traceGalProfile, "VBO size %d used %d\n", m_currentSize, AllItemsSize() );
 
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    resetFreeChunks();
 
     return true;
 }
@@ -289,9 +295,7 @@ bool CACHED_CONTAINER_GPU::defragmentResizeMemcpy( unsigned int aNewSize )
 
     KI_TRACE( traceGalProfile, "VBO size %d used: %d \n", m_currentSize, AllItemsSize() );
 
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    resetFreeChunks();
 
     return true;
 }
@@ -301,7 +305,7 @@ unsigned int CACHED_CONTAINER_GPU::AllItemsSize() const
 {
     unsigned int size = 0;
 
-    for( const auto& item : m_items )
+    for( const auto& [offset, item] : m_items )
     {
         size += item->GetSize();
     }
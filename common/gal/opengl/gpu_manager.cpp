@@ -34,12 +34,14 @@
 
 #include <core/profile.h>
 
+#include <algorithm>
 #include <typeinfo>
 #include <confirm.h>
 #include <trace_helpers.h>
 
 #ifdef KICAD_GAL_PROFILE
 #include <core/profile.h>
+#include <frame_tracer.h>
 #include <wx/log.h>
 #endif /* KICAD_GAL_PROFILE */
 
@@ -90,13 +92,30 @@ GPU_CACHED_MANAGER::GPU_CACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
         m_totalNormal( 0 ),
         m_indexBufSize( 0 ),
         m_indexBufMaxSize( 0 ),
-        m_curVrangeSize( 0 )
+        m_curVrangeSize( 0 ),
+        m_instanceAttrib( -1 ),
+        m_instancedArrays( false ),
+        m_instanceBuffer( 0 ),
+        m_totalInstances( 0 )
 {
 }
 
 
 GPU_CACHED_MANAGER::~GPU_CACHED_MANAGER()
 {
+    if( m_instanceBuffer && glDeleteBuffers )
+        glDeleteBuffers( 1, &m_instanceBuffer );
+}
+
+
+void GPU_CACHED_MANAGER::SetShader( SHADER& aShader )
+{
+    GPU_MANAGER::SetShader( aShader );
+
+    m_instanceAttrib = aShader.GetAttribute( "a_instanceOffset" );
+
+    // Without instanced arrays, each instance is drawn with its own call
+    m_instancedArrays = GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced;
 }
 
 
@@ -108,6 +127,9 @@ void GPU_CACHED_MANAGER::BeginDrawing()
     m_indexBufMaxSize = 0;
     m_indexBufSize = 0;
     m_vranges.clear();
+    m_pendingInstances.clear();
+    m_instanceOffsets.clear();
+    m_totalInstances = 0;
 
     m_isDrawing = true;
 }
@@ -136,15 +158,83 @@ void GPU_CACHED_MANAGER::DrawIndices( const VERTEX_ITEM *aItem )
 }
 
 
+bool GPU_CACHED_MANAGER::SupportsInstancing() const
+{
+    return m_shader != nullptr && m_instanceAttrib != -1;
+}
+
+
+void GPU_CACHED_MANAGER::DrawIndicesInstanced( const VERTEX_ITEM* aItem, const VECTOR2D& aOffset )
+{
+    wxASSERT( m_isDrawing );
+
+    if( aItem->GetSize() > 0 )
+        m_pendingInstances.emplace_back( aItem, aOffset );
+}
+
+
+void GPU_CACHED_MANAGER::FlushInstances()
+{
+    if( m_pendingInstances.empty() )
+        return;
+
+    // Gather the instances of each item, in a repeatable order
+    std::stable_sort( m_pendingInstances.begin(), m_pendingInstances.end(),
+                      []( const std::pair<const VERTEX_ITEM*, VECTOR2D>& aA,
+                          const std::pair<const VERTEX_ITEM*, VECTOR2D>& aB )
+                      {
+                          return aA.first->GetOffset() < aB.first->GetOffset();
+                      } );
+
+    for( size_t ii = 0; ii < m_pendingInstances.size(); )
+    {
+        const VERTEX_ITEM* item = m_pendingInstances[ii].first;
+        unsigned int       offset = item->GetOffset();
+        VRANGE             range( offset, offset + item->GetSize() - 1, true );
+
+        range.m_firstInstance = m_instanceOffsets.size() / 2;
+
+        for( ; ii < m_pendingInstances.size() && m_pendingInstances[ii].first == item; ++ii )
+        {
+            m_instanceOffsets.push_back( m_pendingInstances[ii].second.x );
+            m_instanceOffsets.push_back( m_pendingInstances[ii].second.y );
+            range.m_instanceCount++;
+        }
+
+        m_totalInstances += range.m_instanceCount;
+        m_vranges.push_back( range );
+    }
+
+    // Instanced ranges split the index buffer like the huge ones
+    m_indexBufSize = std::max( m_curVrangeSize, m_indexBufSize );
+    m_curVrangeSize = 0;
+    m_pendingInstances.clear();
+}
+
+
 void GPU_CACHED_MANAGER::EndDrawing()
 {
     wxASSERT( m_isDrawing );
 
+    KI_TRACE_ZONE( "GPU_CACHED_MANAGER::EndDrawing", "gal" );
+
+    FlushInstances();
+
     CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container );
 
     if( cached->IsMapped() )
         cached->Unmap();
 
+    if( m_instancedArrays && !m_instanceOffsets.empty() )
+    {
+        if( !m_instanceBuffer )
+            glGenBuffers( 1, &m_instanceBuffer );
+
+        glBindBuffer( GL_ARRAY_BUFFER, m_instanceBuffer );
+        glBufferData( GL_ARRAY_BUFFER, m_instanceOffsets.size() * sizeof( GLfloat ),
+                      m_instanceOffsets.data(), GL_STREAM_DRAW );
+    }
+
     m_indexBufSize = std::max( m_curVrangeSize, m_indexBufSize );
     m_indexBufMaxSize = std::max( 2*m_indexBufSize, m_indexBufMaxSize );
 
@@ -196,8 +286,16 @@ void GPU_CACHED_MANAGER::EndDrawing()
             icnt = 0;
             iptr = m_indices.get();
 
-            glDrawArrays( GL_TRIANGLES, cur->m_start, cur->m_end - cur->m_start + 1 );
-            drawCalls++;
+            if( cur->m_instanceCount > 0 )
+            {
+                drawInstances( *cur );
+                drawCalls += m_instancedArrays ? 1 : cur->m_instanceCount;
+            }
+            else
+            {
+                glDrawArrays( GL_TRIANGLES, cur->m_start, cur->m_end - cur->m_start + 1 );
+                drawCalls++;
+            }
         }
         else
         {
@@ -219,8 +317,10 @@ void GPU_CACHED_MANAGER::EndDrawing()
     cntDraw.Stop();
 
     KI_TRACE( traceGalProfile,
-              "Cached manager size: VBO size %u iranges %zu max elt size %u drawcalls %u\n",
-              cached->AllItemsSize(), m_vranges.size(), m_indexBufMaxSize, drawCalls );
+              "Cached manager size: VBO size %u iranges %zu max elt size %u drawcalls %u "
+              "instances %d\n",
+              cached->AllItemsSize(), m_vranges.size(), m_indexBufMaxSize, drawCalls,
+              m_totalInstances );
     KI_TRACE( traceGalProfile, "Timing: %s\n", cntDraw.to_string() );
 
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
@@ -240,6 +340,43 @@ void GPU_CACHED_MANAGER::EndDrawing()
 }
 
 
+void GPU_CACHED_MANAGER::drawInstances( const VRANGE& aRange )
+{
+    GLsizei count = aRange.m_end - aRange.m_start + 1;
+
+    if( m_instancedArrays )
+    {
+        GLint vertexBuffer = 0;
+        glGetIntegerv( GL_ARRAY_BUFFER_BINDING, &vertexBuffer );
+
+        glBindBuffer( GL_ARRAY_BUFFER, m_instanceBuffer );
+        glEnableVertexAttribArray( m_instanceAttrib );
+        glVertexAttribPointer( m_instanceAttrib, 2, GL_FLOAT, GL_FALSE, 0,
+                               (GLvoid*) ( aRange.m_firstInstance * 2 * sizeof( GLfloat ) ) );
+        glVertexAttribDivisorARB( m_instanceAttrib, 1 );
+
+        glDrawArraysInstancedARB( GL_TRIANGLES, aRange.m_start, count, aRange.m_instanceCount );
+
+        glVertexAttribDivisorARB( m_instanceAttrib, 0 );
+        glDisableVertexAttribArray( m_instanceAttrib );
+        glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer );
+    }
+    else
+    {
+        const GLfloat* offset = &m_instanceOffsets[aRange.m_firstInstance * 2];
+
+        for( unsigned int ii = 0; ii < aRange.m_instanceCount; ++ii, offset += 2 )
+        {
+            glVertexAttrib2f( m_instanceAttrib, offset[0], offset[1] );
+            glDrawArrays( GL_TRIANGLES, aRange.m_start, count );
+        }
+    }
+
+    // Everything else is drawn without an offset
+    glVertexAttrib2f( m_instanceAttrib, 0.0f, 0.0f );
+}
+
+
 void GPU_CACHED_MANAGER::resizeIndices( unsigned int aNewSize )
 {
     if( aNewSize > m_indicesCapacity )
@@ -271,6 +408,8 @@ void GPU_NONCACHED_MANAGER::DrawIndices( const VERTEX_ITEM* aItem )
 
 void GPU_NONCACHED_MANAGER::EndDrawing()
 {
+    KI_TRACE_ZONE( "GPU_NONCACHED_MANAGER::EndDrawing", "gal upload" );
+
 #ifdef KICAD_GAL_PROFILE
     PROF_TIMER totalRealTime;
 #endif /* KICAD_GAL_PROFILE */
@@ -51,6 +51,7 @@
 #include <core/thread_pool.h>
 
 #include <core/profile.h>
+#include <frame_tracer.h>
 #include <trace_helpers.h>
 
 #include <gal/opengl/gl_utils.h>
@@ -548,6 +549,8 @@ VECTOR2D OPENGL_GAL::getScreenPixelSize() const
 
 void OPENGL_GAL::BeginDrawing()
 {
+    KI_TRACE_ZONE( "OPENGL_GAL::BeginDrawing", "gal" );
+
 #ifdef KICAD_GAL_PROFILE
     PROF_TIMER totalRealTime( "OPENGL_GAL::beginDrawing()", true );
 #endif /* KICAD_GAL_PROFILE */
@@ -719,6 +722,8 @@ void OPENGL_GAL::EndDrawing()
 {
     wxASSERT_MSG( m_isContextLocked, "What happened to the context lock?" );
 
+    KI_TRACE_ZONE( "OPENGL_GAL::EndDrawing", "gal" );
+
     PROF_TIMER cntTotal("gl-end-total");
     PROF_TIMER cntEndCached("gl-end-cached");
     PROF_TIMER cntEndNoncached("gl-end-noncached");
@@ -818,10 +823,35 @@ void OPENGL_GAL::endUpdate()
     if( !m_isInitialized )
         return;
 
+    KI_TRACE_ZONE( "OPENGL_GAL::endUpdate", "gal upload" );
+
+    // Keep the cached vertices packed a little at a time, rather than copying all of them when
+    // the container runs out of room
+    const unsigned int COMPACTION_STEP = 65536;
+
+    if( unsigned int moved = m_cachedManager->Compact( COMPACTION_STEP ) )
+    {
+        VERTEX_CACHE_STATS stats = GetVertexCacheStats();
+
+        KI_TRACE( traceGalProfile,
+                  "VBO compaction moved %u vertices: size %u used %u high water %u "
+                  "fragmentation %.2f\n",
+                  moved, stats.m_size, stats.m_used, stats.m_highWater, stats.Fragmentation() );
+    }
+
     m_cachedManager->Unmap();
 }
 
 
+VERTEX_CACHE_STATS OPENGL_GAL::GetVertexCacheStats() const
+{
+    VERTEX_CACHE_STATS stats;
+
+    m_cachedManager->GetCacheStats( stats );
+    return stats;
+}
+
+
 void OPENGL_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     m_currentManager->Color( m_strokeColor.r, m_strokeColor.g, m_strokeColor.b, m_strokeColor.a );
@@ -1364,6 +1394,17 @@ void OPENGL_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
 }
 
 
+void OPENGL_GAL::DrawTriangles( const std::vector<VECTOR2F>& aVertices )
+{
+    if( !m_isFillEnabled || aVertices.empty() )
+        return;
+
+    m_currentManager->Shader( SHADER_NONE );
+    m_currentManager->Color( m_fillColor.r, m_fillColor.g, m_fillColor.b, m_fillColor.a );
+    m_currentManager->Vertices( aVertices, m_layerDepth );
+}
+
+
 void OPENGL_GAL::drawTriangulatedPolyset( const SHAPE_POLY_SET& aPolySet,
                                           bool aStrokeTriangulation )
 {
@@ -2013,6 +2054,32 @@ void OPENGL_GAL::DrawGroup( int aGroupNumber )
 }
 
 
+bool OPENGL_GAL::SupportsGroupInstancing() const
+{
+    return ADVANCED_CFG::GetCfg().m_EnableGalInstancing && m_cachedManager
+           && m_cachedManager->SupportsInstancing();
+}
+
+
+void OPENGL_GAL::DrawGroupInstance( int aGroupNumber, const VECTOR2D& aOffset )
+{
+    auto group = m_groups.find( aGroupNumber );
+
+    if( group != m_groups.end() )
+        m_cachedManager->DrawItemInstance( *group->second, aOffset );
+}
+
+
+void OPENGL_GAL::SetLayerDepth( double aLayerDepth )
+{
+    // Instances are batched by layer, so that they keep their place in the drawing order
+    if( m_cachedManager )
+        m_cachedManager->FlushInstances();
+
+    GAL::SetLayerDepth( aLayerDepth );
+}
+
+
 void OPENGL_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     auto group = m_groups.find( aGroupNumber );
@@ -2848,14 +2915,9 @@ void OPENGL_GAL::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTotal )
 
         DrawPolylines( strokeGlyph );
     }
-    else if( aGlyph.IsOutline() )
+    else if( aGlyph.IsOutline() || aGlyph.IsSharedOutline() )
     {
-        const auto& outlineGlyph = static_cast<const KIFONT::OUTLINE_GLYPH&>( aGlyph );
-
-        m_currentManager->Shader( SHADER_NONE );
-        m_currentManager->Color( m_fillColor );
-
-        outlineGlyph.Triangulate(
+        auto addTriangle =
                 [&]( const VECTOR2D& aPt1, const VECTOR2D& aPt2, const VECTOR2D& aPt3 )
                 {
                     m_currentManager->Reserve( 3 );
@@ -2863,7 +2925,15 @@ void OPENGL_GAL::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTotal )
                     m_currentManager->Vertex( aPt1.x, aPt1.y, m_layerDepth );
                     m_currentManager->Vertex( aPt2.x, aPt2.y, m_layerDepth );
                     m_currentManager->Vertex( aPt3.x, aPt3.y, m_layerDepth );
-                } );
+                };
+
+        m_currentManager->Shader( SHADER_NONE );
+        m_currentManager->Color( m_fillColor );
+
+        if( aGlyph.IsSharedOutline() )
+            static_cast<const KIFONT::SHARED_OUTLINE_GLYPH&>( aGlyph ).Triangulate( addTriangle );
+        else
+            static_cast<const KIFONT::OUTLINE_GLYPH&>( aGlyph ).Triangulate( addTriangle );
     }
 }
 
@@ -2887,7 +2957,7 @@ void OPENGL_GAL::DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>&
 
     for( const std::unique_ptr<KIFONT::GLYPH>& glyph : aGlyphs )
     {
-        if( !glyph->IsOutline() )
+        if( !glyph->IsOutline() && !glyph->IsSharedOutline() )
         {
             allGlyphsAreOutline = false;
             break;
@@ -2928,12 +2998,31 @@ void OPENGL_GAL::DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>&
     }
     else if( allGlyphsAreOutline )
     {
-        // Optimized path for outline fonts that pre-reserves glyph triangles.
-        int triangleCount = 0;
+        // Optimized path for outline fonts that pre-reserves glyph triangles.  Shared glyphs are
+        // stored in font units and mapped through their transform here.
+        using KIFONT::OUTLINE_GLYPH;
+        using KIFONT::SHARED_OUTLINE_GLYPH;
+
+        auto getOutline =
+                [&]( const KIFONT::GLYPH& aGlyph,
+                     const SHARED_OUTLINE_GLYPH*& aShared ) -> const OUTLINE_GLYPH&
+                {
+                    if( aGlyph.IsSharedOutline() )
+                    {
+                        aShared = static_cast<const SHARED_OUTLINE_GLYPH*>( &aGlyph );
+                        return aShared->GetGlyph();
+                    }
+
+                    aShared = nullptr;
+                    return static_cast<const OUTLINE_GLYPH&>( aGlyph );
+                };
+
+        int                         triangleCount = 0;
+        const SHARED_OUTLINE_GLYPH* shared = nullptr;
 
         for( const std::unique_ptr<KIFONT::GLYPH>& glyph : aGlyphs )
         {
-            const auto& outlineGlyph = static_cast<const KIFONT::OUTLINE_GLYPH&>( *glyph );
+            const OUTLINE_GLYPH& outlineGlyph = getOutline( *glyph, shared );
 
             for( unsigned int i = 0; i < outlineGlyph.TriangulatedPolyCount(); i++ )
             {
@@ -2951,7 +3040,7 @@ void OPENGL_GAL::DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>&
 
         for( const std::unique_ptr<KIFONT::GLYPH>& glyph : aGlyphs )
         {
-            const auto& outlineGlyph = static_cast<const KIFONT::OUTLINE_GLYPH&>( *glyph );
+            const OUTLINE_GLYPH& outlineGlyph = getOutline( *glyph, shared );
 
             for( unsigned int i = 0; i < outlineGlyph.TriangulatedPolyCount(); i++ )
             {
@@ -2963,9 +3052,20 @@ void OPENGL_GAL::DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>&
                     VECTOR2I a, b, c;
                     polygon->GetTriangle( j, a, b, c );
 
-                    m_currentManager->Vertex( a.x, a.y, m_layerDepth );
-                    m_currentManager->Vertex( b.x, b.y, m_layerDepth );
-                    m_currentManager->Vertex( c.x, c.y, m_layerDepth );
+                    VECTOR2D pa( a ), pb( b ), pc( c );
+
+                    if( shared )
+                    {
+                        const MATRIX3x3D& transform = shared->GetTransform();
+
+                        pa = transform * pa;
+                        pb = transform * pb;
+                        pc = transform * pc;
+                    }
+
+                    m_currentManager->Vertex( pa.x, pa.y, m_layerDepth );
+                    m_currentManager->Vertex( pb.x, pb.y, m_layerDepth );
+                    m_currentManager->Vertex( pc.x, pc.y, m_layerDepth );
                 }
             }
         }
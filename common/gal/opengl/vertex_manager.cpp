@@ -164,6 +164,31 @@ bool VERTEX_MANAGER::Vertices( const VERTEX aVertices[], unsigned int aSize )
 }
 
 
+bool VERTEX_MANAGER::Vertices( const std::vector<VECTOR2F>& aVertices, GLfloat aZ )
+{
+    // flag to avoid hanging by calling DisplayError too many times:
+    static bool show_err = true;
+
+    VERTEX* newVertex = m_container->Allocate( (unsigned int) aVertices.size() );
+
+    if( newVertex == nullptr )
+    {
+        if( show_err )
+        {
+            DisplayError( nullptr, wxT( "VERTEX_MANAGER::Vertices: Vertex allocation error" ) );
+            show_err = false;
+        }
+
+        return false;
+    }
+
+    for( size_t i = 0; i < aVertices.size(); ++i )
+        putVertex( newVertex[i], aVertices[i].x, aVertices[i].y, aZ );
+
+    return true;
+}
+
+
 void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem ) const
 {
     m_container->SetItem( &aItem );
@@ -243,6 +268,27 @@ void VERTEX_MANAGER::Clear() const
 }
 
 
+unsigned int VERTEX_MANAGER::Compact( unsigned int aMaxVertices ) const
+{
+    if( CACHED_CONTAINER* cached = dynamic_cast<CACHED_CONTAINER*>( m_container.get() ) )
+        return cached->Compact( aMaxVertices );
+
+    return 0;
+}
+
+
+bool VERTEX_MANAGER::GetCacheStats( VERTEX_CACHE_STATS& aStats ) const
+{
+    if( CACHED_CONTAINER* cached = dynamic_cast<CACHED_CONTAINER*>( m_container.get() ) )
+    {
+        aStats = cached->GetStats();
+        return true;
+    }
+
+    return false;
+}
+
+
 void VERTEX_MANAGER::BeginDrawing() const
 {
     m_gpu->BeginDrawing();
@@ -255,6 +301,24 @@ void VERTEX_MANAGER::DrawItem( const VERTEX_ITEM& aItem ) const
 }
 
 
+bool VERTEX_MANAGER::SupportsInstancing() const
+{
+    return m_gpu->SupportsInstancing();
+}
+
+
+void VERTEX_MANAGER::DrawItemInstance( const VERTEX_ITEM& aItem, const VECTOR2D& aOffset ) const
+{
+    m_gpu->DrawIndicesInstanced( &aItem, aOffset );
+}
+
+
+void VERTEX_MANAGER::FlushInstances() const
+{
+    m_gpu->FlushInstances();
+}
+
+
 void VERTEX_MANAGER::EndDrawing() const
 {
     m_gpu->EndDrawing();
@@ -26,6 +26,7 @@
 
 #include <gal/painter.h>
 #include <gal/graphics_abstraction_layer.h>
+#include <view/view_item.h>
 
 using namespace KIGFX;
 
@@ -38,3 +39,12 @@ PAINTER::PAINTER( GAL* aGal ) :
 PAINTER::~PAINTER()
 {
 }
+
+
+BOX2I PAINTER::GetInstanceBBox( const VIEW_ITEM* aItem, int aLayer, const VECTOR2I& aOffset )
+{
+    BOX2I bbox = aItem->ViewBBox();
+
+    bbox.Move( -aOffset );
+    return bbox;
+}
@@ -0,0 +1,530 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/recording_gal.h>
+
+#include <font/glyph.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+using namespace KIGFX;
+
+
+namespace
+{
+
+std::unique_ptr<KIFONT::GLYPH> cloneGlyph( const KIFONT::GLYPH& aGlyph )
+{
+    if( aGlyph.IsStroke() )
+    {
+        return std::make_unique<KIFONT::STROKE_GLYPH>(
+                static_cast<const KIFONT::STROKE_GLYPH&>( aGlyph ) );
+    }
+    else if( aGlyph.IsOutline() )
+    {
+        return std::make_unique<KIFONT::OUTLINE_GLYPH>(
+                static_cast<const KIFONT::OUTLINE_GLYPH&>( aGlyph ) );
+    }
+    else if( aGlyph.IsSharedOutline() )
+    {
+        return std::make_unique<KIFONT::SHARED_OUTLINE_GLYPH>(
+                static_cast<const KIFONT::SHARED_OUTLINE_GLYPH&>( aGlyph ) );
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+
+RECORDING_GAL::RECORDING_GAL( GAL& aTarget ) :
+        GAL( aTarget.GetDisplayOptions() ),
+        m_isCairo( aTarget.IsCairoEngine() ),
+        m_isOpenGl( aTarget.IsOpenGlEngine() ),
+        m_initialIsFill( aTarget.GetIsFill() ),
+        m_initialIsStroke( aTarget.GetIsStroke() ),
+        m_initialFillColor( aTarget.GetFillColor() ),
+        m_initialStrokeColor( aTarget.GetStrokeColor() ),
+        m_initialLineWidth( aTarget.GetLineWidth() )
+{
+    m_screenSize = aTarget.GetScreenPixelSize();
+    m_lookAtPoint = aTarget.GetLookAtPoint();
+    m_zoomFactor = aTarget.GetZoomFactor();
+    m_rotation = aTarget.GetRotation();
+    m_worldScale = aTarget.GetWorldScale();
+    m_worldScreenMatrix = aTarget.GetWorldScreenMatrix();
+    m_screenWorldMatrix = aTarget.GetScreenWorldMatrix();
+    m_globalFlipX = aTarget.IsFlippedX();
+    m_globalFlipY = aTarget.IsFlippedY();
+    m_depthRange = VECTOR2D( aTarget.GetMinDepth(), aTarget.GetMaxDepth() );
+
+    GAL::SetIsFill( m_initialIsFill );
+    GAL::SetIsStroke( m_initialIsStroke );
+    GAL::SetFillColor( m_initialFillColor );
+    GAL::SetStrokeColor( m_initialStrokeColor );
+    GAL::SetLineWidth( m_initialLineWidth );
+}
+
+
+RECORDING_GAL::RECORDING RECORDING_GAL::TakeRecording()
+{
+    RECORDING recording;
+
+    std::swap( recording, m_recording );
+
+    GAL::SetIsFill( m_initialIsFill );
+    GAL::SetIsStroke( m_initialIsStroke );
+    GAL::SetFillColor( m_initialFillColor );
+    GAL::SetStrokeColor( m_initialStrokeColor );
+    GAL::SetLineWidth( m_initialLineWidth );
+    ResetTextAttributes();
+
+    return recording;
+}
+
+
+void RECORDING_GAL::Replay( const RECORDING& aRecording, GAL& aTarget )
+{
+    for( const std::function<void( GAL& )>& call : aRecording )
+        call( aTarget );
+}
+
+
+void RECORDING_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawLine( aStartPoint, aEndPoint );
+            } );
+}
+
+
+void RECORDING_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                                 double aWidth )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawSegment( aStartPoint, aEndPoint, aWidth );
+            } );
+}
+
+
+void RECORDING_GAL::DrawSegmentChain( const std::vector<VECTOR2D>& aPointList, double aWidth )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawSegmentChain( aPointList, aWidth );
+            } );
+}
+
+
+void RECORDING_GAL::DrawSegmentChain( const SHAPE_LINE_CHAIN& aLineChain, double aWidth )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawSegmentChain( aLineChain, aWidth );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolyline( aPointList );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const std::vector<VECTOR2D>& aPointList )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolyline( aPointList );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
+{
+    std::vector<VECTOR2D> points( aPointList, aPointList + aListSize );
+
+    m_recording.emplace_back(
+            [points]( GAL& aGal )
+            {
+                aGal.DrawPolyline( points.data(), (int) points.size() );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolyline( aLineChain );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolylines( aPointLists );
+            } );
+}
+
+
+void RECORDING_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawCircle( aCenterPoint, aRadius );
+            } );
+}
+
+
+void RECORDING_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
+                             const EDA_ANGLE& aStartAngle, const EDA_ANGLE& aAngle )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawArc( aCenterPoint, aRadius, aStartAngle, aAngle );
+            } );
+}
+
+
+void RECORDING_GAL::DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                    const EDA_ANGLE& aStartAngle, const EDA_ANGLE& aAngle,
+                                    double aWidth, double aMaxError )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawArcSegment( aCenterPoint, aRadius, aStartAngle, aAngle, aWidth,
+                                     aMaxError );
+            } );
+}
+
+
+void RECORDING_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawRectangle( aStartPoint, aEndPoint );
+            } );
+}
+
+
+void RECORDING_GAL::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTotal )
+{
+    std::shared_ptr<KIFONT::GLYPH> glyph( cloneGlyph( aGlyph ) );
+
+    if( !glyph )
+        return;
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawGlyph( *glyph, aNth, aTotal );
+            } );
+}
+
+
+void RECORDING_GAL::DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>& aGlyphs )
+{
+    // Keep the glyphs together, as some GALs draw a whole string more efficiently
+    auto glyphs = std::make_shared<std::vector<std::unique_ptr<KIFONT::GLYPH>>>();
+
+    for( const std::unique_ptr<KIFONT::GLYPH>& glyph : aGlyphs )
+    {
+        if( std::unique_ptr<KIFONT::GLYPH> clone = cloneGlyph( *glyph ) )
+            glyphs->push_back( std::move( clone ) );
+    }
+
+    m_recording.emplace_back(
+            [glyphs]( GAL& aGal )
+            {
+                aGal.DrawGlyphs( *glyphs );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolygon( aPointList );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
+{
+    std::vector<VECTOR2D> points( aPointList, aPointList + aListSize );
+
+    m_recording.emplace_back(
+            [points]( GAL& aGal )
+            {
+                aGal.DrawPolygon( points.data(), (int) points.size() );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet, bool aStrokeTriangulation )
+{
+    // The copy keeps the triangulation, so that painters can cache it on the worker threads
+    auto polySet = std::make_shared<SHAPE_POLY_SET>( aPolySet );
+
+    m_recording.emplace_back(
+            [polySet, aStrokeTriangulation]( GAL& aGal )
+            {
+                aGal.DrawPolygon( *polySet, aStrokeTriangulation );
+            } );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolygon( aPolySet );
+            } );
+}
+
+
+void RECORDING_GAL::DrawTriangles( const std::vector<VECTOR2F>& aVertices )
+{
+    m_recording.emplace_back(
+            [aVertices]( GAL& aGal )
+            {
+                aGal.DrawTriangles( aVertices );
+            } );
+}
+
+
+void RECORDING_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                               const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                               double aFilterValue )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawCurve( aStartPoint, aControlPointA, aControlPointB, aEndPoint,
+                                aFilterValue );
+            } );
+}
+
+
+void RECORDING_GAL::DrawBitmap( const BITMAP_BASE& aBitmap, double alphaBlend )
+{
+    const BITMAP_BASE* bitmap = &aBitmap;
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawBitmap( *bitmap, alphaBlend );
+            } );
+}
+
+
+void RECORDING_GAL::SetIsFill( bool aIsFillEnabled )
+{
+    GAL::SetIsFill( aIsFillEnabled );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetIsFill( aIsFillEnabled );
+            } );
+}
+
+
+void RECORDING_GAL::SetIsStroke( bool aIsStrokeEnabled )
+{
+    GAL::SetIsStroke( aIsStrokeEnabled );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetIsStroke( aIsStrokeEnabled );
+            } );
+}
+
+
+void RECORDING_GAL::SetFillColor( const COLOR4D& aColor )
+{
+    GAL::SetFillColor( aColor );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetFillColor( aColor );
+            } );
+}
+
+
+void RECORDING_GAL::SetStrokeColor( const COLOR4D& aColor )
+{
+    GAL::SetStrokeColor( aColor );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetStrokeColor( aColor );
+            } );
+}
+
+
+void RECORDING_GAL::SetLineWidth( float aLineWidth )
+{
+    GAL::SetLineWidth( aLineWidth );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetLineWidth( aLineWidth );
+            } );
+}
+
+
+void RECORDING_GAL::SetLayerDepth( double aLayerDepth )
+{
+    GAL::SetLayerDepth( aLayerDepth );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetLayerDepth( aLayerDepth );
+            } );
+}
+
+
+void RECORDING_GAL::SetNegativeDrawMode( bool aSetting )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetNegativeDrawMode( aSetting );
+            } );
+}
+
+
+void RECORDING_GAL::BitmapText( const wxString& aText, const VECTOR2I& aPosition,
+                                const EDA_ANGLE& aAngle )
+{
+    // Text attributes are not virtual, so they are captured along with the text
+    VECTOR2I          glyphSize = GetGlyphSize();
+    bool              bold = IsFontBold();
+    bool              italic = IsFontItalic();
+    bool              underlined = IsFontUnderlined();
+    bool              mirrored = IsTextMirrored();
+    GR_TEXT_H_ALIGN_T hAlign = GetHorizontalJustify();
+    GR_TEXT_V_ALIGN_T vAlign = GetVerticalJustify();
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetGlyphSize( glyphSize );
+                aGal.SetFontBold( bold );
+                aGal.SetFontItalic( italic );
+                aGal.SetFontUnderlined( underlined );
+                aGal.SetTextMirrored( mirrored );
+                aGal.SetHorizontalJustify( hAlign );
+                aGal.SetVerticalJustify( vAlign );
+                aGal.BitmapText( aText, aPosition, aAngle );
+            } );
+}
+
+
+void RECORDING_GAL::Transform( const MATRIX3x3D& aTransformation )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Transform( aTransformation );
+            } );
+}
+
+
+void RECORDING_GAL::Rotate( double aAngle )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Rotate( aAngle );
+            } );
+}
+
+
+void RECORDING_GAL::Translate( const VECTOR2D& aTranslation )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Translate( aTranslation );
+            } );
+}
+
+
+void RECORDING_GAL::Scale( const VECTOR2D& aScale )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Scale( aScale );
+            } );
+}
+
+
+void RECORDING_GAL::Save()
+{
+    m_recording.emplace_back(
+            []( GAL& aGal )
+            {
+                aGal.Save();
+            } );
+}
+
+
+void RECORDING_GAL::Restore()
+{
+    m_recording.emplace_back(
+            []( GAL& aGal )
+            {
+                aGal.Restore();
+            } );
+}
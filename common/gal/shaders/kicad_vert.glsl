@@ -41,6 +41,7 @@ const float SHADER_LINE_F               = 10.0;
 const float MIN_WIDTH = 1.0;
 
 attribute vec4 a_shaderParams;
+attribute vec2 a_instanceOffset;
 varying vec4 v_shaderParams;
 varying vec2 v_circleCoords;
 
@@ -50,6 +51,9 @@ uniform float u_pixelSizeMultiplier;
 uniform float u_minLinePixelWidth;
 uniform vec2 u_antialiasingOffset;
 
+// Vertex position, moved to the drawn instance of a shared group
+vec4 vertex;
+
 
 float roundr( float f, float r )
 {
@@ -64,7 +68,7 @@ vec4 roundv( vec4 x, vec2 t)
 void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir, float lineWidth, bool endV )
 {
     float lineLength = length(vs);
-    vec4 screenPos = gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0);
+    vec4 screenPos = gl_ModelViewProjectionMatrix * vertex + vec4(1, 1, 0, 0);
     float w = ((lineWidth == 0.0) ? u_worldPixelSize : lineWidth );
     float pixelWidth = roundr( w / u_worldPixelSize, 1.0 );
     float aspect = ( lineLength + w ) / w;
@@ -117,7 +121,7 @@ void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir,
 void computeCircleCoords( float mode, float vertexIndex, float radius, float lineWidth )
 {
     vec4 delta;
-    vec4 center = roundv( gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0), u_screenPixelSize );
+    vec4 center = roundv( gl_ModelViewProjectionMatrix * vertex + vec4(1, 1, 0, 0), u_screenPixelSize );
     float pixelWidth = roundr( lineWidth / u_worldPixelSize, 1.0);
     float pixelR = roundr( radius / u_worldPixelSize, 1.0);
 
@@ -175,6 +179,8 @@ void main()
 {
     float mode = a_shaderParams[0];
 
+    vertex = gl_Vertex + vec4( a_instanceOffset, 0.0, 0.0 );
+
     // Pass attributes to the fragment shader
     v_shaderParams = a_shaderParams;
 
@@ -200,7 +206,7 @@ void main()
     else
     {
         // Pass through the coordinates like in the fixed pipeline
-        gl_Position = ftransform();
+        gl_Position = gl_ModelViewProjectionMatrix * vertex;
         gl_FrontColor = gl_Color;
 
     }
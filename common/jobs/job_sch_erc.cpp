@@ -27,6 +27,7 @@ JOB_SCH_ERC::JOB_SCH_ERC( bool aIsCli ) :
     m_units( JOB_SCH_ERC::UNITS::MILLIMETERS ),
     m_severity( RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING ),
     m_format( OUTPUT_FORMAT::REPORT ),
-    m_exitCodeViolations( false )
+    m_exitCodeViolations( false ),
+    m_reportTimings( false )
 {
 }
\ No newline at end of file
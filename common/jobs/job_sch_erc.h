@@ -55,6 +55,7 @@ public:
     OUTPUT_FORMAT m_format;
 
     bool m_exitCodeViolations;
+    bool m_reportTimings;
 };
 
 #endif
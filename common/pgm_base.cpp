@@ -39,6 +39,7 @@
 #include <wx/stdpaths.h>
 #include <wx/sysopt.h>
 #include <wx/filedlg.h>
+#include <wx/datetime.h>
 #include <wx/ffile.h>
 #include <wx/tooltip.h>
 
@@ -49,6 +50,7 @@
 #include <common.h>
 #include <confirm.h>
 #include <core/arraydim.h>
+#include <frame_tracer.h>
 #include <id.h>
 #include <kicad_curl/kicad_curl.h>
 #include <kiplatform/policy.h>
@@ -166,6 +168,17 @@ void PGM_BASE::Destroy()
 {
     KICAD_CURL::Cleanup();
 
+    if( ADVANCED_CFG::GetCfg().m_EnableFrameTracing && FRAME_TRACER::Instance().GetCount() )
+    {
+        wxFileName traceFile( PATHS::GetLogsPath(),
+                              wxDateTime::Now().Format( wxS( "frame_trace_%Y%m%d_%H%M%S.json" ) ) );
+
+        if( PATHS::EnsurePathExists( traceFile.GetPath() ) )
+            FRAME_TRACER::Instance().SaveChromeTrace( traceFile.GetFullPath() );
+
+        FRAME_TRACER::Instance().Clear();
+    }
+
 #ifdef KICAD_USE_SENTRY
     sentry_close();
 #endif
@@ -1139,6 +1139,14 @@ TOOL_ACTION ACTIONS::reportBug( TOOL_ACTION_ARGS()
         .Tooltip( _( "Report a problem with KiCad" ) )
         .Icon( BITMAPS::bug ) );
 
+TOOL_ACTION ACTIONS::saveFrameTrace( TOOL_ACTION_ARGS()
+        .Name( "common.SuiteControl.saveFrameTrace" )
+        .Scope( AS_GLOBAL )
+        .DefaultHotkey( MD_CTRL + MD_SHIFT + WXK_F12 )
+        .FriendlyName( _( "Save Frame Trace..." ) )
+        .Tooltip( _( "Start recording the time spent drawing and handling events, or save the "
+                     "recording as a Chrome trace" ) ) );
+
 TOOL_ACTION ACTIONS::ddAddLibrary( TOOL_ACTION_ARGS()
         .Name( "common.Control.ddaddLibrary" )
         .Scope( AS_GLOBAL ) );
@@ -29,6 +29,7 @@
 #include <bitmaps.h>
 #include <build_version.h>
 #include <common.h>     // for SearchHelpFileFullPath
+#include <confirm.h>
 #include <pgm_base.h>
 #include <tool/actions.h>
 #include <tool/tool_manager.h>
@@ -41,6 +42,10 @@
 #include <kiface_base.h>
 #include <dialogs/dialog_configure_paths.h>
 #include <eda_doc.h>
+#include <frame_tracer.h>
+#include <paths.h>
+#include <wildcards_and_files_ext.h>
+#include <wx/filedlg.h>
 #include <wx/msgdlg.h>
 
 #define URL_GET_INVOLVED wxS( "https://kicad.org/contribute/" )
@@ -336,6 +341,35 @@ int COMMON_CONTROL::ReportBug( const TOOL_EVENT& aEvent )
 }
 
 
+int COMMON_CONTROL::SaveFrameTrace( const TOOL_EVENT& aEvent )
+{
+    FRAME_TRACER& tracer = FRAME_TRACER::Instance();
+
+    if( !tracer.IsEnabled() )
+    {
+        tracer.Clear();
+        tracer.Enable( true );
+
+        m_frame->ShowInfoBarMsg( _( "Recording frame trace.  Run Save Frame Trace again to save "
+                                    "it." ) );
+        return 0;
+    }
+
+    tracer.Enable( false );
+
+    wxFileDialog dlg( m_frame, _( "Save Frame Trace" ), PATHS::GetLogsPath(),
+                      wxS( "kicad_frame_trace.json" ), FILEEXT::JsonFileWildcard(),
+                      wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( dlg.ShowModal() == wxID_OK && !tracer.SaveChromeTrace( dlg.GetPath() ) )
+        DisplayError( m_frame, wxString::Format( _( "Failed to write '%s'." ), dlg.GetPath() ) );
+
+    tracer.Clear();
+
+    return 0;
+}
+
+
 void COMMON_CONTROL::setTransitions()
 {
     Go( &COMMON_CONTROL::OpenPreferences,    ACTIONS::openPreferences.MakeEvent() );
@@ -354,6 +388,7 @@ void COMMON_CONTROL::setTransitions()
     Go( &COMMON_CONTROL::GetInvolved,        ACTIONS::getInvolved.MakeEvent() );
     Go( &COMMON_CONTROL::Donate,             ACTIONS::donate.MakeEvent() );
     Go( &COMMON_CONTROL::ReportBug,          ACTIONS::reportBug.MakeEvent() );
+    Go( &COMMON_CONTROL::SaveFrameTrace,     ACTIONS::saveFrameTrace.MakeEvent() );
     Go( &COMMON_CONTROL::About,              ACTIONS::about.MakeEvent() );
 }
 
@@ -24,6 +24,7 @@
  */
 
 #include <core/ignore.h>
+#include <frame_tracer.h>
 #include <macros.h>
 #include <trace_helpers.h>
 #include <tool/tool_manager.h>
@@ -418,6 +419,8 @@ std::optional<TOOL_EVENT> TOOL_DISPATCHER::GetToolEvent( wxKeyEvent* aKeyEvent,
 
 void TOOL_DISPATCHER::DispatchWxEvent( wxEvent& aEvent )
 {
+    KI_TRACE_ZONE( "TOOL_DISPATCHER::DispatchWxEvent", "tool" );
+
     bool            motion = false;
     bool            buttonEvents = false;
     VECTOR2D        pos;
@@ -25,6 +25,7 @@
  */
 
 #include <core/kicad_algo.h>
+#include <frame_tracer.h>
 #include <optional>
 #include <map>
 #include <stack>
@@ -726,6 +727,8 @@ TOOL_EVENT* TOOL_MANAGER::ScheduleWait( TOOL_BASE* aTool, const TOOL_EVENT_LIST&
 
 bool TOOL_MANAGER::dispatchInternal( TOOL_EVENT& aEvent )
 {
+    KI_TRACE_ZONE( "TOOL_MANAGER::dispatchInternal", "tool" );
+
     bool handled = false;
 
     wxLogTrace( kicadTraceToolStack, wxS( "TOOL_MANAGER::dispatchInternal - received event: %s" ),
@@ -1178,6 +1181,8 @@ void TOOL_MANAGER::applyViewControls( const TOOL_STATE* aState )
 
 bool TOOL_MANAGER::processEvent( const TOOL_EVENT& aEvent )
 {
+    KI_TRACE_ZONE( "TOOL_MANAGER::processEvent", "tool" );
+
     wxLogTrace( kicadTraceToolStack, wxS( "TOOL_MANAGER::processEvent - %s" ), aEvent.Format() );
 
     // First try to dispatch the action associated with the event if it is a key press event
@@ -26,6 +26,8 @@
  */
 
 
+#include <atomic>
+
 #include <layer_ids.h>
 #include <trace_helpers.h>
 
@@ -34,12 +36,17 @@
 #include <view/view_item.h>
 #include <view/view_rtree.h>
 #include <view/view_overlay.h>
+#include <view/view_query_cache.h>
 
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <gal/painter.h>
+#include <gal/recording_gal.h>
 
 #include <core/profile.h>
+#include <core/thread_pool.h>
+#include <frame_tracer.h>
+#include <hash.h>
 
 #ifdef KICAD_GAL_PROFILE
 #include <wx/log.h>
@@ -138,6 +145,104 @@ private:
     }
 
 
+    /**
+     * Return the group id of the simplified drawing of the item on the given layer, or -1 if
+     * there is none.
+     *
+     * @param aLayer is the layer number for which group id is queried.
+     * @param aScale is set to the view scale below which the simplified drawing is used.
+     */
+    int getLODGroup( int aLayer, double* aScale = nullptr ) const
+    {
+        for( const LOD_GROUP& lod : m_lodGroups )
+        {
+            if( lod.m_layer == aLayer )
+            {
+                if( aScale )
+                    *aScale = lod.m_scale;
+
+                return lod.m_group;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * Set the group id of the simplified drawing of the item on the given layer.
+     *
+     * @param aLayer is the layer number.
+     * @param aGroup is the group id, or -1 to forget the simplified drawing.
+     * @param aScale is the view scale below which the simplified drawing is used.
+     */
+    void setLODGroup( int aLayer, int aGroup, double aScale = 0.0 )
+    {
+        for( auto it = m_lodGroups.begin(); it != m_lodGroups.end(); ++it )
+        {
+            if( it->m_layer == aLayer )
+            {
+                if( aGroup < 0 )
+                    m_lodGroups.erase( it );
+                else
+                    *it = { aLayer, aGroup, aScale };
+
+                return;
+            }
+        }
+
+        if( aGroup >= 0 )
+            m_lodGroups.push_back( { aLayer, aGroup, aScale } );
+    }
+
+    /**
+     * Return the key of the shared group used to draw the item on the given layer, or 0 if the
+     * item has its own group there.
+     *
+     * @param aLayer is the layer number.
+     * @param aOffset is set to the offset at which the shared group is drawn.
+     */
+    size_t getInstance( int aLayer, VECTOR2I* aOffset = nullptr ) const
+    {
+        for( const INSTANCE& instance : m_instances )
+        {
+            if( instance.m_layer == aLayer )
+            {
+                if( aOffset )
+                    *aOffset = instance.m_offset;
+
+                return instance.m_key;
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * Set the key of the shared group used to draw the item on the given layer.
+     *
+     * @param aLayer is the layer number.
+     * @param aKey is the key of the shared group, or 0 if the item has its own group.
+     * @param aOffset is the offset at which the shared group is drawn.
+     */
+    void setInstance( int aLayer, size_t aKey, const VECTOR2I& aOffset = VECTOR2I() )
+    {
+        for( auto it = m_instances.begin(); it != m_instances.end(); ++it )
+        {
+            if( it->m_layer == aLayer )
+            {
+                if( aKey == 0 )
+                    m_instances.erase( it );
+                else
+                    *it = { aLayer, aKey, aOffset };
+
+                return;
+            }
+        }
+
+        if( aKey != 0 )
+            m_instances.push_back( { aLayer, aKey, aOffset } );
+    }
+
     /**
      * Remove all of the stored group ids. Forces recaching of the item.
      */
@@ -146,6 +251,8 @@ private:
         delete[] m_groups;
         m_groups = nullptr;
         m_groupsSize = 0;
+        m_lodGroups.clear();
+        m_instances.clear();
     }
 
 
@@ -179,6 +286,18 @@ private:
 
             m_groups[i].first = new_layer;
         }
+
+        for( LOD_GROUP& lod : m_lodGroups )
+        {
+            if( aReorderMap.count( lod.m_layer ) )
+                lod.m_layer = aReorderMap.at( lod.m_layer );
+        }
+
+        for( INSTANCE& instance : m_instances )
+        {
+            if( aReorderMap.count( instance.m_layer ) )
+                instance.m_layer = aReorderMap.at( instance.m_layer );
+        }
     }
 
     /**
@@ -233,6 +352,26 @@ private:
                                              ///< item occupies.
     int                  m_groupsSize;
 
+    struct LOD_GROUP
+    {
+        int    m_layer;
+        int    m_group;
+        double m_scale;
+    };
+
+    std::vector<LOD_GROUP> m_lodGroups;      ///< Groups holding simplified drawings, used below
+                                             ///< the given view scale.
+
+    struct INSTANCE
+    {
+        int      m_layer;
+        size_t   m_key;
+        VECTOR2I m_offset;
+    };
+
+    std::vector<INSTANCE> m_instances;       ///< Layers on which the group is shared with other
+                                             ///< items, and drawn at an offset.
+
     std::vector<int>     m_layers;           /// Stores layer numbers used by the item.
 
     BOX2I                m_bbox;             /// Cached inserted Bbox for faster removals.
@@ -262,7 +401,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_queryVersion( 0 )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -303,6 +443,8 @@ VIEW::VIEW( bool aIsDynamic ) :
 
     m_preview.reset( new KIGFX::VIEW_GROUP() );
     Add( m_preview.get() );
+
+    m_queryCache = std::make_unique<VIEW_QUERY_CACHE>( this );
 }
 
 
@@ -335,6 +477,7 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
     aItem->viewPrivData()->saveLayers( layers, layers_count );
 
     m_allItems->push_back( aItem );
+    m_queryVersion++;
 
     for( int i = 0; i < layers_count; ++i )
     {
@@ -368,6 +511,8 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         aItem->m_viewPrivData->getLayers( layers, layers_count );
         const BOX2I* bbox = &aItem->m_viewPrivData->m_bbox;
 
+        m_queryVersion++;
+
         for( int i = 0; i < layers_count; ++i )
         {
             VIEW_LAYER& l = m_layers[layers[i]];
@@ -375,7 +520,9 @@ void VIEW::Remove( VIEW_ITEM* aItem )
             MarkTargetDirty( l.target );
 
             // Clear the GAL cache
-            int prevGroup = aItem->m_viewPrivData->getGroup( layers[i] );
+            releaseGroup( aItem->m_viewPrivData, layers[i] );
+
+            int prevGroup = aItem->m_viewPrivData->getLODGroup( layers[i] );
 
             if( prevGroup >= 0 )
                 m_gal->DeleteGroup( prevGroup );
@@ -423,6 +570,35 @@ struct QUERY_VISITOR
 };
 
 
+int VIEW::Query( const BOX2I& aRect, const std::vector<int>& aLayers,
+                 std::vector<LAYER_ITEM_PAIR>& aResult ) const
+{
+    for( int layer : aLayers )
+    {
+        wxCHECK2( layer >= 0 && layer < (int) m_layers.size(), continue );
+
+        QUERY_VISITOR<std::vector<LAYER_ITEM_PAIR> > visitor( aResult, layer );
+        m_layers[layer].items->Query( aRect, visitor );
+    }
+
+    return aResult.size();
+}
+
+
+std::vector<int> VIEW::GetQueryLayers() const
+{
+    std::vector<int> layers;
+
+    for( auto i = m_orderedLayers.rbegin(); i != m_orderedLayers.rend(); ++i )
+    {
+        if( !( *i )->displayOnly && ( *i )->visible )
+            layers.push_back( ( *i )->id );
+    }
+
+    return layers;
+}
+
+
 int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const
 {
     if( m_orderedLayers.empty() )
@@ -693,6 +869,7 @@ void VIEW::ReorderLayerData( std::unordered_map<int, int> aReorderMap )
 
     // Transfer reordered data (using the copy assignment operator ):
     m_layers = new_map;
+    m_queryVersion++;
 
     for( VIEW_ITEM* item : *m_allItems )
     {
@@ -729,10 +906,17 @@ struct VIEW::UPDATE_COLOR_VISITOR
         // Obtain the color that should be used for coloring the item
         const COLOR4D color = painter->GetSettings()->GetColor( aItem, layer );
         int           group = aItem->viewPrivData()->getGroup( layer );
+        int           lodGroup = aItem->viewPrivData()->getLODGroup( layer );
 
-        if( group >= 0 )
+        // Shared groups are drawn for other items too, so the item has to switch to another one
+        if( aItem->viewPrivData()->getInstance( layer ) )
+            aItem->viewPrivData()->m_requiredUpdate |= REPAINT;
+        else if( group >= 0 )
             gal->ChangeGroupColor( group, color );
 
+        if( lodGroup >= 0 )
+            gal->ChangeGroupColor( lodGroup, color );
+
         return true;
     }
 
@@ -783,9 +967,15 @@ void VIEW::UpdateAllLayersColor()
             {
                 const COLOR4D color = m_painter->GetSettings()->GetColor( item, layers[i] );
                 int           group = viewData->getGroup( layers[i] );
+                int           lodGroup = viewData->getLODGroup( layers[i] );
 
-                if( group >= 0 )
+                if( viewData->getInstance( layers[i] ) )
+                    viewData->m_requiredUpdate |= REPAINT;
+                else if( group >= 0 )
                     m_gal->ChangeGroupColor( group, color );
+
+                if( lodGroup >= 0 )
+                    m_gal->ChangeGroupColor( lodGroup, color );
             }
         }
     }
@@ -806,10 +996,14 @@ struct VIEW::UPDATE_DEPTH_VISITOR
     bool operator()( VIEW_ITEM* aItem )
     {
         int group = aItem->viewPrivData()->getGroup( layer );
+        int lodGroup = aItem->viewPrivData()->getLODGroup( layer );
 
         if( group >= 0 )
             gal->ChangeGroupDepth( group, depth );
 
+        if( lodGroup >= 0 )
+            gal->ChangeGroupDepth( lodGroup, depth );
+
         return true;
     }
 
@@ -915,9 +1109,13 @@ void VIEW::UpdateAllLayersOrder()
             for( int i = 0; i < layers_count; ++i )
             {
                 int group = viewData->getGroup( layers[i] );
+                int lodGroup = viewData->getLODGroup( layers[i] );
 
                 if( group >= 0 )
                     m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+
+                if( lodGroup >= 0 )
+                    m_gal->ChangeGroupDepth( lodGroup, m_layers[layers[i]].renderingOrder );
             }
         }
     }
@@ -1000,6 +1198,8 @@ void VIEW::redrawRect( const BOX2I& aRect )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
         {
+            KI_TRACE_ZONE( "VIEW::redrawRect layer", "view" );
+
             DRAW_ITEM_VISITOR drawFunc( this, l->id, m_useDrawPriority, m_reverseDrawOrder );
 
             m_gal->SetTarget( l->target );
@@ -1047,9 +1247,23 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     if( IsCached( aLayer ) && !aImmediate )
     {
         // Draw using cached information or create one
-        int group = viewData->getGroup( aLayer );
+        int    group = viewData->getGroup( aLayer );
+        double lodScale = 0.0;
+        int    lodGroup = viewData->getLODGroup( aLayer, &lodScale );
 
-        if( group >= 0 )
+        VECTOR2I instanceOffset;
+        size_t   instance = viewData->getInstance( aLayer, &instanceOffset );
+
+        // Zoomed out far enough, the simplified drawing looks the same and is much lighter
+        if( group >= 0 && lodGroup >= 0 && m_scale < lodScale )
+        {
+            group = lodGroup;
+            instance = 0;
+        }
+
+        if( group >= 0 && instance )
+            m_gal->DrawGroupInstance( group, instanceOffset );
+        else if( group >= 0 )
             m_gal->DrawGroup( group );
         else
             Update( aItem );
@@ -1057,6 +1271,8 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     else
     {
         // Immediate mode
+        KI_TRACE_ZONE( "PAINTER::Draw", "painter" );
+
         if( !m_painter->Draw( aItem, aLayer ) )
             aItem->ViewDraw( aLayer, this );  // Alternative drawing method
     }
@@ -1104,12 +1320,14 @@ struct VIEW::RECACHE_ITEM_VISITOR
             return false;
 
         // Remove previously cached group
-        int group = viewData->getGroup( layer );
+        view->releaseGroup( viewData, layer );
+
+        int group = viewData->getLODGroup( layer );
 
         if( group >= 0 )
             gal->DeleteGroup( group );
 
-        viewData->setGroup( layer, -1 );
+        viewData->setLODGroup( layer, -1 );
         view->Update( aItem );
 
         return true;
@@ -1130,7 +1348,9 @@ void VIEW::Clear()
     for( VIEW_LAYER& layer : m_layers )
         layer.items->RemoveAll();
 
+    m_queryVersion++;
     m_nextDrawPriority = 0;
+    m_instanceTemplates.clear();
 
     m_gal->ClearCache();
 }
@@ -1157,6 +1377,8 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
+    KI_TRACE_ZONE( "VIEW::Redraw", "view" );
+
 #ifdef KICAD_GAL_PROFILE
     PROF_TIMER totalRealTime;
 #endif /* KICAD_GAL_PROFILE */
@@ -1221,6 +1443,8 @@ void VIEW::clearGroupCache()
 
     for( VIEW_LAYER& layer : m_layers )
         layer.items->Query( r, visitor );
+
+    m_instanceTemplates.clear();
 }
 
 
@@ -1277,6 +1501,7 @@ void VIEW::sortLayers()
 
     sort( m_orderedLayers.begin(), m_orderedLayers.end(), compareRenderingOrder );
 
+    m_queryVersion++;
     MarkDirty();
 }
 
@@ -1290,18 +1515,31 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
     if( !viewData )
         return;
 
+    // The color is a part of the instance key, so shared groups are never recolored
+    if( viewData->getInstance( aLayer ) )
+    {
+        updateItemGeometry( aItem, aLayer );
+        return;
+    }
+
     // Obtain the color that should be used for coloring the item on the specific layerId
     const COLOR4D color = m_painter->GetSettings()->GetColor( aItem, aLayer );
     int group = viewData->getGroup( aLayer );
+    int lodGroup = viewData->getLODGroup( aLayer );
 
     // Change the color, only if it has group assigned
     if( group >= 0 )
         m_gal->ChangeGroupColor( group, color );
+
+    if( lodGroup >= 0 )
+        m_gal->ChangeGroupColor( lodGroup, color );
 }
 
 
 void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
 {
+    KI_TRACE_ZONE( "VIEW::updateItemGeometry", "painter" );
+
     VIEW_ITEM_DATA* viewData = aItem->viewPrivData();
     wxCHECK( (unsigned) aLayer < m_layers.size(), /*void*/ );
     wxCHECK( IsCached( aLayer ), /*void*/ );
@@ -1315,18 +1553,257 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     m_gal->SetLayerDepth( l.renderingOrder );
 
     // Redraw the item from scratch
-    int group = viewData->getGroup( aLayer );
+    releaseGroup( viewData, aLayer );
 
-    if( group >= 0 )
-        m_gal->DeleteGroup( group );
+    VECTOR2I instanceOffset;
+    size_t   instance = instanceKey( aItem, aLayer, instanceOffset );
+    auto     shared = m_instanceTemplates.find( instance );
+    BOX2I    instanceBBox;
+
+    if( instance )
+        instanceBBox = m_painter->GetInstanceBBox( aItem, aLayer, instanceOffset );
+
+    // The key is only a hash, so a different drawing may have the same one
+    if( instance && shared != m_instanceTemplates.end() && shared->second.m_bbox != instanceBBox )
+        instance = 0;
 
-    group = m_gal->BeginGroup();
-    viewData->setGroup( aLayer, group );
+    if( instance && shared != m_instanceTemplates.end() )
+    {
+        // Another item already drew the same thing
+        shared->second.m_refCount++;
+        viewData->setGroup( aLayer, shared->second.m_group );
+        viewData->setInstance( aLayer, instance, instanceOffset );
+    }
+    else
+    {
+        int group = m_gal->BeginGroup();
+        viewData->setGroup( aLayer, group );
+
+        // Shared groups are drawn around the origin, and moved to each item when drawn
+        if( instance )
+        {
+            m_gal->Save();
+            m_gal->Translate( -instanceOffset );
+        }
+
+        auto recording = m_recordings.find( { aItem, aLayer, false } );
 
-    if( !m_painter->Draw( aItem, aLayer ) )
-        aItem->ViewDraw( aLayer, this ); // Alternative drawing method
+        if( recording != m_recordings.end() )
+            RECORDING_GAL::Replay( recording->second, *m_gal );
+        else if( !m_painter->Draw( aItem, aLayer ) )
+            aItem->ViewDraw( aLayer, this ); // Alternative drawing method
+
+        if( instance )
+        {
+            m_gal->Restore();
+            m_instanceTemplates[instance] = { group, 1, instanceBBox };
+            viewData->setInstance( aLayer, instance, instanceOffset );
+        }
+
+        m_gal->EndGroup();
+    }
+
+    // Then the simplified drawing, if the painter has one
+    int lodGroup = viewData->getLODGroup( aLayer );
+
+    if( lodGroup >= 0 )
+    {
+        m_gal->DeleteGroup( lodGroup );
+        viewData->setLODGroup( aLayer, -1 );
+    }
+
+    double lodScale = m_painter->GetLODScale( aItem, aLayer );
+
+    if( lodScale <= 0.0 )
+        return;
+
+    lodGroup = m_gal->BeginGroup();
+    recording = m_recordings.find( { aItem, aLayer, true } );
+
+    bool drawn = recording != m_recordings.end();
+
+    if( drawn )
+        RECORDING_GAL::Replay( recording->second, *m_gal );
+    else
+        drawn = m_painter->DrawLOD( aItem, aLayer );
 
     m_gal->EndGroup();
+
+    if( drawn )
+        viewData->setLODGroup( aLayer, lodGroup, lodScale );
+    else
+        m_gal->DeleteGroup( lodGroup );
+}
+
+
+void VIEW::recordItemsConcurrently()
+{
+    // Below this, starting the workers costs more than it saves
+    const size_t MIN_CONCURRENT_DRAWS = 256;
+
+    std::vector<std::pair<VIEW_ITEM*, int>> draws;
+    int                                     layers[VIEW_MAX_LAYERS], layers_count;
+
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        VIEW_ITEM_DATA* viewData = item->viewPrivData();
+
+        if( !viewData )
+            continue;
+
+        if( !( viewData->m_requiredUpdate & ( INITIAL_ADD | GEOMETRY | LAYERS | REPAINT ) ) )
+            continue;
+
+        item->ViewGetLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            VECTOR2I offset;
+
+            // Shared drawings are mostly done once, it is not worth recording them
+            if( IsCached( layers[i] ) && m_painter->CanDrawConcurrently( item, layers[i] )
+                    && !instanceKey( item, layers[i], offset ) )
+            {
+                draws.emplace_back( item, layers[i] );
+            }
+        }
+    }
+
+    if( draws.size() < MIN_CONCURRENT_DRAWS )
+        return;
+
+    KI_TRACE_ZONE( "VIEW::recordItemsConcurrently", "view" );
+
+    PROF_TIMER   timer;
+    thread_pool& tp = GetKiCadThreadPool();
+    size_t       workers = std::max<size_t>( 1, tp.get_thread_count() );
+
+    std::vector<std::unique_ptr<RECORDING_GAL>> gals;
+    std::vector<std::unique_ptr<PAINTER>>       painters;
+
+    for( size_t ii = 0; ii < workers; ++ii )
+    {
+        gals.push_back( std::make_unique<RECORDING_GAL>( *m_gal ) );
+        painters.push_back( m_painter->Clone( gals.back().get() ) );
+
+        if( !painters.back() )
+            return;
+    }
+
+    // All layers of an item are drawn by the same worker, as painters may cache data (such as
+    // triangulations) in the items they draw
+    std::sort( draws.begin(), draws.end() );
+
+    std::vector<size_t> itemStarts;
+
+    for( size_t ii = 0; ii < draws.size(); ++ii )
+    {
+        if( ii == 0 || draws[ii].first != draws[ii - 1].first )
+            itemStarts.push_back( ii );
+    }
+
+    itemStarts.push_back( draws.size() );
+
+    std::vector<RECORDING_GAL::RECORDING> recordings( draws.size() );
+    std::vector<RECORDING_GAL::RECORDING> lodRecordings( draws.size() );
+    std::vector<char>                     drawn( draws.size(), false );
+    std::vector<char>                     lodDrawn( draws.size(), false );
+    std::atomic<size_t>                   nextItem( 0 );
+
+    auto recordItems =
+            [&]( size_t aWorker )
+            {
+                KI_TRACE_ZONE( "VIEW::recordItemsConcurrently worker", "painter" );
+
+                for( size_t item = nextItem++; item + 1 < itemStarts.size(); item = nextItem++ )
+                {
+                    for( size_t ii = itemStarts[item]; ii < itemStarts[item + 1]; ++ii )
+                    {
+                        PAINTER*   painter = painters[aWorker].get();
+                        VIEW_ITEM* drawItem = draws[ii].first;
+                        int        layer = draws[ii].second;
+
+                        drawn[ii] = painter->Draw( drawItem, layer );
+                        recordings[ii] = gals[aWorker]->TakeRecording();
+
+                        if( painter->GetLODScale( drawItem, layer ) > 0.0 )
+                        {
+                            lodDrawn[ii] = painter->DrawLOD( drawItem, layer );
+                            lodRecordings[ii] = gals[aWorker]->TakeRecording();
+                        }
+                    }
+                }
+            };
+
+    std::vector<std::future<void>> returns;
+
+    for( size_t ii = 0; ii < workers; ++ii )
+        returns.emplace_back( tp.submit( recordItems, ii ) );
+
+    for( std::future<void>& ret : returns )
+        ret.wait();
+
+    for( size_t ii = 0; ii < draws.size(); ++ii )
+    {
+        const auto& [item, layer] = draws[ii];
+
+        if( drawn[ii] )
+            m_recordings[{ item, layer, false }] = std::move( recordings[ii] );
+
+        if( lodDrawn[ii] )
+            m_recordings[{ item, layer, true }] = std::move( lodRecordings[ii] );
+    }
+
+    KI_TRACE( traceGalProfile,
+              wxS( "View update: %zu item layers drawn on %zu threads in %0.1f ms\n" ),
+              draws.size(), workers, timer.msecs() );
+}
+
+
+size_t VIEW::instanceKey( VIEW_ITEM* aItem, int aLayer, VECTOR2I& aOffset )
+{
+    size_t key = 0;
+
+    if( !m_gal->SupportsGroupInstancing()
+            || !m_painter->GetInstanceKey( aItem, aLayer, key, aOffset ) )
+    {
+        return 0;
+    }
+
+    hash_combine( key, aLayer );
+
+    // 0 means no instance
+    return key ? key : 1;
+}
+
+
+void VIEW::releaseGroup( VIEW_ITEM_DATA* aViewData, int aLayer )
+{
+    int    group = aViewData->getGroup( aLayer );
+    size_t instance = aViewData->getInstance( aLayer );
+
+    if( group < 0 )
+        return;
+
+    if( instance )
+    {
+        auto shared = m_instanceTemplates.find( instance );
+
+        // The group belongs to the last of the items sharing it
+        if( shared != m_instanceTemplates.end() && --shared->second.m_refCount == 0 )
+        {
+            m_gal->DeleteGroup( shared->second.m_group );
+            m_instanceTemplates.erase( shared );
+        }
+
+        aViewData->setInstance( aLayer, 0 );
+    }
+    else
+    {
+        m_gal->DeleteGroup( group );
+    }
+
+    aViewData->setGroup( aLayer, -1 );
 }
 
 
@@ -1340,6 +1817,7 @@ void VIEW::updateBbox( VIEW_ITEM* aItem )
     const BOX2I  new_bbox = aItem->ViewBBox();
     const BOX2I* old_bbox = &aItem->m_viewPrivData->m_bbox;
     aItem->m_viewPrivData->m_bbox = new_bbox;
+    m_queryVersion++;
 
     for( int i = 0; i < layers_count; ++i )
     {
@@ -1362,6 +1840,7 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Remove the item from previous layer set
     viewData->getLayers( layers, layers_count );
     const BOX2I* old_bbox = &aItem->m_viewPrivData->m_bbox;
+    m_queryVersion++;
 
     for( int i = 0; i < layers_count; ++i )
     {
@@ -1372,12 +1851,14 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
         if( IsCached( l.id ) )
         {
             // Redraw the item from scratch
-            int prevGroup = viewData->getGroup( layers[i] );
+            releaseGroup( viewData, layers[i] );
+
+            int prevGroup = viewData->getLODGroup( layers[i] );
 
             if( prevGroup >= 0 )
             {
                 m_gal->DeleteGroup( prevGroup );
-                viewData->setGroup( l.id, -1 );
+                viewData->setLODGroup( l.id, -1 );
             }
         }
     }
@@ -1437,6 +1918,8 @@ void VIEW::UpdateItems()
     if( !m_gal->IsVisible() || !m_gal->IsInitialized() )
         return;
 
+    KI_TRACE_ZONE( "VIEW::UpdateItems", "view" );
+
     unsigned int cntGeomUpdate = 0;
     bool         anyUpdated = false;
 
@@ -1470,6 +1953,8 @@ void VIEW::UpdateItems()
 
     if( ratio > 0.3 )
     {
+        KI_TRACE_ZONE( "VIEW::UpdateItems rebuild R-trees", "view" );
+
         auto allItems = *m_allItems;
         int  layers[VIEW_MAX_LAYERS], layers_count;
 
@@ -1477,6 +1962,8 @@ void VIEW::UpdateItems()
         for( VIEW_LAYER& layer : m_layers )
             layer.items->RemoveAll();
 
+        m_queryVersion++;
+
         // and re-insert items from scratch
         for( VIEW_ITEM* item : allItems )
         {
@@ -1503,6 +1990,8 @@ void VIEW::UpdateItems()
     {
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
+        recordItemsConcurrently();
+
         for( VIEW_ITEM* item : *m_allItems.get() )
         {
             if( item->viewPrivData() && item->viewPrivData()->m_requiredUpdate != NONE )
@@ -1511,6 +2000,8 @@ void VIEW::UpdateItems()
                 item->viewPrivData()->m_requiredUpdate = NONE;
             }
         }
+
+        m_recordings.clear();
     }
 
     KI_TRACE( traceGalProfile, wxS( "View update: total items %u, geom %u anyUpdated %u\n" ), cntTotal,
@@ -0,0 +1,262 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <view/view_query_cache.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include <core/thread_pool.h>
+#include <frame_tracer.h>
+
+
+namespace KIGFX
+{
+
+namespace
+{
+
+/// Hit tests are only shared between threads above this number of candidates.
+const size_t MIN_CONCURRENT_HIT_TESTS = 256;
+
+
+/// Box overlap test matching the one done by VIEW_RTREE, edges included.
+bool touches( const BOX2I& aA, const BOX2I& aB )
+{
+    return aA.GetX() <= aB.GetRight() && aB.GetX() <= aA.GetRight()
+           && aA.GetY() <= aB.GetBottom() && aB.GetY() <= aA.GetBottom();
+}
+
+
+bool covers( const BOX2I& aArea, const BOX2I& aRect )
+{
+    return aArea.GetX() <= aRect.GetX() && aRect.GetRight() <= aArea.GetRight()
+           && aArea.GetY() <= aRect.GetY() && aRect.GetBottom() <= aArea.GetBottom();
+}
+
+
+BOX2I corners( int aLeft, int aTop, int aRight, int aBottom )
+{
+    return BOX2I( VECTOR2I( aLeft, aTop ), VECTOR2I( aRight - aLeft, aBottom - aTop ) );
+}
+
+
+/// Tell if the neighborhood of \a aRect can be computed without overflowing coordinates.
+bool cacheable( const BOX2I& aRect )
+{
+    const int64_t limit = std::numeric_limits<int>::max() / 4;
+
+    return std::abs( (int64_t) aRect.GetX() ) < limit && std::abs( (int64_t) aRect.GetY() ) < limit
+           && std::abs( (int64_t) aRect.GetRight() ) < limit
+           && std::abs( (int64_t) aRect.GetBottom() ) < limit;
+}
+
+} // namespace
+
+
+VIEW_QUERY_CACHE::VIEW_QUERY_CACHE( const VIEW* aView ) :
+        m_view( aView ),
+        m_version( 0 ),
+        m_valid( false ),
+        m_reused( false ),
+        m_margin( 0 )
+{
+}
+
+
+void VIEW_QUERY_CACHE::Invalidate()
+{
+    m_valid = false;
+    m_layers.clear();
+    m_candidates.clear();
+}
+
+
+int VIEW_QUERY_CACHE::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult )
+{
+    BOX2I rect = aRect;
+    rect.Normalize();
+
+    if( !cacheable( rect ) )
+        return m_view->Query( aRect, aResult );
+
+    update( rect );
+
+    for( const CANDIDATE& candidate : m_candidates )
+    {
+        if( touches( candidate.m_bbox, rect ) )
+            aResult.emplace_back( candidate.m_item, candidate.m_layer );
+    }
+
+    return aResult.size();
+}
+
+
+int VIEW_QUERY_CACHE::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult,
+                             const HIT_TEST& aHitTest )
+{
+    KI_TRACE_ZONE( "VIEW_QUERY_CACHE::Query", "view" );
+
+    std::vector<LAYER_ITEM_PAIR> candidates;
+    Query( aRect, candidates );
+
+    FilterHits( candidates, aHitTest, aResult );
+
+    return aResult.size();
+}
+
+
+void VIEW_QUERY_CACHE::FilterHits( const std::vector<LAYER_ITEM_PAIR>& aCandidates,
+                                   const HIT_TEST& aHitTest,
+                                   std::vector<LAYER_ITEM_PAIR>& aResult )
+{
+    std::vector<char> hits( aCandidates.size(), false );
+
+    if( aCandidates.size() < MIN_CONCURRENT_HIT_TESTS )
+    {
+        for( size_t ii = 0; ii < aCandidates.size(); ++ii )
+            hits[ii] = aHitTest( aCandidates[ii].first, aCandidates[ii].second );
+    }
+    else
+    {
+        thread_pool& tp = GetKiCadThreadPool();
+
+        tp.parallelize_loop( 0, aCandidates.size(),
+                             [&]( size_t aStart, size_t aEnd )
+                             {
+                                 for( size_t ii = aStart; ii < aEnd; ++ii )
+                                 {
+                                     hits[ii] = aHitTest( aCandidates[ii].first,
+                                                          aCandidates[ii].second );
+                                 }
+                             } ).wait();
+    }
+
+    for( size_t ii = 0; ii < aCandidates.size(); ++ii )
+    {
+        if( hits[ii] )
+            aResult.push_back( aCandidates[ii] );
+    }
+}
+
+
+void VIEW_QUERY_CACHE::update( const BOX2I& aRect )
+{
+    int margin = std::max( m_margin, std::max( aRect.GetWidth(), aRect.GetHeight() ) );
+
+    if( !m_valid || m_version != m_view->GetQueryVersion() )
+    {
+        // If the dropped items were never used, the view changes between each query (for
+        // instance while items are dragged), so searching around the queried area is useless
+        if( m_valid && !m_reused )
+            margin = 0;
+
+        // The layer visibility is only checked once for all the queries made until the view
+        // changes
+        Invalidate();
+        m_layers = m_view->GetQueryLayers();
+        m_version = m_view->GetQueryVersion();
+    }
+    else if( covers( m_neighborhood, aRect ) )
+    {
+        m_reused = true;
+        return;
+    }
+
+    BOX2I area = aRect;
+    area.Inflate( margin );
+
+    if( m_valid && touches( m_neighborhood, area ) )
+    {
+        m_reused = true;
+
+        // Keep the items still in the new neighborhood, and only search the part of it that
+        // was not covered by the previous one
+        std::erase_if( m_candidates,
+                       [&]( const CANDIDATE& aCandidate )
+                       {
+                           return !touches( aCandidate.m_bbox, area );
+                       } );
+
+        std::set<std::pair<VIEW_ITEM*, int>> known;
+
+        for( const CANDIDATE& candidate : m_candidates )
+            known.emplace( candidate.m_item, candidate.m_layer );
+
+        // Part of the new neighborhood already covered by the previous one
+        const int left = std::max( area.GetX(), m_neighborhood.GetX() );
+        const int top = std::max( area.GetY(), m_neighborhood.GetY() );
+        const int right = std::min( area.GetRight(), m_neighborhood.GetRight() );
+        const int bottom = std::min( area.GetBottom(), m_neighborhood.GetBottom() );
+
+        if( area.GetY() < top )
+            search( corners( area.GetX(), area.GetY(), area.GetRight(), top - 1 ), &known );
+
+        if( bottom < area.GetBottom() )
+            search( corners( area.GetX(), bottom + 1, area.GetRight(), area.GetBottom() ), &known );
+
+        if( area.GetX() < left )
+            search( corners( area.GetX(), top, left - 1, bottom ), &known );
+
+        if( right < area.GetRight() )
+            search( corners( right + 1, top, area.GetRight(), bottom ), &known );
+
+        std::stable_sort( m_candidates.begin(), m_candidates.end(),
+                          []( const CANDIDATE& aLeft, const CANDIDATE& aRight )
+                          {
+                              return aLeft.m_rank < aRight.m_rank;
+                          } );
+    }
+    else
+    {
+        m_candidates.clear();
+        m_reused = false;
+        search( area, nullptr );
+    }
+
+    m_neighborhood = area;
+    m_valid = true;
+}
+
+
+void VIEW_QUERY_CACHE::search( const BOX2I& aArea, std::set<std::pair<VIEW_ITEM*, int>>* aKnown )
+{
+    std::vector<LAYER_ITEM_PAIR> found;
+
+    for( int rank = 0; rank < (int) m_layers.size(); ++rank )
+    {
+        found.clear();
+        m_view->Query( aArea, { m_layers[rank] }, found );
+
+        for( const auto& [item, layer] : found )
+        {
+            if( aKnown && !aKnown->emplace( item, layer ).second )
+                continue;
+
+            m_candidates.push_back( { item, layer, rank, item->ViewBBox() } );
+        }
+    }
+}
+
+} // namespace KIGFX
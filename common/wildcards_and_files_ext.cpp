@@ -127,6 +127,7 @@ const std::string FILEEXT::LockFilePrefix( "~" );
 const std::string FILEEXT::LockFileExtension( "lck" );
 
 const std::string FILEEXT::KiCadSymbolLibFileExtension( "kicad_sym" );
+const std::string FILEEXT::KiCadSymbolLibIndexFileExtension( "kicad_sym_index" );
 const std::string FILEEXT::SchematicSymbolFileExtension( "sym" );
 const std::string FILEEXT::LegacySymbolLibFileExtension( "lib" );
 const std::string FILEEXT::LegacySymbolDocumentFileExtension( "dcm" );
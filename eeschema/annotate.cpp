@@ -22,6 +22,7 @@
  */
 
 #include <algorithm>
+#include <unordered_set>
 
 #include <confirm.h>
 #include <reporter.h>
@@ -330,12 +331,17 @@ void SCH_EDIT_FRAME::AnnotateSymbols( SCH_COMMIT* aCommit, ANNOTATE_SCOPE_T  aAn
 
     if( aAnnotateScope != ANNOTATE_ALL )
     {
-        SCH_REFERENCE_LIST allRefs;
+        SCH_REFERENCE_LIST           allRefs;
+        std::unordered_set<wxString> annotatedPaths;
+
         sheets.GetSymbols( allRefs );
 
+        for( const SCH_REFERENCE& ref : references )
+            annotatedPaths.insert( ref.GetFullPath() );
+
         for( size_t i = 0; i < allRefs.GetCount(); i++ )
         {
-            if( !references.Contains( allRefs[i] ) )
+            if( !annotatedPaths.count( allRefs[i].GetFullPath() ) )
                 additionalRefs.AddItem( allRefs[i] );
         }
     }
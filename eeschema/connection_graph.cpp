@@ -27,12 +27,14 @@
 #include <core/profile.h>
 #include <core/kicad_algo.h>
 #include <common.h>
+#include <frame_tracer.h>
 #include <core/kicad_algo.h>
 #include <erc.h>
 #include <pin_type.h>
 #include <sch_bus_entry.h>
 #include <sch_symbol.h>
 #include <sch_edit_frame.h>
+#include <sch_label.h>
 #include <sch_line.h>
 #include <sch_marker.h>
 #include <sch_pin.h>
@@ -66,6 +68,64 @@ static const wxChar DanglingProfileMask[] = wxT( "CONN_PROFILE" );
 static const wxChar ConnTrace[] = wxT( "CONN" );
 
 
+/**
+ * Return the key of the name through which \a aItem connects on \a aSheet other than by wires,
+ * as used by CONNECTION_GRAPH::m_name_dependencies, or an empty string if it has none.
+ */
+static wxString nameDependencyKey( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet )
+{
+    switch( aItem->Type() )
+    {
+    case SCH_GLOBAL_LABEL_T:
+    {
+        SCH_LABEL_BASE* label = static_cast<SCH_LABEL_BASE*>( aItem );
+
+        return wxT( "G/" ) + EscapeString( label->GetShownText( &aSheet, false ), CTX_NETNAME );
+    }
+
+    case SCH_LABEL_T:
+    case SCH_HIER_LABEL_T:
+    {
+        SCH_LABEL_BASE* label = static_cast<SCH_LABEL_BASE*>( aItem );
+        wxString        scope = aItem->Type() == SCH_LABEL_T ? wxT( "L/" ) : wxT( "H/" );
+
+        return aSheet.PathAsString() + scope
+                    + EscapeString( label->GetShownText( &aSheet, false ), CTX_NETNAME );
+    }
+
+    case SCH_SHEET_PIN_T:
+    {
+        // Sheet pins depend on the hierarchical labels inside their sheet
+        SCH_SHEET_PIN* sheetPin = static_cast<SCH_SHEET_PIN*>( aItem );
+        SCH_SHEET_PATH path = aSheet;
+
+        if( path.Last() != sheetPin->GetParent() )
+            path.push_back( sheetPin->GetParent() );
+
+        return path.PathAsString() + wxT( "H/" )
+                    + EscapeString( sheetPin->GetShownText( &path, false ), CTX_NETNAME );
+    }
+
+    case SCH_PIN_T:
+    {
+        SCH_PIN* pin = static_cast<SCH_PIN*>( aItem );
+
+        if( !pin->IsGlobalPower() )
+            return wxEmptyString;
+
+        // Same names as generateGlobalPowerPinSubGraphs()
+        if( pin->GetLibPin()->GetParentSymbol()->IsPower() )
+            return wxT( "G/" ) + pin->GetParentSymbol()->GetValue( true, &aSheet, false );
+
+        return wxT( "G/" ) + pin->GetShownName();
+    }
+
+    default:
+        return wxEmptyString;
+    }
+}
+
+
 void CONNECTION_SUBGRAPH::RemoveItem( SCH_ITEM* aItem )
 {
     m_items.erase( aItem );
@@ -573,6 +633,12 @@ void CONNECTION_GRAPH::Merge( CONNECTION_GRAPH& aGraph )
     for( auto& [key, value] : aGraph.m_global_label_cache )
         m_global_label_cache.insert_or_assign( key, value );
 
+    for( auto& [key, value] : aGraph.m_name_dependencies )
+    {
+        std::vector<CONNECTION_SUBGRAPH*>& dependents = m_name_dependencies[key];
+        dependents.insert( dependents.end(), value.begin(), value.end() );
+    }
+
     m_last_bus_code = std::max( m_last_bus_code, aGraph.m_last_bus_code );
     m_last_net_code = std::max( m_last_net_code, aGraph.m_last_net_code );
     m_last_subgraph_code = std::max( m_last_subgraph_code, aGraph.m_last_subgraph_code );
@@ -602,6 +668,7 @@ void CONNECTION_GRAPH::Reset()
     m_item_to_subgraph_map.clear();
     m_local_label_cache.clear();
     m_global_label_cache.clear();
+    m_name_dependencies.clear();
     m_last_net_code = 1;
     m_last_bus_code = 1;
     m_last_subgraph_code = 1;
@@ -611,6 +678,8 @@ void CONNECTION_GRAPH::Reset()
 void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnconditional,
                                     std::function<void( SCH_ITEM* )>* aChangedItemHandler )
 {
+    KI_TRACE_ZONE( "CONNECTION_GRAPH::Recalculate", "connectivity" );
+
     PROF_TIMER recalc_time( "CONNECTION_GRAPH::Recalculate" );
 
     if( aUnconditional )
@@ -731,38 +800,28 @@ std::set<std::pair<SCH_SHEET_PATH, SCH_ITEM*>> CONNECTION_GRAPH::ExtractAffected
         aSubgraph->getAllConnectedItems( retvals, subgraphs );
     };
 
-    auto extract_element = [&]( SCH_ITEM* aItem )
-    {
-        CONNECTION_SUBGRAPH* item_sg = GetSubgraphForItem( aItem );
+    std::set<CONNECTION_SUBGRAPH*> scanned;
 
-        if( !item_sg )
-        {
-            wxLogTrace( ConnTrace, wxT( "Item %s not found in connection graph" ), aItem->GetTypeDesc() );
+    auto scan_net = [&]( CONNECTION_SUBGRAPH* aSubgraph )
+    {
+        if( !scanned.insert( aSubgraph ).second )
             return;
-        }
-        if( !item_sg->ResolveDrivers( true ) )
-        {
-            wxLogTrace( ConnTrace, wxT( "Item %s in subgraph %ld (%p) has no driver" ),
-                        aItem->GetTypeDesc(), item_sg->m_code, item_sg );
-        }
 
-        std::vector<CONNECTION_SUBGRAPH*> sg_to_scan = GetAllSubgraphs( item_sg->GetNetName() );
+        std::vector<CONNECTION_SUBGRAPH*> sg_to_scan = GetAllSubgraphs( aSubgraph->GetNetName() );
 
         if( sg_to_scan.empty() )
         {
-            wxLogTrace( ConnTrace, wxT( "Item %s in subgraph %ld with net %s has no neighbors" ),
-                        aItem->GetTypeDesc(), item_sg->m_code, item_sg->GetNetName() );
-            sg_to_scan.push_back( item_sg );
+            wxLogTrace( ConnTrace, wxT( "Subgraph %ld with net %s has no neighbors" ),
+                        aSubgraph->m_code, aSubgraph->GetNetName() );
+            sg_to_scan.push_back( aSubgraph );
         }
 
         wxLogTrace( ConnTrace,
-                    wxT( "Removing all item %s connections from subgraph %ld with net %s: Found "
+                    wxT( "Removing all connections from subgraph %ld with net %s: Found "
                          "%zu subgraphs" ),
-                    aItem->GetTypeDesc(), item_sg->m_code, item_sg->GetNetName(),
-                    sg_to_scan.size() );
+                    aSubgraph->m_code, aSubgraph->GetNetName(), sg_to_scan.size() );
 
         for( CONNECTION_SUBGRAPH* sg : sg_to_scan )
-
         {
             traverse_subgraph( sg );
 
@@ -778,6 +837,53 @@ std::set<std::pair<SCH_SHEET_PATH, SCH_ITEM*>> CONNECTION_GRAPH::ExtractAffected
                     traverse_subgraph( bus_sg );
             }
         }
+    };
+
+    // The names an item has now may not be the ones it had when the graph was built (or the
+    // item may be new), so the nets it joins by name must be recalculated too.
+    auto scan_name_dependents = [&]( SCH_ITEM* aItem )
+    {
+        EDA_ITEM* parent = aItem->GetParent();
+
+        while( parent && parent->Type() != SCH_SCREEN_T )
+            parent = parent->GetParent();
+
+        if( !parent )
+            return;
+
+        for( const SCH_SHEET_PATH& sheet : static_cast<SCH_SCREEN*>( parent )->GetClientSheetPaths() )
+        {
+            auto it = m_name_dependencies.find( nameDependencyKey( aItem, sheet ) );
+
+            if( it == m_name_dependencies.end() )
+                continue;
+
+            wxLogTrace( ConnTrace, wxT( "Item %s depends on %zu subgraphs named %s" ),
+                        aItem->GetTypeDesc(), it->second.size(), it->first );
+
+            for( CONNECTION_SUBGRAPH* sg : it->second )
+                scan_net( sg );
+        }
+    };
+
+    auto extract_element = [&]( SCH_ITEM* aItem )
+    {
+        scan_name_dependents( aItem );
+
+        CONNECTION_SUBGRAPH* item_sg = GetSubgraphForItem( aItem );
+
+        if( !item_sg )
+        {
+            wxLogTrace( ConnTrace, wxT( "Item %s not found in connection graph" ), aItem->GetTypeDesc() );
+            return;
+        }
+        if( !item_sg->ResolveDrivers( true ) )
+        {
+            wxLogTrace( ConnTrace, wxT( "Item %s in subgraph %ld (%p) has no driver" ),
+                        aItem->GetTypeDesc(), item_sg->m_code, item_sg );
+        }
+
+        scan_net( item_sg );
 
         alg::delete_matching( m_items, aItem );
     };
@@ -828,6 +934,94 @@ void CONNECTION_GRAPH::RemoveItem( SCH_ITEM* aItem )
 }
 
 
+int CONNECTION_GRAPH::VerifyIncremental( const SCH_SHEET_LIST& aSheetList,
+                                         std::function<void( SCH_ITEM* )>* aChangedItemHandler )
+{
+    // Net name and net code (0 for buses) of each item on each sheet
+    typedef std::map<std::pair<SCH_SHEET_PATH, SCH_ITEM*>, std::pair<wxString, int>> ITEM_NETS;
+
+    auto collectNets =
+            [&]() -> ITEM_NETS
+            {
+                ITEM_NETS nets;
+
+                auto addItem =
+                        [&]( const SCH_SHEET_PATH& aSheet, SCH_ITEM* aItem )
+                        {
+                            if( SCH_CONNECTION* conn = aItem->Connection( &aSheet ) )
+                            {
+                                nets[{ aSheet, aItem }] = { conn->Name(),
+                                                            conn->IsBus() ? 0 : conn->NetCode() };
+                            }
+                        };
+
+                for( const SCH_SHEET_PATH& sheet : aSheetList )
+                {
+                    for( SCH_ITEM* item : sheet.LastScreen()->Items() )
+                    {
+                        if( !item->IsConnectable() )
+                            continue;
+
+                        if( item->Type() == SCH_SYMBOL_T )
+                        {
+                            for( SCH_PIN* pin : static_cast<SCH_SYMBOL*>( item )->GetPins( &sheet ) )
+                                addItem( sheet, pin );
+                        }
+                        else if( item->Type() == SCH_SHEET_T )
+                        {
+                            for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+                                addItem( sheet, pin );
+                        }
+                        else
+                        {
+                            addItem( sheet, item );
+                        }
+                    }
+                }
+
+                return nets;
+            };
+
+    ITEM_NETS incremental = collectNets();
+
+    Recalculate( aSheetList, true, aChangedItemHandler );
+
+    ITEM_NETS      full = collectNets();
+    UNITS_PROVIDER unitsProvider( schIUScale, EDA_UNITS::MILLIMETRES );
+    int            mismatches = 0;
+
+    // Net codes differ between both graphs, but must split the items in the same nets
+    std::map<int, int> incrementalToFull;
+    std::map<int, int> fullToIncremental;
+
+    for( const auto& [ sheetItem, net ] : full )
+    {
+        auto     it = incremental.find( sheetItem );
+        wxString name = it != incremental.end() ? it->second.first : wxString();
+        int      code = it != incremental.end() ? it->second.second : 0;
+        bool     match = name == net.first;
+
+        if( match && code > 0 && net.second > 0 )
+        {
+            match = incrementalToFull.emplace( code, net.second ).first->second == net.second
+                    && fullToIncremental.emplace( net.second, code ).first->second == code;
+        }
+
+        if( !match )
+        {
+            wxLogTrace( ConnTrace,
+                        wxT( "Incremental connectivity mismatch: %s on %s is on net %s (%d) "
+                             "instead of %s (%d)" ),
+                        sheetItem.second->GetItemDescription( &unitsProvider ),
+                        sheetItem.first.PathHumanReadable(), name, code, net.first, net.second );
+            mismatches++;
+        }
+    }
+
+    return mismatches;
+}
+
+
 void CONNECTION_GRAPH::removeSubgraphs( std::set<CONNECTION_SUBGRAPH*>& aSubgraphs )
 {
     wxLogTrace( ConnTrace, wxT( "Removing %zu subgraphs" ), aSubgraphs.size() );
@@ -977,6 +1171,20 @@ void CONNECTION_GRAPH::removeSubgraphs( std::set<CONNECTION_SUBGRAPH*>& aSubgrap
             ++it;
     }
 
+    for( auto it = m_name_dependencies.begin(); it != m_name_dependencies.end(); )
+    {
+        alg::delete_if( it->second,
+                        [&]( CONNECTION_SUBGRAPH* sg )
+                        {
+                            return aSubgraphs.count( sg ) > 0;
+                        } );
+
+        if( it->second.empty() )
+            it = m_name_dependencies.erase( it );
+        else
+            ++it;
+    }
+
     for( CONNECTION_SUBGRAPH* sg : aSubgraphs )
     {
         sg->m_code = -1;
@@ -989,6 +1197,8 @@ void CONNECTION_GRAPH::removeSubgraphs( std::set<CONNECTION_SUBGRAPH*>& aSubgrap
 void CONNECTION_GRAPH::updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
                                                const std::vector<SCH_ITEM*>& aItemList )
 {
+    KI_TRACE_ZONE( "CONNECTION_GRAPH::updateItemConnectivity", "connectivity" );
+
     wxLogTrace( wxT( "Updating connectivity for sheet %s with %zu items" ),
                 aSheet.Last()->GetFileName(), aItemList.size() );
     std::map<VECTOR2I, std::vector<SCH_ITEM*>> connection_map;
@@ -1440,6 +1650,26 @@ void CONNECTION_GRAPH::collectAllDriverValues()
 }
 
 
+void CONNECTION_GRAPH::collectNameDependencies()
+{
+    m_name_dependencies.clear();
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+    {
+        if( subgraph->m_absorbed )
+            continue;
+
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            wxString key = nameDependencyKey( item, subgraph->m_sheet );
+
+            if( !key.IsEmpty() )
+                m_name_dependencies[key].push_back( subgraph );
+        }
+    }
+}
+
+
 void CONNECTION_GRAPH::generateBusAliasMembers()
 {
     std::vector<CONNECTION_SUBGRAPH*> new_subgraphs;
@@ -1571,15 +1801,46 @@ void CONNECTION_GRAPH::processSubGraphs()
 {
     // Here we do all the local (sheet) processing of each subgraph, including assigning net
     // codes, merging subgraphs together that use label connections, etc.
+    //
+    // Subgraphs are only merged with subgraphs of the same sheet, so the merging is done for all
+    // sheets in parallel.  The naming of weakly driven subgraphs and the net codes depend on the
+    // other sheets; they are handled serially before and after the merging, in the order of
+    // m_driver_subgraphs, giving the same results as processing each subgraph in turn.
+
+    const size_t count = m_driver_subgraphs.size();
+
+    // Indices in m_driver_subgraphs of the subgraphs of each sheet
+    std::vector<std::vector<size_t>> sheetGroups;
+    std::unordered_map<SCH_SHEET_PATH, size_t> sheetGroupIndex;
 
     // Cache remaining valid subgraphs by sheet path
-    for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
+    for( size_t ii = 0; ii < count; ++ii )
+    {
+        CONNECTION_SUBGRAPH* subgraph = m_driver_subgraphs[ii];
+
         m_sheet_to_subgraphs_map[ subgraph->m_sheet ].emplace_back( subgraph );
 
-    std::unordered_set<CONNECTION_SUBGRAPH*> invalidated_subgraphs;
+        auto [it, added] = sheetGroupIndex.emplace( subgraph->m_sheet, sheetGroups.size() );
 
-    for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
+        if( added )
+            sheetGroups.emplace_back();
+
+        sheetGroups[ it->second ].push_back( ii );
+    }
+
+    // Name and connection of each subgraph before merging
+    std::vector<wxString>        names( count );
+    std::vector<SCH_CONNECTION*> connections( count );
+
+    // Weakly driven subgraphs which will be promoted to strong drivers when their turn comes
+    std::unordered_set<CONNECTION_SUBGRAPH*> promoted;
+
+    for( size_t ii = 0; ii < count; ++ii )
     {
+        CONNECTION_SUBGRAPH* subgraph = m_driver_subgraphs[ii];
+
+        // A subgraph can only be absorbed by the merging below once it has a strong driver, so
+        // the weakly driven ones handled here are still valid when their turn comes
         if( subgraph->m_absorbed )
             continue;
 
@@ -1703,202 +1964,272 @@ void CONNECTION_GRAPH::processSubGraphs()
                                     subgraph->m_code, name,
                                     subgraph->m_driver->GetItemDescription( &unitsProvider ) );
 
-                        subgraph->m_strong_driver = true;
+                        promoted.insert( subgraph );
                     }
                 }
             }
         }
 
-        // Assign net codes
-        if( connection->IsBus() )
-        {
-            int  code = -1;
-            auto it   = m_bus_name_to_code_map.find( name );
-
-            if( it != m_bus_name_to_code_map.end() )
-            {
-                code = it->second;
-            }
-            else
-            {
-                code = m_last_bus_code++;
-                m_bus_name_to_code_map[ name ] = code;
-            }
-
-            connection->SetBusCode( code );
-            assignNetCodesToBus( connection );
-        }
-        else
-        {
-            assignNewNetCode( *connection );
-        }
+        names[ii] = name;
+        connections[ii] = connection;
+    }
 
-        // Reset the flag for the next loop below
-        subgraph->m_dirty = true;
+    // Whether each subgraph was still valid when its turn came in the merging
+    std::vector<char> processed( count, 0 );
 
-        // Next, we merge together subgraphs that have label connections, and create
-        // neighbor links for subgraphs that are part of a bus on the same sheet.
-        // For merging, we consider each possible strong driver.
+    // Indices of the subgraphs of each sheet which absorbed others
+    std::vector<std::vector<size_t>> invalidated( sheetGroups.size() );
 
-        // If this subgraph doesn't have a strong driver, let's skip it, since there is no
-        // way it will be merged with anything.
-        if( !subgraph->m_strong_driver )
-            continue;
+    auto mergeSheetSubgraphs =
+            [&]( size_t aGroup )
+            {
+                const std::vector<size_t>&               group = sheetGroups[aGroup];
+                const std::vector<CONNECTION_SUBGRAPH*>& sheetSubgraphs =
+                        m_sheet_to_subgraphs_map.at( m_driver_subgraphs[group[0]]->m_sheet );
 
-        // candidate_subgraphs will contain each valid, non-bus subgraph on the same sheet
-        // as the subgraph we are considering that has a strong driver.
-        // Weakly driven subgraphs are not considered since they will never be absorbed or
-        // form neighbor links.
-        std::vector<CONNECTION_SUBGRAPH*> candidate_subgraphs;
-        std::copy_if( m_sheet_to_subgraphs_map[ subgraph->m_sheet ].begin(),
-                      m_sheet_to_subgraphs_map[ subgraph->m_sheet ].end(),
-                      std::back_inserter( candidate_subgraphs ),
-                      [&] ( const CONNECTION_SUBGRAPH* candidate )
-                      {
-                          return ( !candidate->m_absorbed &&
-                                   candidate->m_strong_driver &&
-                                   candidate != subgraph );
-                      } );
-
-        // This is a list of connections on the current subgraph to compare to the
-        // drivers of each candidate subgraph.  If the current subgraph is a bus,
-        // we should consider each bus member.
-        std::vector< std::shared_ptr<SCH_CONNECTION> > connections_to_check;
-
-        // Also check the main driving connection
-        connections_to_check.push_back( std::make_shared<SCH_CONNECTION>( *connection ) );
-
-        auto add_connections_to_check =
-                [&] ( CONNECTION_SUBGRAPH* aSubgraph )
+                for( size_t ii : group )
                 {
-                    for( SCH_ITEM* possible_driver : aSubgraph->m_items )
-                    {
-                        if( possible_driver == aSubgraph->m_driver )
-                            continue;
-
-                        auto c = getDefaultConnection( possible_driver, aSubgraph );
-
-                        if( c )
-                        {
-                            if( c->Type() != aSubgraph->m_driver_connection->Type() )
-                                continue;
+                    CONNECTION_SUBGRAPH* subgraph = m_driver_subgraphs[ii];
 
-                            if( c->Name( true ) == aSubgraph->m_driver_connection->Name( true ) )
-                                continue;
-
-                            connections_to_check.push_back( c );
-                            wxLogTrace( ConnTrace,
-                                        wxS( "%lu (%s): Adding secondary driver %s" ),
-                                        aSubgraph->m_code,
-                                        aSubgraph->m_driver_connection->Name( true ),
-                                        c->Name( true ) );
-                        }
-                    }
-                };
-
-        // Now add other strong drivers
-        // The actual connection attached to these items will have been overwritten
-        // by the chosen driver of the subgraph, so we need to create a dummy connection
-        add_connections_to_check( subgraph );
-
-        std::set<SCH_CONNECTION*> checked_connections;
-
-        for( unsigned i = 0; i < connections_to_check.size(); i++ )
-        {
-            auto member = connections_to_check[i];
+                    if( subgraph->m_absorbed )
+                        continue;
 
-            // Don't check the same connection twice
-            if( !checked_connections.insert( member.get() ).second )
-                continue;
+                    processed[ii] = 1;
 
-            if( member->IsBus() )
-            {
-                connections_to_check.insert( connections_to_check.end(),
-                                             member->Members().begin(),
-                                             member->Members().end() );
-            }
+                    if( promoted.count( subgraph ) )
+                        subgraph->m_strong_driver = true;
 
-            wxString test_name = member->Name( true );
+                    SCH_CONNECTION*       connection = connections[ii];
+                    const SCH_SHEET_PATH& sheet = subgraph->m_sheet;
 
-            for( CONNECTION_SUBGRAPH* candidate : candidate_subgraphs )
-            {
-                if( candidate->m_absorbed || candidate == subgraph )
-                    continue;
+                    // Reset the flag for the next loop below
+                    subgraph->m_dirty = true;
 
-                bool match = false;
+                    // Next, we merge together subgraphs that have label connections, and create
+                    // neighbor links for subgraphs that are part of a bus on the same sheet.
+                    // For merging, we consider each possible strong driver.
 
-                if( candidate->m_driver_connection->Name( true ) == test_name )
-                {
-                    match = true;
-                }
-                else
-                {
-                    if( !candidate->m_multiple_drivers )
+                    // If this subgraph doesn't have a strong driver, let's skip it, since there
+                    // is no way it will be merged with anything.
+                    if( !subgraph->m_strong_driver )
                         continue;
 
-                    for( SCH_ITEM *driver : candidate->m_drivers )
+                    // candidate_subgraphs will contain each valid, non-bus subgraph on the same
+                    // sheet as the subgraph we are considering that has a strong driver.
+                    // Weakly driven subgraphs are not considered since they will never be
+                    // absorbed or form neighbor links.
+                    std::vector<CONNECTION_SUBGRAPH*> candidate_subgraphs;
+                    std::copy_if( sheetSubgraphs.begin(), sheetSubgraphs.end(),
+                                  std::back_inserter( candidate_subgraphs ),
+                                  [&] ( const CONNECTION_SUBGRAPH* candidate )
+                                  {
+                                      return ( !candidate->m_absorbed &&
+                                               candidate->m_strong_driver &&
+                                               candidate != subgraph );
+                                  } );
+
+                    // This is a list of connections on the current subgraph to compare to the
+                    // drivers of each candidate subgraph.  If the current subgraph is a bus,
+                    // we should consider each bus member.
+                    std::vector< std::shared_ptr<SCH_CONNECTION> > connections_to_check;
+
+                    // Also check the main driving connection.  It is only used to match names,
+                    // so it doesn't need the net codes assigned below.
+                    connections_to_check.push_back(
+                            std::make_shared<SCH_CONNECTION>( *connection ) );
+
+                    auto add_connections_to_check =
+                            [&] ( CONNECTION_SUBGRAPH* aSubgraph )
+                            {
+                                for( SCH_ITEM* possible_driver : aSubgraph->m_items )
+                                {
+                                    if( possible_driver == aSubgraph->m_driver )
+                                        continue;
+
+                                    auto c = getDefaultConnection( possible_driver, aSubgraph );
+
+                                    if( c )
+                                    {
+                                        if( c->Type() != aSubgraph->m_driver_connection->Type() )
+                                            continue;
+
+                                        const SCH_CONNECTION* driverConn =
+                                                aSubgraph->m_driver_connection;
+
+                                        if( c->Name( true ) == driverConn->Name( true ) )
+                                            continue;
+
+                                        connections_to_check.push_back( c );
+                                        wxLogTrace( ConnTrace,
+                                                    wxS( "%lu (%s): Adding secondary driver %s" ),
+                                                    aSubgraph->m_code,
+                                                    aSubgraph->m_driver_connection->Name( true ),
+                                                    c->Name( true ) );
+                                    }
+                                }
+                            };
+
+                    // Now add other strong drivers
+                    // The actual connection attached to these items will have been overwritten
+                    // by the chosen driver of the subgraph, so we need to create a dummy connection
+                    add_connections_to_check( subgraph );
+
+                    std::set<SCH_CONNECTION*> checked_connections;
+
+                    for( unsigned i = 0; i < connections_to_check.size(); i++ )
                     {
-                        if( driver == candidate->m_driver )
-                            continue;
+                        auto member = connections_to_check[i];
 
-                        // Sheet pins are not candidates for merging
-                        if( driver->Type() == SCH_SHEET_PIN_T )
+                        // Don't check the same connection twice
+                        if( !checked_connections.insert( member.get() ).second )
                             continue;
 
-                        if( driver->Type() == SCH_PIN_T )
+                        if( member->IsBus() )
                         {
-                            auto pin = static_cast<SCH_PIN*>( driver );
+                            connections_to_check.insert( connections_to_check.end(),
+                                                         member->Members().begin(),
+                                                         member->Members().end() );
+                        }
 
-                            if( pin->IsGlobalPower()
-                                && pin->GetDefaultNetName( sheet ) == test_name )
+                        wxString test_name = member->Name( true );
+
+                        for( CONNECTION_SUBGRAPH* candidate : candidate_subgraphs )
+                        {
+                            if( candidate->m_absorbed || candidate == subgraph )
+                                continue;
+
+                            bool match = false;
+
+                            if( candidate->m_driver_connection->Name( true ) == test_name )
                             {
                                 match = true;
-                                break;
                             }
-                        }
-                        else
-                        {
-                            wxASSERT( driver->Type() == SCH_LABEL_T ||
-                                      driver->Type() == SCH_GLOBAL_LABEL_T ||
-                                      driver->Type() == SCH_HIER_LABEL_T );
+                            else
+                            {
+                                if( !candidate->m_multiple_drivers )
+                                    continue;
+
+                                for( SCH_ITEM *driver : candidate->m_drivers )
+                                {
+                                    if( driver == candidate->m_driver )
+                                        continue;
+
+                                    // Sheet pins are not candidates for merging
+                                    if( driver->Type() == SCH_SHEET_PIN_T )
+                                        continue;
+
+                                    if( driver->Type() == SCH_PIN_T )
+                                    {
+                                        auto pin = static_cast<SCH_PIN*>( driver );
+
+                                        if( pin->IsGlobalPower()
+                                            && pin->GetDefaultNetName( sheet ) == test_name )
+                                        {
+                                            match = true;
+                                            break;
+                                        }
+                                    }
+                                    else
+                                    {
+                                        wxASSERT( driver->Type() == SCH_LABEL_T ||
+                                                  driver->Type() == SCH_GLOBAL_LABEL_T ||
+                                                  driver->Type() == SCH_HIER_LABEL_T );
+
+                                        if( subgraph->GetNameForDriver( driver ) == test_name )
+                                        {
+                                            match = true;
+                                            break;
+                                        }
+                                    }
+                                }
+                            }
 
-                            if( subgraph->GetNameForDriver( driver )  == test_name )
+                            if( match )
                             {
-                                match = true;
-                                break;
+                                if( connection->IsBus() && candidate->m_driver_connection->IsNet() )
+                                {
+                                    wxLogTrace( ConnTrace, wxS( "%lu (%s) has bus child %lu (%s)" ),
+                                                subgraph->m_code, connection->Name(),
+                                                candidate->m_code, member->Name() );
+
+                                    subgraph->m_bus_neighbors[member].insert( candidate );
+                                    candidate->m_bus_parents[member].insert( subgraph );
+                                }
+                                else if( connection->Type()
+                                         == candidate->m_driver_connection->Type() )
+                                {
+                                    wxLogTrace( ConnTrace,
+                                                wxS( "%lu (%s) absorbs neighbor %lu (%s)" ),
+                                                subgraph->m_code, connection->Name(),
+                                                candidate->m_code,
+                                                candidate->m_driver_connection->Name() );
+
+                                    // Candidate may have other non-chosen drivers we need to follow
+                                    add_connections_to_check( candidate );
+
+                                    subgraph->Absorb( candidate );
+                                    invalidated[aGroup].push_back( ii );
+                                }
                             }
                         }
                     }
                 }
+            };
 
-                if( match )
-                {
-                    if( connection->IsBus() && candidate->m_driver_connection->IsNet() )
-                    {
-                         wxLogTrace( ConnTrace, wxS( "%lu (%s) has bus child %lu (%s)" ),
-                                     subgraph->m_code, connection->Name(),
-                                     candidate->m_code, member->Name() );
+    thread_pool& tp = GetKiCadThreadPool();
 
-                        subgraph->m_bus_neighbors[member].insert( candidate );
-                        candidate->m_bus_parents[member].insert( subgraph );
-                    }
-                    else if( connection->Type() == candidate->m_driver_connection->Type() )
-                    {
-                        wxLogTrace( ConnTrace, wxS( "%lu (%s) absorbs neighbor %lu (%s)" ),
-                                    subgraph->m_code, connection->Name(),
-                                    candidate->m_code, candidate->m_driver_connection->Name() );
+    tp.push_loop( sheetGroups.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                    mergeSheetSubgraphs( ii );
+            } );
+    tp.wait_for_tasks();
 
-                        // Candidate may have other non-chosen drivers we need to follow
-                        add_connections_to_check( candidate );
+    // Assign net codes, in the order the subgraphs would have been processed serially
+    for( size_t ii = 0; ii < count; ++ii )
+    {
+        if( !processed[ii] )
+            continue;
 
-                        subgraph->Absorb( candidate );
-                        invalidated_subgraphs.insert( subgraph );
-                    }
-                }
+        SCH_CONNECTION* connection = connections[ii];
+
+        if( connection->IsBus() )
+        {
+            int  code = -1;
+            auto it   = m_bus_name_to_code_map.find( names[ii] );
+
+            if( it != m_bus_name_to_code_map.end() )
+            {
+                code = it->second;
             }
+            else
+            {
+                code = m_last_bus_code++;
+                m_bus_name_to_code_map[ names[ii] ] = code;
+            }
+
+            connection->SetBusCode( code );
+            assignNetCodesToBus( connection );
+        }
+        else
+        {
+            assignNewNetCode( *connection );
         }
     }
 
+    std::vector<size_t> invalidatedIndices;
+
+    for( const std::vector<size_t>& group : invalidated )
+        invalidatedIndices.insert( invalidatedIndices.end(), group.begin(), group.end() );
+
+    std::sort( invalidatedIndices.begin(), invalidatedIndices.end() );
+
+    std::unordered_set<CONNECTION_SUBGRAPH*> invalidated_subgraphs;
+
+    for( size_t ii : invalidatedIndices )
+        invalidated_subgraphs.insert( m_driver_subgraphs[ii] );
+
     // Update any subgraph that was invalidated above
     for( CONNECTION_SUBGRAPH* subgraph : invalidated_subgraphs )
     {
@@ -1934,6 +2265,8 @@ void CONNECTION_GRAPH::processSubGraphs()
 
 void CONNECTION_GRAPH::buildConnectionGraph( std::function<void( SCH_ITEM* )>* aChangedItemHandler, bool aUnconditional )
 {
+    KI_TRACE_ZONE( "CONNECTION_GRAPH::buildConnectionGraph", "connectivity" );
+
     // Recache all bus aliases for later use
     wxCHECK_RET( m_schematic, wxT( "Connection graph cannot be built without schematic pointer" ) );
 
@@ -1992,6 +2325,8 @@ void CONNECTION_GRAPH::buildConnectionGraph( std::function<void( SCH_ITEM* )>* a
     for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
         m_sheet_to_subgraphs_map[ subgraph->m_sheet ].emplace_back( subgraph );
 
+    collectHierarchicalLinks();
+
     thread_pool& tp = GetKiCadThreadPool();
 
     tp.push_loop( m_driver_subgraphs.size(),
@@ -2218,6 +2553,8 @@ void CONNECTION_GRAPH::buildConnectionGraph( std::function<void( SCH_ITEM* )>* a
         m_net_name_to_subgraphs_map[subgraph->m_driver_connection->Name()].push_back( subgraph );
     }
 
+    collectNameDependencies();
+
     std::shared_ptr<NET_SETTINGS>& netSettings = m_schematic->Prj().GetProjectFile().m_NetSettings;
     std::map<wxString, wxString>   oldAssignments = netSettings->m_NetClassLabelAssignments;
 
@@ -2352,98 +2689,152 @@ void CONNECTION_GRAPH::assignNetCodesToBus( SCH_CONNECTION* aConnection )
 }
 
 
-void CONNECTION_GRAPH::propagateToNeighbors( CONNECTION_SUBGRAPH* aSubgraph, bool aForce )
+void CONNECTION_GRAPH::collectHierarchicalLinks()
 {
-    SCH_CONNECTION* conn = aSubgraph->m_driver_connection;
-    std::vector<CONNECTION_SUBGRAPH*> search_list;
-    std::unordered_set<CONNECTION_SUBGRAPH*> visited;
-    std::unordered_set<SCH_CONNECTION*> stale_bus_members;
+    thread_pool& tp = GetKiCadThreadPool();
 
-    auto visit =[&]( CONNECTION_SUBGRAPH* aParent )
-    {
-        for( SCH_SHEET_PIN* pin : aParent->m_hier_pins )
-        {
-            SCH_SHEET_PATH path = aParent->m_sheet;
-            path.push_back( pin->GetParent() );
+    // The names of drivers using text variables are cached by their subgraph on first use; fill
+    // these caches first, so that the subgraphs are only read while looking for the links.
+    tp.push_loop( m_driver_subgraphs.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    CONNECTION_SUBGRAPH* subgraph = m_driver_subgraphs[ii];
 
-            auto it = m_sheet_to_subgraphs_map.find( path );
+                    for( SCH_SHEET_PIN* pin : subgraph->m_hier_pins )
+                        subgraph->GetNameForDriver( pin );
 
-            if( it == m_sheet_to_subgraphs_map.end() )
-                continue;
+                    for( SCH_HIERLABEL* label : subgraph->m_hier_ports )
+                        subgraph->GetNameForDriver( label );
+                }
+            } );
+    tp.wait_for_tasks();
 
-            for( CONNECTION_SUBGRAPH* candidate : it->second )
+    // Only the links depending on the graph as it is before propagation are collected here; the
+    // visited subgraphs and the connection types are checked by propagateToNeighbors()
+    auto findLinks =
+            [&]( CONNECTION_SUBGRAPH* aParent )
             {
-                if( !candidate->m_strong_driver
-                    || candidate->m_hier_ports.empty()
-                    || visited.count( candidate ) )
+                aParent->m_hier_child_links.clear();
+                aParent->m_hier_parent_links.clear();
+
+                for( SCH_SHEET_PIN* pin : aParent->m_hier_pins )
                 {
-                    continue;
+                    SCH_SHEET_PATH path = aParent->m_sheet;
+                    path.push_back( pin->GetParent() );
+
+                    auto it = m_sheet_to_subgraphs_map.find( path );
+
+                    if( it == m_sheet_to_subgraphs_map.end() )
+                        continue;
+
+                    for( CONNECTION_SUBGRAPH* candidate : it->second )
+                    {
+                        if( !candidate->m_strong_driver || candidate->m_hier_ports.empty() )
+                            continue;
+
+                        for( SCH_HIERLABEL* label : candidate->m_hier_ports )
+                        {
+                            if( candidate->GetNameForDriver( label )
+                                == aParent->GetNameForDriver( pin ) )
+                            {
+                                aParent->m_hier_child_links.push_back( candidate );
+                                break;
+                            }
+                        }
+                    }
                 }
 
-                for( SCH_HIERLABEL* label : candidate->m_hier_ports )
+                for( SCH_HIERLABEL* label : aParent->m_hier_ports )
                 {
-                    if( candidate->GetNameForDriver( label ) == aParent->GetNameForDriver( pin ) )
+                    SCH_SHEET_PATH path = aParent->m_sheet;
+                    path.pop_back();
+
+                    auto it = m_sheet_to_subgraphs_map.find( path );
+
+                    if( it == m_sheet_to_subgraphs_map.end() )
+                        continue;
+
+                    for( CONNECTION_SUBGRAPH* candidate : it->second )
                     {
-                        wxLogTrace( ConnTrace, wxS( "%lu: found child %lu (%s)" ), aParent->m_code,
-                                    candidate->m_code, candidate->m_driver_connection->Name() );
+                        if( candidate->m_hier_pins.empty() )
+                            continue;
 
-                        candidate->m_hier_parent = aParent;
-                        aParent->m_hier_children.insert( candidate );
+                        const KIID& last_parent_uuid = aParent->m_sheet.Last()->m_Uuid;
 
-                        wxASSERT( candidate->m_graph == aParent->m_graph );
+                        for( SCH_SHEET_PIN* pin : candidate->m_hier_pins )
+                        {
+                            // If the last sheet UUIDs won't match, no need to check the full path
+                            if( pin->GetParent()->m_Uuid != last_parent_uuid )
+                                continue;
 
-                        search_list.push_back( candidate );
-                        break;
+                            SCH_SHEET_PATH pin_path = path;
+                            pin_path.push_back( pin->GetParent() );
+
+                            if( pin_path != aParent->m_sheet )
+                                continue;
+
+                            if( aParent->GetNameForDriver( label )
+                                == candidate->GetNameForDriver( pin ) )
+                            {
+                                aParent->m_hier_parent_links.push_back( candidate );
+                                break;
+                            }
+                        }
                     }
                 }
-            }
-        }
+            };
 
-        for( SCH_HIERLABEL* label : aParent->m_hier_ports )
-        {
-            SCH_SHEET_PATH path = aParent->m_sheet;
-            path.pop_back();
+    tp.push_loop( m_driver_subgraphs.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                    findLinks( m_driver_subgraphs[ii] );
+            } );
+    tp.wait_for_tasks();
+}
 
-            auto it = m_sheet_to_subgraphs_map.find( path );
 
-            if( it == m_sheet_to_subgraphs_map.end() )
+void CONNECTION_GRAPH::propagateToNeighbors( CONNECTION_SUBGRAPH* aSubgraph, bool aForce )
+{
+    SCH_CONNECTION* conn = aSubgraph->m_driver_connection;
+    std::vector<CONNECTION_SUBGRAPH*> search_list;
+    std::unordered_set<CONNECTION_SUBGRAPH*> visited;
+    std::unordered_set<SCH_CONNECTION*> stale_bus_members;
+
+    auto visit =[&]( CONNECTION_SUBGRAPH* aParent )
+    {
+        for( CONNECTION_SUBGRAPH* candidate : aParent->m_hier_child_links )
+        {
+            if( visited.count( candidate ) )
                 continue;
 
-            for( CONNECTION_SUBGRAPH* candidate : it->second )
-            {
-                if( candidate->m_hier_pins.empty()
-                    || visited.count( candidate )
-                    || candidate->m_driver_connection->Type() != aParent->m_driver_connection->Type() )
-                {
-                    continue;
-                }
+            wxLogTrace( ConnTrace, wxS( "%lu: found child %lu (%s)" ), aParent->m_code,
+                        candidate->m_code, candidate->m_driver_connection->Name() );
 
-                const KIID& last_parent_uuid = aParent->m_sheet.Last()->m_Uuid;
+            candidate->m_hier_parent = aParent;
+            aParent->m_hier_children.insert( candidate );
 
-                for( SCH_SHEET_PIN* pin : candidate->m_hier_pins )
-                {
-                    // If the last sheet UUIDs won't match, no need to check the full path
-                    if( pin->GetParent()->m_Uuid != last_parent_uuid )
-                        continue;
+            wxASSERT( candidate->m_graph == aParent->m_graph );
 
-                    SCH_SHEET_PATH pin_path = path;
-                    pin_path.push_back( pin->GetParent() );
+            search_list.push_back( candidate );
+        }
 
-                    if( pin_path != aParent->m_sheet )
-                        continue;
+        for( CONNECTION_SUBGRAPH* candidate : aParent->m_hier_parent_links )
+        {
+            if( visited.count( candidate )
+                || candidate->m_driver_connection->Type() != aParent->m_driver_connection->Type() )
+            {
+                continue;
+            }
 
-                    if( aParent->GetNameForDriver( label ) == candidate->GetNameForDriver( pin ) )
-                    {
-                        wxLogTrace( ConnTrace, wxS( "%lu: found additional parent %lu (%s)" ),
-                                    aParent->m_code, candidate->m_code,
-                                    candidate->m_driver_connection->Name() );
+            wxLogTrace( ConnTrace, wxS( "%lu: found additional parent %lu (%s)" ),
+                        aParent->m_code, candidate->m_code,
+                        candidate->m_driver_connection->Name() );
 
-                        aParent->m_hier_children.insert( candidate );
-                        search_list.push_back( candidate );
-                        break;
-                    }
-                }
-            }
+            aParent->m_hier_children.insert( candidate );
+            search_list.push_back( candidate );
         }
     };
 
@@ -2937,7 +3328,8 @@ int CONNECTION_GRAPH::RunERC()
 
     // We don't want to run many ERC checks more than once on a given screen even though it may
     // represent multiple sheets with multiple subgraphs.  We can tell these apart by drivers.
-    std::set<SCH_ITEM*> seenDriverInstances;
+    std::set<SCH_ITEM*>               seenDriverInstances;
+    std::vector<CONNECTION_SUBGRAPH*> subgraphs;
 
     for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
     {
@@ -2956,62 +3348,99 @@ int CONNECTION_GRAPH::RunERC()
         if( subgraph->m_driver )
             seenDriverInstances.insert( subgraph->m_driver );
 
-        /**
-         * NOTE:
-         *
-         * We could check that labels attached to bus subgraphs follow the
-         * proper format (i.e. actually define a bus).
-         *
-         * This check doesn't need to be here right now because labels
-         * won't actually be connected to bus wires if they aren't in the right
-         * format due to their TestDanglingEnds() implementation.
-         */
-        if( settings.IsTestEnabled( ERCE_DRIVER_CONFLICT ) )
-        {
-            if( !ercCheckMultipleDrivers( subgraph ) )
-                error_count++;
-        }
+        subgraphs.push_back( subgraph );
+    }
 
-        subgraph->ResolveDrivers( false );
+    // The subgraphs are checked in parallel.  Markers are kept aside for each subgraph, and
+    // added to the screens in the order of the subgraphs once all the checks are done, so that
+    // the results are the same as checking the subgraphs one after another.
+    std::vector<ERC_MARKERS> markers( subgraphs.size() );
+    std::vector<int>         errors( subgraphs.size(), 0 );
+    thread_pool&             tp = GetKiCadThreadPool();
+
+    // Resolving the drivers of a subgraph changes it, so it must be done for all subgraphs
+    // before the checks below look at neighboring subgraphs
+    tp.push_loop( subgraphs.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    if( settings.IsTestEnabled( ERCE_DRIVER_CONFLICT ) )
+                    {
+                        if( !ercCheckMultipleDrivers( subgraphs[ii], markers[ii] ) )
+                            errors[ii]++;
+                    }
 
-        if( settings.IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT ) )
-        {
-            if( !ercCheckBusToNetConflicts( subgraph ) )
-                error_count++;
-        }
+                    subgraphs[ii]->ResolveDrivers( false );
+                }
+            } );
+    tp.wait_for_tasks();
 
-        if( settings.IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT ) )
-        {
-            if( !ercCheckBusToBusEntryConflicts( subgraph ) )
-                error_count++;
-        }
+    tp.push_loop( subgraphs.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    const CONNECTION_SUBGRAPH* subgraph = subgraphs[ii];
+
+                    /**
+                     * NOTE:
+                     *
+                     * We could check that labels attached to bus subgraphs follow the
+                     * proper format (i.e. actually define a bus).
+                     *
+                     * This check doesn't need to be here right now because labels
+                     * won't actually be connected to bus wires if they aren't in the right
+                     * format due to their TestDanglingEnds() implementation.
+                     */
+                    if( settings.IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT ) )
+                    {
+                        if( !ercCheckBusToNetConflicts( subgraph, markers[ii] ) )
+                            errors[ii]++;
+                    }
 
-        if( settings.IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT ) )
-        {
-            if( !ercCheckBusToBusConflicts( subgraph ) )
-                error_count++;
-        }
+                    if( settings.IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT ) )
+                    {
+                        if( !ercCheckBusToBusEntryConflicts( subgraph, markers[ii] ) )
+                            errors[ii]++;
+                    }
 
-        if( settings.IsTestEnabled( ERCE_WIRE_DANGLING ) )
-        {
-            if( !ercCheckFloatingWires( subgraph ) )
-                error_count++;
-        }
+                    if( settings.IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT ) )
+                    {
+                        if( !ercCheckBusToBusConflicts( subgraph, markers[ii] ) )
+                            errors[ii]++;
+                    }
 
-        if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED )
-                || settings.IsTestEnabled( ERCE_NOCONNECT_NOT_CONNECTED )
-                || settings.IsTestEnabled( ERCE_PIN_NOT_CONNECTED ) )
-        {
-            if( !ercCheckNoConnects( subgraph ) )
-                error_count++;
-        }
+                    if( settings.IsTestEnabled( ERCE_WIRE_DANGLING ) )
+                    {
+                        if( !ercCheckFloatingWires( subgraph, markers[ii] ) )
+                            errors[ii]++;
+                    }
 
-        if( settings.IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
-                || settings.IsTestEnabled( ERCE_GLOBLABEL ) )
-        {
-            if( !ercCheckLabels( subgraph ) )
-                error_count++;
-        }
+                    if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED )
+                            || settings.IsTestEnabled( ERCE_NOCONNECT_NOT_CONNECTED )
+                            || settings.IsTestEnabled( ERCE_PIN_NOT_CONNECTED ) )
+                    {
+                        if( !ercCheckNoConnects( subgraph, markers[ii] ) )
+                            errors[ii]++;
+                    }
+
+                    if( settings.IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
+                            || settings.IsTestEnabled( ERCE_GLOBLABEL ) )
+                    {
+                        if( !ercCheckLabels( subgraph, markers[ii] ) )
+                            errors[ii]++;
+                    }
+                }
+            } );
+    tp.wait_for_tasks();
+
+    for( size_t ii = 0; ii < subgraphs.size(); ++ii )
+    {
+        for( const auto& [ screen, marker ] : markers[ii] )
+            screen->Append( marker );
+
+        error_count += errors[ii];
     }
 
     // Hierarchical sheet checking is done at the schematic level
@@ -3039,7 +3468,8 @@ int CONNECTION_GRAPH::RunERC()
 }
 
 
-bool CONNECTION_GRAPH::ercCheckMultipleDrivers( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckMultipleDrivers( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                ERC_MARKERS& aMarkers )
 {
     wxCHECK( aSubgraph, false );
 
@@ -3073,7 +3503,7 @@ bool CONNECTION_GRAPH::ercCheckMultipleDrivers( const CONNECTION_SUBGRAPH* aSubg
                 ercItem->SetErrorMessage( msg );
 
                 SCH_MARKER* marker = new SCH_MARKER( ercItem, driver->GetPosition() );
-                aSubgraph->m_sheet.LastScreen()->Append( marker );
+                aMarkers.emplace_back( aSubgraph->m_sheet.LastScreen(), marker );
 
                 return false;
             }
@@ -3126,7 +3556,8 @@ bool CONNECTION_GRAPH::ercCheckNetclassConflicts( const std::vector<CONNECTION_S
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                  ERC_MARKERS& aMarkers )
 {
     const SCH_SHEET_PATH& sheet = aSubgraph->m_sheet;
     SCH_SCREEN* screen = sheet.LastScreen();
@@ -3178,7 +3609,7 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
         ercItem->SetItems( net_item, bus_item );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, net_item->GetPosition() );
-        screen->Append( marker );
+        aMarkers.emplace_back( screen, marker );
 
         return false;
     }
@@ -3187,7 +3618,8 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                  ERC_MARKERS& aMarkers )
 {
     const SCH_SHEET_PATH& sheet = aSubgraph->m_sheet;
     SCH_SCREEN* screen = sheet.LastScreen();
@@ -3246,7 +3678,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
             ercItem->SetItems( label, port );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, label->GetPosition() );
-            screen->Append( marker );
+            aMarkers.emplace_back( screen, marker );
 
             return false;
         }
@@ -3256,7 +3688,8 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
 }
 
 
-bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                                       ERC_MARKERS& aMarkers )
 {
     bool conflict = false;
     const SCH_SHEET_PATH& sheet = aSubgraph->m_sheet;
@@ -3351,7 +3784,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
         ercItem->SetErrorMessage( msg );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, bus_entry->GetPosition() );
-        screen->Append( marker );
+        aMarkers.emplace_back( screen, marker );
 
         return false;
     }
@@ -3360,7 +3793,8 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
 }
 
 
-bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
+                                           ERC_MARKERS& aMarkers )
 {
     ERC_SETTINGS&         settings = m_schematic->ErcSettings();
     const SCH_SHEET_PATH& sheet  = aSubgraph->m_sheet;
@@ -3466,7 +3900,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             }
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pos );
-            screen->Append( marker );
+            aMarkers.emplace_back( screen, marker );
 
             ok = false;
         }
@@ -3480,7 +3914,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItemsSheetPaths( sheet );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, aSubgraph->m_no_connect->GetPosition() );
-            screen->Append( marker );
+            aMarkers.emplace_back( screen, marker );
 
             ok = false;
         }
@@ -3574,7 +4008,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( pin );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pin->GetTransformedPosition() );
-            screen->Append( marker );
+            aMarkers.emplace_back( screen, marker );
 
             ok = false;
         }
@@ -3600,7 +4034,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
 
                     SCH_MARKER* marker = new SCH_MARKER( ercItem,
                                                          testPin->GetTransformedPosition() );
-                    screen->Append( marker );
+                    aMarkers.emplace_back( screen, marker );
 
                     ok = false;
                 }
@@ -3612,7 +4046,8 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
 }
 
 
-bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph,
+                                              ERC_MARKERS& aMarkers )
 {
     if( aSubgraph->m_driver )
         return true;
@@ -3642,7 +4077,7 @@ bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgra
                            wires.size() > 3 ? wires[3] : nullptr );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, wires[0]->GetPosition() );
-        screen->Append( marker );
+        aMarkers.emplace_back( screen, marker );
 
         return false;
     }
@@ -3651,7 +4086,7 @@ bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgra
 }
 
 
-bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
+bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph, ERC_MARKERS& aMarkers )
 {
     // Label connection rules:
     // Any label without a no-connect needs to have at least 2 pins, otherwise it is invalid
@@ -3696,7 +4131,7 @@ bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
             ercItem->SetItems( aText );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, aText->GetPosition() );
-            aSubgraph->m_sheet.LastScreen()->Append( marker );
+            aMarkers.emplace_back( aSubgraph->m_sheet.LastScreen(), marker );
         }
     };
 
@@ -41,7 +41,9 @@ class CONNECTION_GRAPH;
 class SCHEMATIC;
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
+class SCH_MARKER;
 class SCH_PIN;
+class SCH_SCREEN;
 class SCH_SHEET_PIN;
 
 
@@ -280,6 +282,11 @@ private:
     /// this one.
     std::unordered_set<CONNECTION_SUBGRAPH*> m_hier_children;
 
+    /// Subgraphs of the child sheets matching the sheet pins of this one, and subgraphs of the
+    /// parent sheet matching its hierarchical labels.  Found before propagation.
+    std::vector<CONNECTION_SUBGRAPH*> m_hier_child_links;
+    std::vector<CONNECTION_SUBGRAPH*> m_hier_parent_links;
+
     /// A cache of escaped netnames from schematic items.
     mutable std::unordered_map<SCH_ITEM*, wxString> m_driver_name_cache;
 
@@ -439,6 +446,10 @@ public:
      * For a set of items, this will remove the connected items and their
      * associated data including subgraphs and generated codes from the connection graph.
      *
+     * Besides the nets the items are on, this removes the subgraphs which depend on the names
+     * the items now have (labels, sheet pins and power pins), so that renamed or new items
+     * join their new nets when the removed items are recalculated.
+     *
      * @param aItems A vector of items whose presence should be removed from the graph.
      * @return The full set of all items associated with the input items that were removed.
      */
@@ -456,7 +467,22 @@ public:
 
     void RemoveItem( SCH_ITEM* aItem );
 
+    /**
+     * Check the connectivity found by incremental updates against a full recalculation.
+     *
+     * The net of every connectable item on every sheet is recorded, then the graph is
+     * recalculated from scratch.  Items whose net name changed, or which no longer share their
+     * net with the same items, are reported in the connectivity trace.
+     *
+     * @return the number of items whose connectivity differs.
+     */
+    int VerifyIncremental( const SCH_SHEET_LIST& aSheetList,
+                           std::function<void( SCH_ITEM* )>* aChangedItemHandler = nullptr );
+
 private:
+    /// Markers found by ERC checks running in parallel, with the screens they belong to
+    typedef std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>> ERC_MARKERS;
+
     /**
      * Update the graphical connectivity between items (i.e. where they touch)
      * The items passed in must be on the same sheet.
@@ -521,6 +547,11 @@ private:
      */
     void collectAllDriverValues();
 
+    /**
+     * Rebuild #m_name_dependencies from the subgraphs of this graph.
+     */
+    void collectNameDependencies();
+
     /**
      * Iterate through the global power pins to collect the global labels as drivers.
      */
@@ -557,6 +588,12 @@ private:
      */
     void assignNetCodesToBus( SCH_CONNECTION* aConnection );
 
+    /**
+     * Find the subgraphs linked to each subgraph by sheet pins and hierarchical labels (in
+     * parallel), for propagateToNeighbors().
+     */
+    void collectHierarchicalLinks();
+
     /**
      * Update all neighbors of a subgraph with this one's connectivity info.
      *
@@ -608,9 +645,10 @@ private:
      * creates the markers.
      *
      * @param aSubgraph is the subgraph to examine
+     * @param aMarkers receives the markers for the errors found
      * @return  true for no errors, false for errors
      */
-    bool ercCheckMultipleDrivers( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckMultipleDrivers( const CONNECTION_SUBGRAPH* aSubgraph, ERC_MARKERS& aMarkers );
 
     bool ercCheckNetclassConflicts( const std::vector<CONNECTION_SUBGRAPH*>& subgraphs );
 
@@ -620,9 +658,10 @@ private:
      * For example, a net wire connected to a bus port/pin, or vice versa
      *
      * @param  aSubgraph      is the subgraph to examine.
+     * @param  aMarkers       receives the markers for the errors found.
      * @return                true for no errors, false for errors.
      */
-    bool ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph, ERC_MARKERS& aMarkers );
 
     /**
      * Check one subgraph for conflicting connections between two bus items.
@@ -632,9 +671,10 @@ private:
      * sheet pin.
      *
      * @param  aSubgraph      is the subgraph to examine.
+     * @param  aMarkers       receives the markers for the errors found.
      * @return                true for no errors, false for errors.
      */
-    bool ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph, ERC_MARKERS& aMarkers );
 
     /**
      * Check one subgraph for conflicting bus entry to bus connections.
@@ -646,9 +686,11 @@ private:
      * "USB.DP" but someone might accidentally just enter "DP".
      *
      * @param  aSubgraph      is the subgraph to examine.
+     * @param  aMarkers       receives the markers for the errors found.
      * @return                true for no errors, false for errors.
      */
-    bool ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
+                                        ERC_MARKERS& aMarkers );
 
     /**
      * Check one subgraph for proper presence or absence of no-connect symbols.
@@ -657,9 +699,10 @@ private:
      * A pin without a no-connect symbol should have at least one connection.
      *
      * @param  aSubgraph      is the subgraph to examine.
+     * @param  aMarkers       receives the markers for the errors found.
      * @return                true for no errors, false for errors.
      */
-    bool ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph, ERC_MARKERS& aMarkers );
 
     /**
      * Check one subgraph for floating wires.
@@ -667,9 +710,10 @@ private:
      * Will throw an error for any subgraph that consists of just wires with no driver.
      *
      * @param  aSubgraph      is the subgraph to examine.
+     * @param  aMarkers       receives the markers for the errors found.
      * @return                true for no errors, false for errors.
      */
-    bool ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgraph, ERC_MARKERS& aMarkers );
 
     /**
      * Check one subgraph for proper connection of labels.
@@ -677,10 +721,11 @@ private:
      * Labels should be connected to something.
      *
      * @param  aSubgraph      is the subgraph to examine.
+     * @param  aMarkers       receives the markers for the errors found.
      * @param  aCheckGlobalLabels is true if global labels should be checked for loneliness.
      * @return                true for no errors, false for errors.
      */
-    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph );
+    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph, ERC_MARKERS& aMarkers );
 
     /**
      * Check that a hierarchical sheet has at least one matching label inside the sheet for each
@@ -738,6 +783,10 @@ private:
 
     std::unordered_map<SCH_ITEM*, CONNECTION_SUBGRAPH*> m_item_to_subgraph_map;
 
+    /// Subgraphs by the names they connect through other than wires.  Global labels and power
+    /// pins are keyed by name, local and hierarchical labels and sheet pins by sheet and name.
+    std::unordered_map<wxString, std::vector<CONNECTION_SUBGRAPH*>> m_name_dependencies;
+
     NET_MAP m_net_code_to_subgraphs_map;
 
     int m_last_net_code;
@@ -635,8 +635,8 @@ int DIALOG_CHANGE_SYMBOLS::processSymbols( SCH_COMMIT* aCommit,
 
         for( unsigned i = 0; i < symbol->GetFields().size(); ++i )
         {
-            SCH_FIELD& field = symbol->GetFields()[i];
-            SCH_FIELD* libField = nullptr;
+            SCH_FIELD&       field = symbol->GetFields()[i];
+            const SCH_FIELD* libField = nullptr;
 
             // Mandatory fields always exist in m_updateFields, but these names can be translated.
             // so use GetCanonicalName().
@@ -715,7 +715,7 @@ int DIALOG_CHANGE_SYMBOLS::processSymbols( SCH_COMMIT* aCommit,
             }
         }
 
-        std::vector<SCH_FIELD*> libFields;
+        std::vector<const SCH_FIELD*> libFields;
         symbol->GetLibSymbolRef()->GetFields( libFields );
 
         for( unsigned i = MANDATORY_FIELDS; i < libFields.size(); ++i )
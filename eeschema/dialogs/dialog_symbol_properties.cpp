@@ -349,7 +349,7 @@ DIALOG_SYMBOL_PROPERTIES::DIALOG_SYMBOL_PROPERTIES( SCH_EDIT_FRAME* aParent,
         m_dataModel( nullptr )
 {
     m_symbol = aSymbol;
-    m_part = m_symbol->GetLibSymbolRef().get();
+    m_part = m_symbol->GetLibSymbolRef();
 
     // GetLibSymbolRef() now points to the cached part in the schematic, which should always be
     // there for usual cases, but can be null when opening old schematics not storing the part
@@ -749,11 +749,9 @@ bool DIALOG_SYMBOL_PROPERTIES::TransferDataFromWindow()
     case 2: m_symbol->SetOrientation( SYM_MIRROR_Y ); break;
     }
 
-    if( m_part )
-    {
-        m_part->SetShowPinNames( m_ShowPinNameButt->GetValue() );
-        m_part->SetShowPinNumbers( m_ShowPinNumButt->GetValue() );
-    }
+    // The library symbol can be shared with other symbols: the symbol copies it if needed
+    m_symbol->SetShowPinNames( m_ShowPinNameButt->GetValue() );
+    m_symbol->SetShowPinNumbers( m_ShowPinNumButt->GetValue() );
 
     // Restore m_Flag modified by SetUnit() and other change settings from the dialog
     m_symbol->ClearFlags();
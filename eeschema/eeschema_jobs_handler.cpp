@@ -998,6 +998,15 @@ int EESCHEMA_JOBS_HANDLER::JobSchErc( JOB* aJob )
     ercTester.RunTests( drawingSheet.get(), nullptr, m_kiway->KiFACE( KIWAY::FACE_CVPCB ),
                         &sch->Prj(), m_progressReporter );
 
+    if( ercJob->m_reportTimings )
+    {
+        for( const auto& [ name, msecs ] : ercTester.GetTimings() )
+        {
+            m_reporter->Report( wxString::Format( wxS( "%s: %0.1f ms\n" ), name, msecs ),
+                                RPT_SEVERITY_INFO );
+        }
+    }
+
     markersProvider->SetSeverities( ercJob->m_severity );
 
     m_reporter->Report( wxString::Format( _( "Found %d violations\n" ),
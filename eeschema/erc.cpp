@@ -24,12 +24,16 @@
  */
 
 #include <algorithm>
+#include <functional>
+#include <future>
 #include <numeric>
 
 #include "connection_graph.h"
 #include "kiface_ids.h"
 #include <advanced_config.h>
 #include <common.h>     // for ExpandEnvVarSubstitutions
+#include <core/profile.h>
+#include <core/thread_pool.h>
 #include <erc.h>
 #include <erc_sch_pin_context.h>
 #include <gal/graphics_abstraction_layer.h>
@@ -164,7 +168,7 @@ int ERC_TESTER::TestDuplicateSheetNames( bool aCreateMarker )
                         ercItem->SetItems( sheet, test_item );
 
                         SCH_MARKER* marker = new SCH_MARKER( ercItem, sheet->GetPosition() );
-                        screen->Append( marker );
+                        addMarker( screen, marker );
                     }
 
                     err_count++;
@@ -217,7 +221,7 @@ void ERC_TESTER::TestTextVars( DS_PROXY_VIEW_ITEM* aDrawingSheet )
                         ercItem->SetSheetSpecificPath( sheet );
 
                         SCH_MARKER* marker = new SCH_MARKER( ercItem, field.GetPosition() );
-                        screen->Append( marker );
+                        addMarker( screen, marker );
                     }
                 }
             }
@@ -234,7 +238,7 @@ void ERC_TESTER::TestTextVars( DS_PROXY_VIEW_ITEM* aDrawingSheet )
                         ercItem->SetSheetSpecificPath( sheet );
 
                         SCH_MARKER* marker = new SCH_MARKER( ercItem, field.GetPosition() );
-                        screen->Append( marker );
+                        addMarker( screen, marker );
                     }
                 }
 
@@ -250,7 +254,7 @@ void ERC_TESTER::TestTextVars( DS_PROXY_VIEW_ITEM* aDrawingSheet )
                         ercItem->SetSheetSpecificPath( sheet );
 
                         SCH_MARKER* marker = new SCH_MARKER( ercItem, pin->GetPosition() );
-                        screen->Append( marker );
+                        addMarker( screen, marker );
                     }
                 }
             }
@@ -263,7 +267,7 @@ void ERC_TESTER::TestTextVars( DS_PROXY_VIEW_ITEM* aDrawingSheet )
                     ercItem->SetSheetSpecificPath( sheet );
 
                     SCH_MARKER* marker = new SCH_MARKER( ercItem, text->GetPosition() );
-                    screen->Append( marker );
+                    addMarker( screen, marker );
                 }
             }
             else if( SCH_TEXTBOX* textBox = dynamic_cast<SCH_TEXTBOX*>( item ) )
@@ -275,7 +279,7 @@ void ERC_TESTER::TestTextVars( DS_PROXY_VIEW_ITEM* aDrawingSheet )
                     ercItem->SetSheetSpecificPath( sheet );
 
                     SCH_MARKER* marker = new SCH_MARKER( ercItem, textBox->GetPosition() );
-                    screen->Append( marker );
+                    addMarker( screen, marker );
                 }
             }
         }
@@ -291,7 +295,7 @@ void ERC_TESTER::TestTextVars( DS_PROXY_VIEW_ITEM* aDrawingSheet )
                     erc->SetSheetSpecificPath( sheet );
 
                     SCH_MARKER* marker = new SCH_MARKER( erc, text->GetPosition() );
-                    screen->Append( marker );
+                    addMarker( screen, marker );
                 }
             }
         }
@@ -332,7 +336,7 @@ int ERC_TESTER::TestConflictingBusAliases()
                     ercItem->SetErrorMessage( msg );
 
                     SCH_MARKER* marker = new SCH_MARKER( ercItem, VECTOR2I() );
-                    test->GetParent()->Append( marker );
+                    addMarker( test->GetParent(), marker );
 
                     ++err_count;
                 }
@@ -400,7 +404,7 @@ int ERC_TESTER::TestMultiunitFootprints()
                 ercItem->SetItems( unit, secondUnit );
 
                 SCH_MARKER* marker = new SCH_MARKER( ercItem, secondUnit->GetPosition() );
-                secondRef.GetSheetPath().LastScreen()->Append( marker );
+                addMarker( secondRef.GetSheetPath().LastScreen(), marker );
 
                 ++errors;
             }
@@ -429,7 +433,7 @@ int ERC_TESTER::TestMissingUnits()
         // Reference unit
         SCH_REFERENCE& base_ref = refList.GetItem( 0 );
         SCH_SYMBOL* unit = base_ref.GetSymbol();
-        LIB_SYMBOL* libSymbol = base_ref.GetLibPart();
+        const LIB_SYMBOL* libSymbol = base_ref.GetLibPart();
 
         if( static_cast<ssize_t>( refList.GetCount() ) == libSymbol->GetUnitCount() )
             continue;
@@ -453,7 +457,7 @@ int ERC_TESTER::TestMissingUnits()
                     break;
                 }
 
-                missing_pin_units += libSymbol->GetUnitDisplayName( missing_unit ) + ", " ;
+                missing_pin_units += unit->GetUnitDisplayName( missing_unit ) + ", " ;
             }
 
             missing_pin_units.Truncate( missing_pin_units.length() - 2 );
@@ -466,7 +470,7 @@ int ERC_TESTER::TestMissingUnits()
             ercItem->SetItems( unit );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, unit->GetPosition() );
-            base_ref.GetSheetPath().LastScreen()->Append( marker );
+            addMarker( base_ref.GetSheetPath().LastScreen(), marker );
 
             ++errors;
         };
@@ -574,7 +578,7 @@ int ERC_TESTER::TestMissingNetclasses()
                                                             netclass ) );
 
                 SCH_MARKER* marker = new SCH_MARKER( ercItem, item->GetPosition() );
-                sheet.LastScreen()->Append( marker );
+                addMarker( sheet.LastScreen(), marker );
             };
 
     for( const SCH_SHEET_PATH& sheet : m_schematic->GetSheets() )
@@ -669,7 +673,7 @@ int ERC_TESTER::TestNoConnectPins()
                 ercItem->SetSheetSpecificPath( sheet );
 
                 SCH_MARKER* marker = new SCH_MARKER( ercItem, pair.first );
-                sheet.LastScreen()->Append( marker );
+                addMarker( sheet.LastScreen(), marker );
             }
         }
     }
@@ -685,10 +689,10 @@ int ERC_TESTER::TestPinToPin()
 
     int errors = 0;
 
-    for( const std::pair<NET_NAME_CODE_CACHE_KEY, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
+    for( const auto& net : nets )
     {
-        std::vector<ERC_SCH_PIN_CONTEXT>           pins;
-        std::unordered_map<EDA_ITEM*, SCH_SCREEN*> pinToScreenMap;
+        std::vector<ERC_SCH_PIN_CONTEXT> pins;
+        std::vector<SCH_SCREEN*>         pinScreens;
         bool has_noconnect = false;
 
         for( CONNECTION_SUBGRAPH* subgraph: net.second )
@@ -701,32 +705,40 @@ int ERC_TESTER::TestPinToPin()
                 if( item->Type() == SCH_PIN_T )
                 {
                     pins.emplace_back( static_cast<SCH_PIN*>( item ), subgraph->GetSheet() );
-                    pinToScreenMap[item] = subgraph->GetSheet().LastScreen();
+                    pinScreens.push_back( subgraph->GetSheet().LastScreen() );
                 }
             }
         }
 
+        // Indices of the pins of each electrical type.  Power rails can have hundreds of pins
+        // but only a few types, so conflicts are looked up per type pair rather than per pin pair.
+        std::vector<size_t> pinsByType[ELECTRICAL_PINTYPES_TOTAL];
+
+        for( size_t ii = 0; ii < pins.size(); ++ii )
+            pinsByType[static_cast<int>( pins[ii].Pin()->GetType() )].push_back( ii );
+
+        auto hasType =
+                [&]( ELECTRICAL_PINTYPE aType )
+                {
+                    return !pinsByType[static_cast<int>( aType )].empty();
+                };
+
         ERC_SCH_PIN_CONTEXT needsDriver;
+        SCH_SCREEN*         needsDriverScreen = nullptr;
         bool                hasDriver = false;
 
         // We need different drivers for power nets and normal nets.
         // A power net has at least one pin having the ELECTRICAL_PINTYPE::PT_POWER_IN
         // and power nets can be driven only by ELECTRICAL_PINTYPE::PT_POWER_OUT pins
-        bool     ispowerNet  = false;
+        bool ispowerNet = hasType( ELECTRICAL_PINTYPE::PT_POWER_IN );
 
-        for( ERC_SCH_PIN_CONTEXT& refPin : pins )
-        {
-            if( refPin.Pin()->GetType() == ELECTRICAL_PINTYPE::PT_POWER_IN )
-            {
-                ispowerNet = true;
-                break;
-            }
-        }
+        for( ELECTRICAL_PINTYPE type : ispowerNet ? DrivingPowerPinTypes : DrivingPinTypes )
+            hasDriver |= hasType( type );
 
-        for( auto refIt = pins.begin(); refIt != pins.end(); ++refIt )
+        for( size_t ii = 0; ii < pins.size(); ++ii )
         {
-            ERC_SCH_PIN_CONTEXT& refPin = *refIt;
-            ELECTRICAL_PINTYPE refType = refPin.Pin()->GetType();
+            ERC_SCH_PIN_CONTEXT& refPin = pins[ii];
+            ELECTRICAL_PINTYPE   refType = refPin.Pin()->GetType();
 
             if( DrivenPinTypes.count( refType ) )
             {
@@ -741,53 +753,76 @@ int ERC_TESTER::TestPinToPin()
                          && ispowerNet == ( refType == ELECTRICAL_PINTYPE::PT_POWER_IN ) ) )
                 {
                     needsDriver = refPin;
+                    needsDriverScreen = pinScreens[ii];
                 }
             }
+        }
 
-            if( ispowerNet )
-                hasDriver |= ( DrivingPowerPinTypes.count( refType ) != 0 );
-            else
-                hasDriver |= ( DrivingPinTypes.count( refType ) != 0 );
+        // Only the pins of conflicting types are compared with each other.  The conflicts are
+        // then sorted so that they are reported in the same order as a pairwise comparison.
+        std::vector<std::pair<size_t, size_t>> conflicts;
 
-            for( auto testIt = refIt + 1; testIt != pins.end(); ++testIt )
+        if( settings.IsTestEnabled( ERCE_PIN_TO_PIN_WARNING ) )
+        {
+            for( int refType = 0; refType < ELECTRICAL_PINTYPES_TOTAL; ++refType )
             {
-                ERC_SCH_PIN_CONTEXT& testPin = *testIt;
-
-                // Multiple pins in the same symbol that share a type,
-                // name and position are considered
-                // "stacked" and shouldn't trigger ERC errors
-                if( refPin.Pin()->IsStacked( testPin.Pin() ) && refPin.Sheet() == testPin.Sheet() )
-                    continue;
+                for( int testType = 0; testType < ELECTRICAL_PINTYPES_TOTAL; ++testType )
+                {
+                    if( settings.GetPinMapValue( refType, testType ) == PIN_ERROR::OK )
+                        continue;
 
-                ELECTRICAL_PINTYPE testType = testPin.Pin()->GetType();
+                    for( size_t refIdx : pinsByType[refType] )
+                    {
+                        for( size_t testIdx : pinsByType[testType] )
+                        {
+                            if( testIdx <= refIdx )
+                                continue;
 
-                if( ispowerNet )
-                    hasDriver |= ( DrivingPowerPinTypes.count( testType ) != 0 );
-                else
-                    hasDriver |= ( DrivingPinTypes.count( testType ) != 0 );
+                            ERC_SCH_PIN_CONTEXT& refPin = pins[refIdx];
+                            ERC_SCH_PIN_CONTEXT& testPin = pins[testIdx];
 
-                PIN_ERROR erc = settings.GetPinMapValue( refType, testType );
+                            // Multiple pins in the same symbol that share a type,
+                            // name and position are considered
+                            // "stacked" and shouldn't trigger ERC errors
+                            if( refPin.Pin()->IsStacked( testPin.Pin() )
+                                && refPin.Sheet() == testPin.Sheet() )
+                            {
+                                continue;
+                            }
 
-                if( erc != PIN_ERROR::OK && settings.IsTestEnabled( ERCE_PIN_TO_PIN_WARNING ) )
-                {
-                    std::shared_ptr<ERC_ITEM> ercItem =
-                            ERC_ITEM::Create( erc == PIN_ERROR::WARNING ? ERCE_PIN_TO_PIN_WARNING :
-                                                                          ERCE_PIN_TO_PIN_ERROR );
-                    ercItem->SetItems( refPin.Pin(), testPin.Pin() );
-                    ercItem->SetSheetSpecificPath( refPin.Sheet() );
-                    ercItem->SetItemsSheetPaths( refPin.Sheet(), testPin.Sheet() );
-
-                    ercItem->SetErrorMessage(
-                            wxString::Format( _( "Pins of type %s and %s are connected" ),
-                                              ElectricalPinTypeGetText( refType ),
-                                              ElectricalPinTypeGetText( testType ) ) );
-
-                    SCH_MARKER* marker = new SCH_MARKER( ercItem,
-                                                         refPin.Pin()->GetTransformedPosition() );
-                    pinToScreenMap[refPin.Pin()]->Append( marker );
-                    errors++;
+                            conflicts.emplace_back( refIdx, testIdx );
+                        }
+                    }
                 }
             }
+
+            std::sort( conflicts.begin(), conflicts.end() );
+        }
+
+        for( const auto& [ refIdx, testIdx ] : conflicts )
+        {
+            ERC_SCH_PIN_CONTEXT& refPin = pins[refIdx];
+            ERC_SCH_PIN_CONTEXT& testPin = pins[testIdx];
+            ELECTRICAL_PINTYPE   refType = refPin.Pin()->GetType();
+            ELECTRICAL_PINTYPE   testType = testPin.Pin()->GetType();
+            PIN_ERROR            erc = settings.GetPinMapValue( refType, testType );
+
+            std::shared_ptr<ERC_ITEM> ercItem =
+                    ERC_ITEM::Create( erc == PIN_ERROR::WARNING ? ERCE_PIN_TO_PIN_WARNING :
+                                                                  ERCE_PIN_TO_PIN_ERROR );
+            ercItem->SetItems( refPin.Pin(), testPin.Pin() );
+            ercItem->SetSheetSpecificPath( refPin.Sheet() );
+            ercItem->SetItemsSheetPaths( refPin.Sheet(), testPin.Sheet() );
+
+            ercItem->SetErrorMessage(
+                    wxString::Format( _( "Pins of type %s and %s are connected" ),
+                                      ElectricalPinTypeGetText( refType ),
+                                      ElectricalPinTypeGetText( testType ) ) );
+
+            SCH_MARKER* marker = new SCH_MARKER( ercItem,
+                                                 refPin.Pin()->GetTransformedPosition() );
+            addMarker( pinScreens[refIdx], marker );
+            errors++;
         }
 
         if( needsDriver.Pin() && !hasDriver && !has_noconnect )
@@ -804,7 +839,7 @@ int ERC_TESTER::TestPinToPin()
 
                 SCH_MARKER* marker = new SCH_MARKER( ercItem,
                                                      needsDriver.Pin()->GetTransformedPosition() );
-                pinToScreenMap[needsDriver.Pin()]->Append( marker );
+                addMarker( needsDriverScreen, marker );
                 errors++;
             }
         }
@@ -822,7 +857,7 @@ int ERC_TESTER::TestMultUnitPinConflicts()
 
     std::unordered_map<wxString, std::pair<wxString, SCH_PIN*>> pinToNetMap;
 
-    for( const std::pair<NET_NAME_CODE_CACHE_KEY, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
+    for( const auto& net : nets )
     {
         const wxString& netName = net.first.Name;
 
@@ -862,7 +897,7 @@ int ERC_TESTER::TestMultUnitPinConflicts()
 
                         SCH_MARKER* marker = new SCH_MARKER( ercItem,
                                                              pin->GetTransformedPosition() );
-                        sheet.LastScreen()->Append( marker );
+                        addMarker( sheet.LastScreen(), marker );
                         errors += 1;
                     }
                 }
@@ -880,9 +915,17 @@ int ERC_TESTER::TestSimilarLabels()
 
     int errors = 0;
 
-    std::unordered_map<wxString, std::pair<SCH_LABEL_BASE*, SCH_SHEET_PATH>> labelMap;
+    /// The first label found for a case-folded name, with its shown text
+    struct LABEL_INFO
+    {
+        SCH_LABEL_BASE* m_label;
+        SCH_SHEET_PATH  m_sheet;
+        wxString        m_text;
+    };
 
-    for( const std::pair<NET_NAME_CODE_CACHE_KEY, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
+    std::unordered_map<wxString, LABEL_INFO> labelMap;
+
+    for( const auto& net : nets )
     {
         for( CONNECTION_SUBGRAPH* subgraph : net.second )
         {
@@ -897,27 +940,28 @@ int ERC_TESTER::TestSimilarLabels()
                 case SCH_GLOBAL_LABEL_T:
                 {
                     SCH_LABEL_BASE* label = static_cast<SCH_LABEL_BASE*>( item );
+                    wxString        text = label->GetShownText( &sheet, false );
+                    wxString        normalized = text.Lower();
 
-                    wxString normalized = label->GetShownText( &sheet, false ).Lower();
+                    auto it = labelMap.find( normalized );
 
-                    if( !labelMap.count( normalized ) )
+                    if( it == labelMap.end() )
                     {
-                        labelMap[normalized] = std::make_pair( label, sheet );
+                        labelMap.emplace( normalized, LABEL_INFO{ label, sheet, text } );
                         break;
                     }
 
-                    auto& [ otherLabel, otherSheet ] = labelMap.at( normalized );
+                    const LABEL_INFO& other = it->second;
 
-                    if( otherLabel->GetShownText( &otherSheet, false )
-                            != label->GetShownText( &sheet, false ) )
+                    if( other.m_text != text )
                     {
                         std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( ERCE_SIMILAR_LABELS );
-                        ercItem->SetItems( label, labelMap.at( normalized ).first );
+                        ercItem->SetItems( label, other.m_label );
                         ercItem->SetSheetSpecificPath( sheet );
-                        ercItem->SetItemsSheetPaths( sheet, labelMap.at( normalized ).second );
+                        ercItem->SetItemsSheetPaths( sheet, other.m_sheet );
 
                         SCH_MARKER* marker = new SCH_MARKER( ercItem, label->GetPosition() );
-                        sheet.LastScreen()->Append( marker );
+                        addMarker( sheet.LastScreen(), marker );
                         errors += 1;
                     }
 
@@ -953,7 +997,7 @@ int ERC_TESTER::TestLibSymbolIssues()
         for( SCH_ITEM* item : screen->Items().OfType( SCH_SYMBOL_T ) )
         {
             SCH_SYMBOL* symbol = static_cast<SCH_SYMBOL*>( item );
-            LIB_SYMBOL* libSymbolInSchematic = symbol->GetLibSymbolRef().get();
+            const LIB_SYMBOL* libSymbolInSchematic = symbol->GetLibSymbolRef();
 
             wxCHECK2( libSymbolInSchematic, continue );
 
@@ -1030,7 +1074,7 @@ int ERC_TESTER::TestLibSymbolIssues()
 
         for( SCH_MARKER* marker : markers )
         {
-            screen->Append( marker );
+            addMarker( screen, marker );
             err_count += 1;
         }
     }
@@ -1110,7 +1154,7 @@ int ERC_TESTER::TestFootprintLinkIssues( KIFACE* aCvPcb, PROJECT* aProject )
 
         for( SCH_MARKER* marker : markers )
         {
-            sheet.LastScreen()->Append( marker );
+            addMarker( sheet.LastScreen(), marker );
             err_count += 1;
         }
     }
@@ -1175,7 +1219,7 @@ int ERC_TESTER::TestOffGridEndpoints()
 
         for( SCH_MARKER* marker : markers )
         {
-            screen->Append( marker );
+            addMarker( screen, marker );
             err_count += 1;
         }
     }
@@ -1226,7 +1270,7 @@ int ERC_TESTER::TestSimModelIssues()
 
         for( SCH_MARKER* marker : markers )
         {
-            sheet.LastScreen()->Append( marker );
+            addMarker( sheet.LastScreen(), marker );
             err_count += 1;
         }
     }
@@ -1235,11 +1279,30 @@ int ERC_TESTER::TestSimModelIssues()
 }
 
 
+void ERC_TESTER::addMarker( SCH_SCREEN* aScreen, SCH_MARKER* aMarker )
+{
+    if( m_bufferMarkers )
+        m_markers.emplace_back( aScreen, aMarker );
+    else
+        aScreen->Append( aMarker );
+}
+
+
 void ERC_TESTER::RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet, SCH_EDIT_FRAME* aEditFrame,
                            KIFACE* aCvPcb, PROJECT* aProject, PROGRESS_REPORTER* aProgressReporter )
 {
     ERC_SETTINGS& settings = m_schematic->ErcSettings();
 
+    m_timings.clear();
+
+    auto timed =
+            [&]( const wxString& aName, const std::function<void()>& aTest )
+            {
+                PROF_TIMER timer;
+                aTest();
+                m_timings.emplace_back( aName, timer.msecs() );
+            };
+
     // Test duplicate sheet names inside a given sheet.  While one can have multiple references
     // to the same file, each must have a unique name.
     if( settings.IsTestEnabled( ERCE_DUPLICATE_SHEET_NAME ) )
@@ -1247,7 +1310,7 @@ void ERC_TESTER::RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet, SCH_EDIT_FRAME* aE
         if( aProgressReporter )
             aProgressReporter->AdvancePhase( _( "Checking sheet names..." ) );
 
-        TestDuplicateSheetNames( true );
+        timed( wxS( "TestDuplicateSheetNames" ), [&]() { TestDuplicateSheetNames( true ); } );
     }
 
     if( settings.IsTestEnabled( ERCE_BUS_ALIAS_CONFLICT ) )
@@ -1255,7 +1318,7 @@ void ERC_TESTER::RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet, SCH_EDIT_FRAME* aE
         if( aProgressReporter )
             aProgressReporter->AdvancePhase( _( "Checking bus conflicts..." ) );
 
-        TestConflictingBusAliases();
+        timed( wxS( "TestConflictingBusAliases" ), [&]() { TestConflictingBusAliases(); } );
     }
 
     // The connection graph has a whole set of ERC checks it can run
@@ -1271,18 +1334,49 @@ void ERC_TESTER::RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet, SCH_EDIT_FRAME* aE
             aEditFrame->RecalculateConnections( nullptr, NO_CLEANUP );
     }
 
-    m_schematic->ConnectionGraph()->RunERC();
+    timed( wxS( "ConnectionGraph" ), [&]() { m_schematic->ConnectionGraph()->RunERC(); } );
 
-    if( aProgressReporter )
-        aProgressReporter->AdvancePhase( _( "Checking units..." ) );
+    // The remaining tests only read the schematic, so they can run at the same time.  Each one
+    // gets its own tester, which keeps the markers aside until they are added in the order of
+    // the tests below.
+    struct TEST
+    {
+        wxString                           m_phase;    ///< Progress message, if any
+        wxString                           m_name;
+        std::function<void( ERC_TESTER& )> m_run;
+        bool                               m_parallel; ///< Can run on a worker thread
+        std::unique_ptr<ERC_TESTER>        m_tester;
+        double                             m_msecs = 0.0;
+        std::future<void>                  m_result;
+    };
+
+    std::vector<TEST> tests;
+
+    auto addTest =
+            [&]( const wxString& aPhase, const wxString& aName, bool aParallel,
+                 std::function<void( ERC_TESTER& )> aRun )
+            {
+                TEST& test = tests.emplace_back();
+
+                test.m_phase = aPhase;
+                test.m_name = aName;
+                test.m_run = std::move( aRun );
+                test.m_parallel = aParallel;
+
+                if( test.m_run )
+                {
+                    test.m_tester = std::make_unique<ERC_TESTER>( m_schematic );
+                    test.m_tester->m_bufferMarkers = true;
+                }
+            };
+
+    addTest( _( "Checking units..." ), wxEmptyString, false, nullptr );
 
     // Test is all units of each multiunit symbol have the same footprint assigned.
     if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_FP ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking footprints..." ) );
-
-        TestMultiunitFootprints();
+        addTest( _( "Checking footprints..." ), wxS( "TestMultiunitFootprints" ), true,
+                 []( ERC_TESTER& aTester ) { aTester.TestMultiunitFootprints(); } );
     }
 
     if( settings.IsTestEnabled( ERCE_MISSING_UNIT )
@@ -1290,88 +1384,141 @@ void ERC_TESTER::RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet, SCH_EDIT_FRAME* aE
         || settings.IsTestEnabled( ERCE_MISSING_POWER_INPUT_PIN )
         || settings.IsTestEnabled( ERCE_MISSING_BIDI_PIN ) )
     {
-        TestMissingUnits();
+        addTest( wxEmptyString, wxS( "TestMissingUnits" ), true,
+                 []( ERC_TESTER& aTester ) { aTester.TestMissingUnits(); } );
     }
 
-    if( aProgressReporter )
-        aProgressReporter->AdvancePhase( _( "Checking pins..." ) );
+    addTest( _( "Checking pins..." ), wxEmptyString, false, nullptr );
 
     if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_NET ) )
-        TestMultUnitPinConflicts();
+    {
+        addTest( wxEmptyString, wxS( "TestMultUnitPinConflicts" ), true,
+                 []( ERC_TESTER& aTester ) { aTester.TestMultUnitPinConflicts(); } );
+    }
 
     // Test pins on each net against the pin connection table
     if( settings.IsTestEnabled( ERCE_PIN_TO_PIN_ERROR )
         || settings.IsTestEnabled( ERCE_POWERPIN_NOT_DRIVEN )
         || settings.IsTestEnabled( ERCE_PIN_NOT_DRIVEN ) )
     {
-        TestPinToPin();
+        addTest( wxEmptyString, wxS( "TestPinToPin" ), true,
+                 []( ERC_TESTER& aTester ) { aTester.TestPinToPin(); } );
     }
 
     // Test similar labels (i;e. labels which are identical when
     // using case insensitive comparisons)
     if( settings.IsTestEnabled( ERCE_SIMILAR_LABELS ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking labels..." ) );
-
-        TestSimilarLabels();
+        addTest( _( "Checking labels..." ), wxS( "TestSimilarLabels" ), true,
+                 []( ERC_TESTER& aTester ) { aTester.TestSimilarLabels(); } );
     }
 
+    // The drawing sheet, simulation libraries, symbol libraries and footprint libraries are not
+    // safe to use from several threads; these tests run on the calling thread instead.
     if( settings.IsTestEnabled( ERCE_UNRESOLVED_VARIABLE ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking for unresolved variables..." ) );
-
-        TestTextVars( aDrawingSheet );
+        addTest( _( "Checking for unresolved variables..." ), wxS( "TestTextVars" ), false,
+                 [aDrawingSheet]( ERC_TESTER& aTester )
+                 {
+                     aTester.TestTextVars( aDrawingSheet );
+                 } );
     }
 
     if( settings.IsTestEnabled( ERCE_SIMULATION_MODEL ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking SPICE models..." ) );
-
-        TestSimModelIssues();
+        addTest( _( "Checking SPICE models..." ), wxS( "TestSimModelIssues" ), false,
+                 []( ERC_TESTER& aTester ) { aTester.TestSimModelIssues(); } );
     }
 
     if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking no connect pins for connections..." ) );
-
-        TestNoConnectPins();
+        addTest( _( "Checking no connect pins for connections..." ), wxS( "TestNoConnectPins" ),
+                 true, []( ERC_TESTER& aTester ) { aTester.TestNoConnectPins(); } );
     }
 
     if( settings.IsTestEnabled( ERCE_LIB_SYMBOL_ISSUES )
         || settings.IsTestEnabled( ERCE_LIB_SYMBOL_MISMATCH ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking for library symbol issues..." ) );
-
-        TestLibSymbolIssues();
+        addTest( _( "Checking for library symbol issues..." ), wxS( "TestLibSymbolIssues" ), false,
+                 []( ERC_TESTER& aTester ) { aTester.TestLibSymbolIssues(); } );
     }
 
     if( settings.IsTestEnabled( ERCE_FOOTPRINT_LINK_ISSUES ) && aCvPcb )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking for footprint link issues..." ) );
-
-        TestFootprintLinkIssues( aCvPcb, aProject );
+        addTest( _( "Checking for footprint link issues..." ), wxS( "TestFootprintLinkIssues" ),
+                 false,
+                 [aCvPcb, aProject]( ERC_TESTER& aTester )
+                 {
+                     aTester.TestFootprintLinkIssues( aCvPcb, aProject );
+                 } );
     }
 
     if( settings.IsTestEnabled( ERCE_ENDPOINT_OFF_GRID ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking for off grid pins and wires..." ) );
-
-        TestOffGridEndpoints();
+        addTest( _( "Checking for off grid pins and wires..." ), wxS( "TestOffGridEndpoints" ),
+                 true, []( ERC_TESTER& aTester ) { aTester.TestOffGridEndpoints(); } );
     }
 
     if( settings.IsTestEnabled( ERCE_UNDEFINED_NETCLASS ) )
     {
-        if( aProgressReporter )
-            aProgressReporter->AdvancePhase( _( "Checking for undefined netclasses..." ) );
+        addTest( _( "Checking for undefined netclasses..." ), wxS( "TestMissingNetclasses" ),
+                 true, []( ERC_TESTER& aTester ) { aTester.TestMissingNetclasses(); } );
+    }
 
-        TestMissingNetclasses();
+    auto runTest =
+            []( TEST& aTest )
+            {
+                PROF_TIMER timer;
+                aTest.m_run( *aTest.m_tester );
+                aTest.m_msecs = timer.msecs();
+            };
+
+    thread_pool& tp = GetKiCadThreadPool();
+
+    for( TEST& test : tests )
+    {
+        if( test.m_run && test.m_parallel )
+            test.m_result = tp.submit( [&test, &runTest]() { runTest( test ); } );
+    }
+
+    try
+    {
+        for( TEST& test : tests )
+        {
+            if( aProgressReporter && !test.m_phase.IsEmpty() )
+                aProgressReporter->AdvancePhase( test.m_phase );
+
+            if( !test.m_run )
+                continue;
+
+            if( test.m_result.valid() )
+                test.m_result.get();
+            else
+                runTest( test );
+
+            m_timings.emplace_back( test.m_name, test.m_msecs );
+        }
+    }
+    catch( ... )
+    {
+        // The tests still running refer to the list
+        for( TEST& test : tests )
+        {
+            if( test.m_result.valid() )
+                test.m_result.wait();
+        }
+
+        throw;
+    }
+
+    // The screens are only modified once no test iterates over them anymore
+    for( TEST& test : tests )
+    {
+        if( !test.m_run )
+            continue;
+
+        for( const auto& [ screen, marker ] : test.m_tester->m_markers )
+            screen->Append( marker );
     }
 
     m_schematic->ResolveERCExclusionsPostUpdate();
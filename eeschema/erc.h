@@ -26,9 +26,13 @@
 #ifndef ERC_H
 #define ERC_H
 
+#include <vector>
+
 #include <erc_settings.h>
 
 
+class SCH_MARKER;
+class SCH_SCREEN;
 class SCH_SHEET_LIST;
 class SCHEMATIC;
 class DS_PROXY_VIEW_ITEM;
@@ -47,7 +51,8 @@ class ERC_TESTER
 public:
 
     ERC_TESTER( SCHEMATIC* aSchematic ) :
-            m_schematic( aSchematic )
+            m_schematic( aSchematic ),
+            m_bufferMarkers( false )
     {
     }
 
@@ -141,12 +146,34 @@ public:
      */
     int TestMissingNetclasses();
 
+    /**
+     * Run all the enabled tests.
+     *
+     * Tests which only read the schematic run in parallel.  The markers they find are added to
+     * the schematic in the same order as if the tests had run one after another.
+     */
     void RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet, SCH_EDIT_FRAME* aEditFrame,
                    KIFACE* aCvPcb, PROJECT* aProject, PROGRESS_REPORTER* aProgressReporter );
 
+    /**
+     * @return the name and the duration (in milliseconds) of each test run by the last call to
+     *         RunTests().
+     */
+    const std::vector<std::pair<wxString, double>>& GetTimings() const { return m_timings; }
+
 private:
+    /**
+     * Add \a aMarker to \a aScreen, or keep it in m_markers if the test is running in parallel
+     * with other tests.
+     */
+    void addMarker( SCH_SCREEN* aScreen, SCH_MARKER* aMarker );
 
     SCHEMATIC* m_schematic;
+
+    bool                                             m_bufferMarkers;
+    std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>> m_markers;
+
+    std::vector<std::pair<wxString, double>>         m_timings;
 };
 
 
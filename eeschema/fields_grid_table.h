@@ -114,13 +114,13 @@ protected:
     void onUnitsChanged( wxCommandEvent& aEvent );
 
 private:
-    SCH_BASE_FRAME* m_frame;
-    DIALOG_SHIM*    m_dialog;
-    KICAD_T         m_parentType;
-    int             m_mandatoryFieldCount;
-    LIB_SYMBOL*     m_part;
-    wxString        m_symbolNetlist;
-    wxString        m_curdir;
+    SCH_BASE_FRAME*   m_frame;
+    DIALOG_SHIM*      m_dialog;
+    KICAD_T           m_parentType;
+    int               m_mandatoryFieldCount;
+    const LIB_SYMBOL* m_part;
+    wxString          m_symbolNetlist;
+    wxString          m_curdir;
 
     FIELD_VALIDATOR   m_fieldNameValidator;
     FIELD_VALIDATOR   m_referenceValidator;
@@ -1210,6 +1210,23 @@ void LIB_SYMBOL::GetFields( std::vector<SCH_FIELD*>& aList )
 }
 
 
+void LIB_SYMBOL::GetFields( std::vector<const SCH_FIELD*>& aList ) const
+{
+    // Grab the MANDATORY_FIELDS first, in expected order given by enum MANDATORY_FIELD_T
+    for( int id = 0; id < MANDATORY_FIELDS; ++id )
+        aList.push_back( GetFieldById( id ) );
+
+    // Now grab all the rest of fields.
+    for( const SCH_ITEM& item : m_drawings[ SCH_FIELD_T ] )
+    {
+        const SCH_FIELD* field = static_cast<const SCH_FIELD*>( &item );
+
+        if( !field->IsMandatory() )
+            aList.push_back( field );
+    }
+}
+
+
 void LIB_SYMBOL::GetFields( std::vector<SCH_FIELD>& aList )
 {
     // Grab the MANDATORY_FIELDS first, in expected order given by enum MANDATORY_FIELD_T
@@ -276,6 +276,7 @@ public:
      * @param aList - List to add fields to
      */
     void GetFields( std::vector<SCH_FIELD*>& aList );
+    void GetFields( std::vector<const SCH_FIELD*>& aList ) const;
     void GetFields( std::vector<SCH_FIELD>& aList );
 
     /**
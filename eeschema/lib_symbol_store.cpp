@@ -0,0 +1,121 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <lib_symbol_store.h>
+
+#include <algorithm>
+
+#include <lib_symbol.h>
+#include <richio.h>
+#include <sch_io/kicad_sexpr/sch_io_kicad_sexpr.h>
+
+
+LIB_SYMBOL_STORE::LIB_SYMBOL_STORE() :
+        m_pruneSize( 256 )
+{
+}
+
+
+LIB_SYMBOL_STORE& LIB_SYMBOL_STORE::Get()
+{
+    static LIB_SYMBOL_STORE store;
+
+    return store;
+}
+
+
+std::shared_ptr<LIB_SYMBOL> LIB_SYMBOL_STORE::Acquire( const LIB_SYMBOL& aLibSymbol )
+{
+    // The file format holds everything a schematic symbol can see of its library symbol,
+    // except the library identifier which is replaced by the name in the embedded copies.
+    STRING_FORMATTER formatter;
+
+    formatter.Print( 0, "%s\n", aLibSymbol.GetLibId().Format().c_str() );
+    SCH_IO_KICAD_SEXPR::FormatLibSymbol( const_cast<LIB_SYMBOL*>( &aLibSymbol ), formatter );
+
+    const std::string& content = formatter.GetString();
+    size_t             hash = std::hash<std::string>()( content );
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    auto [ first, last ] = m_entries.equal_range( hash );
+
+    for( auto it = first; it != last; ++it )
+    {
+        if( it->second.m_content != content )
+            continue;
+
+        if( std::shared_ptr<LIB_SYMBOL> symbol = it->second.m_symbol.lock() )
+            return symbol;
+
+        // Nobody uses the symbol anymore, give the entry a new one
+        std::shared_ptr<LIB_SYMBOL> symbol = makeShared( aLibSymbol );
+        it->second.m_symbol = symbol;
+        return symbol;
+    }
+
+    if( m_entries.size() >= m_pruneSize )
+    {
+        prune();
+        m_pruneSize = std::max<size_t>( 256, 2 * m_entries.size() );
+    }
+
+    std::shared_ptr<LIB_SYMBOL> symbol = makeShared( aLibSymbol );
+    m_entries.emplace( hash, ENTRY{ content, symbol } );
+
+    return symbol;
+}
+
+
+std::shared_ptr<LIB_SYMBOL> LIB_SYMBOL_STORE::makeShared( const LIB_SYMBOL& aLibSymbol )
+{
+    std::shared_ptr<LIB_SYMBOL> symbol = std::make_shared<LIB_SYMBOL>( aLibSymbol );
+
+    // Nobody can sort the draw items once the symbol is shared.  The file format is written
+    // in this order too, so it doesn't change the content of the symbol.
+    symbol->GetDrawItems().sort();
+
+    return symbol;
+}
+
+
+size_t LIB_SYMBOL_STORE::GetCount()
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    prune();
+
+    return m_entries.size();
+}
+
+
+void LIB_SYMBOL_STORE::prune()
+{
+    for( auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        if( it->second.m_symbol.expired() )
+            it = m_entries.erase( it );
+        else
+            ++it;
+    }
+}
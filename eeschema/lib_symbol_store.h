@@ -0,0 +1,91 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef LIB_SYMBOL_STORE_H
+#define LIB_SYMBOL_STORE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class LIB_SYMBOL;
+
+
+/**
+ * Hold the flattened library symbols used by the symbols of all the open schematics.
+ *
+ * Schematic symbols referencing identical library symbols, on the same screen or not, share
+ * a single #LIB_SYMBOL instead of each owning a copy of it.  Library symbols are identified
+ * by their content, so a library symbol modified in one screen is no longer shared with the
+ * symbols of the other screens.
+ *
+ * The store only keeps weak references: a library symbol is freed when the last schematic
+ * symbol using it goes away.
+ */
+class LIB_SYMBOL_STORE
+{
+public:
+    LIB_SYMBOL_STORE();
+
+    /**
+     * @return the store shared by all the schematics.
+     */
+    static LIB_SYMBOL_STORE& Get();
+
+    /**
+     * Return a library symbol identical to \a aLibSymbol, shared with all the other callers
+     * asking for the same symbol.
+     *
+     * The returned symbol must not be modified, as it can be used by any number of schematic
+     * symbols: holders wanting to change it must make their own copy first.  Its draw items
+     * are sorted.  This is safe to call from several threads.
+     *
+     * @param aLibSymbol is the (flattened) library symbol to share.
+     */
+    std::shared_ptr<LIB_SYMBOL> Acquire( const LIB_SYMBOL& aLibSymbol );
+
+    /**
+     * @return the number of library symbols currently shared.
+     */
+    size_t GetCount();
+
+private:
+    /// Drop the entries of the library symbols nobody uses anymore.
+    void prune();
+
+    /// Make the shared copy of \a aLibSymbol.
+    static std::shared_ptr<LIB_SYMBOL> makeShared( const LIB_SYMBOL& aLibSymbol );
+
+    struct ENTRY
+    {
+        std::string                m_content;   ///< The symbol in the file format.
+        std::weak_ptr<LIB_SYMBOL>  m_symbol;
+    };
+
+    std::mutex                             m_mutex;
+    std::unordered_multimap<size_t, ENTRY> m_entries;     ///< Entries by content hash.
+    size_t                                 m_pruneSize;   ///< Entry count triggering a prune.
+};
+
+#endif  // LIB_SYMBOL_STORE_H
@@ -182,7 +182,7 @@ std::vector<PIN_INFO> NETLIST_EXPORTER_BASE::CreatePinList( SCH_SYMBOL* aSymbol,
     eraseDuplicatePins( pins );
 
     // record the usage of this library symbol
-    m_libParts.insert( aSymbol->GetLibSymbolRef().get() ); // rejects non-unique pointers
+    m_libParts.insert( aSymbol->GetLibSymbolRef() ); // rejects non-unique pointers
 
     return pins;
 }
@@ -65,7 +65,7 @@ public:
 struct LIB_SYMBOL_LESS_THAN
 {
     // a "less than" test on two LIB_SYMBOLs (.m_name wxStrings)
-    bool operator()( LIB_SYMBOL* const& libsymbol1, LIB_SYMBOL* const& libsymbol2 ) const
+    bool operator()( const LIB_SYMBOL* libsymbol1, const LIB_SYMBOL* libsymbol2 ) const
     {
         // Use case specific GetName() wxString compare
         return libsymbol1->GetLibId() < libsymbol2->GetLibId();
@@ -197,7 +197,7 @@ protected:
     UNIQUE_STRINGS        m_referencesAlreadyFound;
 
     /// unique library symbols used. LIB_SYMBOL items are sorted by names
-    std::set<LIB_SYMBOL*, LIB_SYMBOL_LESS_THAN> m_libParts;
+    std::set<const LIB_SYMBOL*, LIB_SYMBOL_LESS_THAN> m_libParts;
 
     /// The schematic we're generating a netlist for
     SCHEMATIC_IFACE*      m_schematic;
@@ -53,7 +53,107 @@ bool NETLIST_EXPORTER_KICAD::WriteNetlist( const wxString& aOutFileName, unsigne
 
 void NETLIST_EXPORTER_KICAD::Format( OUTPUTFORMATTER* aOut, int aCtl )
 {
-    std::unique_ptr<XNODE> xroot( makeRoot( aCtl ) );
+    // Same output as XNODE::Format() of the makeRoot() tree: each child is preceded by a new
+    // line and the last one is directly followed by the closing parenthesis of its parent.
+    aOut->Print( 0, "(export (version %s)", aOut->Quotew( wxT( "E" ) ).c_str() );
 
-    xroot->Format( aOut, 0 );
+    auto formatSection =
+            [&]( XNODE* aSection )
+            {
+                std::unique_ptr<XNODE> xsection( aSection );
+
+                aOut->Print( 0, "\n" );
+                xsection->Format( aOut, 1 );
+            };
+
+    // The symbols and library parts are written one at a time, as they are built
+    auto formatSectionNode =
+            [&]( XNODE* aNode )
+            {
+                std::unique_ptr<XNODE> xnode( aNode );
+
+                aOut->Print( 0, "\n" );
+                xnode->Format( aOut, 2 );
+            };
+
+    if( aCtl & GNL_HEADER )
+        formatSection( makeDesignHeader() );
+
+    if( aCtl & GNL_SYMBOLS )
+    {
+        aOut->Print( 0, "\n" );
+        aOut->Print( 1, "(components" );
+        visitSymbols( aCtl, formatSectionNode );
+        aOut->Print( 0, ")" );
+    }
+
+    if( aCtl & GNL_PARTS )
+    {
+        aOut->Print( 0, "\n" );
+        aOut->Print( 1, "(libparts" );
+        visitLibParts( formatSectionNode );
+        aOut->Print( 0, ")" );
+    }
+
+    if( aCtl & GNL_LIBRARIES )
+        // must follow visitLibParts()
+        formatSection( makeLibraries() );
+
+    if( aCtl & GNL_NETS )
+    {
+        aOut->Print( 0, "\n" );
+        formatNets( aOut, 1, aCtl );
+    }
+
+    aOut->Print( 0, ")" );
+}
+
+
+void NETLIST_EXPORTER_KICAD::formatNets( OUTPUTFORMATTER* aOut, int aNestLevel, unsigned aCtl )
+{
+    aOut->Print( aNestLevel, "(nets" );
+
+    visitNets( aCtl,
+            [&]( const NET_RECORD& aNet )
+            {
+                bool added = false;
+
+                for( const NET_NODE& netNode : aNet.m_Nodes )
+                {
+                    // Skip power symbols and virtual symbols
+                    if( netNode.m_Ref[0] == wxChar( '#' ) )
+                        continue;
+
+                    if( !added )
+                    {
+                        aOut->Print( 0, "\n" );
+                        aOut->Print( aNestLevel + 1, "(net (code %s) (name %s)",
+                                     aOut->Quotew( wxString::Format( wxT( "%d" ),
+                                                                     aNet.m_Code ) ).c_str(),
+                                     aOut->Quotew( aNet.m_Name ).c_str() );
+                        added = true;
+                    }
+
+                    wxString pinName = netNode.m_Pin->GetShownName();
+                    wxString pinType = netNode.m_Pin->GetCanonicalElectricalTypeName();
+
+                    if( aNet.m_NoConnectPins )
+                        pinType += wxT( "+no_connect" );
+
+                    aOut->Print( 0, "\n" );
+                    aOut->Print( aNestLevel + 2, "(node (ref %s) (pin %s)",
+                                 aOut->Quotew( netNode.m_Ref ).c_str(),
+                                 aOut->Quotew( netNode.m_PinNumber ).c_str() );
+
+                    if( !pinName.IsEmpty() )
+                        aOut->Print( 0, " (pinfunction %s)", aOut->Quotew( pinName ).c_str() );
+
+                    aOut->Print( 0, " (pintype %s))", aOut->Quotew( pinType ).c_str() );
+                }
+
+                if( added )
+                    aOut->Print( 0, ")" );
+            } );
+
+    aOut->Print( 0, ")" );
 }
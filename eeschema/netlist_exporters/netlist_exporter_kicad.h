@@ -53,12 +53,22 @@ public:
     /**
      * Output this s-expression netlist into @a aOutputFormatter.
      *
+     * The symbols, library parts and nets are written one at a time as they are built, so the
+     * document tree built by makeRoot() is never held in memory.  Only the small design header
+     * and library sections are built as trees.  The output is the same as formatting the tree.
+     *
      * @param aOutputFormatter is the destination of the serialization to text.
      * @param aCtl is bit set composed by OR-ing together enum GNL bits, it allows outputting
      *  a subset of the full document model.
      * @throw IO_ERROR if any problems.
      */
     void Format( OUTPUTFORMATTER* aOutputFormatter, int aCtl );
+
+private:
+    /**
+     * Write the "nets" section, as makeListOfNets() would build it, without building it.
+     */
+    void formatNets( OUTPUTFORMATTER* aOut, int aNestLevel, unsigned aCtl );
 };
 
 #endif
@@ -32,6 +32,7 @@
 #include <string_utils.h>
 #include <connection_graph.h>
 #include <core/kicad_algo.h>
+#include <core/thread_pool.h>
 #include <wx/wfstream.h>
 #include <xnode.h>      // also nests: <wx/xml/xml.h>
 #include <nlohmann/json.hpp>
@@ -243,6 +244,19 @@ XNODE* NETLIST_EXPORTER_XML::makeSymbols( unsigned aCtl )
 {
     XNODE* xcomps = node( wxT( "components" ) );
 
+    visitSymbols( aCtl,
+            [&]( XNODE* aComp )
+            {
+                xcomps->AddChild( aComp );
+            } );
+
+    return xcomps;
+}
+
+
+void NETLIST_EXPORTER_XML::visitSymbols( unsigned aCtl,
+                                         const std::function<void( XNODE* )>& aVisitor )
+{
     m_referencesAlreadyFound.Clear();
     m_libParts.clear();
 
@@ -304,8 +318,7 @@ XNODE* NETLIST_EXPORTER_XML::makeSymbols( unsigned aCtl )
             // not always look best, but it will allow faster execution under XSL processing
             // systems which do sequential searching within an element.
 
-            XNODE* xcomp;  // current symbol being constructed
-            xcomps->AddChild( xcomp = node( wxT( "comp" ) ) );
+            XNODE* xcomp = node( wxT( "comp" ) );  // current symbol being constructed
 
             xcomp->AddAttribute( wxT( "ref" ), symbol->GetRef( &sheet ) );
             addSymbolFields( xcomp, symbol, &sheet );
@@ -383,7 +396,7 @@ XNODE* NETLIST_EXPORTER_XML::makeSymbols( unsigned aCtl )
                 xproperty->AddAttribute( wxT( "name" ), wxT( "dnp" ) );
             }
 
-            if( const std::unique_ptr<LIB_SYMBOL>& part = symbol->GetLibSymbolRef() )
+            if( const LIB_SYMBOL* part = symbol->GetLibSymbolRef() )
             {
                 if( part->GetKeyWords().size() )
                 {
@@ -433,12 +446,12 @@ XNODE* NETLIST_EXPORTER_XML::makeSymbols( unsigned aCtl )
             // Output the primary UUID
             uuid = symbol->m_Uuid.AsString();
             xunits->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, uuid ) );
+
+            aVisitor( xcomp );
         }
     }
 
     m_schematic->SetCurrentSheet( currentSheet );
-
-    return xcomps;
 }
 
 
@@ -569,14 +582,26 @@ XNODE* NETLIST_EXPORTER_XML::makeLibraries()
 
 XNODE* NETLIST_EXPORTER_XML::makeLibParts()
 {
-    XNODE*                  xlibparts = node( wxT( "libparts" ) );   // auto_ptr
+    XNODE* xlibparts = node( wxT( "libparts" ) );   // auto_ptr
 
-    std::vector<LIB_PIN*>   pinList;
-    std::vector<SCH_FIELD*> fieldList;
+    visitLibParts(
+            [&]( XNODE* aLibPart )
+            {
+                xlibparts->AddChild( aLibPart );
+            } );
+
+    return xlibparts;
+}
+
+
+void NETLIST_EXPORTER_XML::visitLibParts( const std::function<void( XNODE* )>& aVisitor )
+{
+    std::vector<LIB_PIN*>         pinList;
+    std::vector<const SCH_FIELD*> fieldList;
 
     m_libraries.clear();
 
-    for( LIB_SYMBOL* lcomp : m_libParts )
+    for( const LIB_SYMBOL* lcomp : m_libParts )
     {
         wxString libNickname = lcomp->GetLibId().GetLibNickname();;
 
@@ -584,8 +609,7 @@ XNODE* NETLIST_EXPORTER_XML::makeLibParts()
         if( !libNickname.IsEmpty() )
             m_libraries.insert( libNickname );  // inserts symbol's library if unique
 
-        XNODE* xlibpart;
-        xlibparts->AddChild( xlibpart = node( wxT( "libpart" ) ) );
+        XNODE* xlibpart = node( wxT( "libpart" ) );
         xlibpart->AddAttribute( wxT( "lib" ), libNickname );
         xlibpart->AddAttribute( wxT( "part" ), lcomp->GetName()  );
 
@@ -659,182 +683,186 @@ XNODE* NETLIST_EXPORTER_XML::makeLibParts()
                 // caution: construction work site here, drive slowly
             }
         }
-    }
 
-    return xlibparts;
+        aVisitor( xlibpart );
+    }
 }
 
 
-XNODE* NETLIST_EXPORTER_XML::makeListOfNets( unsigned aCtl )
+void NETLIST_EXPORTER_XML::visitNets( unsigned aCtl,
+                                      const std::function<void( const NET_RECORD& )>& aVisitor )
 {
-    XNODE*      xnets = node( wxT( "nets" ) );      // auto_ptr if exceptions ever get used.
-    wxString    netCodeTxt;
-    wxString    netName;
-    wxString    ref;
+    // Number of nets prepared together on the thread pool before being visited
+    static const size_t NETS_PER_BATCH = 1024;
 
-    XNODE*      xnet = nullptr;
+    using NET_ENTRY = std::pair<const wxString*, const std::vector<CONNECTION_SUBGRAPH*>*>;
 
-    /*  output:
-        <net code="123" name="/cfcard.sch/WAIT#">
-            <node ref="R23" pin="1"/>
-            <node ref="U18" pin="12"/>
-        </net>
-    */
-
-    struct NET_NODE
-    {
-        NET_NODE( SCH_PIN* aPin, const SCH_SHEET_PATH& aSheet ) : m_Pin( aPin ), m_Sheet( aSheet )
-        {}
-
-        SCH_PIN*       m_Pin;
-        SCH_SHEET_PATH m_Sheet;
-    };
-
-    struct NET_RECORD
-    {
-        NET_RECORD( const wxString& aName ) : m_Name( aName ), m_HasNoConnect( false ){};
-
-        wxString              m_Name;
-        bool                  m_HasNoConnect;
-        std::vector<NET_NODE> m_Nodes;
-    };
-
-    std::vector<NET_RECORD*> nets;
+    std::vector<NET_ENTRY> netList;
 
     for( const auto& [ key, subgraphs ] : m_schematic->ConnectionGraph()->GetNetMap() )
     {
-        wxString    net_name  = key.Name;
-        NET_RECORD* net_record = nullptr;
-
-        if( subgraphs.empty() )
-            continue;
+        if( !subgraphs.empty() )
+            netList.emplace_back( &key.Name, &subgraphs );
+    }
 
-        nets.emplace_back( new NET_RECORD( net_name ) );
-        net_record = nets.back();
+    // Netlist ordering: Net name, then ref des, then pin name
+    std::sort( netList.begin(), netList.end(),
+               []( const NET_ENTRY& a, const NET_ENTRY& b )
+               {
+                   return StrNumCmp( *a.first, *b.first ) < 0;
+               } );
 
-        for( CONNECTION_SUBGRAPH* subgraph : subgraphs )
-        {
-            bool nc = subgraph->GetNoConnect() && subgraph->GetNoConnect()->Type() == SCH_NO_CONNECT_T;
-            const SCH_SHEET_PATH& sheet = subgraph->GetSheet();
+    auto buildNet =
+            [&]( size_t aIndex, NET_RECORD& aNet )
+            {
+                const auto& [ netName, subgraphs ] = netList[aIndex];
+                bool        hasNoConnect = false;
 
-            if( nc )
-                net_record->m_HasNoConnect = true;
+                aNet.m_Code = (int) aIndex + 1;
+                aNet.m_Name = *netName;
+                aNet.m_Nodes.clear();
 
-            for( SCH_ITEM* item : subgraph->GetItems() )
-            {
-                if( item->Type() == SCH_PIN_T )
+                for( CONNECTION_SUBGRAPH* subgraph : *subgraphs )
                 {
-                    SCH_PIN* pin = static_cast<SCH_PIN*>( item );
-                    SYMBOL*  symbol = pin->GetParentSymbol();
+                    const SCH_SHEET_PATH& sheet = subgraph->GetSheet();
 
-                    if( !symbol
-                       || ( ( aCtl & GNL_OPT_BOM ) && symbol->GetExcludedFromBOM() )
-                       || ( ( aCtl & GNL_OPT_KICAD ) && symbol->GetExcludedFromBoard() ) )
+                    if( subgraph->GetNoConnect()
+                            && subgraph->GetNoConnect()->Type() == SCH_NO_CONNECT_T )
                     {
-                        continue;
+                        hasNoConnect = true;
                     }
 
-                    net_record->m_Nodes.emplace_back( pin, sheet );
-                }
-            }
-        }
-    }
+                    for( SCH_ITEM* item : subgraph->GetItems() )
+                    {
+                        if( item->Type() != SCH_PIN_T )
+                            continue;
 
-    // Netlist ordering: Net name, then ref des, then pin name
-    std::sort( nets.begin(), nets.end(),
-               []( const NET_RECORD* a, const NET_RECORD*b )
-               {
-                   return StrNumCmp( a->m_Name, b->m_Name ) < 0;
-               } );
+                        SCH_PIN* pin = static_cast<SCH_PIN*>( item );
+                        SYMBOL*  symbol = pin->GetParentSymbol();
 
-    for( int i = 0; i < (int) nets.size(); ++i )
-    {
-        NET_RECORD* net_record = nets[i];
-        bool        added = false;
-        XNODE*      xnode;
+                        if( !symbol
+                           || ( ( aCtl & GNL_OPT_BOM ) && symbol->GetExcludedFromBOM() )
+                           || ( ( aCtl & GNL_OPT_KICAD ) && symbol->GetExcludedFromBoard() ) )
+                        {
+                            continue;
+                        }
 
-        // Netlist ordering: Net name, then ref des, then pin name
-        std::sort( net_record->m_Nodes.begin(), net_record->m_Nodes.end(),
-        []( const NET_NODE& a, const NET_NODE& b )
+                        aNet.m_Nodes.push_back( { pin, symbol->GetRef( &sheet ),
+                                                  pin->GetShownNumber() } );
+                    }
+                }
+
+                // Netlist ordering: Net name, then ref des, then pin name
+                std::sort( aNet.m_Nodes.begin(), aNet.m_Nodes.end(),
+                           []( const NET_NODE& a, const NET_NODE& b )
+                           {
+                               if( a.m_Ref == b.m_Ref )
+                                   return a.m_PinNumber < b.m_PinNumber;
+
+                               return a.m_Ref < b.m_Ref;
+                           } );
+
+                // Some duplicates can exist, for example on multi-unit parts with duplicated pins
+                // across units.  If the user connects the pins on each unit, they will appear on
+                // separate subgraphs.  Remove those here:
+                alg::remove_duplicates( aNet.m_Nodes,
+                        []( const NET_NODE& a, const NET_NODE& b )
+                        {
+                            return a.m_Ref == b.m_Ref && a.m_PinNumber == b.m_PinNumber;
+                        } );
+
+                // Determine if all pins in the net are stacked (nets with only one pin are
+                // implicitly taken to be stacked)
+                bool allNetPinsStacked = true;
+
+                if( aNet.m_Nodes.size() > 1 )
                 {
-                    wxString refA = a.m_Pin->GetParentSymbol()->GetRef( &a.m_Sheet );
-                    wxString refB = b.m_Pin->GetParentSymbol()->GetRef( &b.m_Sheet );
+                    SCH_PIN* firstPin = aNet.m_Nodes.begin()->m_Pin;
+                    allNetPinsStacked =
+                            std::all_of( aNet.m_Nodes.begin() + 1, aNet.m_Nodes.end(),
+                                         [=]( const NET_NODE& node )
+                                         {
+                                             SCH_PIN* pin = node.m_Pin;
+
+                                             return firstPin->GetParent() == pin->GetParent()
+                                                 && firstPin->GetPosition() == pin->GetPosition()
+                                                 && firstPin->GetName() == pin->GetName();
+                                         } );
+                }
 
-                    if( refA == refB )
-                        return a.m_Pin->GetShownNumber() < b.m_Pin->GetShownNumber();
+                aNet.m_NoConnectPins = hasNoConnect
+                                       && ( aNet.m_Nodes.size() == 1 || allNetPinsStacked );
+            };
 
-                    return refA < refB;
-                } );
+    thread_pool&            tp = GetKiCadThreadPool();
+    std::vector<NET_RECORD> batch;
 
-        // Some duplicates can exist, for example on multi-unit parts with duplicated pins across
-        // units.  If the user connects the pins on each unit, they will appear on separate
-        // subgraphs.  Remove those here:
-        alg::remove_duplicates( net_record->m_Nodes,
-                []( const NET_NODE& a, const NET_NODE& b )
-                {
-                    wxString refA = a.m_Pin->GetParentSymbol()->GetRef( &a.m_Sheet );
-                    wxString refB = b.m_Pin->GetParentSymbol()->GetRef( &b.m_Sheet );
+    for( size_t first = 0; first < netList.size(); first += NETS_PER_BATCH )
+    {
+        batch.resize( std::min( NETS_PER_BATCH, netList.size() - first ) );
 
-                    return refA == refB && a.m_Pin->GetShownNumber() == b.m_Pin->GetShownNumber();
+        tp.push_loop( batch.size(),
+                [&]( const int a, const int b )
+                {
+                    for( int ii = a; ii < b; ++ii )
+                        buildNet( first + ii, batch[ii] );
                 } );
+        tp.wait_for_tasks();
 
-        // Determine if all pins in the net are stacked (nets with only one pin are implicitly
-        // taken to be stacked)
-        bool allNetPinsStacked = true;
+        for( const NET_RECORD& net : batch )
+            aVisitor( net );
+    }
+}
 
-        if( net_record->m_Nodes.size() > 1 )
-        {
-            SCH_PIN* firstPin = net_record->m_Nodes.begin()->m_Pin;
-            allNetPinsStacked =
-                    std::all_of( net_record->m_Nodes.begin() + 1, net_record->m_Nodes.end(),
-                                 [=]( auto& node )
-                                 {
-                                     return firstPin->GetParent() == node.m_Pin->GetParent()
-                                            && firstPin->GetPosition() == node.m_Pin->GetPosition()
-                                            && firstPin->GetName() == node.m_Pin->GetName();
-                                 } );
-        }
 
-        for( const NET_NODE& netNode : net_record->m_Nodes )
-        {
-            wxString refText = netNode.m_Pin->GetParentSymbol()->GetRef( &netNode.m_Sheet );
-            wxString pinText = netNode.m_Pin->GetShownNumber();
+XNODE* NETLIST_EXPORTER_XML::makeListOfNets( unsigned aCtl )
+{
+    XNODE*      xnets = node( wxT( "nets" ) );      // auto_ptr if exceptions ever get used.
 
-            // Skip power symbols and virtual symbols
-            if( refText[0] == wxChar( '#' ) )
-                continue;
+    /*  output:
+        <net code="123" name="/cfcard.sch/WAIT#">
+            <node ref="R23" pin="1"/>
+            <node ref="U18" pin="12"/>
+        </net>
+    */
 
-            if( !added )
+    visitNets( aCtl,
+            [&]( const NET_RECORD& aNet )
             {
-                netCodeTxt.Printf( wxT( "%d" ), i + 1 );
+                XNODE* xnet = nullptr;
 
-                xnets->AddChild( xnet = node( wxT( "net" ) ) );
-                xnet->AddAttribute( wxT( "code" ), netCodeTxt );
-                xnet->AddAttribute( wxT( "name" ), net_record->m_Name );
+                for( const NET_NODE& netNode : aNet.m_Nodes )
+                {
+                    // Skip power symbols and virtual symbols
+                    if( netNode.m_Ref[0] == wxChar( '#' ) )
+                        continue;
 
-                added = true;
-            }
+                    if( !xnet )
+                    {
+                        xnets->AddChild( xnet = node( wxT( "net" ) ) );
+                        xnet->AddAttribute( wxT( "code" ), wxString::Format( wxT( "%d" ),
+                                                                             aNet.m_Code ) );
+                        xnet->AddAttribute( wxT( "name" ), aNet.m_Name );
+                    }
 
-            xnet->AddChild( xnode = node( wxT( "node" ) ) );
-            xnode->AddAttribute( wxT( "ref" ), refText );
-            xnode->AddAttribute( wxT( "pin" ), pinText );
+                    XNODE* xnode;
 
-            wxString pinName = netNode.m_Pin->GetShownName();
-            wxString pinType = netNode.m_Pin->GetCanonicalElectricalTypeName();
+                    xnet->AddChild( xnode = node( wxT( "node" ) ) );
+                    xnode->AddAttribute( wxT( "ref" ), netNode.m_Ref );
+                    xnode->AddAttribute( wxT( "pin" ), netNode.m_PinNumber );
 
-            if( !pinName.IsEmpty() )
-                xnode->AddAttribute( wxT( "pinfunction" ), pinName );
+                    wxString pinName = netNode.m_Pin->GetShownName();
+                    wxString pinType = netNode.m_Pin->GetCanonicalElectricalTypeName();
 
-            if( net_record->m_HasNoConnect
-                && ( net_record->m_Nodes.size() == 1 || allNetPinsStacked ) )
-                pinType += wxT( "+no_connect" );
+                    if( !pinName.IsEmpty() )
+                        xnode->AddAttribute( wxT( "pinfunction" ), pinName );
 
-            xnode->AddAttribute( wxT( "pintype" ), pinType );
-        }
-    }
+                    if( aNet.m_NoConnectPins )
+                        pinType += wxT( "+no_connect" );
 
-    for( NET_RECORD* record : nets )
-        delete record;
+                    xnode->AddAttribute( wxT( "pintype" ), pinType );
+                }
+            } );
 
     return xnets;
 }
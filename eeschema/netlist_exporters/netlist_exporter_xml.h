@@ -28,11 +28,14 @@
 
 #include <netlist_exporter_base.h>
 
+#include <functional>
+
 #include <project.h>
 
 #include <sch_edit_frame.h>
 
 class CONNECTION_GRAPH;
+class SCH_PIN;
 class SYMBOL_LIB_TABLE;
 class XNODE;
 
@@ -70,6 +73,9 @@ public:
     /**
      * Write generic netlist to \a aOutFileName.
      *
+     * The whole makeRoot() tree is built and saved through wxXmlDocument; unlike the KiCad
+     * netlist, the XML netlist is not streamed.
+     *
      * @param aOutFileName is the file name to write.
      * @param aNetlistOptions are the options used to control the netlist output.
      *
@@ -81,6 +87,23 @@ public:
 #define GNL_ALL     ( GNL_LIBRARIES | GNL_SYMBOLS | GNL_PARTS | GNL_HEADER | GNL_NETS )
 
 protected:
+    /// A pin of a net, with the strings it is sorted by.
+    struct NET_NODE
+    {
+        SCH_PIN* m_Pin;
+        wxString m_Ref;
+        wxString m_PinNumber;
+    };
+
+    /// A net ready to be written, with its pins in netlist order.
+    struct NET_RECORD
+    {
+        int                   m_Code;          ///< Net code written in the netlist.
+        wxString              m_Name;
+        bool                  m_NoConnectPins; ///< Pins get the "+no_connect" pin type suffix.
+        std::vector<NET_NODE> m_Nodes;         ///< Sorted by ref then pin, without duplicates.
+    };
+
    /**
      * A convenience function that creates a new XNODE with an optional textual child.
      * It also provides some insulation from a possible change in XML library.
@@ -105,6 +128,14 @@ protected:
      */
     XNODE* makeSymbols( unsigned aCtl );
 
+    /**
+     * Build the "comp" node of each schematic symbol in netlist order, and pass it to
+     * \a aVisitor, which takes ownership of it.
+     *
+     * @param aCtl a bitset or-ed together from GNL_ENUM values, used to filter symbols.
+     */
+    void visitSymbols( unsigned aCtl, const std::function<void( XNODE* )>& aVisitor );
+
     /**
      * Fill out a project "design" header into an XML node.
      * @return the design header
@@ -117,12 +148,29 @@ protected:
      */
     XNODE* makeLibParts();
 
+    /**
+     * Build the "libpart" node of each library symbol used by the symbols visited by
+     * visitSymbols(), and pass it to \a aVisitor, which takes ownership of it.
+     */
+    void visitLibParts( const std::function<void( XNODE* )>& aVisitor );
+
     /**
      * Fill out an XML node with a list of nets and returns it.
      * @return the list of nets nodes
      */
     XNODE* makeListOfNets( unsigned aCtl );
 
+    /**
+     * Call \a aVisitor for each net of the connection graph, in netlist order.
+     *
+     * Only the net names are sorted up front.  The pins of the nets are gathered and sorted
+     * by batches on the thread pool, and each batch is released once visited, so the pin lists
+     * of the whole design are never held in memory together.
+     *
+     * @param aCtl a bitset or-ed together from GNL_ENUM values, used to filter symbols.
+     */
+    void visitNets( unsigned aCtl, const std::function<void( const NET_RECORD& )>& aVisitor );
+
     /**
      * Fill out an XML node with a list of used libraries and returns it.
      * Must have called makeGenericLibParts() before this function.
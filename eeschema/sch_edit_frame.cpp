@@ -1839,6 +1839,9 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_COMMIT* aCommit, SCH_CLEANUP_FL
 
         new_graph.Recalculate( list, false, &changeHandler );
         Schematic().ConnectionGraph()->Merge( new_graph );
+
+        if( ADVANCED_CFG::GetCfg().m_VerifyIncrementalConnectivity )
+            Schematic().ConnectionGraph()->VerifyIncremental( list, &changeHandler );
     }
 
     GetCanvas()->GetView()->UpdateAllItemsConditionally(
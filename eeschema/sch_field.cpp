@@ -101,6 +101,8 @@ SCH_FIELD::SCH_FIELD( const SCH_FIELD& aField ) :
             m_renderCache.emplace_back( std::make_unique<KIFONT::OUTLINE_GLYPH>( *outline ) );
         else if( KIFONT::STROKE_GLYPH* stroke = dynamic_cast<KIFONT::STROKE_GLYPH*>( glyph.get() ) )
             m_renderCache.emplace_back( std::make_unique<KIFONT::STROKE_GLYPH>( *stroke ) );
+        else if( auto* shared = dynamic_cast<KIFONT::SHARED_OUTLINE_GLYPH*>( glyph.get() ) )
+            m_renderCache.emplace_back( std::make_unique<KIFONT::SHARED_OUTLINE_GLYPH>( *shared ) );
     }
 
     m_renderCacheValid = aField.m_renderCacheValid;
@@ -128,6 +130,8 @@ SCH_FIELD& SCH_FIELD::operator=( const SCH_FIELD& aField )
             m_renderCache.emplace_back( std::make_unique<KIFONT::OUTLINE_GLYPH>( *outline ) );
         else if( KIFONT::STROKE_GLYPH* stroke = dynamic_cast<KIFONT::STROKE_GLYPH*>( glyph.get() ) )
             m_renderCache.emplace_back( std::make_unique<KIFONT::STROKE_GLYPH>( *stroke ) );
+        else if( auto* shared = dynamic_cast<KIFONT::SHARED_OUTLINE_GLYPH*>( glyph.get() ) )
+            m_renderCache.emplace_back( std::make_unique<KIFONT::SHARED_OUTLINE_GLYPH>( *shared ) );
     }
 
     m_renderCacheValid = aField.m_renderCacheValid;
@@ -361,6 +365,8 @@ SCH_FIELD::GetRenderCache( const wxString& forResolvedText, const VECTOR2I& forP
             {
                 if( glyph->IsOutline() )
                     static_cast<KIFONT::OUTLINE_GLYPH*>( glyph.get() )->Move( delta );
+                else if( glyph->IsSharedOutline() )
+                    static_cast<KIFONT::SHARED_OUTLINE_GLYPH*>( glyph.get() )->Move( delta );
                 else
                     static_cast<KIFONT::STROKE_GLYPH*>( glyph.get() )->Move( delta );
             }
@@ -25,6 +25,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <core/thread_pool.h>
 #include <database/database_connection.h>
 #include <database/database_lib_settings.h>
 #include <fmt.h>
@@ -46,6 +47,9 @@ SCH_IO_DATABASE::SCH_IO_DATABASE() : SCH_IO( wxS( "Database library" ) ),
 
 SCH_IO_DATABASE::~SCH_IO_DATABASE()
 {
+    // Don't wait for a pending refresh: it owns its state, and stops before its next table
+    if( m_snapshotRefresh )
+        m_snapshotRefresh->m_cancelled.store( true );
 }
 
 
@@ -205,17 +209,48 @@ void SCH_IO_DATABASE::cacheLib()
 {
     long long currentTimestampSeconds = wxDateTime::Now().GetValue().GetValue() / 1000;
 
-    if( m_libTable->GetModifyHash() == m_cacheModifyHash
+    bool refreshed = finishSnapshotRefresh();
+
+    if( !refreshed && m_libTable->GetModifyHash() == m_cacheModifyHash
         && ( currentTimestampSeconds - m_cacheTimestamp ) < m_settings->m_Cache.max_age )
     {
         return;
     }
 
+    if( m_settings->m_Cache.snapshot && !m_snapshot )
+    {
+        m_snapshot = std::make_unique<DATABASE_SNAPSHOT>(
+                DATABASE_SNAPSHOT::GetFileNameFor( m_settings->GetFilename() ) );
+        m_snapshot->Load();
+    }
+
+    bool snapshotModified = false;
+    bool needsRefresh = false;
+
     for( const DATABASE_LIB_TABLE& table : m_settings->m_Tables )
     {
-        std::vector<DATABASE_CONNECTION::ROW> results;
+        const DATABASE_SNAPSHOT::TABLE* snapshotTable =
+                m_snapshot ? m_snapshot->GetTable( table.table ) : nullptr;
+        DATABASE_SNAPSHOT::TABLE fetched;
+        const std::vector<DATABASE_CONNECTION::ROW>* results = nullptr;
 
-        if( !m_conn->SelectAll( table.table, table.key_col, results ) )
+        if( snapshotTable && isSnapshotCurrent( table, *snapshotTable ) )
+        {
+            wxLogTrace( traceDatabase, wxT( "cacheLib: using snapshot of table %s" ),
+                        table.table );
+
+            m_conn->CacheRows( table.table, table.key_col, snapshotTable->rows );
+            results = &snapshotTable->rows;
+
+            // Without a modification column, only the row count was checked
+            if( table.modified_col.empty() )
+                needsRefresh = true;
+        }
+        else if( fetchTable( *m_conn, table, fetched ) )
+        {
+            results = &fetched.rows;
+        }
+        else
         {
             if( !m_conn->GetLastError().empty() )
             {
@@ -227,26 +262,158 @@ void SCH_IO_DATABASE::cacheLib()
             continue;
         }
 
-        for( DATABASE_CONNECTION::ROW& result : results )
+        for( const DATABASE_CONNECTION::ROW& result : *results )
         {
             if( !result.count( table.key_col ) )
                 continue;
 
             std::string prefix = table.name.empty() ? "" : fmt::format( "{}/", table.name );
-            wxString    name( fmt::format( "{}{}", prefix,
-                                           std::any_cast<std::string>( result[table.key_col] ) ) );
+            std::string key = std::any_cast<std::string>( result.at( table.key_col ) );
+            wxString    name( fmt::format( "{}{}", prefix, key ) );
 
             std::unique_ptr<LIB_SYMBOL> symbol = loadSymbolFromRow( name, table, result );
 
             if( symbol )
                 m_nameToSymbolcache[symbol->GetName()] = std::move( symbol );
         }
+
+        if( m_snapshot && results == &fetched.rows )
+        {
+            m_snapshot->SetTable( table.table, std::move( fetched ) );
+            snapshotModified = true;
+        }
     }
 
+    // A pending refresh saves its own, complete snapshot
+    if( snapshotModified && !m_snapshotRefresh )
+        m_snapshot->Save();
+
+    // A refreshed snapshot was just used; don't start another refresh right away
+    if( needsRefresh && !refreshed )
+        startSnapshotRefresh();
+
     m_cacheTimestamp = currentTimestampSeconds;
     m_cacheModifyHash = m_libTable->GetModifyHash();
 }
 
+
+bool SCH_IO_DATABASE::fetchTable( DATABASE_CONNECTION& aConn, const DATABASE_LIB_TABLE& aTable,
+                                  DATABASE_SNAPSHOT::TABLE& aResult )
+{
+    aResult.key = aTable.key_col;
+    aResult.columns = columnsFor( aTable );
+
+    // Read the stamp first, so that rows modified while fetching the table make the snapshot
+    // out of date rather than being missed
+    if( !aTable.modified_col.empty()
+        && !aConn.SelectMax( aTable.table, aTable.modified_col, aResult.stamp ) )
+    {
+        return false;
+    }
+
+    if( !aConn.SelectAll( aTable.table, aTable.key_col, aResult.rows ) )
+        return false;
+
+    aResult.count = aResult.rows.size();
+    return true;
+}
+
+
+bool SCH_IO_DATABASE::isSnapshotCurrent( const DATABASE_LIB_TABLE& aTable,
+                                         const DATABASE_SNAPSHOT::TABLE& aSnapshotTable )
+{
+    if( aSnapshotTable.key != aTable.key_col || aSnapshotTable.columns != columnsFor( aTable ) )
+        return false;
+
+    size_t count = 0;
+
+    if( !m_conn->SelectCount( aTable.table, count ) || count != aSnapshotTable.count )
+        return false;
+
+    if( !aTable.modified_col.empty() )
+    {
+        std::string stamp;
+
+        if( !m_conn->SelectMax( aTable.table, aTable.modified_col, stamp )
+            || stamp != aSnapshotTable.stamp )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void SCH_IO_DATABASE::startSnapshotRefresh()
+{
+    if( m_snapshotRefresh )
+        return;
+
+    std::string basePath( wxFileName( m_settings->GetFilename() ).GetPath().ToUTF8() );
+    auto        state = std::make_shared<SNAPSHOT_REFRESH>();
+
+    auto refresh =
+            [state, source = m_settings->m_Source, tables = m_settings->m_Tables, basePath,
+             fileName = m_snapshot->GetFileName()]()
+            {
+                state->m_snapshot = fetchSnapshot( source, basePath, tables, fileName,
+                                                   state->m_cancelled );
+                state->m_done.store( true, std::memory_order_release );
+            };
+
+    m_snapshotRefresh = state;
+    GetKiCadThreadPool().push_task( refresh );
+}
+
+
+std::unique_ptr<DATABASE_SNAPSHOT>
+SCH_IO_DATABASE::fetchSnapshot( const DATABASE_SOURCE& aSource, const std::string& aBasePath,
+                                const std::vector<DATABASE_LIB_TABLE>& aTables,
+                                const wxString& aFileName, const std::atomic<bool>& aCancelled )
+{
+    std::unique_ptr<DATABASE_CONNECTION> conn = createConnection( aSource, aBasePath, aTables );
+
+    if( !conn )
+        return nullptr;
+
+    auto snapshot = std::make_unique<DATABASE_SNAPSHOT>( aFileName );
+
+    for( const DATABASE_LIB_TABLE& table : aTables )
+    {
+        DATABASE_SNAPSHOT::TABLE snapshotTable;
+
+        if( aCancelled.load() || !fetchTable( *conn, table, snapshotTable ) )
+            return nullptr;
+
+        snapshot->SetTable( table.table, std::move( snapshotTable ) );
+    }
+
+    if( aCancelled.load() )
+        return nullptr;
+
+    snapshot->Save();
+    return snapshot;
+}
+
+
+bool SCH_IO_DATABASE::finishSnapshotRefresh()
+{
+    if( !m_snapshotRefresh || !m_snapshotRefresh->m_done.load( std::memory_order_acquire ) )
+        return false;
+
+    std::unique_ptr<DATABASE_SNAPSHOT> snapshot = std::move( m_snapshotRefresh->m_snapshot );
+
+    m_snapshotRefresh.reset();
+
+    if( !snapshot )
+        return false;
+
+    m_snapshot = std::move( snapshot );
+    return true;
+}
+
+
 void SCH_IO_DATABASE::ensureSettings( const wxString& aSettingsPath )
 {
     auto tryLoad =
@@ -313,24 +480,9 @@ void SCH_IO_DATABASE::connect()
 
     if( !m_conn )
     {
-        if( m_settings->m_Source.connection_string.empty() )
-        {
-            m_conn = std::make_unique<DATABASE_CONNECTION>( m_settings->m_Source.dsn,
-                                                            m_settings->m_Source.username,
-                                                            m_settings->m_Source.password,
-                                                            m_settings->m_Source.timeout );
-        }
-        else
-        {
-            std::string cs = m_settings->m_Source.connection_string;
-            std::string basePath( wxFileName( m_settings->GetFilename() ).GetPath().ToUTF8() );
+        std::string basePath( wxFileName( m_settings->GetFilename() ).GetPath().ToUTF8() );
 
-            // Database drivers that use files operate on absolute paths, so provide a mechanism
-            // for specifying on-disk databases that live next to the kicad_dbl file
-            boost::replace_all( cs, "${CWD}", basePath );
-
-            m_conn = std::make_unique<DATABASE_CONNECTION>( cs, m_settings->m_Source.timeout );
-        }
+        m_conn = createConnection( m_settings->m_Source, basePath, m_settings->m_Tables );
 
         if( !m_conn->IsConnected() )
         {
@@ -339,29 +491,65 @@ void SCH_IO_DATABASE::connect()
             return;
         }
 
-        for( const DATABASE_LIB_TABLE& tableIter : m_settings->m_Tables )
-        {
-            std::set<std::string> columns;
+        m_conn->SetCacheParams( m_settings->m_Cache.max_size, m_settings->m_Cache.max_age );
+    }
+}
 
-            columns.insert( tableIter.key_col );
-            columns.insert( tableIter.footprints_col );
-            columns.insert( tableIter.symbols_col );
 
-            columns.insert( tableIter.properties.description );
-            columns.insert( tableIter.properties.footprint_filters );
-            columns.insert( tableIter.properties.keywords );
-            columns.insert( tableIter.properties.exclude_from_sim );
-            columns.insert( tableIter.properties.exclude_from_bom );
-            columns.insert( tableIter.properties.exclude_from_board );
+std::unique_ptr<DATABASE_CONNECTION>
+SCH_IO_DATABASE::createConnection( const DATABASE_SOURCE& aSource, const std::string& aBasePath,
+                                   const std::vector<DATABASE_LIB_TABLE>& aTables )
+{
+    std::unique_ptr<DATABASE_CONNECTION> conn;
 
-            for( const DATABASE_FIELD_MAPPING& field : tableIter.fields )
-                columns.insert( field.column );
+    if( aSource.connection_string.empty() )
+    {
+        conn = std::make_unique<DATABASE_CONNECTION>( aSource.dsn, aSource.username,
+                                                      aSource.password, aSource.timeout );
+    }
+    else
+    {
+        std::string cs = aSource.connection_string;
 
-            m_conn->CacheTableInfo( tableIter.table, columns );
-        }
+        // Database drivers that use files operate on absolute paths, so provide a mechanism
+        // for specifying on-disk databases that live next to the kicad_dbl file
+        boost::replace_all( cs, "${CWD}", aBasePath );
 
-        m_conn->SetCacheParams( m_settings->m_Cache.max_size, m_settings->m_Cache.max_age );
+        conn = std::make_unique<DATABASE_CONNECTION>( cs, aSource.timeout );
     }
+
+    if( conn->IsConnected() )
+    {
+        for( const DATABASE_LIB_TABLE& tableIter : aTables )
+            conn->CacheTableInfo( tableIter.table, columnsFor( tableIter ) );
+    }
+
+    return conn;
+}
+
+
+std::set<std::string> SCH_IO_DATABASE::columnsFor( const DATABASE_LIB_TABLE& aTable )
+{
+    std::set<std::string> columns;
+
+    columns.insert( aTable.key_col );
+    columns.insert( aTable.footprints_col );
+    columns.insert( aTable.symbols_col );
+
+    columns.insert( aTable.properties.description );
+    columns.insert( aTable.properties.footprint_filters );
+    columns.insert( aTable.properties.keywords );
+    columns.insert( aTable.properties.exclude_from_sim );
+    columns.insert( aTable.properties.exclude_from_bom );
+    columns.insert( aTable.properties.exclude_from_board );
+
+    if( !aTable.modified_col.empty() )
+        columns.insert( aTable.modified_col );
+
+    for( const DATABASE_FIELD_MAPPING& field : aTable.fields )
+        columns.insert( field.column );
+
+    return columns;
 }
 
 
@@ -21,7 +21,11 @@
 #ifndef SCH_IO_DATABASE_H_
 #define SCH_IO_DATABASE_H_
 
+#include <atomic>
+#include <memory>
+
 #include <database/database_connection.h>
+#include <database/database_snapshot.h>
 #include <sch_io/sch_io.h>
 #include <sch_io/sch_io_mgr.h>
 #include <wildcards_and_files_ext.h>
@@ -29,6 +33,7 @@
 
 class DATABASE_LIB_SETTINGS;
 struct DATABASE_LIB_TABLE;
+struct DATABASE_SOURCE;
 
 
 /**
@@ -93,6 +98,48 @@ private:
 
     void connect();
 
+    static std::unique_ptr<DATABASE_CONNECTION>
+    createConnection( const DATABASE_SOURCE& aSource, const std::string& aBasePath,
+                      const std::vector<DATABASE_LIB_TABLE>& aTables );
+
+    static std::set<std::string> columnsFor( const DATABASE_LIB_TABLE& aTable );
+
+    /**
+     * Fetch all the rows of \a aTable, along with what is needed to check them later against
+     * the database.
+     */
+    static bool fetchTable( DATABASE_CONNECTION& aConn, const DATABASE_LIB_TABLE& aTable,
+                            DATABASE_SNAPSHOT::TABLE& aResult );
+
+    /**
+     * @return true if the rows of \a aTable saved in the snapshot are still those of the
+     *         database.
+     */
+    bool isSnapshotCurrent( const DATABASE_LIB_TABLE& aTable,
+                            const DATABASE_SNAPSHOT::TABLE& aSnapshotTable );
+
+    /**
+     * Fetch all the tables on a worker thread, with a separate connection, to update the
+     * snapshot when it could not be fully checked against the database.
+     */
+    void startSnapshotRefresh();
+
+    /**
+     * Fetch all the tables with a new connection and save them as a new snapshot, unless
+     * \a aCancelled is set in the meantime.
+     *
+     * @return the saved snapshot, or nullptr if it was cancelled or failed.
+     */
+    static std::unique_ptr<DATABASE_SNAPSHOT>
+    fetchSnapshot( const DATABASE_SOURCE& aSource, const std::string& aBasePath,
+                   const std::vector<DATABASE_LIB_TABLE>& aTables, const wxString& aFileName,
+                   const std::atomic<bool>& aCancelled );
+
+    /**
+     * @return true if a snapshot refresh completed, in which case it replaced the snapshot.
+     */
+    bool finishSnapshotRefresh();
+
     std::unique_ptr<LIB_SYMBOL> loadSymbolFromRow( const wxString& aSymbolName,
                                                    const DATABASE_LIB_TABLE& aTable,
                                                    const DATABASE_CONNECTION::ROW& aRow );
@@ -116,7 +163,19 @@ private:
 
     int m_cacheModifyHash;
 
+    /// Local copy of the tables, when enabled in the library settings
+    std::unique_ptr<DATABASE_SNAPSHOT> m_snapshot;
+
+    /// State of a snapshot refresh, shared with the worker thread which can outlive the plugin
+    struct SNAPSHOT_REFRESH
+    {
+        std::atomic<bool>                  m_cancelled{ false };
+        std::atomic<bool>                  m_done{ false };
+        std::unique_ptr<DATABASE_SNAPSHOT> m_snapshot;    ///< The result, once m_done is set
+    };
 
+    /// The pending snapshot refresh, if any
+    std::shared_ptr<SNAPSHOT_REFRESH> m_snapshotRefresh;
 
     wxString m_lastError;
 };
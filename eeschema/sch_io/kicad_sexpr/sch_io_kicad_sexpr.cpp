@@ -66,6 +66,7 @@
 #include <string_utils.h>
 #include <wx_filename.h>       // for ::ResolvePossibleSymlinks()
 #include <progress_reporter.h>
+#include <core/thread_pool.h>
 #include <boost/algorithm/string/join.hpp>
 
 using namespace TSCHEMATIC_T;
@@ -84,6 +85,7 @@ SCH_IO_KICAD_SEXPR::SCH_IO_KICAD_SEXPR() : SCH_IO( wxS( "Eeschema s-expression"
 
 SCH_IO_KICAD_SEXPR::~SCH_IO_KICAD_SEXPR()
 {
+    releasePreloadedScreens();
     delete m_cache;
 }
 
@@ -242,24 +244,47 @@ void SCH_IO_KICAD_SEXPR::loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath,
         }
         else
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            auto preloaded = m_preloadedScreens.find( fileName.GetFullPath() );
 
-            try
+            if( preloaded != m_preloadedScreens.end() )
             {
-                loadFile( fileName.GetFullPath(), aSheet );
+                SCH_SCREEN* preloadedScreen = preloaded->second.m_Screen;
+                wxString    error = preloaded->second.m_Error;
+
+                m_preloadedScreens.erase( preloaded );
+
+                aSheet->SetScreen( preloadedScreen );
+                preloadedScreen->DecRefCount();     // Reference held by m_preloadedScreens
+
+                if( !error.IsEmpty() )
+                {
+                    if( !m_error.IsEmpty() )
+                        m_error += "\n";
+
+                    m_error += error;
+                }
             }
-            catch( const IO_ERROR& ioe )
+            else
             {
-                // If there is a problem loading the root sheet, there is no recovery.
-                if( aSheet == m_rootSheet )
-                    throw;
+                aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
+                aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
 
-                // For all subsheets, queue up the error message for the caller.
-                if( !m_error.IsEmpty() )
-                    m_error += "\n";
+                try
+                {
+                    loadFile( fileName.GetFullPath(), aSheet );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    // If there is a problem loading the root sheet, there is no recovery.
+                    if( aSheet == m_rootSheet )
+                        throw;
+
+                    // For all subsheets, queue up the error message for the caller.
+                    if( !m_error.IsEmpty() )
+                        m_error += "\n";
 
-                m_error += ioe.What();
+                    m_error += ioe.What();
+                }
             }
 
             if( fileName.FileExists() )
@@ -276,6 +301,9 @@ void SCH_IO_KICAD_SEXPR::loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath,
             SCH_SHEET_PATH currentSheetPath = aParentSheetPath;
             currentSheetPath.push_back( aSheet );
 
+            if( aParentSheetPath.empty() )
+                preloadSheetFiles( aSheet );
+
             // This was moved out of the try{} block so that any sheet definitions that
             // the plugin fully parsed before the exception was raised will be loaded.
             for( SCH_ITEM* aItem : aSheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
@@ -286,6 +314,11 @@ void SCH_IO_KICAD_SEXPR::loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath,
                 // Recursion starts here.
                 loadHierarchy( currentSheetPath, sheet );
             }
+
+            // Files which ended up not being part of the hierarchy (only referenced by sheets
+            // recursing into one of their ancestors)
+            if( aParentSheetPath.empty() )
+                releasePreloadedScreens();
         }
 
         m_currentPath.pop();
@@ -322,6 +355,149 @@ void SCH_IO_KICAD_SEXPR::loadFile( const wxString& aFileName, SCH_SHEET* aSheet
 }
 
 
+void SCH_IO_KICAD_SEXPR::preloadSheetFiles( SCH_SHEET* aSheet )
+{
+    // The sheets of the current level of the hierarchy, with the path of the file containing them
+    std::vector<std::pair<SCH_SHEET*, wxString>> sheets;
+    std::set<wxString>                           files;
+
+    auto addChildSheets =
+            [&]( SCH_SCREEN* aScreen )
+            {
+                wxString path = wxFileName( aScreen->GetFileName() ).GetPath();
+
+                for( SCH_ITEM* item : aScreen->Items().OfType( SCH_SHEET_T ) )
+                    sheets.emplace_back( static_cast<SCH_SHEET*>( item ), path );
+            };
+
+    files.insert( aSheet->GetScreen()->GetFileName() );
+    addChildSheets( aSheet->GetScreen() );
+
+    thread_pool&      tp = GetKiCadThreadPool();
+    std::atomic<bool> cancelled( false );
+
+    while( !sheets.empty() )
+    {
+        std::vector<wxString>                   levelFiles;
+        std::vector<std::unique_ptr<SCH_SHEET>> parseSheets;
+
+        for( const auto& [ sheet, path ] : sheets )
+        {
+            wxFileName  fileName = sheet->GetFileName();
+            SCH_SCREEN* screen = nullptr;
+
+            if( !fileName.IsAbsolute() )
+                fileName.MakeAbsolute( path );
+
+            // Files already loaded in the schematic being appended to are linked as they are
+            if( !files.insert( fileName.GetFullPath() ).second
+                    || m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen ) )
+            {
+                continue;
+            }
+
+            // The screen is parsed through a scratch sheet, so that loadHierarchy() still finds
+            // the sheets of the hierarchy without a screen
+            screen = new SCH_SCREEN( m_schematic );
+            screen->SetFileName( fileName.GetFullPath() );
+            screen->IncRefCount();
+
+            m_preloadedScreens[ fileName.GetFullPath() ] = { screen, wxEmptyString };
+
+            levelFiles.push_back( fileName.GetFullPath() );
+            parseSheets.emplace_back( std::make_unique<SCH_SHEET>( m_schematic ) );
+            parseSheets.back()->SetScreen( screen );
+        }
+
+        sheets.clear();
+
+        // The parsers don't report progress: the progress reporter can only be used from this
+        // thread.  The locale was set by LoadSchematicFile() before starting the threads.
+        auto parseFile =
+                [&]( size_t aIndex ) -> size_t
+                {
+                    if( cancelled )
+                        return 0;
+
+                    wxLogTrace( traceSchPlugin, "Preloading     '%s'", levelFiles[aIndex] );
+
+                    try
+                    {
+                        FILE_LINE_READER          reader( levelFiles[aIndex] );
+                        SCH_IO_KICAD_SEXPR_PARSER parser( &reader, nullptr, 0, m_rootSheet,
+                                                          m_appending );
+
+                        parser.ParseSchematic( parseSheets[aIndex].get() );
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        m_preloadedScreens.at( levelFiles[aIndex] ).m_Error = ioe.What();
+                    }
+
+                    return 1;
+                };
+
+        std::vector<std::future<size_t>> returns;
+
+        for( size_t ii = 0; ii < levelFiles.size(); ++ii )
+            returns.emplace_back( tp.submit( parseFile, ii ) );
+
+        for( size_t ii = 0; ii < returns.size(); ++ii )
+        {
+            std::future_status status = returns[ii].wait_for( std::chrono::milliseconds( 250 ) );
+
+            while( status != std::future_status::ready )
+            {
+                if( m_progressReporter && !m_progressReporter->KeepRefreshing() )
+                    cancelled = true;
+
+                status = returns[ii].wait_for( std::chrono::milliseconds( 250 ) );
+            }
+
+            if( m_progressReporter && !cancelled )
+            {
+                m_progressReporter->Report( wxString::Format( _( "Loading %s..." ),
+                                                              levelFiles[ii] ) );
+
+                if( !m_progressReporter->KeepRefreshing() )
+                    cancelled = true;
+            }
+        }
+
+        for( size_t ii = 0; ii < returns.size(); ++ii )
+        {
+            SCH_SCREEN* screen = parseSheets[ii]->GetScreen();
+
+            parseSheets[ii]->SetScreen( nullptr );
+            returns[ii].get();      // Propagate any other exception
+
+            if( !cancelled )
+                addChildSheets( screen );
+        }
+
+        if( cancelled )
+        {
+            releasePreloadedScreens();
+            THROW_IO_ERROR( _( "Open cancelled by user." ) );
+        }
+    }
+}
+
+
+void SCH_IO_KICAD_SEXPR::releasePreloadedScreens()
+{
+    for( auto& [ fileName, preloaded ] : m_preloadedScreens )
+    {
+        preloaded.m_Screen->DecRefCount();
+
+        if( preloaded.m_Screen->GetRefCount() == 0 )
+            delete preloaded.m_Screen;
+    }
+
+    m_preloadedScreens.clear();
+}
+
+
 void SCH_IO_KICAD_SEXPR::LoadContent( LINE_READER& aReader, SCH_SHEET* aSheet, int aFileVersion )
 {
     wxCHECK( aSheet, /* void */ );
@@ -1568,7 +1744,12 @@ void SCH_IO_KICAD_SEXPR::cacheLib( const wxString& aLibraryFileName,
         delete m_cache;
         m_cache = new SCH_IO_KICAD_SEXPR_LIB_CACHE( aLibraryFileName );
 
-        if( !isBuffering( aProperties ) )
+        if( isBuffering( aProperties ) )
+            return;
+
+        if( ADVANCED_CFG::GetCfg().m_IndexSymbolLibraries )
+            m_cache->LoadIndex();
+        else
             m_cache->Load();
     }
 }
@@ -1620,8 +1801,14 @@ void SCH_IO_KICAD_SEXPR::EnumerateSymbolLib( std::vector<LIB_SYMBOL*>& aSymbolLi
     bool powerSymbolsOnly = ( aProperties &&
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
 
+    bool indexOnly = ( aProperties &&
+                       aProperties->find( SYMBOL_LIB_TABLE::PropSymsIndexOnly ) != aProperties->end() );
+
     cacheLib( aLibraryPath, aProperties );
 
+    if( !indexOnly )
+        m_cache->LoadAllSymbols();
+
     const LIB_SYMBOL_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_SYMBOL_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -1656,6 +1843,8 @@ LIB_SYMBOL* SCH_IO_KICAD_SEXPR::LoadSymbol( const wxString& aLibraryPath,
     if( it == m_cache->m_symbols.end() )
         return nullptr;
 
+    m_cache->LoadSymbol( it->second );
+
     return it->second;
 }
 
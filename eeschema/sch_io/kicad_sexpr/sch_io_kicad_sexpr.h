@@ -23,6 +23,7 @@
 #ifndef SCH_IO_KICAD_SEXPR_H_
 #define SCH_IO_KICAD_SEXPR_H_
 
+#include <map>
 #include <memory>
 #include <sch_io/sch_io.h>
 #include <sch_io/sch_io_mgr.h>
@@ -141,6 +142,14 @@ private:
     void loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath, SCH_SHEET* aSheet );
     void loadFile( const wxString& aFileName, SCH_SHEET* aSheet );
 
+    /**
+     * Parse the files of all the sheets below \a aSheet in parallel, one level of the hierarchy
+     * at a time, into #m_preloadedScreens.  loadHierarchy() then links them to the sheets in the
+     * same order as if it had loaded them itself.
+     */
+    void preloadSheetFiles( SCH_SHEET* aSheet );
+    void releasePreloadedScreens();
+
     void saveSymbol( SCH_SYMBOL* aSymbol, const SCHEMATIC& aSchematic, int aNestLevel,
                      bool aForClipboard, const SCH_SHEET_PATH* aRelativePath = nullptr );
     void saveField( SCH_FIELD* aField, int aNestLevel );
@@ -175,6 +184,15 @@ protected:
     OUTPUTFORMATTER*        m_out;              ///< The formatter for saving SCH_SCREEN objects.
     SCH_IO_KICAD_SEXPR_LIB_CACHE* m_cache;
 
+    struct PRELOADED_SCREEN
+    {
+        SCH_SCREEN* m_Screen;
+        wxString    m_Error;    ///< Error raised while parsing the file, if any.
+    };
+
+    /// Screens parsed by preloadSheetFiles() and not linked yet, by full file name.
+    std::map<wxString, PRELOADED_SCREEN> m_preloadedScreens;
+
     /// initialize PLUGIN like a constructor would.
     void init( SCHEMATIC* aSchematic, const STRING_UTF8_MAP* aProperties = nullptr );
 };
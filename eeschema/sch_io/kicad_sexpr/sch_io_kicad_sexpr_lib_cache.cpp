@@ -19,7 +19,9 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <wx/ffile.h>
 #include <wx/log.h>
+#include <fmt/format.h>
 #include <base_units.h>
 #include <build_version.h>
 #include <lib_shape.h>
@@ -34,6 +36,7 @@
 #include "sch_io_kicad_sexpr_parser.h"
 #include <string_utils.h>
 #include <trace_helpers.h>
+#include <wildcards_and_files_ext.h>
 
 
 SCH_IO_KICAD_SEXPR_LIB_CACHE::SCH_IO_KICAD_SEXPR_LIB_CACHE( const wxString& aFullPathAndFileName ) :
@@ -81,11 +84,456 @@ void SCH_IO_KICAD_SEXPR_LIB_CACHE::Load()
 }
 
 
+namespace
+{
+
+/// Version of the library index files.  Increment it when their content changes.
+const int INDEX_FILE_VERSION = 1;
+
+
+bool readFile( const wxString& aFileName, std::string& aContent )
+{
+    wxLogNull doNotLog;     // We report our own errors
+    wxFFile   file( aFileName, wxS( "rb" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    aContent.resize( static_cast<size_t>( file.Length() ) );
+
+    return file.Read( aContent.data(), aContent.size() ) == aContent.size();
+}
+
+
+/*
+ * A minimal reader of the s-expression structure of symbol libraries, used to index them.  It
+ * only knows where lists and atoms start and end, and leaves their meaning to the parser.
+ */
+
+size_t skipSpace( const std::string& aText, size_t aPos )
+{
+    while( aPos < aText.size() && isspace( static_cast<unsigned char>( aText[aPos] ) ) )
+        aPos++;
+
+    return aPos;
+}
+
+
+/// @return the end of the atom (a quoted string or a symbol) starting at \a aPos.
+size_t atomEnd( const std::string& aText, size_t aPos )
+{
+    if( aPos < aText.size() && aText[aPos] == '"' )
+    {
+        for( aPos++; aPos < aText.size(); aPos++ )
+        {
+            if( aText[aPos] == '\\' )
+                aPos++;
+            else if( aText[aPos] == '"' )
+                return aPos + 1;
+        }
+
+        return aText.size();
+    }
+
+    while( aPos < aText.size() && aText[aPos] != '(' && aText[aPos] != ')'
+           && !isspace( static_cast<unsigned char>( aText[aPos] ) ) )
+    {
+        aPos++;
+    }
+
+    return aPos;
+}
+
+
+/// @return the end of the list starting at \a aPos, after its closing parenthesis.
+size_t listEnd( const std::string& aText, size_t aPos )
+{
+    int depth = 0;
+
+    while( aPos < aText.size() )
+    {
+        char c = aText[aPos];
+
+        if( c == '"' )
+        {
+            aPos = atomEnd( aText, aPos );
+            continue;
+        }
+
+        aPos++;
+
+        if( c == '(' )
+            depth++;
+        else if( c == ')' && --depth == 0 )
+            return aPos;
+    }
+
+    THROW_IO_ERROR( _( "Unbalanced parentheses in symbol library." ) );
+}
+
+
+/// @return the first atom of the list starting at \a aPos.
+std::string listHead( const std::string& aText, size_t aPos )
+{
+    size_t start = skipSpace( aText, aPos + 1 );
+
+    return aText.substr( start, atomEnd( aText, start ) - start );
+}
+
+
+/// @return true if \a aToken is the token of a symbol graphic item or pin.
+bool isDrawItemToken( const std::string& aToken )
+{
+    return aToken == "arc" || aToken == "bezier" || aToken == "circle" || aToken == "pin"
+           || aToken == "polyline" || aToken == "rectangle" || aToken == "text"
+           || aToken == "text_box";
+}
+
+
+/**
+ * Append the symbol (or symbol unit) list from \a aStart to \a aEnd to \a aHeader, without its
+ * graphic items and pins.
+ */
+void appendSymbolHeader( const std::string& aText, size_t aStart, size_t aEnd,
+                         std::string& aHeader )
+{
+    aHeader += '(';
+
+    for( size_t pos = skipSpace( aText, aStart + 1 ); pos < aEnd && aText[pos] != ')';
+         pos = skipSpace( aText, pos ) )
+    {
+        size_t end;
+
+        if( aText[pos] == '(' )
+        {
+            end = listEnd( aText, pos );
+
+            std::string head = listHead( aText, pos );
+
+            if( head == "symbol" )
+            {
+                aHeader += ' ';
+                appendSymbolHeader( aText, pos, end, aHeader );
+            }
+            else if( !isDrawItemToken( head ) )
+            {
+                aHeader += ' ';
+                aHeader.append( aText, pos, end - pos );
+            }
+        }
+        else
+        {
+            end = atomEnd( aText, pos );
+
+            if( aHeader.back() != '(' )
+                aHeader += ' ';
+
+            aHeader.append( aText, pos, end - pos );
+        }
+
+        pos = end;
+    }
+
+    aHeader += ')';
+}
+
+} // namespace
+
+
+wxString SCH_IO_KICAD_SEXPR_LIB_CACHE::GetIndexFileName( const wxString& aLibraryPath )
+{
+    wxFileName fn( aLibraryPath );
+
+    fn.SetExt( FILEEXT::KiCadSymbolLibIndexFileExtension );
+
+    return fn.GetFullPath();
+}
+
+
+void SCH_IO_KICAD_SEXPR_LIB_CACHE::LoadIndex()
+{
+    if( !m_libFileName.FileExists() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Library file '%s' not found." ),
+                                          m_libFileName.GetFullPath() ) );
+    }
+
+    wxCHECK_RET( m_libFileName.IsAbsolute(),
+                 wxString::Format( "Cannot use relative file paths in sexpr plugin to "
+                                   "open library '%s'.", m_libFileName.GetFullPath() ) );
+
+    LOCALE_IO toggle;
+
+    wxString                 libFileName = m_libFileName.GetFullPath();
+    wxString                 indexFileName = GetIndexFileName( libFileName );
+    std::vector<INDEX_ENTRY> entries;
+    int                      version = 0;
+
+    wxLogTrace( traceSchLegacyPlugin, "Indexing sexpr symbol library file '%s'", libFileName );
+
+    if( !readIndex( indexFileName, entries, version ) )
+    {
+        std::string content;
+
+        if( !readFile( libFileName, content ) )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "Cannot read library file '%s'." ),
+                                              libFileName ) );
+        }
+
+        size_t pos = skipSpace( content, 0 );
+
+        if( pos >= content.size() || content[pos] != '('
+                || listHead( content, pos ) != "kicad_symbol_lib" )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "'%s' is not a KiCad symbol library." ),
+                                              libFileName ) );
+        }
+
+        size_t libEnd = listEnd( content, pos ) - 1;
+
+        entries.clear();
+        version = 0;
+
+        for( pos = skipSpace( content, atomEnd( content, skipSpace( content, pos + 1 ) ) );
+             pos < libEnd; pos = skipSpace( content, pos ) )
+        {
+            if( content[pos] != '(' )
+            {
+                pos = atomEnd( content, pos );
+                continue;
+            }
+
+            size_t      end = listEnd( content, pos );
+            std::string head = listHead( content, pos );
+
+            if( head == "version" )
+            {
+                size_t value = skipSpace( content, atomEnd( content, skipSpace( content,
+                                                                                pos + 1 ) ) );
+
+                version = atoi( content.c_str() + value );
+            }
+            else if( head == "symbol" )
+            {
+                INDEX_ENTRY& entry = entries.emplace_back();
+
+                entry.m_offset = pos;
+                entry.m_length = end - pos;
+                appendSymbolHeader( content, pos, end, entry.m_header );
+            }
+
+            pos = end;
+        }
+
+        // Let the parser report libraries too recent for us
+        if( version > SEXPR_SYMBOL_LIB_FILE_VERSION )
+        {
+            Load();
+            return;
+        }
+
+        writeIndex( indexFileName, entries, version );
+    }
+
+    // Symbols are listed in the order of the library, which puts parents before their
+    // derived symbols.
+    for( INDEX_ENTRY& entry : entries )
+    {
+        STRING_LINE_READER        reader( entry.m_header, libFileName );
+        SCH_IO_KICAD_SEXPR_PARSER parser( &reader );
+        LIB_SYMBOL*               symbol = parser.ParseSymbol( m_symbols, version );
+
+        if( !symbol )
+            continue;
+
+        auto it = m_symbols.find( symbol->GetName() );
+
+        // A duplicate name replaces the previous symbol, as it does when loading the library
+        if( it != m_symbols.end() )
+        {
+            m_unloadedSymbols.erase( it->second );
+            delete it->second;
+        }
+
+        m_symbols[ symbol->GetName() ] = symbol;
+        m_unloadedSymbols[ symbol ] = { entry.m_offset, entry.m_length };
+    }
+
+    m_indexedFileName = libFileName;
+    IncrementModifyHash();
+
+    m_fileModTime = GetLibModificationTime();
+    SetFileFormatVersionAtLoad( version );
+}
+
+
+bool SCH_IO_KICAD_SEXPR_LIB_CACHE::readIndex( const wxString& aIndexFileName,
+                                              std::vector<INDEX_ENTRY>& aEntries, int& aVersion )
+{
+    wxFileName libFile = GetRealFile();
+    std::string content;
+
+    if( !wxFileName::FileExists( aIndexFileName ) || !readFile( aIndexFileName, content ) )
+        return false;
+
+    // The index is only valid for the library file it was made from
+    unsigned long long libSize = libFile.GetSize().GetValue();
+    long long          libTime = libFile.GetModificationTime().GetValue().GetValue();
+
+    int                indexVersion = 0;
+    unsigned long long indexLibSize = 0;
+    long long          indexLibTime = 0;
+    int                headerLength = 0;
+
+    if( sscanf( content.c_str(), "kicad_symbol_lib_index %d %d %llu %lld\n%n", &indexVersion,
+                &aVersion, &indexLibSize, &indexLibTime, &headerLength ) != 4
+            || headerLength == 0 || indexVersion != INDEX_FILE_VERSION
+            || indexLibSize != libSize || indexLibTime != libTime )
+    {
+        return false;
+    }
+
+    for( size_t pos = headerLength; pos < content.size(); )
+    {
+        INDEX_ENTRY& entry = aEntries.emplace_back();
+        size_t       headerSize = 0;
+        int          lineLength = 0;
+
+        if( sscanf( content.c_str() + pos, "%zu %zu %zu\n%n", &entry.m_offset, &entry.m_length,
+                    &headerSize, &lineLength ) != 3
+                || lineLength == 0 )
+        {
+            return false;
+        }
+
+        pos += lineLength;
+
+        if( entry.m_offset + entry.m_length > libSize || pos + headerSize + 1 > content.size() )
+            return false;
+
+        entry.m_header = content.substr( pos, headerSize );
+        pos += headerSize + 1;
+    }
+
+    return true;
+}
+
+
+void SCH_IO_KICAD_SEXPR_LIB_CACHE::writeIndex( const wxString& aIndexFileName,
+                                               const std::vector<INDEX_ENTRY>& aEntries,
+                                               int aVersion )
+{
+    wxFileName  libFile = GetRealFile();
+    std::string content;
+
+    content += fmt::format( "kicad_symbol_lib_index {} {} {} {}\n", INDEX_FILE_VERSION, aVersion,
+                            libFile.GetSize().GetValue(),
+                            libFile.GetModificationTime().GetValue().GetValue() );
+
+    for( const INDEX_ENTRY& entry : aEntries )
+    {
+        content += fmt::format( "{} {} {}\n", entry.m_offset, entry.m_length,
+                                entry.m_header.size() );
+        content += entry.m_header;
+        content += '\n';
+    }
+
+    // Libraries in read-only folders simply don't get an index
+    wxLogNull doNotLog;
+    wxFFile   file( aIndexFileName, wxS( "wb" ) );
+
+    if( file.IsOpened() && !file.Write( content.data(), content.size() ) )
+    {
+        file.Close();
+        wxRemoveFile( aIndexFileName );
+    }
+}
+
+
+void SCH_IO_KICAD_SEXPR_LIB_CACHE::LoadSymbol( LIB_SYMBOL* aSymbol )
+{
+    auto it = m_unloadedSymbols.find( aSymbol );
+
+    if( it == m_unloadedSymbols.end() )
+        return;
+
+    wxLogNull doNotLog;     // We report our own errors
+    wxFFile   file( m_indexedFileName, wxS( "rb" ) );
+    auto [ offset, length ] = it->second;
+    std::string text( length, '\0' );
+
+    if( !file.IsOpened() || !file.Seek( offset ) || file.Read( text.data(), length ) != length )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Cannot read symbol '%s' from library file '%s'." ),
+                                          aSymbol->GetName(), m_indexedFileName ) );
+    }
+
+    loadSymbol( aSymbol, text );
+}
+
+
+void SCH_IO_KICAD_SEXPR_LIB_CACHE::LoadAllSymbols()
+{
+    if( m_unloadedSymbols.empty() )
+        return;
+
+    std::string content;
+
+    if( !readFile( m_indexedFileName, content ) )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Cannot read library file '%s'." ),
+                                          m_indexedFileName ) );
+    }
+
+    while( !m_unloadedSymbols.empty() )
+    {
+        auto [ symbol, location ] = *m_unloadedSymbols.begin();
+        auto [ offset, length ] = location;
+
+        if( offset + length > content.size() )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "Library file '%s' has changed." ),
+                                              m_indexedFileName ) );
+        }
+
+        loadSymbol( symbol, content.substr( offset, length ) );
+    }
+}
+
+
+void SCH_IO_KICAD_SEXPR_LIB_CACHE::loadSymbol( LIB_SYMBOL* aSymbol, const std::string& aText )
+{
+    // Derived symbols need the graphics and pins of their parent
+    if( LIB_SYMBOL_SPTR parent = aSymbol->GetParent().lock() )
+        LoadSymbol( parent.get() );
+
+    LOCALE_IO toggle;
+
+    STRING_LINE_READER          reader( aText, m_indexedFileName );
+    SCH_IO_KICAD_SEXPR_PARSER   parser( &reader );
+    std::unique_ptr<LIB_SYMBOL> symbol( parser.ParseSymbol( m_symbols,
+                                                            m_fileFormatVersionAtLoad ) );
+
+    if( !symbol || symbol->GetName() != aSymbol->GetName() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Library file '%s' has changed." ),
+                                          m_indexedFileName ) );
+    }
+
+    // Callers and derived symbols keep pointers to the indexed symbol
+    *aSymbol = *symbol;
+    m_unloadedSymbols.erase( aSymbol );
+}
+
+
 void SCH_IO_KICAD_SEXPR_LIB_CACHE::Save( const std::optional<bool>& aOpt )
 {
     if( !m_isModified )
         return;
 
+    LoadAllSymbols();
+
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
     // Write through symlinks, don't replace them.
@@ -524,8 +972,19 @@ void SCH_IO_KICAD_SEXPR_LIB_CACHE::saveTextBox( LIB_TEXTBOX* aTextBox, OUTPUTFOR
 }
 
 
+void SCH_IO_KICAD_SEXPR_LIB_CACHE::AddSymbol( const LIB_SYMBOL* aSymbol )
+{
+    // The library is about to be saved, which needs all of it
+    LoadAllSymbols();
+
+    SCH_IO_LIB_CACHE::AddSymbol( aSymbol );
+}
+
+
 void SCH_IO_KICAD_SEXPR_LIB_CACHE::DeleteSymbol( const wxString& aSymbolName )
 {
+    LoadAllSymbols();
+
     LIB_SYMBOL_MAP::iterator it = m_symbols.find( aSymbolName );
 
     if( it == m_symbols.end() )
@@ -22,6 +22,10 @@
 #ifndef SCH_IO_KICAD_SEXPR_LIB_CACHE_H_
 #define SCH_IO_KICAD_SEXPR_LIB_CACHE_H_
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "sch_io/sch_io_lib_cache.h"
 
 class FILE_LINE_READER;
@@ -49,6 +53,33 @@ public:
 
     void Load() override;
 
+    /**
+     * Load the index of the library instead of the full library.
+     *
+     * The symbols get their properties, units and inheritance but not their graphics and pins,
+     * which are only parsed when each symbol is first needed (see LoadSymbol()).  This is much
+     * faster than Load() for listing the symbols of large libraries.
+     *
+     * The index is read from the index file next to the library when it is up to date.
+     * Otherwise it is built from a single scan of the library, and saved to the index file
+     * for the next time.
+     */
+    void LoadIndex();
+
+    /**
+     * Make sure \a aSymbol, a symbol of this library, has its graphics and pins loaded.
+     *
+     * The symbol stays at the same address.
+     */
+    void LoadSymbol( LIB_SYMBOL* aSymbol );
+
+    /**
+     * Make sure all the symbols of the library have their graphics and pins loaded.
+     */
+    void LoadAllSymbols();
+
+    void AddSymbol( const LIB_SYMBOL* aSymbol ) override;
+
     void DeleteSymbol( const wxString& aName ) override;
 
     static void SaveSymbol( LIB_SYMBOL* aSymbol, OUTPUTFORMATTER& aFormatter,
@@ -57,11 +88,38 @@ public:
     void SetFileFormatVersionAtLoad( int aVersion ) { m_fileFormatVersionAtLoad = aVersion; }
     int GetFileFormatVersionAtLoad()  const { return m_fileFormatVersionAtLoad; }
 
+    /**
+     * @return the file name of the index of the library \a aLibraryPath.
+     */
+    static wxString GetIndexFileName( const wxString& aLibraryPath );
+
 private:
     friend SCH_IO_KICAD_SEXPR;
 
+    /// A symbol of the library index.
+    struct INDEX_ENTRY
+    {
+        size_t      m_offset;   ///< Offset of the symbol in the library file.
+        size_t      m_length;   ///< Length of the symbol in the library file.
+        std::string m_header;   ///< The symbol without its graphics and pins.
+    };
+
+    bool readIndex( const wxString& aIndexFileName, std::vector<INDEX_ENTRY>& aEntries,
+                    int& aVersion );
+
+    void writeIndex( const wxString& aIndexFileName, const std::vector<INDEX_ENTRY>& aEntries,
+                     int aVersion );
+
+    void loadSymbol( LIB_SYMBOL* aSymbol, const std::string& aText );
+
     int m_fileFormatVersionAtLoad;
 
+    wxString m_indexedFileName;     ///< The library file the index was loaded from.
+
+    /// Offset and length in the library file of the symbols whose graphics and pins are not
+    /// loaded yet.
+    std::map<LIB_SYMBOL*, std::pair<size_t, size_t>> m_unloadedSymbols;
+
     static void saveSymbolDrawItem( SCH_ITEM* aItem, OUTPUTFORMATTER& aFormatter,
                                     int aNestLevel );
     static void saveField( SCH_FIELD* aField, OUTPUTFORMATTER& aFormatter, int aNestLevel );
@@ -34,6 +34,7 @@
 #include <geometry/shape_segment.h>
 #include <geometry/shape_rect.h>
 #include <gr_text.h>
+#include <hash.h>
 #include <lib_shape.h>
 #include <lib_pin.h>
 #include <lib_text.h>
@@ -154,6 +155,159 @@ bool SCH_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
     return false;
 }
 
+
+/**
+ * Hash everything the drawing of a library symbol body item depends on, in library coordinates.
+ *
+ * Pin names, types and shapes are left out as they are overridden by the schematic pins.
+ */
+static size_t hashSymbolItem( const SCH_ITEM& aItem )
+{
+    size_t ret = hash_val( aItem.Type(), aItem.GetUnit(), aItem.GetBodyStyle(), aItem.IsPrivate(),
+                           aItem.GetPosition(), aItem.GetPenWidth(),
+                           aItem.GetForcedTransparency() );
+
+    if( const LIB_SHAPE* shape = dynamic_cast<const LIB_SHAPE*>( &aItem ) )
+    {
+        STROKE_PARAMS stroke = shape->GetStroke();
+
+        hash_combine( ret, shape->GetShape(), shape->GetStart(), shape->GetEnd(),
+                      shape->GetBezierC1(), shape->GetBezierC2() );
+        hash_combine( ret, stroke.GetWidth(), stroke.GetLineStyle(), stroke.GetColor(),
+                      shape->GetFillMode(), shape->GetFillColor() );
+
+        if( shape->GetShape() == SHAPE_T::ARC )
+            hash_combine( ret, shape->GetCenter() );
+
+        if( shape->GetShape() == SHAPE_T::POLY )
+        {
+            for( auto it = shape->GetPolyShape().CIterateWithHoles(); it; it++ )
+                hash_combine( ret, *it );
+        }
+    }
+
+    if( const LIB_TEXTBOX* textBox = dynamic_cast<const LIB_TEXTBOX*>( &aItem ) )
+    {
+        hash_combine( ret, textBox->GetMarginLeft(), textBox->GetMarginTop(),
+                      textBox->GetMarginRight(), textBox->GetMarginBottom() );
+    }
+
+    if( const EDA_TEXT* text = dynamic_cast<const EDA_TEXT*>( &aItem ) )
+    {
+        hash_combine( ret, text->GetText(), text->GetTextPos(), text->GetTextWidth(),
+                      text->GetTextHeight(), text->GetTextThickness(),
+                      text->GetTextAngle().AsDegrees() );
+        hash_combine( ret, text->GetHorizJustify(), text->GetVertJustify(), text->IsItalic(),
+                      text->IsBold(), text->IsMirrored(), text->IsVisible(), text->GetFont(),
+                      text->GetTextColor(), text->GetLineSpacing() );
+    }
+
+    if( aItem.Type() == LIB_PIN_T )
+    {
+        const LIB_PIN* pin = static_cast<const LIB_PIN*>( &aItem );
+
+        hash_combine( ret, pin->GetLength(), pin->GetOrientation(), pin->GetNumber(),
+                      pin->IsVisible(), pin->GetNameTextSize(), pin->GetNumberTextSize() );
+    }
+
+    return ret;
+}
+
+
+bool SCH_PAINTER::GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, size_t& aKey,
+                                  VECTOR2I& aOffset )
+{
+    const SCH_SYMBOL* symbol = dynamic_cast<const SCH_SYMBOL*>( aItem );
+
+    if( !symbol || !m_schematic || m_schSettings.IsPrinting()
+            || m_schSettings.GetDrawBoundingBoxes() )
+    {
+        return false;
+    }
+
+    // Only the symbol body is shared.  Fields, dangling indicators and operating points are
+    // specific to each symbol.
+    if( aLayer != LAYER_DEVICE && aLayer != LAYER_DEVICE_BACKGROUND
+            && aLayer != LAYER_NOTES_BACKGROUND )
+    {
+        return false;
+    }
+
+    const LIB_SYMBOL* libSymbol = symbol->GetLibSymbolRef();
+
+    // Selected symbols have zoom-dependent text; brightened ones won't stay that way for long
+    if( !libSymbol || libSymbol->IsAlias() || symbol->IsSelected() || symbol->IsBrightened() )
+        return false;
+
+    int unit = symbol->GetUnitSelection( &m_schematic->CurrentSheet() );
+    int bodyStyle = symbol->GetBodyStyle();
+
+    // The whole body is drawn once per orientation, the view only moves it
+    aKey = hash_val( unit, symbol->GetUnit(), bodyStyle, symbol->GetTransform(),
+                     symbol->GetDNP(), libSymbol->GetShowPinNames(),
+                     libSymbol->GetShowPinNumbers(), libSymbol->GetPinNameOffset() );
+
+    for( const SCH_ITEM& item : libSymbol->GetDrawItems() )
+    {
+        if( item.Type() == SCH_FIELD_T )
+            continue;
+
+        // Text variables are expanded in the context of each symbol
+        const EDA_TEXT* text = dynamic_cast<const EDA_TEXT*>( &item );
+
+        if( text && text->HasTextVars() )
+            return false;
+
+        hash_combine( aKey, hashSymbolItem( item ) );
+    }
+
+    std::vector<LIB_PIN*> libPins;
+    libSymbol->GetPins( libPins, unit, bodyStyle );
+
+    for( LIB_PIN* libPin : libPins )
+    {
+        const SCH_PIN* pin = symbol->GetPin( libPin );
+
+        if( !pin || pin->IsSelected() || pin->IsBrightened() )
+            return false;
+
+        hash_combine( aKey, expandLibItemTextVars( pin->GetShownName(), symbol ), pin->GetType(),
+                      pin->GetShape(), pin->IsDangling() );
+    }
+
+    const EESCHEMA_SETTINGS* cfg = eeconfig();
+
+    hash_combine( aKey, cfg->m_Appearance.show_hidden_pins, cfg->m_Appearance.show_hidden_fields,
+                  cfg->m_Appearance.default_font );
+    hash_combine( aKey, m_schSettings.GetDefaultPenWidth(), m_schSettings.m_ShowUnit,
+                  m_schSettings.m_ShowBodyStyle, m_schSettings.m_ShowPinsElectricalType,
+                  m_schSettings.m_ShowPinNumbers, m_schSettings.m_ShowDisabled,
+                  m_schSettings.m_ShowGraphicsDisabled, m_schSettings.m_OverrideItemColors,
+                  m_schSettings.m_PinSymbolSize, m_schSettings.m_TextOffsetRatio );
+
+    for( int layer : { LAYER_DEVICE, LAYER_DEVICE_BACKGROUND, LAYER_NOTES_BACKGROUND, LAYER_PIN,
+                       LAYER_PINNAM, LAYER_PINNUM, LAYER_HIDDEN, LAYER_PRIVATE_NOTES,
+                       LAYER_DNP_MARKER, LAYER_SCHEMATIC_BACKGROUND } )
+    {
+        hash_combine( aKey, m_schSettings.GetLayerColor( layer ) );
+    }
+
+    aOffset = symbol->GetPosition();
+
+    return true;
+}
+
+
+BOX2I SCH_PAINTER::GetInstanceBBox( const VIEW_ITEM* aItem, int aLayer, const VECTOR2I& aOffset )
+{
+    // The view bounding box also covers the fields, which are drawn for each symbol
+    BOX2I bbox = static_cast<const SCH_SYMBOL*>( aItem )->GetBodyAndPinsBoundingBox();
+
+    bbox.Move( -aOffset );
+    return bbox;
+}
+
+
 void SCH_PAINTER::draw( const EDA_ITEM* aItem, int aLayer, bool aDimmed )
 {
 
@@ -2535,8 +2689,8 @@ void SCH_PAINTER::draw( const SCH_SYMBOL* aSymbol, int aLayer )
     int bodyStyle = aSymbol->GetBodyStyle();
 
     // Use dummy symbol if the actual couldn't be found (or couldn't be locked).
-    LIB_SYMBOL* originalSymbol = aSymbol->GetLibSymbolRef() ? aSymbol->GetLibSymbolRef().get()
-                                                            : dummy();
+    const LIB_SYMBOL* originalSymbol = aSymbol->GetLibSymbolRef() ? aSymbol->GetLibSymbolRef()
+                                                                  : dummy();
     std::vector<LIB_PIN*> originalPins;
     originalSymbol->GetPins( originalPins, unit, bodyStyle );
 
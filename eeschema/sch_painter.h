@@ -78,6 +78,14 @@ public:
     /// @copydoc PAINTER::GetSettings()
     virtual SCH_RENDER_SETTINGS* GetSettings() override { return &m_schSettings; }
 
+    /// @copydoc PAINTER::GetInstanceKey()
+    virtual bool GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, size_t& aKey,
+                                 VECTOR2I& aOffset ) override;
+
+    /// @copydoc PAINTER::GetInstanceBBox()
+    virtual BOX2I GetInstanceBBox( const VIEW_ITEM* aItem, int aLayer,
+                                   const VECTOR2I& aOffset ) override;
+
     void SetSchematic( SCHEMATIC* aSchematic ) { m_schematic = aSchematic; }
 
 private:
@@ -360,6 +360,31 @@ void SCH_REFERENCE_LIST::ReannotateByOptions( ANNOTATE_ORDER_T             aSort
                                               const SCH_REFERENCE_LIST&    aAdditionalRefs,
                                               bool                         aStartAtCurrent,
                                               SCH_SHEET_LIST*              aHierarchy )
+{
+    reannotateByOptions( aSortOption, aAlgoOption, aStartNumber, aAdditionalRefs, nullptr,
+                         aStartAtCurrent, aHierarchy );
+}
+
+
+void SCH_REFERENCE_LIST::ReannotateByOptions( ANNOTATE_ORDER_T             aSortOption,
+                                              ANNOTATE_ALGO_T              aAlgoOption,
+                                              int                          aStartNumber,
+                                              const SCH_REFERENCE_INDEX&   aAdditionalRefs,
+                                              bool                         aStartAtCurrent,
+                                              SCH_SHEET_LIST*              aHierarchy )
+{
+    reannotateByOptions( aSortOption, aAlgoOption, aStartNumber, SCH_REFERENCE_LIST(),
+                         &aAdditionalRefs, aStartAtCurrent, aHierarchy );
+}
+
+
+void SCH_REFERENCE_LIST::reannotateByOptions( ANNOTATE_ORDER_T             aSortOption,
+                                              ANNOTATE_ALGO_T              aAlgoOption,
+                                              int                          aStartNumber,
+                                              const SCH_REFERENCE_LIST&    aAdditionalRefs,
+                                              const SCH_REFERENCE_INDEX*   aAdditionalIndex,
+                                              bool                         aStartAtCurrent,
+                                              SCH_SHEET_LIST*              aHierarchy )
 {
     SplitReferences();
 
@@ -392,7 +417,7 @@ void SCH_REFERENCE_LIST::ReannotateByOptions( ANNOTATE_ORDER_T             aSort
     }
 
     AnnotateByOptions( aSortOption, aAlgoOption, aStartNumber, lockedSymbols, aAdditionalRefs,
-                       aStartAtCurrent );
+                       aStartAtCurrent, aAdditionalIndex );
 }
 
 
@@ -407,7 +432,8 @@ void SCH_REFERENCE_LIST::AnnotateByOptions( ANNOTATE_ORDER_T             aSortOp
                                             int                          aStartNumber,
                                             SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap,
                                             const SCH_REFERENCE_LIST&    aAdditionalRefs,
-                                            bool                         aStartAtCurrent )
+                                            bool                         aStartAtCurrent,
+                                            const SCH_REFERENCE_INDEX*   aAdditionalIndex )
 {
     switch( aSortOption )
     {
@@ -440,13 +466,15 @@ void SCH_REFERENCE_LIST::AnnotateByOptions( ANNOTATE_ORDER_T             aSortOp
         break;
     }
 
-    Annotate( useSheetNum, idStep, aStartNumber, aLockedUnitMap, aAdditionalRefs, aStartAtCurrent );
+    Annotate( useSheetNum, idStep, aStartNumber, aLockedUnitMap, aAdditionalRefs, aStartAtCurrent,
+              aAdditionalIndex );
 }
 
 
 void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int aStartNumber,
                                    SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap,
-                                   const SCH_REFERENCE_LIST& aAdditionalRefs, bool aStartAtCurrent )
+                                   const SCH_REFERENCE_LIST& aAdditionalRefs, bool aStartAtCurrent,
+                                   const SCH_REFERENCE_INDEX* aAdditionalIndex )
 {
     if ( m_flatList.size() == 0 )
         return;
@@ -479,6 +507,41 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         AddItem( additionalRef ); //add to this container
     }
 
+    // The reference numbers in use, kept up to date as references are annotated
+    SCH_REFERENCE_INDEX inUseNumbers( aAdditionalIndex );
+
+    for( const SCH_REFERENCE& ref : m_flatList )
+        inUseNumbers.Add( ref );
+
+    auto setNumber =
+            [&]( SCH_REFERENCE& aRef, int aNumber, const wxString& aNumberStr, int aUnit )
+            {
+                inUseNumbers.Remove( aRef );
+                aRef.m_numRef = aNumber;
+                aRef.m_numRefStr = aNumberStr;
+                aRef.m_unit = aUnit;
+                aRef.m_isNew = false;
+                inUseNumbers.Add( aRef );
+            };
+
+    // The locked lists holding each symbol, in the order of aLockedUnitMap, and the references
+    // to each symbol in this list, so that neither needs to be searched for each reference.
+    std::unordered_map<SCH_SYMBOL*, std::vector<std::pair<const SCH_REFERENCE*,
+                                                          SCH_REFERENCE_LIST*>>> lockedLists;
+    std::unordered_map<SCH_SYMBOL*, std::vector<unsigned>> symbolRefs;
+
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+        {
+            const SCH_REFERENCE& thisRef = pair.second[thisRefI];
+            lockedLists[thisRef.GetSymbol()].emplace_back( &thisRef, &pair.second );
+        }
+    }
+
+    for( unsigned ii = 0; ii < m_flatList.size(); ii++ )
+        symbolRefs[m_flatList[ii].GetSymbol()].push_back( ii );
+
     int LastReferenceNumber = 0;
 
     /* calculate index of the first symbol with the same reference prefix
@@ -507,24 +570,18 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         // Check whether this symbol is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = nullptr;
+        auto                lockedIt = lockedLists.find( ref_unit.GetSymbol() );
 
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+        if( lockedIt != lockedLists.end() )
         {
-            unsigned n_refs = pair.second.GetCount();
-
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
+            for( const auto& [ thisRef, list ] : lockedIt->second )
             {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
-
-                if( thisRef.IsSameInstance( ref_unit ) )
+                if( thisRef->IsSameInstance( ref_unit ) )
                 {
-                    lockedList = &pair.second;
+                    lockedList = list;
                     break;
                 }
             }
-
-            if( lockedList != nullptr )
-                break;
         }
 
         if(  ( m_flatList[first].CompareRef( ref_unit ) != 0 )
@@ -551,11 +608,10 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         {
             if( ref_unit.m_isNew )
             {
-                std::vector<int> idList;
-                GetRefsInUse( first, idList, minRefId );
-                LastReferenceNumber = createFirstFreeRefId( idList, minRefId );
-                ref_unit.m_numRef = LastReferenceNumber;
-                ref_unit.m_numRefStr = wxString::Format( "%d", LastReferenceNumber );
+                LastReferenceNumber = inUseNumbers.FindFirstFreeNumber( ref_unit.GetRef(),
+                                                                        minRefId );
+                setNumber( ref_unit, LastReferenceNumber,
+                           wxString::Format( "%d", LastReferenceNumber ), ref_unit.m_unit );
             }
 
             ref_unit.m_flag  = 1;
@@ -572,10 +628,10 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
             if( ref_unit.m_isNew )
             {
-                LastReferenceNumber = FindFirstUnusedReference( ref_unit, minRefId, units );
-                ref_unit.m_numRef = LastReferenceNumber;
-                ref_unit.m_numRefStr = wxString::Format( "%d", LastReferenceNumber );
-                ref_unit.m_isNew = false;
+                LastReferenceNumber = inUseNumbers.FindFirstUnusedReference( ref_unit, minRefId,
+                                                                             units );
+                setNumber( ref_unit, LastReferenceNumber,
+                           wxString::Format( "%d", LastReferenceNumber ), ref_unit.m_unit );
                 ref_unit.m_flag = 1;
             }
 
@@ -586,7 +642,8 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                 if( lockedRef.IsSameInstance( ref_unit ) )
                 {
                     // This is the symbol we're currently annotating. Hold the unit!
-                    ref_unit.m_unit = lockedRef.m_unit;
+                    setNumber( ref_unit, ref_unit.m_numRef, ref_unit.m_numRefStr,
+                               lockedRef.m_unit );
 
                     // lock this new full reference
                     inUseRefs.insert( buildFullReference( ref_unit ) );
@@ -599,9 +656,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     continue;
 
                 // Find the matching symbol
-                for( unsigned jj = ii + 1; jj < m_flatList.size(); jj++ )
+                for( unsigned jj : symbolRefs[lockedRef.GetSymbol()] )
                 {
-                    if( !lockedRef.IsSameInstance( m_flatList[jj] ) )
+                    if( jj <= ii || !lockedRef.IsSameInstance( m_flatList[jj] ) )
                         continue;
 
                     wxString ref_candidate = buildFullReference( ref_unit, lockedRef.m_unit );
@@ -609,11 +666,16 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     // propagate the new reference and unit selection to the "old" symbol,
                     // if this new full reference is not already used (can happens when initial
                     // multiunits symbols have duplicate references)
-                    if( inUseRefs.find( ref_candidate ) == inUseRefs.end() )
+                    bool inUse = inUseRefs.find( ref_candidate ) != inUseRefs.end()
+                                 || ( aAdditionalIndex
+                                      && aAdditionalIndex->Count( ref_unit.GetRef(),
+                                                                  ref_unit.m_numRef,
+                                                                  lockedRef.m_unit ) > 0 );
+
+                    if( !inUse )
                     {
-                        m_flatList[jj].m_numRef = ref_unit.m_numRef;
-                        m_flatList[jj].m_numRefStr = ref_unit.m_numRefStr;
-                        m_flatList[jj].m_isNew = false;
+                        setNumber( m_flatList[jj], ref_unit.m_numRef, ref_unit.m_numRefStr,
+                                   m_flatList[jj].m_unit );
                         m_flatList[jj].m_flag = 1;
 
                         // lock this new full reference
@@ -629,9 +691,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             // know what group this might belong to, so just find the first unused reference for
             // this specific unit. The other units will be annotated in the following passes.
             std::vector<int> units = { ref_unit.GetUnit() };
-            LastReferenceNumber = FindFirstUnusedReference( ref_unit, minRefId, units );
-            ref_unit.m_numRef = LastReferenceNumber;
-            ref_unit.m_isNew = false;
+            LastReferenceNumber = inUseNumbers.FindFirstUnusedReference( ref_unit, minRefId,
+                                                                         units );
+            setNumber( ref_unit, LastReferenceNumber, ref_unit.m_numRefStr, ref_unit.m_unit );
             ref_unit.m_flag = 1;
         }
     }
@@ -795,7 +857,7 @@ int SCH_REFERENCE_LIST::CheckAnnotation( ANNOTATION_ERROR_HANDLER aHandler )
 }
 
 
-SCH_REFERENCE::SCH_REFERENCE( SCH_SYMBOL* aSymbol, LIB_SYMBOL* aLibSymbol,
+SCH_REFERENCE::SCH_REFERENCE( SCH_SYMBOL* aSymbol, const LIB_SYMBOL* aLibSymbol,
                               const SCH_SHEET_PATH& aSheetPath )
 {
     wxASSERT( aSymbol != nullptr );
@@ -908,6 +970,345 @@ bool SCH_REFERENCE::IsSplitNeeded()
 }
 
 
+void SCH_REFERENCE_INDEX::Clear()
+{
+    m_prefixes.clear();
+    m_symbols.clear();
+}
+
+
+SCH_REFERENCE_INDEX::ENTRY SCH_REFERENCE_INDEX::makeEntry( const SCH_REFERENCE& aRef )
+{
+    ENTRY entry;
+
+    entry.m_symbol = aRef.GetSymbol();
+    entry.m_unit = aRef.m_unit;
+    entry.m_libName = aRef.GetSymbol()->GetLibId().GetLibItemName().wx_str();
+    entry.m_value = aRef.m_value;
+
+    return entry;
+}
+
+
+void SCH_REFERENCE_INDEX::Add( const SCH_REFERENCE& aRef )
+{
+    if( aRef.m_isNew )
+        return;
+
+    wxString key = prefixKey( aRef.m_ref );
+    PREFIX&  prefix = m_prefixes[key];
+    int      number = aRef.m_numRef;
+    ENTRY    entry = makeEntry( aRef );
+
+    std::vector<ENTRY>& entries = prefix.m_numbers[number];
+
+    if( entries.empty() )
+    {
+        // Merge the number with the runs around it
+        auto next = prefix.m_runs.upper_bound( number );
+        auto prev = next == prefix.m_runs.begin() ? prefix.m_runs.end() : std::prev( next );
+        bool joinsPrev = prev != prefix.m_runs.end() && prev->second == number - 1;
+        bool joinsNext = next != prefix.m_runs.end() && next->first == number + 1;
+
+        if( joinsPrev && joinsNext )
+        {
+            prev->second = next->second;
+            prefix.m_runs.erase( next );
+        }
+        else if( joinsPrev )
+        {
+            prev->second = number;
+        }
+        else if( joinsNext )
+        {
+            int last = next->second;
+            prefix.m_runs.erase( next );
+            prefix.m_runs[number] = last;
+        }
+        else
+        {
+            prefix.m_runs[number] = number;
+        }
+    }
+
+    prefix.m_parts[partKey( entry.m_libName, entry.m_value )].insert( number );
+    entries.push_back( std::move( entry ) );
+
+    m_symbols[aRef.GetSymbol()].emplace_back( key, number );
+}
+
+
+void SCH_REFERENCE_INDEX::removeEntry( const wxString& aKey, int aNumber, size_t aIndex )
+{
+    PREFIX&             prefix = m_prefixes[aKey];
+    std::vector<ENTRY>& entries = prefix.m_numbers[aNumber];
+    ENTRY               entry = entries[aIndex];
+
+    entries.erase( entries.begin() + aIndex );
+
+    bool partUsed = std::any_of( entries.begin(), entries.end(),
+            [&]( const ENTRY& aOther )
+            {
+                return aOther.m_libName == entry.m_libName && aOther.m_value == entry.m_value;
+            } );
+
+    if( !partUsed )
+    {
+        auto part = prefix.m_parts.find( partKey( entry.m_libName, entry.m_value ) );
+
+        if( part != prefix.m_parts.end() )
+        {
+            part->second.erase( aNumber );
+
+            if( part->second.empty() )
+                prefix.m_parts.erase( part );
+        }
+    }
+
+    if( !entries.empty() )
+        return;
+
+    prefix.m_numbers.erase( aNumber );
+
+    // Split the run holding the number
+    auto run = std::prev( prefix.m_runs.upper_bound( aNumber ) );
+    int  first = run->first;
+    int  last = run->second;
+
+    prefix.m_runs.erase( run );
+
+    if( first < aNumber )
+        prefix.m_runs[first] = aNumber - 1;
+
+    if( aNumber < last )
+        prefix.m_runs[aNumber + 1] = last;
+
+    if( prefix.m_numbers.empty() )
+        m_prefixes.erase( aKey );
+}
+
+
+void SCH_REFERENCE_INDEX::Remove( const SCH_REFERENCE& aRef )
+{
+    if( aRef.m_isNew )
+        return;
+
+    wxString key = prefixKey( aRef.m_ref );
+    auto     prefix = m_prefixes.find( key );
+
+    if( prefix == m_prefixes.end() )
+        return;
+
+    auto number = prefix->second.m_numbers.find( aRef.m_numRef );
+
+    if( number == prefix->second.m_numbers.end() )
+        return;
+
+    ENTRY                     entry = makeEntry( aRef );
+    const std::vector<ENTRY>& entries = number->second;
+
+    for( size_t ii = 0; ii < entries.size(); ++ii )
+    {
+        if( entries[ii].m_symbol == entry.m_symbol && entries[ii].m_unit == entry.m_unit
+            && entries[ii].m_libName == entry.m_libName && entries[ii].m_value == entry.m_value )
+        {
+            removeEntry( key, aRef.m_numRef, ii );
+
+            std::vector<std::pair<wxString, int>>& symbolRefs = m_symbols[aRef.GetSymbol()];
+            auto it = std::find( symbolRefs.begin(), symbolRefs.end(),
+                                 std::make_pair( key, aRef.m_numRef ) );
+
+            if( it != symbolRefs.end() )
+                symbolRefs.erase( it );
+
+            if( symbolRefs.empty() )
+                m_symbols.erase( aRef.GetSymbol() );
+
+            return;
+        }
+    }
+}
+
+
+void SCH_REFERENCE_INDEX::RemoveSymbol( const SCH_SYMBOL* aSymbol )
+{
+    auto symbolRefs = m_symbols.find( aSymbol );
+
+    if( symbolRefs == m_symbols.end() )
+        return;
+
+    for( const auto& [ key, number ] : symbolRefs->second )
+    {
+        auto prefix = m_prefixes.find( key );
+
+        if( prefix == m_prefixes.end() )
+            continue;
+
+        auto numberIt = prefix->second.m_numbers.find( number );
+
+        if( numberIt == prefix->second.m_numbers.end() )
+            continue;
+
+        // Each pair stands for one entry of the symbol
+        for( size_t ii = numberIt->second.size(); ii > 0; --ii )
+        {
+            if( numberIt->second[ii - 1].m_symbol == aSymbol )
+            {
+                removeEntry( key, number, ii - 1 );
+                break;
+            }
+        }
+    }
+
+    m_symbols.erase( symbolRefs );
+}
+
+
+int SCH_REFERENCE_INDEX::Count( const wxString& aPrefix, int aNumber, int aUnit ) const
+{
+    wxString key = prefixKey( aPrefix );
+    int      count = 0;
+
+    for( const SCH_REFERENCE_INDEX* index = this; index; index = index->m_base )
+    {
+        auto prefix = index->m_prefixes.find( key );
+
+        if( prefix == index->m_prefixes.end() )
+            continue;
+
+        auto number = prefix->second.m_numbers.find( aNumber );
+
+        if( number == prefix->second.m_numbers.end() )
+            continue;
+
+        for( const ENTRY& entry : number->second )
+        {
+            if( entry.m_unit == aUnit )
+                count++;
+        }
+    }
+
+    return count;
+}
+
+
+int SCH_REFERENCE_INDEX::firstFreeNumber( const PREFIX& aPrefix, int aMinValue )
+{
+    auto run = aPrefix.m_runs.upper_bound( aMinValue );
+
+    if( run == aPrefix.m_runs.begin() )
+        return aMinValue;
+
+    --run;
+
+    // Runs are as long as possible, so the number following a run is free
+    return run->second >= aMinValue ? run->second + 1 : aMinValue;
+}
+
+
+int SCH_REFERENCE_INDEX::FindFirstFreeNumber( const wxString& aPrefix, int aMinValue ) const
+{
+    wxString key = prefixKey( aPrefix );
+    int      number = aMinValue;
+    bool     changed = true;
+
+    // The number must be free in all the indexes: skip the runs of each of them in turn until
+    // none moves the number any further
+    while( changed )
+    {
+        changed = false;
+
+        for( const SCH_REFERENCE_INDEX* index = this; index; index = index->m_base )
+        {
+            auto prefix = index->m_prefixes.find( key );
+
+            if( prefix == index->m_prefixes.end() )
+                continue;
+
+            int free = firstFreeNumber( prefix->second, number );
+
+            if( free != number )
+            {
+                number = free;
+                changed = true;
+            }
+        }
+    }
+
+    return number;
+}
+
+
+int SCH_REFERENCE_INDEX::FindFirstUnusedReference( const SCH_REFERENCE& aRef, int aMinValue,
+                                                   const std::vector<int>& aRequiredUnits ) const
+{
+    // Any number in use will do when no unit is required
+    if( aRequiredUnits.empty() )
+        return aMinValue;
+
+    wxString key = prefixKey( aRef.m_ref );
+    ENTRY    ref = makeEntry( aRef );
+    wxString part = partKey( ref.m_libName, ref.m_value );
+
+    // All the numbers below the first free one are in use.  Only the ones used by units of
+    // the same symbol can be shared, the others are skipped without being looked at.
+    int best = FindFirstFreeNumber( aRef.m_ref, aMinValue );
+
+    auto isUsable =
+            [&]( int aNumber )
+            {
+                for( const SCH_REFERENCE_INDEX* index = this; index; index = index->m_base )
+                {
+                    auto prefix = index->m_prefixes.find( key );
+
+                    if( prefix == index->m_prefixes.end() )
+                        continue;
+
+                    auto number = prefix->second.m_numbers.find( aNumber );
+
+                    if( number == prefix->second.m_numbers.end() )
+                        continue;
+
+                    for( const ENTRY& entry : number->second )
+                    {
+                        if( entry.m_libName != ref.m_libName || entry.m_value != ref.m_value
+                            || alg::contains( aRequiredUnits, entry.m_unit ) )
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            };
+
+    for( const SCH_REFERENCE_INDEX* index = this; index; index = index->m_base )
+    {
+        auto prefix = index->m_prefixes.find( key );
+
+        if( prefix == index->m_prefixes.end() )
+            continue;
+
+        auto numbers = prefix->second.m_parts.find( part );
+
+        if( numbers == prefix->second.m_parts.end() )
+            continue;
+
+        for( auto it = numbers->second.lower_bound( aMinValue );
+             it != numbers->second.end() && *it < best; ++it )
+        {
+            if( isUsable( *it ) )
+            {
+                best = *it;
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+
 wxString SCH_REFERENCE_LIST::Shorthand( std::vector<SCH_REFERENCE> aList,
                                         const wxString&            refDelimiter,
                                         const wxString&            refRangeDelimiter )
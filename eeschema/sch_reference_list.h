@@ -27,6 +27,8 @@
 #define _SCH_REFERENCE_LIST_H_
 
 #include <map>
+#include <set>
+#include <unordered_map>
 
 #include <lib_symbol.h>
 #include <macros.h>
@@ -88,11 +90,12 @@ public:
         m_sheetNum        = 0;
     }
 
-    SCH_REFERENCE( SCH_SYMBOL* aSymbol, LIB_SYMBOL* aLibSymbol, const SCH_SHEET_PATH& aSheetPath );
+    SCH_REFERENCE( SCH_SYMBOL* aSymbol, const LIB_SYMBOL* aLibSymbol,
+                   const SCH_SHEET_PATH& aSheetPath );
 
     SCH_SYMBOL* GetSymbol() const           { return m_rootSymbol; }
 
-    LIB_SYMBOL* GetLibPart() const          { return m_libPart; }
+    const LIB_SYMBOL* GetLibPart() const    { return m_libPart; }
 
     const SCH_SHEET_PATH& GetSheetPath() const { return m_sheetPath; }
 
@@ -234,11 +237,12 @@ public:
 
 private:
     friend class SCH_REFERENCE_LIST;
+    friend class SCH_REFERENCE_INDEX;
 
     /// Symbol reference prefix, without number (for IC1, this is IC) )
     wxString        m_ref;               // it's private, use the accessors please
     SCH_SYMBOL*     m_rootSymbol;        ///< The symbol associated the reference object.
-    LIB_SYMBOL*     m_libPart;           ///< The source symbol from a library.
+    const LIB_SYMBOL* m_libPart;         ///< The source symbol from a library.
     VECTOR2I        m_symbolPos;         ///< The physical position of the symbol in schematic
                                          ///< used to annotate by X or Y position
     int             m_unit;              ///< The unit number for symbol with multiple parts
@@ -255,6 +259,109 @@ private:
 };
 
 
+/**
+ * Index of the reference designators in use, by reference prefix and number.
+ *
+ * Finding the first free reference number and looking for duplicates take logarithmic time
+ * instead of a scan of a whole #SCH_REFERENCE_LIST, so an index of a large schematic can be
+ * kept and updated as symbols are added, removed and changed.
+ *
+ * An index can be stacked on a base index: queries then take the references of both into
+ * account.  The base index must outlive this one.
+ */
+class SCH_REFERENCE_INDEX
+{
+public:
+    SCH_REFERENCE_INDEX( const SCH_REFERENCE_INDEX* aBase = nullptr ) :
+            m_base( aBase )
+    {
+    }
+
+    void Clear();
+
+    bool IsEmpty() const { return m_prefixes.empty(); }
+
+    /**
+     * Add a reference to the index.  The reference must have been split.
+     *
+     * References which are not annotated are ignored.
+     */
+    void Add( const SCH_REFERENCE& aRef );
+
+    /**
+     * Remove a reference previously added with the same prefix, number, unit, symbol, library
+     * name and value.
+     */
+    void Remove( const SCH_REFERENCE& aRef );
+
+    /**
+     * Remove all the references of \a aSymbol, in all the sheets.
+     */
+    void RemoveSymbol( const SCH_SYMBOL* aSymbol );
+
+    /**
+     * @return the number of references using \a aPrefix, \a aNumber and \a aUnit in this index
+     *         and its base indexes.  More than one is a duplicate.
+     */
+    int Count( const wxString& aPrefix, int aNumber, int aUnit ) const;
+
+    /**
+     * @return the first number greater than or equal to \a aMinValue not used by any reference
+     *         with \a aPrefix.
+     */
+    int FindFirstFreeNumber( const wxString& aPrefix, int aMinValue ) const;
+
+    /**
+     * Return the first reference number from \a aMinValue which is either unused or used by
+     * units of the same symbol (library name and value) as \a aRef, none of them being in
+     * \a aRequiredUnits.
+     *
+     * @see SCH_REFERENCE_LIST::FindFirstUnusedReference
+     */
+    int FindFirstUnusedReference( const SCH_REFERENCE& aRef, int aMinValue,
+                                  const std::vector<int>& aRequiredUnits ) const;
+
+private:
+    struct ENTRY
+    {
+        const SCH_SYMBOL* m_symbol;
+        int               m_unit;
+        wxString          m_libName;
+        wxString          m_value;
+    };
+
+    struct PREFIX
+    {
+        std::map<int, std::vector<ENTRY>>           m_numbers; ///< References by number
+        std::map<int, int>                          m_runs;    ///< First to last number of each
+                                                               ///< run of consecutive numbers
+        std::unordered_map<wxString, std::set<int>> m_parts;   ///< Numbers by library name and
+                                                               ///< value
+    };
+
+    static wxString prefixKey( const wxString& aPrefix ) { return aPrefix.Lower(); }
+
+    static wxString partKey( const wxString& aLibName, const wxString& aValue )
+    {
+        return aLibName + wxS( "\n" ) + aValue;
+    }
+
+    static ENTRY makeEntry( const SCH_REFERENCE& aRef );
+
+    /// Remove the entry at \a aIndex of the references using \a aNumber
+    void removeEntry( const wxString& aKey, int aNumber, size_t aIndex );
+
+    /// Return the first number from \a aMinValue not used in \a aPrefix, ignoring base indexes
+    static int firstFreeNumber( const PREFIX& aPrefix, int aMinValue );
+
+    const SCH_REFERENCE_INDEX*           m_base;
+    std::unordered_map<wxString, PREFIX> m_prefixes;
+
+    /// Prefixes and numbers of the references of each symbol, to remove them
+    std::unordered_map<const SCH_SYMBOL*, std::vector<std::pair<wxString, int>>> m_symbols;
+};
+
+
 /**
  * Define a standard error handler for annotation errors.
  */
@@ -381,6 +488,17 @@ public:
                               bool                         aStartAtCurrent,
                               SCH_SHEET_LIST*              aHierarchy );
 
+    /**
+     * Same as above, with the additional references to check for duplicates given by an index,
+     * such as the one kept by the schematic, rather than by a list.
+     */
+    void ReannotateByOptions( ANNOTATE_ORDER_T             aSortOption,
+                              ANNOTATE_ALGO_T              aAlgoOption,
+                              int                          aStartNumber,
+                              const SCH_REFERENCE_INDEX&   aAdditionalRefs,
+                              bool                         aStartAtCurrent,
+                              SCH_SHEET_LIST*              aHierarchy );
+
     /**
      * Convenience function for the Paste Unique functionality. Do not use as a general
      * reannotation method.
@@ -406,13 +524,15 @@ public:
      * @param aAdditionalReferences Additional references to check for duplicates
      * @param aStartAtCurrent Use m_numRef for each reference as the start number (overrides
      *        aStartNumber)
+     * @param aAdditionalIndex Optional index of more references to check for duplicates
      */
     void AnnotateByOptions( enum ANNOTATE_ORDER_T        aSortOption,
                             enum ANNOTATE_ALGO_T         aAlgoOption,
                             int                          aStartNumber,
                             SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap,
                             const SCH_REFERENCE_LIST&    aAdditionalRefs,
-                            bool                         aStartAtCurrent );
+                            bool                         aStartAtCurrent,
+                            const SCH_REFERENCE_INDEX*   aAdditionalIndex = nullptr );
 
     /**
      * Set the reference designators in the list that have not been annotated.
@@ -434,10 +554,13 @@ public:
      *      in aAdditionalRefs exist in this list.
      * @param aStartAtCurrent Use m_numRef for each reference as the start number (overrides
             aStartNumber)
+     * @param aAdditionalIndex Optional index of more references to check for duplicates, used
+     *      the same way as \a aAdditionalRefs.
      */
     void Annotate( bool aUseSheetNum, int aSheetIntervalId, int aStartNumber,
                    SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap,
-                   const SCH_REFERENCE_LIST& aAdditionalRefs, bool aStartAtCurrent = false );
+                   const SCH_REFERENCE_LIST& aAdditionalRefs, bool aStartAtCurrent = false,
+                   const SCH_REFERENCE_INDEX* aAdditionalIndex = nullptr );
 
     /**
      * Check for annotations errors.
@@ -605,6 +728,14 @@ private:
 
     static bool sortByReferenceOnly( const SCH_REFERENCE& item1, const SCH_REFERENCE& item2 );
 
+    void reannotateByOptions( ANNOTATE_ORDER_T             aSortOption,
+                              ANNOTATE_ALGO_T              aAlgoOption,
+                              int                          aStartNumber,
+                              const SCH_REFERENCE_LIST&    aAdditionalRefs,
+                              const SCH_REFERENCE_INDEX*   aAdditionalIndex,
+                              bool                         aStartAtCurrent,
+                              SCH_SHEET_LIST*              aHierarchy );
+
     /**
      * Search for the first free reference number in \a aListId of reference numbers in use.
      *
@@ -43,6 +43,7 @@
 #include <symbol_library.h>
 #include <connection_graph.h>
 #include <lib_pin.h>
+#include <lib_symbol_store.h>
 #include <sch_symbol.h>
 #include <sch_junction.h>
 #include <sch_line.h>
@@ -160,7 +161,11 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem, bool aUpdateLibSymbol )
 
             if( symbol->GetLibSymbolRef() )
             {
-                symbol->GetLibSymbolRef()->GetDrawItems().sort();
+                // The library symbol can be shared with other symbols, so it cannot be sorted
+                // in place.  Shared library symbols are sorted by the store.
+                const LIB_SYMBOL& libSymbol = *symbol->GetLibSymbolRef();
+
+                symbol->SetLibSymbol( LIB_SYMBOL_STORE::Get().Acquire( libSymbol ) );
 
                 auto it = m_libSymbols.find( symbol->GetSchSymbolLibraryName() );
 
@@ -187,6 +192,10 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem, bool aUpdateLibSymbol )
                         getLibSymbolNameMatches( *symbol, matches );
                         foundSymbol = nullptr;
 
+                        // The symbol library symbol can be shared with other symbols, so the
+                        // name comparison below is done on a copy of it.
+                        LIB_SYMBOL renamedSymbol( *symbol->GetLibSymbolRef() );
+
                         for( const wxString& libSymbolName : matches )
                         {
                             it = m_libSymbols.find( libSymbolName );
@@ -198,20 +207,16 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem, bool aUpdateLibSymbol )
 
                             wxCHECK2( foundSymbol, continue );
 
-                            wxString tmp = symbol->GetLibSymbolRef()->GetName();
-
-                            // Temporarily update the new symbol library symbol name so it
-                            // doesn't fail on the name comparison below.
-                            symbol->GetLibSymbolRef()->SetName( foundSymbol->GetName() );
+                            // Update the library symbol name so it doesn't fail on the name
+                            // comparison below.
+                            renamedSymbol.SetName( foundSymbol->GetName() );
 
-                            if( *foundSymbol == *symbol->GetLibSymbolRef() )
+                            if( *foundSymbol == renamedSymbol )
                             {
                                 newName = libSymbolName;
-                                symbol->GetLibSymbolRef()->SetName( tmp );
                                 break;
                             }
 
-                            symbol->GetLibSymbolRef()->SetName( tmp );
                             foundSymbol = nullptr;
                         }
 
@@ -884,6 +889,7 @@ void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
     wxString msg;
     std::unique_ptr< LIB_SYMBOL > libSymbol;
     std::vector<SCH_SYMBOL*> symbols;
+    std::map<LIB_SYMBOL*, std::shared_ptr<LIB_SYMBOL>> sharedSymbols;
     SYMBOL_LIB_TABLE* libs = PROJECT_SCH::SchSymbolLibTable( &Schematic()->Prj() );
 
     // This will be a nullptr if an s-expression schematic is loaded.
@@ -918,8 +924,13 @@ void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
                 aReporter->ReportTail( msg, RPT_SEVERITY_INFO );
             }
 
-            // Internal library symbols are already flattened so just make a copy.
-            symbol->SetLibSymbol( new LIB_SYMBOL( *it->second ) );
+            // Internal library symbols are already flattened so just share them.
+            std::shared_ptr<LIB_SYMBOL>& sharedSymbol = sharedSymbols[ it->second ];
+
+            if( !sharedSymbol )
+                sharedSymbol = LIB_SYMBOL_STORE::Get().Acquire( *it->second );
+
+            symbol->SetLibSymbol( sharedSymbol );
             continue;
         }
 
@@ -1036,6 +1047,9 @@ void SCH_SCREEN::UpdateLocalLibSymbolLinks()
 {
     std::vector<SCH_SYMBOL*> symbols;
 
+    // Symbols using the same internal library symbol share a single copy of it
+    std::map<LIB_SYMBOL*, std::shared_ptr<LIB_SYMBOL>> sharedSymbols;
+
     for( SCH_ITEM* item : Items().OfType( SCH_SYMBOL_T ) )
         symbols.push_back( static_cast<SCH_SYMBOL*>( item ) );
 
@@ -1046,10 +1060,17 @@ void SCH_SCREEN::UpdateLocalLibSymbolLinks()
 
         auto it = m_libSymbols.find( symbol->GetSchSymbolLibraryName() );
 
-        LIB_SYMBOL* libSymbol = nullptr;
+        std::shared_ptr<LIB_SYMBOL> libSymbol;
+
+        if( it != m_libSymbols.end() && it->second )
+        {
+            std::shared_ptr<LIB_SYMBOL>& sharedSymbol = sharedSymbols[ it->second ];
 
-        if( it != m_libSymbols.end() )
-            libSymbol = new LIB_SYMBOL( *it->second );
+            if( !sharedSymbol )
+                sharedSymbol = LIB_SYMBOL_STORE::Get().Acquire( *it->second );
+
+            libSymbol = sharedSymbol;
+        }
 
         symbol->SetLibSymbol( libSymbol );
 
@@ -75,25 +75,30 @@ std::string toUTFTildaText( const wxString& txt )
  */
 static LIB_SYMBOL* dummy()
 {
-    static LIB_SYMBOL* symbol;
+    // Initialized once, even when first used by schematic files loaded in parallel
+    static LIB_SYMBOL* symbol =
+            []()
+            {
+                LIB_SYMBOL* newSymbol = new LIB_SYMBOL( wxEmptyString );
 
-    if( !symbol )
-    {
-        symbol = new LIB_SYMBOL( wxEmptyString );
+                LIB_SHAPE* square = new LIB_SHAPE( newSymbol, SHAPE_T::RECTANGLE );
 
-        LIB_SHAPE* square = new LIB_SHAPE( symbol, SHAPE_T::RECTANGLE );
+                square->SetPosition( VECTOR2I( schIUScale.MilsToIU( -200 ),
+                                               schIUScale.MilsToIU( 200 ) ) );
+                square->SetEnd( VECTOR2I( schIUScale.MilsToIU( 200 ),
+                                          schIUScale.MilsToIU( -200 ) ) );
 
-        square->SetPosition( VECTOR2I( schIUScale.MilsToIU( -200 ), schIUScale.MilsToIU( 200 ) ) );
-        square->SetEnd( VECTOR2I( schIUScale.MilsToIU( 200 ), schIUScale.MilsToIU( -200 ) ) );
+                LIB_TEXT* text = new LIB_TEXT( newSymbol );
 
-        LIB_TEXT* text = new LIB_TEXT( symbol );
+                text->SetTextSize( VECTOR2I( schIUScale.MilsToIU( 150 ),
+                                             schIUScale.MilsToIU( 150 ) ) );
+                text->SetText( wxString( wxT( "??" ) ) );
 
-        text->SetTextSize( VECTOR2I( schIUScale.MilsToIU( 150 ), schIUScale.MilsToIU( 150 ) ) );
-        text->SetText( wxString( wxT( "??" ) ) );
+                newSymbol->AddDrawItem( square );
+                newSymbol->AddDrawItem( text );
 
-        symbol->AddDrawItem( square );
-        symbol->AddDrawItem( text );
-    }
+                return newSymbol;
+            }();
 
     return symbol;
 }
@@ -193,7 +198,7 @@ SCH_SYMBOL::SCH_SYMBOL( const SCH_SYMBOL& aSymbol ) :
     }
 
     if( aSymbol.m_part )
-        SetLibSymbol( new LIB_SYMBOL( *aSymbol.m_part ) );
+        SetLibSymbol( aSymbol.m_part );
 
     m_fieldsAutoplaced = aSymbol.m_fieldsAutoplaced;
     m_schLibSymbolName = aSymbol.m_schLibSymbolName;
@@ -288,6 +293,25 @@ void SCH_SYMBOL::SetLibSymbol( LIB_SYMBOL* aLibSymbol )
 }
 
 
+void SCH_SYMBOL::SetLibSymbol( std::shared_ptr<LIB_SYMBOL> aLibSymbol )
+{
+    wxCHECK2( !aLibSymbol || aLibSymbol->IsRoot(), aLibSymbol.reset() );
+
+    m_part = std::move( aLibSymbol );
+    UpdatePins();
+}
+
+
+void SCH_SYMBOL::detachLibSymbol()
+{
+    if( m_part && m_part.use_count() > 1 )
+    {
+        m_part = std::make_shared<LIB_SYMBOL>( *m_part );
+        UpdatePins();
+    }
+}
+
+
 wxString SCH_SYMBOL::GetDescription() const
 {
     if( m_part )
@@ -1193,10 +1217,8 @@ void SCH_SYMBOL::SwapData( SCH_ITEM* aItem )
     for( std::unique_ptr<SCH_PIN>& pin : m_pins )
         pin->SetParent( this );
 
-    LIB_SYMBOL* libSymbol = symbol->m_part.release();
-    symbol->m_part = std::move( m_part );
+    m_part.swap( symbol->m_part );
     symbol->UpdatePins();
-    m_part.reset( libSymbol );
     UpdatePins();
 
     std::swap( m_pos, symbol->m_pos );
@@ -2344,7 +2366,7 @@ SCH_SYMBOL& SCH_SYMBOL::operator=( const SCH_SYMBOL& aSymbol )
         SYMBOL::operator=( aSymbol );
 
         m_lib_id    = aSymbol.m_lib_id;
-        m_part.reset( aSymbol.m_part ? new LIB_SYMBOL( *aSymbol.m_part ) : nullptr );
+        m_part      = aSymbol.m_part;
         m_pos       = aSymbol.m_pos;
         m_unit      = aSymbol.m_unit;
         m_bodyStyle = aSymbol.m_bodyStyle;
@@ -213,8 +213,13 @@ public:
     wxString GetSchSymbolLibraryName() const;
     bool UseLibIdLookup() const { return m_schLibSymbolName.IsEmpty(); }
 
-    std::unique_ptr< LIB_SYMBOL >& GetLibSymbolRef() { return m_part; }
-    const std::unique_ptr< LIB_SYMBOL >& GetLibSymbolRef() const { return m_part; }
+    /**
+     * @return the flattened library symbol, or nullptr for orphan symbols.  It can be shared
+     *         with other schematic symbols (see #LIB_SYMBOL_STORE), so it is read-only: the
+     *         per-symbol settings stored in it are changed through the SCH_SYMBOL setters,
+     *         which give the symbol its own copy first.
+     */
+    const LIB_SYMBOL* GetLibSymbolRef() const { return m_part.get(); }
 
     /**
      * Set this schematic symbol library symbol reference to \a aLibSymbol
@@ -234,6 +239,14 @@ public:
      */
     void SetLibSymbol( LIB_SYMBOL* aLibSymbol );
 
+    /**
+     * Set this schematic symbol library symbol reference to \a aLibSymbol, shared with other
+     * schematic symbols.
+     *
+     * The library symbol is copied before being modified through this symbol.
+     */
+    void SetLibSymbol( std::shared_ptr<LIB_SYMBOL> aLibSymbol );
+
     /**
      * @return the associated LIB_SYMBOL's description field (or wxEmptyString).
      */
@@ -850,16 +863,22 @@ public:
 
     void SetShowPinNumbers( bool aShow )
     {
-        if( m_part )
+        if( m_part && m_part->GetShowPinNumbers() != aShow )
+        {
+            detachLibSymbol();
             m_part->SetShowPinNumbers( aShow );
+        }
     }
 
     bool GetShowPinNames() const { return m_part && m_part->GetShowPinNames(); }
 
     void SetShowPinNames( bool aShow )
     {
-        if( m_part )
+        if( m_part && m_part->GetShowPinNames() != aShow )
+        {
+            detachLibSymbol();
             m_part->SetShowPinNames( aShow );
+        }
     }
 
     bool IsPointClickableAnchor( const VECTOR2I& aPos ) const override;
@@ -885,6 +904,12 @@ private:
 
     void Init( const VECTOR2I& pos = VECTOR2I( 0, 0 ) );
 
+    /**
+     * Replace the library symbol by a copy of it when it is shared with other symbols, so it
+     * can be modified.
+     */
+    void detachLibSymbol();
+
     VECTOR2I    m_pos;
     LIB_ID      m_lib_id;       ///< Name and library the symbol was loaded from, i.e. 74xx:74LS00.
     wxString    m_prefix;       ///< C, R, U, Q etc - the first character(s) which typically
@@ -904,8 +929,9 @@ private:
     TRANSFORM                              m_transform; ///< The rotation/mirror transformation.
     std::vector<SCH_FIELD>                 m_fields;    ///< Variable length list of fields.
 
-    std::unique_ptr< LIB_SYMBOL >          m_part;      ///< a flattened copy of the LIB_SYMBOL
-                                                        ///<   from the PROJECT's libraries.
+    std::shared_ptr< LIB_SYMBOL >          m_part;      ///< Flattened copy of the library symbol
+                                                        ///< from the project's libraries,
+                                                        ///< possibly shared with other symbols.
     std::vector<std::unique_ptr<SCH_PIN>>  m_pins;      ///< a SCH_PIN for every LIB_PIN (all units)
     std::unordered_map<LIB_PIN*, SCH_PIN*> m_pinMap;    ///< library pin pointer : SCH_PIN's index
 
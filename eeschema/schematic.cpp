@@ -24,7 +24,9 @@
 #include <core/kicad_algo.h>
 #include <ee_collectors.h>
 #include <erc_settings.h>
+#include <font/glyph_cache.h>
 #include <sch_marker.h>
+#include <sch_reference_list.h>
 #include <project.h>
 #include <project/project_file.h>
 #include <project/net_settings.h>
@@ -146,8 +148,13 @@ void SCHEMATIC::Reset()
 
     m_rootSheet = nullptr;
 
+    // Release the outline glyphs only this schematic's texts were using
+    KIFONT::GLYPH_CACHE::Instance().Purge();
+
     m_connectionGraph->Reset();
     m_currentSheet->clear();
+
+    rebuildReferenceIndex();
 }
 
 
@@ -191,6 +198,8 @@ void SCHEMATIC::SetRoot( SCH_SHEET* aRootSheet )
     m_currentSheet->push_back( m_rootSheet );
 
     m_connectionGraph->Reset();
+
+    rebuildReferenceIndex();
 }
 
 
@@ -653,6 +662,13 @@ void SCHEMATIC::SetSheetNumberAndCount()
 }
 
 
+void SCHEMATIC::AnnotatePowerSymbols()
+{
+    GetSheets().AnnotatePowerSymbols();
+    rebuildReferenceIndex();
+}
+
+
 void SCHEMATIC::RecomputeIntersheetRefs( const std::function<void( SCH_GLOBALLABEL* )>& aItemCallback )
 {
     std::map<wxString, std::set<int>>& pageRefsMap = GetPageRefsMap();
@@ -748,22 +764,117 @@ void SCHEMATIC::FixupJunctions()
 
 void SCHEMATIC::OnItemsAdded( std::vector<SCH_ITEM*>& aNewItems )
 {
+    updateReferenceIndex( aNewItems, false );
     InvokeListeners( &SCHEMATIC_LISTENER::OnSchItemsAdded, *this, aNewItems );
 }
 
 
 void SCHEMATIC::OnItemsRemoved( std::vector<SCH_ITEM*>& aRemovedItems )
 {
+    updateReferenceIndex( aRemovedItems, true );
     InvokeListeners( &SCHEMATIC_LISTENER::OnSchItemsRemoved, *this, aRemovedItems );
 }
 
 
 void SCHEMATIC::OnItemsChanged( std::vector<SCH_ITEM*>& aItems )
 {
+    updateReferenceIndex( aItems, false );
     InvokeListeners( &SCHEMATIC_LISTENER::OnSchItemsChanged, *this, aItems );
 }
 
 
+const SCH_REFERENCE_INDEX& SCHEMATIC::GetReferenceIndex()
+{
+    if( !m_referenceIndex )
+    {
+        m_referenceIndex = std::make_unique<SCH_REFERENCE_INDEX>();
+        rebuildReferenceIndex();
+    }
+
+    return *m_referenceIndex;
+}
+
+
+void SCHEMATIC::rebuildReferenceIndex()
+{
+    if( !m_referenceIndex )
+        return;
+
+    m_referenceIndex->Clear();
+    m_referenceIndexPaths.clear();
+
+    if( !IsValid() )
+        return;
+
+    SCH_REFERENCE_LIST references;
+
+    for( const SCH_SHEET_PATH& sheet : GetSheets() )
+    {
+        m_referenceIndexPaths[sheet.LastScreen()].push_back( sheet );
+        sheet.GetSymbols( references );
+    }
+
+    references.SplitReferences();
+
+    for( const SCH_REFERENCE& ref : references )
+        m_referenceIndex->Add( ref );
+}
+
+
+void SCHEMATIC::updateReferenceIndex( const std::vector<SCH_ITEM*>& aItems, bool aRemoved )
+{
+    if( !m_referenceIndex )
+        return;
+
+    for( SCH_ITEM* item : aItems )
+    {
+        SCH_SYMBOL* symbol = nullptr;
+
+        if( item->Type() == SCH_SHEET_T )
+        {
+            // The hierarchy may have changed, so may have the sheet paths of all the symbols
+            rebuildReferenceIndex();
+            return;
+        }
+        else if( item->Type() == SCH_SYMBOL_T )
+        {
+            symbol = static_cast<SCH_SYMBOL*>( item );
+        }
+        else if( item->Type() == SCH_FIELD_T && item->GetParent()
+                 && item->GetParent()->Type() == SCH_SYMBOL_T )
+        {
+            symbol = static_cast<SCH_SYMBOL*>( item->GetParent() );
+        }
+
+        if( !symbol )
+            continue;
+
+        m_referenceIndex->RemoveSymbol( symbol );
+
+        if( aRemoved )
+            continue;
+
+        auto paths = m_referenceIndexPaths.find( static_cast<SCH_SCREEN*>( symbol->GetParent() ) );
+
+        if( paths == m_referenceIndexPaths.end() )
+        {
+            rebuildReferenceIndex();
+            return;
+        }
+
+        SCH_REFERENCE_LIST references;
+
+        for( const SCH_SHEET_PATH& sheet : paths->second )
+            sheet.AppendSymbol( references, symbol );
+
+        references.SplitReferences();
+
+        for( const SCH_REFERENCE& ref : references )
+            m_referenceIndex->Add( ref );
+    }
+}
+
+
 void SCHEMATIC::OnSchSheetChanged()
 {
     InvokeListeners( &SCHEMATIC_LISTENER::OnSchSheetChanged, *this );
@@ -20,6 +20,9 @@
 #ifndef KICAD_SCHEMATIC_H
 #define KICAD_SCHEMATIC_H
 
+#include <memory>
+#include <unordered_map>
+
 #include <eda_item.h>
 #include <sch_sheet_path.h>
 #include <schematic_settings.h>
@@ -30,6 +33,7 @@ class CONNECTION_GRAPH;
 class EDA_BASE_FRAME;
 class ERC_SETTINGS;
 class PROJECT;
+class SCH_REFERENCE_INDEX;
 class SCH_SCREEN;
 class SCH_SHEET;
 class SCH_SHEET_LIST;
@@ -212,6 +216,14 @@ public:
      */
     void SetSheetNumberAndCount();
 
+    /**
+     * Silently annotate the not yet annotated power symbols of the whole schematic, and update
+     * the reference index as they are not renumbered through a commit.
+     *
+     * @see SCH_SHEET_LIST::AnnotatePowerSymbols()
+     */
+    void AnnotatePowerSymbols();
+
     /**
      * Update the schematic's page reference map for all global labels, and refresh the labels
      * so that they are redrawn with up-to-date references.
@@ -277,6 +289,15 @@ public:
       */
     void OnSchSheetChanged();
 
+    /**
+     * Return the index of the annotated references of the whole schematic.
+     *
+     * The index is built on first use, then kept up to date by OnItemsAdded(), OnItemsRemoved(),
+     * OnItemsChanged() and AnnotatePowerSymbols(), so the symbols must be changed through commits
+     * or that method.  The returned object lives as long as the schematic.
+     */
+    const SCH_REFERENCE_INDEX& GetReferenceIndex();
+
     /**
      * Add a listener to the schematic to receive calls whenever something on the
      * schematic has been modified.  The schematic does not take ownership of the
@@ -305,6 +326,12 @@ public:
 private:
     friend class SCH_EDIT_FRAME;
 
+    /// Fill the reference index from scratch, if it has been built
+    void rebuildReferenceIndex();
+
+    /// Update the reference index for added, changed or (if \a aRemoved) removed items
+    void updateReferenceIndex( const std::vector<SCH_ITEM*>& aItems, bool aRemoved );
+
     template <typename Func, typename... Args>
     void InvokeListeners( Func&& aFunc, Args&&... args )
     {
@@ -348,6 +375,12 @@ private:
      * Currently installed listeners
      */
     std::vector<SCHEMATIC_LISTENER*> m_listeners;
+
+    /// Annotated references of the schematic, built on first use
+    std::unique_ptr<SCH_REFERENCE_INDEX> m_referenceIndex;
+
+    /// Sheet paths of each screen, to index the references of new symbols
+    std::unordered_map<const SCH_SCREEN*, std::vector<SCH_SHEET_PATH>> m_referenceIndexPaths;
 };
 
 #endif
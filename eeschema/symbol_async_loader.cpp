@@ -114,7 +114,7 @@ std::vector<SYMBOL_ASYNC_LOADER::LOADED_PAIR> SYMBOL_ASYNC_LOADER::worker()
 
         try
         {
-            m_table->LoadSymbolLib( pair.second, nickname, onlyPower );
+            m_table->LoadSymbolLib( pair.second, nickname, onlyPower, true );
             ret.emplace_back( std::move( pair ) );
         }
         catch( const IO_ERROR& ioe )
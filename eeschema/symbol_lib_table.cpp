@@ -51,6 +51,7 @@ static const wxString global_tbl_name( "sym-lib-table" );
 
 const char* SYMBOL_LIB_TABLE::PropPowerSymsOnly = "pwr_sym_only";
 const char* SYMBOL_LIB_TABLE::PropNonPowerSymsOnly = "non_pwr_sym_only";
+const char* SYMBOL_LIB_TABLE::PropSymsIndexOnly = "sym_index_only";
 int SYMBOL_LIB_TABLE::m_modifyHash = 1;     // starts at 1 and goes up
 
 
@@ -369,7 +370,8 @@ SYMBOL_LIB_TABLE_ROW* SYMBOL_LIB_TABLE::FindRow( const wxString& aNickname, bool
 
 
 void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_SYMBOL*>& aSymbolList,
-                                      const wxString& aNickname, bool aPowerSymbolsOnly )
+                                      const wxString& aNickname, bool aPowerSymbolsOnly,
+                                      bool aIndexOnly )
 {
     SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname, true );
 
@@ -383,12 +385,15 @@ void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_SYMBOL*>& aSymbolList,
     if( aPowerSymbolsOnly )
         row->SetOptions( row->GetOptions() + " " + PropPowerSymsOnly );
 
+    if( aIndexOnly )
+        row->SetOptions( row->GetOptions() + " " + PropSymsIndexOnly );
+
     row->SetLoaded( false );
     row->plugin->SetLibTable( this );
     row->plugin->EnumerateSymbolLib( aSymbolList, row->GetFullURI( true ), row->GetProperties() );
     row->SetLoaded( true );
 
-    if( aPowerSymbolsOnly )
+    if( aPowerSymbolsOnly || aIndexOnly )
         row->SetOptions( options );
 
     // The library cannot know its own name, because it might have been renamed or moved.
@@ -148,6 +148,7 @@ public:
 
     static const char* PropPowerSymsOnly;
     static const char* PropNonPowerSymsOnly;
+    static const char* PropSymsIndexOnly;
 
     virtual void Parse( LIB_TABLE_LEXER* aLexer ) override;
 
@@ -191,8 +192,19 @@ public:
     void EnumerateSymbolLib( const wxString& aNickname, wxArrayString& aAliasNames,
                              bool aPowerSymbolsOnly = false );
 
+    /**
+     * Return the symbols of the library given by @a aNickname.
+     *
+     * @param aAliasList is filled with the symbols, which are owned by the library.
+     * @param aNickname is a locator for the "library", it is a "name" in LIB_TABLE_ROW.
+     * @param aPowerSymbolsOnly is a flag to enumerate only power symbols.
+     * @param aIndexOnly is a flag telling the symbols are only used to list them: libraries
+     *                   may then return symbols without their graphics and pins, which are
+     *                   loaded by LoadSymbol().
+     * @throw IO_ERROR if the library cannot be found or loaded.
+     */
     void LoadSymbolLib( std::vector<LIB_SYMBOL*>& aAliasList, const wxString& aNickname,
-                        bool aPowerSymbolsOnly = false );
+                        bool aPowerSymbolsOnly = false, bool aIndexOnly = false );
 
     /**
      * Load a #LIB_SYMBOL having @a aName from the library given by @a aNickname.
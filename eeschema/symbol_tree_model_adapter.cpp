@@ -211,7 +211,7 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname, bool p
 
     try
     {
-        m_libs->LoadSymbolLib( symbols, aLibNickname, onlyPowerSymbols );
+        m_libs->LoadSymbolLib( symbols, aLibNickname, onlyPowerSymbols, true );
     }
     catch( const IO_ERROR& ioe )
     {
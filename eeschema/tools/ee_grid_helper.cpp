@@ -35,6 +35,7 @@
 #include <settings/app_settings.h>
 #include <trigo.h>
 #include <view/view.h>
+#include <view/view_query_cache.h>
 #include "ee_grid_helper.h"
 
 
@@ -321,7 +322,8 @@ std::set<SCH_ITEM*> EE_GRID_HELPER::queryVisible( const BOX2I& aArea,
 
     KIGFX::VIEW* view = m_toolMgr->GetView();
 
-    view->Query( aArea, selectedItems );
+    // Called on each mouse move, so the items around the cursor are kept between calls
+    view->GetQueryCache().Query( aArea, selectedItems );
 
     for( const KIGFX::VIEW::LAYER_ITEM_PAIR& it : selectedItems )
     {
@@ -137,11 +137,16 @@ int SCH_DRAWING_TOOLS::PlaceSymbol( const TOOL_EVENT& aEvent )
             hierarchy.FindAllSheetsForScreen( m_frame->GetCurrentSheet().LastScreen() );
     newInstances.SortByPageNumbers();
 
-    // Get a list of all references in the schematic to avoid duplicates wherever
-    // they're placed
-    SCH_REFERENCE_LIST existingRefs;
-    hierarchy.GetSymbols( existingRefs );
-    existingRefs.SortByReferenceOnly();
+    // The references annotated while placing, on top of the ones of the schematic, to avoid
+    // duplicates wherever they're placed
+    SCH_REFERENCE_INDEX existingRefs( &m_frame->Schematic().GetReferenceIndex() );
+
+    auto addExistingRef =
+            [&]( SCH_REFERENCE aRef )
+            {
+                aRef.Split();
+                existingRefs.Add( aRef );
+            };
 
     if( aEvent.IsAction( &EE_ACTIONS::placeSymbol ) )
     {
@@ -191,8 +196,6 @@ int SCH_DRAWING_TOOLS::PlaceSymbol( const TOOL_EVENT& aEvent )
                 symbol = nullptr;
 
                 existingRefs.Clear();
-                hierarchy.GetSymbols( existingRefs );
-                existingRefs.SortByReferenceOnly();
             };
 
     auto annotate =
@@ -203,7 +206,7 @@ int SCH_DRAWING_TOOLS::PlaceSymbol( const TOOL_EVENT& aEvent )
                 // Then we need to annotate all instances by sheet
                 for( SCH_SHEET_PATH& instance : newInstances )
                 {
-                    SCH_REFERENCE newReference( symbol, symbol->GetLibSymbolRef().get(), instance );
+                    SCH_REFERENCE newReference( symbol, symbol->GetLibSymbolRef(), instance );
                     SCH_REFERENCE_LIST refs;
                     refs.AddItem( newReference );
 
@@ -218,7 +221,7 @@ int SCH_DRAWING_TOOLS::PlaceSymbol( const TOOL_EVENT& aEvent )
 
                         // Update existing refs for next iteration
                         for( size_t i = 0; i < refs.GetCount(); i++ )
-                            existingRefs.AddItem( refs[i] );
+                            addExistingRef( refs[i] );
                     }
                 }
 
@@ -377,10 +380,9 @@ int SCH_DRAWING_TOOLS::PlaceSymbol( const TOOL_EVENT& aEvent )
                 annotate();
 
                 // Update the list of references for the next symbol placement.
-                SCH_REFERENCE placedSymbolReference( symbol, symbol->GetLibSymbolRef().get(),
+                SCH_REFERENCE placedSymbolReference( symbol, symbol->GetLibSymbolRef(),
                                                      m_frame->GetCurrentSheet() );
-                existingRefs.AddItem( placedSymbolReference );
-                existingRefs.SortByReferenceOnly();
+                addExistingRef( placedSymbolReference );
 
                 if( m_frame->eeconfig()->m_AutoplaceFields.enable )
                     symbol->AutoplaceFields( /* aScreen */ nullptr, /* aManual */ false );
@@ -441,10 +443,9 @@ int SCH_DRAWING_TOOLS::PlaceSymbol( const TOOL_EVENT& aEvent )
 
                         // Update the list of references for the next symbol placement.
                         SCH_REFERENCE placedSymbolReference( symbol,
-                                                             symbol->GetLibSymbolRef().get(),
+                                                             symbol->GetLibSymbolRef(),
                                                              m_frame->GetCurrentSheet() );
-                        existingRefs.AddItem( placedSymbolReference );
-                        existingRefs.SortByReferenceOnly();
+                        addExistingRef( placedSymbolReference );
                     }
                 }
 
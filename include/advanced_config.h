@@ -259,6 +259,39 @@ public:
      */
     bool m_DrawTriangulationOutlines;
 
+    /**
+     * Draw items sharing the same drawing (such as identical vias and pads) from a single
+     * cached group, moved to each item position.
+     *
+     * @note This only affects the OpenGL GAL.
+     *
+     * Setting name: "EnableGalInstancing"
+     * Valid values: 0 or 1
+     * Default value: 1
+     */
+    bool m_EnableGalInstancing;
+
+    /**
+     * Record the frame trace (view redraw phases, GAL uploads, tool event handling,
+     * connectivity updates) from startup, and save it in the logs folder on exit.
+     *
+     * The trace can also be started and saved with the Save Frame Trace action.
+     *
+     * Setting name: "EnableFrameTracing"
+     * Valid values: 0 or 1
+     * Default value: 0
+     */
+    bool m_EnableFrameTracing;
+
+    /**
+     * Number of zones kept by the frame trace, the oldest ones being dropped.
+     *
+     * Setting name: "FrameTraceZones"
+     * Valid values: 1024 to 16777216
+     * Default value: 262144
+     */
+    int m_FrameTraceZones;
+
     /**
      * When true, adds zone-display-modes for stroking the zone fracture boundaries and the zone
      * triangulation.
@@ -448,6 +481,26 @@ public:
      */
     bool m_IncrementalConnectivity;
 
+    /**
+     * Check each incremental connectivity update against a full recalculation, and report the
+     * differences in the "CONN" trace.  Slow; for debugging the incremental netlister.
+     *
+     * Setting name: "VerifyIncrementalConnectivity"
+     * Valid values: 0 or 1
+     * Default value: 0
+     */
+    bool m_VerifyIncrementalConnectivity;
+
+    /**
+     * Only index the symbols of KiCad symbol libraries when listing them, and parse each symbol
+     * graphics and pins when it is first used.  The index is saved next to each library.
+     *
+     * Setting name: "IndexSymbolLibraries"
+     * Valid values: 0 or 1
+     * Default value: 0
+     */
+    bool m_IndexSymbolLibraries;
+
     /**
      * The number of milliseconds to wait in a click before showing a disambiguation menu.
      *
@@ -69,6 +69,9 @@ public:
      * Retrieves a single row from a database table.  Table and column names are cached when the
      * connection is created, so schema changes to the database won't be recognized unless the
      * connection is recreated.
+     *
+     * When the table is not cached yet, the whole table is fetched and cached (keyed by the
+     * searched column) so that the following calls don't need a round-trip to the database.
      * @param aTable the name of a table in the database
      * @param aWhere column to search, and the value to search for
      * @param aResult will be filled with a row in the database if one was found
@@ -87,11 +90,41 @@ public:
     bool SelectAll( const std::string& aTable, const std::string& aKey,
                     std::vector<ROW>& aResults );
 
+    /**
+     * Retrieves the number of rows in a database table.
+     * @param aTable the name of a table in the database
+     * @param aCount will be set to the number of rows
+     * @return true if the query succeeded
+     */
+    bool SelectCount( const std::string& aTable, size_t& aCount );
+
+    /**
+     * Retrieves the greatest value of a column of a database table, for instance to find out the
+     * last time a row was modified.
+     * @param aTable the name of a table in the database
+     * @param aColumn the column to search; must be one of the columns cached for the table
+     * @param aResult will be set to the greatest value, or to an empty string if the table is empty
+     * @return true if the query succeeded
+     */
+    bool SelectMax( const std::string& aTable, const std::string& aColumn, std::string& aResult );
+
+    /**
+     * Fills the cache with rows of a database table obtained elsewhere, so that SelectOne() and
+     * SelectAll() return them without querying the database until the cache expires.
+     * @param aTable the name of a table in the database
+     * @param aKey holds the column name of the primary key used for caching results
+     * @param aRows all the rows of the table
+     */
+    void CacheRows( const std::string& aTable, const std::string& aKey,
+                    const std::vector<ROW>& aRows );
+
     std::string GetLastError() const { return m_lastError; }
 
 private:
     void init();
 
+    bool selectScalar( const std::string& aQuery, std::string& aResult );
+
     bool getQuoteChar();
 
     std::string columnsFor( const std::string& aTable );
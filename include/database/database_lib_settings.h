@@ -90,6 +90,7 @@ struct KICOMMON_API DATABASE_LIB_TABLE
     std::string key_col;           ///< Unique key column name (will form part of the LIB_ID)
     std::string symbols_col;       ///< Column name containing KiCad symbol refs
     std::string footprints_col;    ///< Column name containing KiCad footprint refs
+    std::string modified_col;      ///< Optional column holding the last modification of a row
 
     MAPPABLE_SYMBOL_PROPERTIES properties;
     std::vector<DATABASE_FIELD_MAPPING> fields;
@@ -100,6 +101,7 @@ struct KICOMMON_API DATABASE_CACHE_SETTINGS
 {
     int max_size;    ///< Maximum number of single-row results to cache
     int max_age;     ///< Max age of cached rows before they expire, in seconds
+    bool snapshot;   ///< Whether to keep a local copy of the tables between sessions
 };
 
 
@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef KICAD_DATABASE_SNAPSHOT_H
+#define KICAD_DATABASE_SNAPSHOT_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <database/database_connection.h>
+
+
+/**
+ * A local copy of the tables used by a database library, saved between sessions so that the
+ * library can be listed without fetching every table from the database.
+ *
+ * Each table is saved with its row count and modification stamp at the time it was fetched.
+ * These are cheap to query, and are compared with the database before using the saved rows.
+ */
+class DATABASE_SNAPSHOT
+{
+public:
+    struct TABLE
+    {
+        std::string           key;      ///< Key column the rows were fetched with
+        std::set<std::string> columns;  ///< Columns the rows were fetched with
+        size_t                count;    ///< Number of rows in the database table
+        std::string           stamp;    ///< Greatest value of the modification column, if any
+
+        std::vector<DATABASE_CONNECTION::ROW> rows;
+    };
+
+    DATABASE_SNAPSHOT( const wxString& aFileName ) :
+            m_fileName( aFileName )
+    {}
+
+    /**
+     * Read the snapshot file.
+     * @return false if the file is missing, invalid or was written by another version.
+     */
+    bool Load();
+
+    /**
+     * Write the snapshot file, creating its directory if needed.  The file is replaced at once,
+     * so several snapshots of the same library can be saved at the same time.
+     * @return false if the file could not be written.
+     */
+    bool Save() const;
+
+    /**
+     * @return the saved copy of \a aTable, or nullptr if there is none.
+     */
+    const TABLE* GetTable( const std::string& aTable ) const;
+
+    void SetTable( const std::string& aTable, TABLE aData );
+
+    const wxString& GetFileName() const { return m_fileName; }
+
+    /**
+     * @return the name of the snapshot file of the database library \a aLibraryPath, in the user
+     *         cache directory.
+     */
+    static wxString GetFileNameFor( const wxString& aLibraryPath );
+
+private:
+    wxString                     m_fileName;
+    std::map<std::string, TABLE> m_tables;
+};
+
+#endif //KICAD_DATABASE_SNAPSHOT_H
@@ -28,6 +28,7 @@
 #include <gal/gal.h>
 #include <memory>
 #include <math/box2.h>
+#include <math/matrix3x3.h>
 #include <geometry/shape_poly_set.h>
 #include <wx/debug.h>
 #include "../../libs/kimath/include/geometry/eda_angle.h"
@@ -55,6 +56,7 @@ public:
 
     virtual bool IsOutline() const { return false; }
     virtual bool IsStroke() const  { return false; }
+    virtual bool IsSharedOutline() const { return false; }
 
     virtual BOX2D BoundingBox() = 0;
 };
@@ -99,6 +101,62 @@ public:
 };
 
 
+/**
+ * An outline glyph owned by the GLYPH_CACHE and shared between all the texts drawing the same
+ * glyph of the same font.  The cached glyph is in font units; each text only stores the
+ * transform (size, mirroring, rotation and position) applied to it when it is drawn.
+ */
+class GAL_API SHARED_OUTLINE_GLYPH : public GLYPH
+{
+public:
+    SHARED_OUTLINE_GLYPH( std::shared_ptr<const OUTLINE_GLYPH> aGlyph,
+                          const MATRIX3x3D& aTransform ) :
+            m_glyph( std::move( aGlyph ) ),
+            m_transform( aTransform )
+    {}
+
+    bool IsSharedOutline() const override { return true; }
+
+    BOX2D BoundingBox() override;
+
+    /**
+     * @return the shared glyph, in font units.  Its outlines and triangulation must be mapped
+     *         through GetTransform() to get the actual glyph.
+     */
+    const OUTLINE_GLYPH& GetGlyph() const { return *m_glyph; }
+
+    const MATRIX3x3D& GetTransform() const { return m_transform; }
+
+    /**
+     * @return the point \a aPt of the shared glyph, mapped to the text.
+     */
+    VECTOR2I Transform( const VECTOR2I& aPt ) const
+    {
+        VECTOR2D pt = m_transform * VECTOR2D( aPt );
+        return VECTOR2I( KiROUND( pt.x ), KiROUND( pt.y ) );
+    }
+
+    void Move( const VECTOR2I& aOffset )
+    {
+        m_transform.SetTranslation( m_transform.GetTranslation() + VECTOR2D( aOffset ) );
+    }
+
+    /**
+     * @return a copy of the glyph as drawn (without triangulation), for when the geometry is
+     *         needed rather than just drawn.
+     */
+    std::unique_ptr<OUTLINE_GLYPH> Instantiate() const;
+
+    void Triangulate( std::function<void( const VECTOR2I& aPt1,
+                                          const VECTOR2I& aPt2,
+                                          const VECTOR2I& aPt3 )> aCallback ) const;
+
+private:
+    std::shared_ptr<const OUTLINE_GLYPH> m_glyph;
+    MATRIX3x3D                           m_transform;
+};
+
+
 class GAL_API STROKE_GLYPH : public GLYPH, public std::vector<std::vector<VECTOR2D>>
 {
 public:
@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <gal/gal.h>
+#include <font/glyph.h>
+#include <math/vector2d.h>
+
+namespace KIFONT
+{
+
+/**
+ * Cached glyphs are stored in font units multiplied by this, so that they keep their precision
+ * as integer coordinates.
+ */
+constexpr double GLYPH_CACHE_SCALE = 1024.0;
+
+
+/**
+ * Identifies a cached glyph: which glyph of which font face, at which character size and with
+ * which synthesized style.  How the glyph is drawn (size, mirroring, rotation and position) is
+ * not part of it; it is applied by each SHARED_OUTLINE_GLYPH.
+ */
+struct GAL_API GLYPH_CACHE_KEY
+{
+    const void*  m_face;
+    unsigned int m_glyphIndex;
+    int          m_charSize;       ///< FreeType character size the font units are based on
+    bool         m_fakeItalic;
+    bool         m_fakeBold;
+
+    bool operator==( const GLYPH_CACHE_KEY& aOther ) const
+    {
+        return m_face == aOther.m_face && m_glyphIndex == aOther.m_glyphIndex
+               && m_charSize == aOther.m_charSize && m_fakeItalic == aOther.m_fakeItalic
+               && m_fakeBold == aOther.m_fakeBold;
+    }
+};
+
+
+struct GAL_API GLYPH_CACHE_KEY_HASH
+{
+    std::size_t operator()( const GLYPH_CACHE_KEY& aKey ) const;
+};
+
+
+/**
+ * Memory used by the glyph cache, and how well it is doing.
+ */
+struct GLYPH_CACHE_STATS
+{
+    size_t m_glyphs = 0;      ///< Number of glyphs in the cache
+    size_t m_bytes = 0;       ///< Approximate memory used by the cached glyphs
+    size_t m_hits = 0;        ///< Lookups served from the cache
+    size_t m_misses = 0;      ///< Lookups that had to build the glyph
+    size_t m_purged = 0;      ///< Unused glyphs dropped from the cache
+};
+
+
+/**
+ * A process-wide store of triangulated outline glyphs, shared by all the texts using them.
+ *
+ * Glyphs are stored in font units, and handed out to texts as SHARED_OUTLINE_GLYPHs which add
+ * their own size, mirroring, rotation and position.  All the texts of a font thus share one copy
+ * of each glyph outline and its triangulation, whatever their size and orientation, and these
+ * are built only the first time the glyph is used.
+ *
+ * Once the cache holds more than MAX_BYTES, glyphs no longer used by any text are dropped.
+ * Purge() does the same on demand, for instance when a document is closed.
+ *
+ * The cache is safe to use from several threads.  Glyphs are immutable once cached, and stay
+ * alive as long as a text references them, even if they are dropped from the cache.
+ */
+class GAL_API GLYPH_CACHE
+{
+public:
+    /// Size above which unused glyphs are dropped from the cache
+    static constexpr size_t MAX_BYTES = 64 * 1024 * 1024;
+
+    static GLYPH_CACHE& Instance();
+
+    /**
+     * Return the glyph for \a aKey, calling \a aBuilder to create it if it is not cached yet.
+     *
+     * The builder is called without holding the cache lock; if two threads build the same glyph
+     * at the same time, the first one stored is kept.
+     */
+    std::shared_ptr<const OUTLINE_GLYPH>
+    Get( const GLYPH_CACHE_KEY&                                   aKey,
+         const std::function<std::unique_ptr<OUTLINE_GLYPH>()>& aBuilder );
+
+    /**
+     * Drop the cached glyphs which are not used by any text.
+     */
+    void Purge();
+
+    /**
+     * Drop all the cached glyphs.  Glyphs still used by texts are freed with the last of them.
+     */
+    void Clear();
+
+    GLYPH_CACHE_STATS GetStats() const;
+
+    /**
+     * @return an estimate of the memory used by \a aGlyph, including its triangulation.
+     */
+    static size_t GlyphBytes( const OUTLINE_GLYPH& aGlyph );
+
+private:
+    GLYPH_CACHE() = default;
+
+    /// Drop the unused glyphs; must be called with the cache lock held
+    void purgeUnlocked();
+
+    mutable std::shared_mutex m_mutex;
+
+    std::unordered_map<GLYPH_CACHE_KEY, std::shared_ptr<const OUTLINE_GLYPH>,
+                       GLYPH_CACHE_KEY_HASH> m_glyphs;
+
+    size_t                    m_bytes = 0;
+    size_t                    m_purgeAbove = MAX_BYTES;   ///< Size triggering the next purge
+    std::atomic<size_t>       m_hits = 0;
+    std::atomic<size_t>       m_misses = 0;
+    size_t                    m_purged = 0;
+};
+
+} // namespace KIFONT
+
+#endif // GLYPH_CACHE_H
@@ -48,16 +48,6 @@ struct CONTOUR
     FT_Orientation        m_Orientation;
 };
 
-struct GLYPH_DATA
-{
-    std::vector<CONTOUR> m_Contours;
-
-    // Cache of the triangulation data.  We'll use this as a hint for triangulating the actual
-    // OUTLINE_GLYPHs.
-    std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> m_TriangulationData;
-};
-
-
 class OUTLINE_DECOMPOSER
 {
 public:
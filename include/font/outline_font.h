@@ -45,6 +45,8 @@
 
 namespace KIFONT
 {
+struct GLYPH_CACHE_KEY;
+
 /**
  * Class OUTLINE_FONT implements outline font drawing.
  */
@@ -122,6 +124,14 @@ private:
                                       bool aMirror, const VECTOR2I& aOrigin,
                                       TEXT_STYLE_FLAGS aTextStyle ) const;
 
+    /**
+     * Build the cached version of a glyph, in font units scaled by GLYPH_CACHE_SCALE.  Must be
+     * called with the FreeType mutex held.
+     */
+    std::unique_ptr<OUTLINE_GLYPH> makeGlyph( FT_Face aFace, unsigned int aGlyphIndex,
+                                              double aAdvance, double aScaler,
+                                              const GLYPH_CACHE_KEY& aKey ) const;
+
 private:
     // FreeType variables
 
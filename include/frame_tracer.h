@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef FRAME_TRACER_H
+#define FRAME_TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <kicommon.h>
+
+class wxString;
+
+/**
+ * Record the time spent in named code zones (view redraw phases, GAL uploads, painter calls,
+ * tool event handling, connectivity updates...) to find out where the time of slow frames goes.
+ *
+ * Zones are stored in a fixed size ring buffer written without locks from any thread, the
+ * oldest zones being overwritten once it is full.  The recorded zones can be saved in the Chrome
+ * trace event format, to be opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Recording is disabled by default.  A zone of a disabled tracer costs a single atomic load, and
+ * the ring buffer is only allocated when the tracer is first enabled.
+ */
+class KICOMMON_API FRAME_TRACER
+{
+public:
+    /**
+     * @param aCapacity is the number of zones kept.
+     */
+    FRAME_TRACER( size_t aCapacity );
+
+    /**
+     * Return the tracer used by #KI_TRACE_ZONE, sized and enabled from the advanced config.
+     */
+    static FRAME_TRACER& Instance();
+
+    /**
+     * Start or stop recording zones.  The ring buffer is allocated the first time the tracer is
+     * enabled, and kept afterwards.
+     */
+    void Enable( bool aEnable );
+    bool IsEnabled() const { return m_enabled.load( std::memory_order_acquire ); }
+
+    /**
+     * @return the time since the tracer creation, in microseconds.
+     */
+    int64_t Now() const;
+
+    /**
+     * Record a zone of the calling thread.
+     *
+     * The name and category are not copied, they must be string literals.  Zones recorded
+     * before the tracer was ever enabled are dropped.
+     *
+     * @param aStart is the zone start time, as returned by Now().
+     * @param aEnd is the zone end time, as returned by Now().
+     */
+    void Record( const char* aName, const char* aCategory, int64_t aStart, int64_t aEnd );
+
+    /**
+     * Forget the zones recorded so far.
+     */
+    void Clear();
+
+    /**
+     * @return the number of zones recorded, at most the tracer capacity.
+     */
+    size_t GetCount() const;
+
+    size_t GetCapacity() const { return m_capacity; }
+
+    /**
+     * @return the recorded zones, oldest first, as a Chrome trace event JSON document.
+     */
+    std::string ToChromeTrace() const;
+
+    /**
+     * Write the recorded zones to \a aFileName as a Chrome trace event JSON document.
+     *
+     * @return false if the file could not be written.
+     */
+    bool SaveChromeTrace( const wxString& aFileName ) const;
+
+private:
+    struct ZONE
+    {
+        ///< 2 * index + 1 while the zone is written, 2 * index + 2 once written
+        std::atomic<uint64_t>    m_sequence;
+        std::atomic<const char*> m_name;
+        std::atomic<const char*> m_category;
+        std::atomic<int64_t>     m_start;
+        std::atomic<int64_t>     m_duration;
+        std::atomic<uint32_t>    m_thread;
+    };
+
+    template <typename FUNC>
+    void forEachZone( FUNC aFunc ) const;
+
+    std::atomic<bool>       m_enabled;
+    size_t                  m_capacity;
+    std::mutex              m_allocMutex;
+    std::unique_ptr<ZONE[]> m_ring;        ///< Owns the ring buffer, once allocated
+    std::atomic<ZONE*>      m_zones;       ///< The ring buffer, or nullptr until first enabled
+    std::atomic<uint64_t>   m_next;        ///< Index of the next zone to write
+    std::atomic<uint64_t>   m_first;       ///< Index of the first zone since the last Clear()
+    int64_t                 m_epoch;       ///< Creation time, in steady clock microseconds
+};
+
+
+/**
+ * Record the time spent in the scope it is declared in, if the tracer is enabled at that time.
+ */
+class FRAME_TRACE_ZONE
+{
+public:
+    FRAME_TRACE_ZONE( const char* aName, const char* aCategory,
+                      FRAME_TRACER& aTracer = FRAME_TRACER::Instance() ) :
+            m_tracer( aTracer ),
+            m_name( aName ),
+            m_category( aCategory ),
+            m_start( aTracer.IsEnabled() ? aTracer.Now() : -1 )
+    {
+    }
+
+    ~FRAME_TRACE_ZONE()
+    {
+        if( m_start >= 0 )
+            m_tracer.Record( m_name, m_category, m_start, m_tracer.Now() );
+    }
+
+private:
+    FRAME_TRACER& m_tracer;
+    const char*   m_name;
+    const char*   m_category;
+    int64_t       m_start;
+};
+
+
+#define KI_TRACE_ZONE_NAME2( aLine ) frameTraceZone##aLine
+#define KI_TRACE_ZONE_NAME( aLine ) KI_TRACE_ZONE_NAME2( aLine )
+
+/**
+ * Record the rest of the enclosing scope as a zone named \a aName in \a aCategory (both string
+ * literals) of the frame trace.
+ */
+#define KI_TRACE_ZONE( aName, aCategory ) \
+    FRAME_TRACE_ZONE KI_TRACE_ZONE_NAME( __LINE__ )( aName, aCategory )
+
+#endif // FRAME_TRACER_H
@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef CAIRO_TILED_RENDERER_H
+#define CAIRO_TILED_RENDERER_H
+
+#include <algorithm>
+
+#include <gal/cairo/cairo_gal.h>
+#include <gal/gal_display_options.h>
+#include <math/box2.h>
+
+class wxImage;
+
+namespace KIGFX
+{
+class VIEW;
+
+/**
+ * A Cairo GAL drawing into a rectangular region of a 32 bit ARGB image, owned by the caller.
+ *
+ * The screen size is the size of the whole image, so that all the regions of an image share the
+ * same world to screen transformation: drawing the same items into every region of the image
+ * gives the same result as drawing them into the whole image at once.
+ */
+class GAL_API CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions );
+
+    /**
+     * Set the image region to draw into.
+     *
+     * @param aImage is the first pixel of the whole image, in CAIRO_FORMAT_ARGB32.
+     * @param aStride is the length in bytes of an image row.
+     * @param aOrigin is the top left corner of the region, in pixels.
+     * @param aSize is the size of the region, in pixels.
+     */
+    void SetImageRegion( unsigned char* aImage, int aStride, const VECTOR2I& aOrigin,
+                         const VECTOR2I& aSize );
+
+    /// @copydoc GAL::EndDrawing()
+    void EndDrawing() override;
+
+    /// @copydoc GAL::StartDiffLayer()
+    void StartDiffLayer() override;
+
+    /// @copydoc GAL::EndDiffLayer()
+    void EndDiffLayer() override;
+
+    /// @copydoc GAL::StartNegativesLayer()
+    void StartNegativesLayer() override;
+
+    /// @copydoc GAL::EndNegativesLayer()
+    void EndNegativesLayer() override;
+
+private:
+    /// Composite the layer drawn since the last push onto the region.
+    void popLayer( cairo_operator_t aOperator );
+};
+
+
+/**
+ * Render the items of a VIEW to a bitmap, splitting it in tiles drawn on the thread pool.
+ *
+ * The items are drawn once into recordings, concurrently when the painter allows it, then each
+ * tile replays the recordings of the items it overlaps into its own region of the bitmap.  As
+ * tiles never overlap, the bitmap is complete once the last tile is drawn.
+ *
+ * Layers are drawn in the view rendering order, without draw priorities.  Differential and
+ * negative layers are composited over the lower layers as the Cairo canvas does.  Items the
+ * painter cannot draw fall back to VIEW_ITEM::ViewDraw(), recorded on the calling thread.
+ */
+class GAL_API CAIRO_TILED_RENDERER
+{
+public:
+    CAIRO_TILED_RENDERER( VIEW& aView );
+
+    /**
+     * Set the size of the square tiles, in pixels.
+     */
+    void SetTileSize( int aSize ) { m_tileSize = std::max( 16, aSize ); }
+    int GetTileSize() const { return m_tileSize; }
+
+    void SetBackgroundColor( const COLOR4D& aColor ) { m_backgroundColor = aColor; }
+
+    /**
+     * Render the items in \a aArea, fitted and centered in a bitmap of \a aSize pixels.
+     *
+     * The view mirroring and the view GAL world unit are used.  Must be called from the thread
+     * owning the view.
+     */
+    wxImage Render( const BOX2D& aArea, const VECTOR2I& aSize );
+
+private:
+    VIEW&               m_view;
+    GAL_DISPLAY_OPTIONS m_options;
+    int                 m_tileSize;
+    COLOR4D             m_backgroundColor;
+};
+
+} // namespace KIGFX
+
+#endif // CAIRO_TILED_RENDERER_H
@@ -82,6 +82,9 @@ public:
     /// Return true if the GAL engine is a OpenGL based type.
     virtual bool IsOpenGlEngine() { return false; }
 
+    /// Return the display options this GAL was created with.
+    GAL_DISPLAY_OPTIONS& GetDisplayOptions() const { return m_options; }
+
     // ---------------
     // Drawing methods
     // ---------------
@@ -213,6 +216,14 @@ public:
     virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet, bool aStrokeTriangulation = false ) {};
     virtual void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) {};
 
+    /**
+     * Draw filled triangles, using the fill color.
+     *
+     * @param aVertices is the list of the triangle corners, three consecutive vertices per
+     *                  triangle.
+     */
+    virtual void DrawTriangles( const std::vector<VECTOR2F>& aVertices );
+
     /**
      * Draw a cubic bezier spline.
      *
@@ -286,6 +297,14 @@ public:
         m_isFillEnabled = aIsFillEnabled;
     }
 
+    /**
+     * @return true if filling of graphic objects is enabled.
+     */
+    inline bool GetIsFill() const
+    {
+        return m_isFillEnabled;
+    }
+
     /**
      * Enable/disable stroked outlines.
      *
@@ -296,6 +315,14 @@ public:
         m_isStrokeEnabled = aIsStrokeEnabled;
     }
 
+    /**
+     * @return true if the outlines of graphic objects are stroked.
+     */
+    inline bool GetIsStroke() const
+    {
+        return m_isStrokeEnabled;
+    }
+
     /**
      * Set the fill color.
      *
@@ -484,6 +511,23 @@ public:
      */
     virtual void DrawGroup( int aGroupNumber ) {};
 
+    /**
+     * Tell if the GAL can draw a group several times at different positions with
+     * DrawGroupInstance().
+     */
+    virtual bool SupportsGroupInstancing() const { return false; }
+
+    /**
+     * Draw the stored group moved by \a aOffset.
+     *
+     * Instances of a group drawn between two layer depth changes may be batched into a single
+     * draw call, so their order relative to other groups of the layer is not kept.
+     *
+     * @param aGroupNumber is the group number.
+     * @param aOffset is the translation applied to the group.
+     */
+    virtual void DrawGroupInstance( int aGroupNumber, const VECTOR2D& aOffset ) {};
+
     /**
      * Change the color used to draw the group.
      *
@@ -28,6 +28,7 @@
 #define CACHED_CONTAINER_H_
 
 #include <gal/opengl/vertex_container.h>
+#include <array>
 #include <map>
 #include <set>
 
@@ -36,11 +37,43 @@ namespace KIGFX
 class VERTEX_ITEM;
 class SHADER;
 
+/**
+ * Allocation and fragmentation statistics of a CACHED_CONTAINER, expressed in vertices.
+ */
+struct VERTEX_CACHE_STATS
+{
+    unsigned int m_size = 0;               ///< Container size
+    unsigned int m_used = 0;               ///< Space held by items
+    unsigned int m_highWater = 0;          ///< End of the last item (the span uploaded to the GPU)
+    unsigned int m_freeChunks = 0;         ///< Number of free chunks
+    unsigned int m_largestFreeChunk = 0;   ///< Size of the largest free chunk
+    unsigned int m_defragmentations = 0;   ///< Full defragmentations (when resizing) so far
+    unsigned int m_compactedVertices = 0;  ///< Vertices moved by incremental compaction so far
+
+    /**
+     * Return the share of the free space that is not in the largest free chunk, from 0 (all
+     * the free space is in one piece) to 1.
+     */
+    double Fragmentation() const
+    {
+        unsigned int freeSpace = m_size - m_used;
+
+        return freeSpace ? 1.0 - (double) m_largestFreeChunk / freeSpace : 0.0;
+    }
+};
+
+
 /**
  * Class to store VERTEX instances with caching.
  *
  * It associates VERTEX objects and with VERTEX_ITEMs. Caching vertices data in the memory and a
  * enables fast reuse of that data.
+ *
+ * Free space is kept in chunks that are merged with their neighbors as soon as they are freed,
+ * and sorted in power of two size classes, so a chunk large enough for a request is found
+ * without searching.  Items are kept packed towards the beginning of the container by Compact(),
+ * which is meant to be run a little at a time, instead of defragmenting the whole container
+ * when it runs out of room.
  */
 
 class CACHED_CONTAINER : public VERTEX_CONTAINER
@@ -78,6 +111,21 @@ public:
     ///< @copydoc VERTEX_CONTAINER::Clear()
     virtual void Clear() override;
 
+    /**
+     * Move items from the end of the container to free space closer to its beginning, copying
+     * at most \a aMaxVertices vertices (or a single item, if it is larger).
+     *
+     * Must be called while the container is mapped, and not while an item is being modified.
+     *
+     * @return the number of vertices moved.
+     */
+    unsigned int Compact( unsigned int aMaxVertices );
+
+    /**
+     * Return the allocation and fragmentation statistics of the container.
+     */
+    VERTEX_CACHE_STATS GetStats() const;
+
     /**
      * Return handle to the vertex buffer. It might be negative if the buffer is not initialized.
      */
@@ -97,12 +145,11 @@ public:
     virtual unsigned int AllItemsSize() const { return 0; }
 
 protected:
-    ///< Maps size of free memory chunks to their offsets
-    typedef std::pair<unsigned int, unsigned int> CHUNK;
-    typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
+    ///< Maps offsets of free memory chunks to their sizes
+    typedef std::map<unsigned int, unsigned int> FREE_CHUNK_MAP;
 
-    /// List of all the stored items
-    typedef std::set<VERTEX_ITEM*> ITEMS;
+    /// List of all the stored items, by offset
+    typedef std::map<unsigned int, VERTEX_ITEM*> ITEMS;
 
     /**
      * Resize the chunk that stores the current item to the given size. The current item has
@@ -134,39 +181,25 @@ protected:
     void defragment( VERTEX* aTarget );
 
     /**
-     * Look for consecutive free memory chunks and merges them, decreasing fragmentation of
-     * memory.
-     */
-    void mergeFreeChunks();
-
-    /**
-     * Return the size of a chunk.
-     *
-     * @param aChunk is the chunk.
-     */
-    inline int getChunkSize( const CHUNK& aChunk ) const
-    {
-        return aChunk.first;
-    }
-
-    /**
-     * Return the offset of a chunk.
-     *
-     * @param aChunk is the chunk.
+     * Reset the free space after the container has been defragmented and resized: all the items
+     * are packed at its beginning, followed by a single free chunk.
      */
-    inline unsigned int getChunkOffset( const CHUNK& aChunk ) const
-    {
-        return aChunk.second;
-    }
+    void resetFreeChunks();
 
     /**
-     * Add a chunk marked as a free space.
+     * Add a chunk marked as a free space, merged with the free chunks it touches.
      */
     void addFreeChunk( unsigned int aOffset, unsigned int aSize );
 
-    ///< Store size & offset of free chunks.
+    ///< Number of free chunk size classes; class n holds the chunks of [2^n, 2^(n+1)) vertices
+    static constexpr int SIZE_CLASSES = 32;
+
+    ///< Store offset & size of free chunks.
     FREE_CHUNK_MAP  m_freeChunks;
 
+    ///< Offsets of free chunks in each size class
+    std::array<std::set<unsigned int>, SIZE_CLASSES> m_freeClasses;
+
     ///< Stored VERTEX_ITEMs
     ITEMS m_items;
 
@@ -180,7 +213,29 @@ protected:
     ///< Maximal vertex index number stored in the container
     unsigned int m_maxIndex;
 
+    ///< Statistics counters
+    unsigned int m_defragmentations;
+    unsigned int m_compactedVertices;
+
 private:
+    /**
+     * Find the free chunk with the lowest offset below \a aMaxOffset able to hold \a aSize
+     * vertices.
+     *
+     * @return the chunk, or m_freeChunks.end() if there is none.
+     */
+    FREE_CHUNK_MAP::iterator findFreeChunk( unsigned int aSize, unsigned int aMaxOffset );
+
+    /**
+     * Remove a chunk from the free space, without changing m_freeSpace.
+     */
+    void removeFreeChunk( FREE_CHUNK_MAP::iterator aChunk );
+
+    /**
+     * Return the size class of a chunk of \a aSize vertices.
+     */
+    static int sizeClass( unsigned int aSize );
+
     /// Debug & test functions
     void showFreeChunks();
     void showUsedChunks();
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <gal/opengl/vertex_common.h>
+#include <math/vector2d.h>
 #include <boost/scoped_array.hpp>
 
 namespace KIGFX
@@ -62,6 +63,23 @@ public:
      */
     virtual void DrawIndices( const VERTEX_ITEM* aItem ) = 0;
 
+    /**
+     * Tell if the manager can draw items moved by an offset with DrawIndicesInstanced().
+     */
+    virtual bool SupportsInstancing() const { return false; }
+
+    /**
+     * Make the GPU draw the vertices of an item moved by \a aOffset.
+     *
+     * The instances of an item are batched until FlushInstances() is called.
+     */
+    virtual void DrawIndicesInstanced( const VERTEX_ITEM* aItem, const VECTOR2D& aOffset ) {}
+
+    /**
+     * Queue the instances drawn since the last call, after the items drawn so far.
+     */
+    virtual void FlushInstances() {}
+
     /**
      * Clear the container after drawing routines.
      */
@@ -108,10 +126,15 @@ public:
         VRANGE( int aStart, int aEnd, bool aContinuous ) :
         m_start( aStart ),
         m_end( aEnd ),
-        m_isContinuous ( aContinuous )
+        m_isContinuous ( aContinuous ),
+        m_firstInstance( 0 ),
+        m_instanceCount( 0 )
         {}
         unsigned int m_start, m_end;
         bool m_isContinuous;
+
+        ///< Instanced ranges are drawn at the offsets starting at m_firstInstance
+        unsigned int m_firstInstance, m_instanceCount;
     };
 
 
@@ -124,9 +147,22 @@ public:
     ///< @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( const VERTEX_ITEM* aItem ) override;
 
+    ///< @copydoc GPU_MANAGER::SupportsInstancing()
+    virtual bool SupportsInstancing() const override;
+
+    ///< @copydoc GPU_MANAGER::DrawIndicesInstanced()
+    virtual void DrawIndicesInstanced( const VERTEX_ITEM* aItem,
+                                       const VECTOR2D& aOffset ) override;
+
+    ///< @copydoc GPU_MANAGER::FlushInstances()
+    virtual void FlushInstances() override;
+
     ///< @copydoc GPU_MANAGER::EndDrawing()
     virtual void EndDrawing() override;
 
+    ///< @copydoc GPU_MANAGER::SetShader()
+    virtual void SetShader( SHADER& aShader ) override;
+
     ///< Map vertex buffer stored in GPU memory.
     void Map();
 
@@ -137,6 +173,9 @@ protected:
     ///< Resizes the indices buffer to aNewSize if necessary
     void resizeIndices( unsigned int aNewSize );
 
+    ///< Draws an instanced range, with the instance offsets uploaded to m_instanceBuffer
+    void drawInstances( const VRANGE& aRange );
+
     ///< Buffers initialization flag
     bool m_buffersInitialized;
 
@@ -163,6 +202,24 @@ protected:
 
     ///< Size of the current VRANGE
     unsigned int m_curVrangeSize;
+
+    ///< Instances waiting for FlushInstances()
+    std::vector<std::pair<const VERTEX_ITEM*, VECTOR2D>> m_pendingInstances;
+
+    ///< Offsets of the instanced VRANGEs, as x, y pairs
+    std::vector<GLfloat> m_instanceOffsets;
+
+    ///< Location of the instance offset shader attribute, or -1 if there is none
+    int m_instanceAttrib;
+
+    ///< true: instances are drawn with a single call using per-instance attributes
+    bool m_instancedArrays;
+
+    ///< Buffer holding m_instanceOffsets in GPU memory
+    GLuint m_instanceBuffer;
+
+    ///< Number of instances drawn in the current frame
+    int m_totalInstances;
 };
 
 
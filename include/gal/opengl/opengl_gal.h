@@ -157,6 +157,9 @@ public:
     void DrawPolygon( const SHAPE_POLY_SET& aPolySet, bool aStrokeTriangulation = false ) override;
     void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
 
+    /// @copydoc GAL::DrawTriangles()
+    void DrawTriangles( const std::vector<VECTOR2F>& aVertices ) override;
+
     /// @copydoc GAL::DrawGlyph()
     virtual void DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTotal ) override;
 
@@ -194,6 +197,11 @@ public:
     /// @copydoc GAL::Flush()
     void Flush() override;
 
+    /**
+     * Return the allocation and fragmentation statistics of the cached vertex container.
+     */
+    VERTEX_CACHE_STATS GetVertexCacheStats() const;
+
     /// @copydoc GAL::ClearScreen()
     void ClearScreen( ) override;
 
@@ -232,6 +240,15 @@ public:
     /// @copydoc GAL::DrawGroup()
     void DrawGroup( int aGroupNumber ) override;
 
+    /// @copydoc GAL::SupportsGroupInstancing()
+    bool SupportsGroupInstancing() const override;
+
+    /// @copydoc GAL::DrawGroupInstance()
+    void DrawGroupInstance( int aGroupNumber, const VECTOR2D& aOffset ) override;
+
+    /// @copydoc GAL::SetLayerDepth()
+    void SetLayerDepth( double aLayerDepth ) override;
+
     /// @copydoc GAL::ChangeGroupColor()
     void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor ) override;
 
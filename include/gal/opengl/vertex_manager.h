@@ -36,8 +36,10 @@
 #include <glm/glm.hpp>
 #include <gal/opengl/vertex_common.h>
 #include <gal/color4d.h>
+#include <math/vector2d.h>
 #include <stack>
 #include <memory>
+#include <vector>
 
 namespace KIGFX
 {
@@ -45,6 +47,7 @@ class SHADER;
 class VERTEX_ITEM;
 class VERTEX_CONTAINER;
 class GPU_MANAGER;
+struct VERTEX_CACHE_STATS;
 
 /**
  * Class to control vertex container and GPU with possibility of emulating old-style OpenGL
@@ -132,6 +135,18 @@ public:
      */
     bool Vertices( const VERTEX aVertices[], unsigned int aSize );
 
+    /**
+     * Add a list of 2D vertices to the currently set item, all at the same depth.
+     *
+     * Color & shader set by Color() and Shader() functions are used.  All the vertex
+     * coordinates will have the current transformation matrix applied.
+     *
+     * @param aVertices contains the XY coordinates of vertices to be added.
+     * @param aZ is the Z coordinate of the new vertices.
+     * @return True if successful, false otherwise.
+     */
+    bool Vertices( const std::vector<VECTOR2F>& aVertices, GLfloat aZ );
+
     /**
      * Changes currently used color that will be applied to newly added vertices.
      *
@@ -325,6 +340,23 @@ public:
      */
     void Clear() const;
 
+    /**
+     * Let a cached container pack its data, moving at most \a aMaxVertices vertices.
+     *
+     * Must be called while the container is mapped, between item updates.
+     *
+     * @see CACHED_CONTAINER::Compact()
+     * @return the number of vertices moved.
+     */
+    unsigned int Compact( unsigned int aMaxVertices ) const;
+
+    /**
+     * Get the allocation statistics of a cached container.
+     *
+     * @return false if the container is not cached.
+     */
+    bool GetCacheStats( VERTEX_CACHE_STATS& aStats ) const;
+
     /**
      * Prepare buffers and items to start drawing.
      */
@@ -337,6 +369,24 @@ public:
      */
     void DrawItem( const VERTEX_ITEM& aItem ) const;
 
+    /**
+     * Tell if items can be drawn moved by an offset with DrawItemInstance().
+     */
+    bool SupportsInstancing() const;
+
+    /**
+     * Draw an item moved by an offset.  Instances are batched until FlushInstances().
+     *
+     * @param aItem is the item to be drawn.
+     * @param aOffset is the translation applied to the item.
+     */
+    void DrawItemInstance( const VERTEX_ITEM& aItem, const VECTOR2D& aOffset ) const;
+
+    /**
+     * Draw the instances batched so far, after the items drawn so far.
+     */
+    void FlushInstances() const;
+
     /**
      * Finish drawing operations.
      */
@@ -38,6 +38,8 @@
 #include <gal/color4d.h>
 #include <render_settings.h>
 #include <layer_ids.h>
+#include <math/box2.h>
+#include <math/vector2d.h>
 #include <memory>
 
 namespace KIGFX
@@ -96,6 +98,76 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Create a copy of this painter, with the same settings, drawing on \a aGal.
+     *
+     * Copies are used to draw items on worker threads.  Must be called from the thread owning
+     * this painter.
+     *
+     * @return the copy, or nullptr if the painter cannot be copied.
+     */
+    virtual std::unique_ptr<PAINTER> Clone( GAL* aGal ) { return nullptr; }
+
+    /**
+     * Tell if \a aItem can be drawn on \a aLayer by a copy of this painter on a worker thread,
+     * while other items are being drawn by other copies.
+     *
+     * Such drawing must not modify anything shared with other items, and must not depend on
+     * the GAL state left by previously drawn items.
+     */
+    virtual bool CanDrawConcurrently( const VIEW_ITEM* aItem, int aLayer ) const
+    {
+        return false;
+    }
+
+    /**
+     * Return the view scale below which \a aItem is drawn on \a aLayer with the simplified
+     * geometry produced by DrawLOD(), or 0 if the painter has no simplified version of it.
+     */
+    virtual double GetLODScale( const VIEW_ITEM* aItem, int aLayer ) const
+    {
+        return 0.0;
+    }
+
+    /**
+     * Draw a simplified version of \a aItem on \a aLayer, used when zoomed out below the scale
+     * returned by GetLODScale().  It is cached in a separate group next to the full drawing.
+     *
+     * @return true if the simplified version was drawn.
+     */
+    virtual bool DrawLOD( const VIEW_ITEM* aItem, int aLayer )
+    {
+        return false;
+    }
+
+    /**
+     * Tell if the drawing of \a aItem on \a aLayer is the drawing of another item moved by an
+     * offset, so that both can share a single cached group drawn at several positions.
+     *
+     * Items returning the same key must produce the same drawing once moved by the opposite of
+     * their offset.  Everything the drawing depends on (geometry, rotation, colors, display
+     * options) must be part of the key; the view adds the layer to it.
+     *
+     * @param aKey is set to the hash of the drawing.
+     * @param aOffset is set to the offset of the item drawing (usually the item position).
+     * @return false if the item drawing cannot be shared.
+     */
+    virtual bool GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, size_t& aKey,
+                                 VECTOR2I& aOffset )
+    {
+        return false;
+    }
+
+    /**
+     * Return the bounding box of the drawing of \a aItem on \a aLayer shared through
+     * GetInstanceKey(), relative to the item offset.  Only called for items that
+     * GetInstanceKey() accepted.
+     *
+     * The view compares it with the one of the item which drew the shared group, so that two
+     * different drawings whose keys collide are not drawn as each other.
+     */
+    virtual BOX2I GetInstanceBBox( const VIEW_ITEM* aItem, int aLayer, const VECTOR2I& aOffset );
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef RECORDING_GAL_H
+#define RECORDING_GAL_H
+
+#include <functional>
+#include <vector>
+
+#include <gal/gal.h>
+#include <gal/graphics_abstraction_layer.h>
+
+namespace KIGFX
+{
+
+/**
+ * A GAL that does not draw anything, but records the drawing calls made to it so that they can
+ * be replayed later on another GAL.
+ *
+ * It lets painters run on worker threads: each thread draws into its own RECORDING_GAL, and the
+ * thread owning the real GAL replays the recordings.  The recorder mimics the view state (zoom,
+ * world/screen matrices, flipping, engine type) of the GAL it was created for, so painters make
+ * the same decisions as they would when drawing directly.
+ *
+ * All arguments are copied when recorded, except bitmaps which are referenced and must outlive
+ * the recording.  The recorder must be created on the thread owning \a aTarget, as it subscribes
+ * to the same display options.
+ */
+class GAL_API RECORDING_GAL : public GAL
+{
+public:
+    using RECORDING = std::vector<std::function<void( GAL& )>>;
+
+    RECORDING_GAL( GAL& aTarget );
+
+    /**
+     * Hand over the calls recorded so far and restore the drawing state the recorder was
+     * created with, ready for the next item.
+     */
+    RECORDING TakeRecording();
+
+    /**
+     * Repeat the calls of \a aRecording on \a aTarget, in order.
+     */
+    static void Replay( const RECORDING& aRecording, GAL& aTarget );
+
+    bool IsCairoEngine() override { return m_isCairo; }
+    bool IsOpenGlEngine() override { return m_isOpenGl; }
+
+    void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override;
+    void DrawSegmentChain( const std::vector<VECTOR2D>& aPointList, double aWidth ) override;
+    void DrawSegmentChain( const SHAPE_LINE_CHAIN& aLineChain, double aWidth ) override;
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolyline( const std::vector<VECTOR2D>& aPointList ) override;
+    void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+    void DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists ) override;
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+    void DrawArc( const VECTOR2D& aCenterPoint, double aRadius, const EDA_ANGLE& aStartAngle,
+                  const EDA_ANGLE& aAngle ) override;
+    void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                         const EDA_ANGLE& aStartAngle, const EDA_ANGLE& aAngle, double aWidth,
+                         double aMaxError ) override;
+    void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTotal ) override;
+    void DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>& aGlyphs ) override;
+    void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet, bool aStrokeTriangulation ) override;
+    void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
+    void DrawTriangles( const std::vector<VECTOR2F>& aVertices ) override;
+    void DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                    const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                    double aFilterValue ) override;
+    void DrawBitmap( const BITMAP_BASE& aBitmap, double alphaBlend ) override;
+
+    void SetIsFill( bool aIsFillEnabled ) override;
+    void SetIsStroke( bool aIsStrokeEnabled ) override;
+    void SetFillColor( const COLOR4D& aColor ) override;
+    void SetStrokeColor( const COLOR4D& aColor ) override;
+    void SetLineWidth( float aLineWidth ) override;
+    void SetLayerDepth( double aLayerDepth ) override;
+    void SetNegativeDrawMode( bool aSetting ) override;
+
+    void BitmapText( const wxString& aText, const VECTOR2I& aPosition,
+                     const EDA_ANGLE& aAngle ) override;
+
+    void Transform( const MATRIX3x3D& aTransformation ) override;
+    void Rotate( double aAngle ) override;
+    void Translate( const VECTOR2D& aTranslation ) override;
+    void Scale( const VECTOR2D& aScale ) override;
+    void Save() override;
+    void Restore() override;
+
+private:
+    RECORDING m_recording;
+
+    bool      m_isCairo;
+    bool      m_isOpenGl;
+
+    // Drawing state of the target when the recorder was created
+    bool      m_initialIsFill;
+    bool      m_initialIsStroke;
+    COLOR4D   m_initialFillColor;
+    COLOR4D   m_initialStrokeColor;
+    float     m_initialLineWidth;
+};
+
+} // namespace KIGFX
+
+#endif // RECORDING_GAL_H
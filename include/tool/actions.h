@@ -219,6 +219,7 @@ public:
     static TOOL_ACTION donate;
     static TOOL_ACTION getInvolved;
     static TOOL_ACTION reportBug;
+    static TOOL_ACTION saveFrameTrace;
 
     // API
     static TOOL_ACTION pluginsReload;
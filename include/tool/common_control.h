@@ -59,6 +59,11 @@ public:
     int Donate( const TOOL_EVENT& aEvent );
     int ReportBug( const TOOL_EVENT& aEvent );
 
+    /**
+     * Start recording the frame trace, or save it if it is being recorded.
+     */
+    int SaveFrameTrace( const TOOL_EVENT& aEvent );
+
     ///< Sets up handlers for various events.
     void setTransitions() override;
 
@@ -28,10 +28,13 @@
 #define __VIEW_H
 
 #include <gal/gal.h>
+#include <functional>
+#include <map>
 #include <vector>
 #include <set>
 #include <unordered_map>
 #include <memory>
+#include <tuple>
 
 #include <math/box2.h>
 #include <gal/definitions.h>
@@ -44,8 +47,10 @@ namespace KIGFX
 class PAINTER;
 class GAL;
 class VIEW_ITEM;
+class VIEW_ITEM_DATA;
 class VIEW_GROUP;
 class VIEW_RTREE;
+class VIEW_QUERY_CACHE;
 
 /**
  * Hold a (potentially large) number of VIEW_ITEMs and renders them on a graphics device
@@ -68,6 +73,7 @@ class GAL_API VIEW
 {
 public:
     friend class VIEW_ITEM;
+    friend class CAIRO_TILED_RENDERER;
 
     typedef std::pair<VIEW_ITEM*, int> LAYER_ITEM_PAIR;
 
@@ -116,6 +122,33 @@ public:
      */
     virtual int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const;
 
+    /**
+     * Find all items on \a aLayers that touch or are within the rectangle \a aRect.
+     *
+     * @param aLayers are the layers to search, in the order their items are to be returned.
+     * @return Number of found items.
+     */
+    int Query( const BOX2I& aRect, const std::vector<int>& aLayers,
+               std::vector<LAYER_ITEM_PAIR>& aResult ) const;
+
+    /**
+     * Return the layers searched by Query(): the visible layers that are not display-only,
+     * top of the rendering stack first.
+     */
+    std::vector<int> GetQueryLayers() const;
+
+    /**
+     * Return a counter changed every time the result of a Query() may have changed because
+     * items were added, removed or moved, or because the queried layers have changed.
+     */
+    uint64_t GetQueryVersion() const { return m_queryVersion; }
+
+    /**
+     * Return the cache used to answer the queries repeated around the cursor (for instance to
+     * find the items under it, or the snap points near it) on each mouse move.
+     */
+    VIEW_QUERY_CACHE& GetQueryCache() { return *m_queryCache; }
+
     /**
      * Set the item visibility.
      *
@@ -401,6 +434,7 @@ public:
             // Target has to be redrawn after changing its visibility
             MarkTargetDirty( m_layers[aLayer].target );
             m_layers[aLayer].visible = aVisible;
+            m_queryVersion++;
         }
     }
 
@@ -459,7 +493,12 @@ public:
     inline void SetLayerDisplayOnly( int aLayer, bool aDisplayOnly = true )
     {
         wxCHECK( aLayer < (int) m_layers.size(), /*void*/ );
-        m_layers[aLayer].displayOnly = aDisplayOnly;
+
+        if( m_layers[aLayer].displayOnly != aDisplayOnly )
+        {
+            m_layers[aLayer].displayOnly = aDisplayOnly;
+            m_queryVersion++;
+        }
     }
 
     /**
@@ -811,6 +850,24 @@ protected:
     ///< Update all information needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /**
+     * Draw the items waiting for a geometry update on worker threads, on the layers where the
+     * painter allows it.  The drawings are recorded, and put into the item groups later on by
+     * updateItemGeometry().
+     */
+    void recordItemsConcurrently();
+
+    /**
+     * Return the key of the group shared by the items drawn like \a aItem on \a aLayer, or 0 if
+     * the item needs a group of its own.
+     *
+     * @param aOffset is set to the offset at which the shared group is drawn for the item.
+     */
+    size_t instanceKey( VIEW_ITEM* aItem, int aLayer, VECTOR2I& aOffset );
+
+    ///< Delete the group drawing an item on a layer, or release it if it is shared
+    void releaseGroup( VIEW_ITEM_DATA* aViewData, int aLayer );
+
     ///< Update bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -868,6 +925,20 @@ protected:
     ///< Interface to #PAINTER that is used to draw items.
     GAL* m_gal;
 
+    ///< Item drawings recorded on worker threads, by item, layer and level of detail
+    std::map<std::tuple<const VIEW_ITEM*, int, bool>, std::vector<std::function<void( GAL& )>>>
+            m_recordings;
+
+    struct INSTANCE_TEMPLATE
+    {
+        int   m_group;
+        int   m_refCount;
+        BOX2I m_bbox;       ///< Bounding box of the drawing, relative to the item offset
+    };
+
+    ///< Groups shared by items drawn the same way at different positions, by instance key
+    std::unordered_map<size_t, INSTANCE_TEMPLATE> m_instanceTemplates;
+
     ///< Dynamic VIEW (eg. display PCB in window) allows changes once it is built,
     ///< static (eg. image/PDF) - does not.
     bool m_dynamic;
@@ -883,6 +954,11 @@ protected:
 
     ///< Flag to reverse the draw order when using draw priority.
     bool m_reverseDrawOrder;
+
+    ///< Changed each time the result of a query may have changed.
+    uint64_t m_queryVersion;
+
+    std::unique_ptr<VIEW_QUERY_CACHE> m_queryCache;
 };
 } // namespace KIGFX
 
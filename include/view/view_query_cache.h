@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef VIEW_QUERY_CACHE_H
+#define VIEW_QUERY_CACHE_H
+
+#include <gal/gal.h>
+#include <view/view.h>
+
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace KIGFX
+{
+
+/**
+ * Answer the VIEW::Query() calls made repeatedly around a moving point, such as the ones made
+ * for each mouse move to find the items under the cursor.
+ *
+ * The items around the queried area are kept, so that the following queries falling in the
+ * same neighborhood are answered without searching the view.  When the cursor leaves the
+ * neighborhood, only the newly covered part of the view is searched.  The cache is dropped
+ * when the content of the view changes (see VIEW::GetQueryVersion()).
+ */
+class GAL_API VIEW_QUERY_CACHE
+{
+public:
+    typedef VIEW::LAYER_ITEM_PAIR LAYER_ITEM_PAIR;
+
+    /// Exact hit test of an item found on a layer; must be safe to call on worker threads.
+    typedef std::function<bool( VIEW_ITEM* aItem, int aLayer )> HIT_TEST;
+
+    VIEW_QUERY_CACHE( const VIEW* aView );
+
+    /**
+     * Find the items that touch or are within \a aRect, on the layers searched by
+     * VIEW::Query().
+     *
+     * @param aResult receives the items, sorted like the result of VIEW::Query().
+     * @return Number of found items.
+     */
+    int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult );
+
+    /**
+     * Find the items that touch or are within \a aRect and pass \a aHitTest.
+     *
+     * The hit tests are shared between worker threads when there are many candidates.
+     */
+    int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult,
+               const HIT_TEST& aHitTest );
+
+    /**
+     * Append to \a aResult the \a aCandidates passing \a aHitTest, keeping their order.
+     *
+     * The hit tests are shared between worker threads when there are many candidates.
+     */
+    static void FilterHits( const std::vector<LAYER_ITEM_PAIR>& aCandidates,
+                            const HIT_TEST& aHitTest, std::vector<LAYER_ITEM_PAIR>& aResult );
+
+    /**
+     * Set the minimum distance the cached neighborhood extends around the queried areas.
+     */
+    void SetMargin( int aMargin ) { m_margin = aMargin; }
+
+    /**
+     * Drop the cached items, for instance when the view is about to be changed.
+     */
+    void Invalidate();
+
+private:
+    struct CANDIDATE
+    {
+        VIEW_ITEM* m_item;
+        int        m_layer;
+        int        m_rank;      ///< Index of the layer in m_layers
+        BOX2I      m_bbox;
+    };
+
+    /// Update the cached items so that they cover \a aRect.
+    void update( const BOX2I& aRect );
+
+    /// Append the items in \a aArea to m_candidates, skipping the ones in \a aKnown.
+    void search( const BOX2I& aArea, std::set<std::pair<VIEW_ITEM*, int>>* aKnown );
+
+    const VIEW*            m_view;
+    uint64_t               m_version;
+    bool                   m_valid;
+    bool                   m_reused;        ///< Cached items were used by several queries
+    int                    m_margin;
+
+    std::vector<int>       m_layers;        ///< Searched layers, top first
+    BOX2I                  m_neighborhood;  ///< Area in which all the items are cached
+    std::vector<CANDIDATE> m_candidates;    ///< Items touching m_neighborhood, top first
+};
+
+} // namespace KIGFX
+
+#endif // VIEW_QUERY_CACHE_H
@@ -152,6 +152,7 @@ public:
     static const std::string KiCadPcbFileExtension;
     #define PcbFileExtension    KiCadPcbFileExtension       // symlink choice
     static const std::string KiCadSymbolLibFileExtension;
+    static const std::string KiCadSymbolLibIndexFileExtension;
     static const std::string DrawingSheetFileExtension;
     static const std::string DesignRulesFileExtension;
 
@@ -36,6 +36,7 @@
 #define ARG_SEVERITY_WARNING "--severity-warning"
 #define ARG_SEVERITY_EXCLUSIONS "--severity-exclusions"
 #define ARG_EXIT_CODE_VIOLATIONS "--exit-code-violations"
+#define ARG_TIMINGS "--timings"
 
 CLI::SCH_ERC_COMMAND::SCH_ERC_COMMAND() : COMMAND( "erc" )
 {
@@ -78,6 +79,10 @@ CLI::SCH_ERC_COMMAND::SCH_ERC_COMMAND() : COMMAND( "erc" )
     m_argParser.add_argument( ARG_EXIT_CODE_VIOLATIONS )
             .help( UTF8STDSTR( _( "Return a nonzero exit code if ERC violations exist" ) ) )
             .flag();
+
+    m_argParser.add_argument( ARG_TIMINGS )
+            .help( UTF8STDSTR( _( "Report the time taken by each check" ) ) )
+            .flag();
 }
 
 
@@ -88,6 +93,7 @@ int CLI::SCH_ERC_COMMAND::doPerform( KIWAY& aKiway )
     ercJob->m_outputFile = m_argOutput;
     ercJob->m_filename = m_argInput;
     ercJob->m_exitCodeViolations = m_argParser.get<bool>( ARG_EXIT_CODE_VIOLATIONS );
+    ercJob->m_reportTimings = m_argParser.get<bool>( ARG_TIMINGS );
     ercJob->SetVarOverrides( m_argDefineVars );
 
     int severity = 0;
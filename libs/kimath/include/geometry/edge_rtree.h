@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GEOMETRY_EDGE_RTREE_H_
+#define GEOMETRY_EDGE_RTREE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <geometry/seg.h>
+
+/**
+ * A static, packed R-tree over the edges of a single polyline or polygon contour.
+ *
+ * The tree is built once (Sort-Tile-Recursive packing) and never modified; it keeps its own copy
+ * of the edge coordinates so that it stays valid when shared between copies of the indexed
+ * shape.  Queries give exactly the same answers as the linear scans in SHAPE_LINE_CHAIN_BASE,
+ * including the lowest-index tie-break on equal distances.
+ */
+class EDGE_RTREE
+{
+public:
+    /// Contours with fewer edges than this are not worth indexing
+    static constexpr size_t MIN_SEGMENTS = 256;
+
+    /**
+     * Build the index over the edges of the contour described by \a aPoints.
+     *
+     * @param aClosed adds the closing edge from the last point back to the first one.
+     */
+    EDGE_RTREE( const std::vector<VECTOR2I>& aPoints, bool aClosed );
+
+    size_t SegmentCount() const { return m_segs.size(); }
+
+    /**
+     * Even-odd crossing test of a ray cast from \a aPt in the positive x direction, using the
+     * same rules as SHAPE_LINE_CHAIN_BASE::PointInside().
+     *
+     * @return true if the ray crosses an odd number of edges.
+     */
+    bool RayCrossingParity( const VECTOR2I& aPt ) const;
+
+    /**
+     * Find the edge nearest to \a aP.
+     *
+     * @param aSquaredDistance [out] receives the squared distance to that edge.
+     * @return the index of the nearest edge in the contour, or -1 if the index is empty.
+     */
+    int Nearest( const VECTOR2I& aP, SEG::ecoord* aSquaredDistance ) const;
+
+    /**
+     * Find the edge nearest to \a aSeg.  See above.
+     */
+    int Nearest( const SEG& aSeg, SEG::ecoord* aSquaredDistance ) const;
+
+private:
+    struct BOX
+    {
+        int32_t m_MinX;
+        int32_t m_MinY;
+        int32_t m_MaxX;
+        int32_t m_MaxY;
+    };
+
+    struct EDGE
+    {
+        VECTOR2I m_A;
+        VECTOR2I m_B;
+        int      m_Index;
+    };
+
+    template <typename QUERY, typename BOUND_FUNC>
+    int nearest( const QUERY& aQuery, BOUND_FUNC aBound, SEG::ecoord* aSquaredDistance ) const;
+
+    bool rayCrossingParity( const VECTOR2I& aPt, size_t aLevel, size_t aNode ) const;
+
+    static constexpr size_t NODE_SIZE = 16;
+
+    std::vector<EDGE>             m_segs;     ///< Edges in packing order
+    std::vector<std::vector<BOX>> m_levels;   ///< Node boxes, leaf level first
+};
+
+
+/**
+ * A lazily built EDGE_RTREE, meant to be a member of the indexed shape.
+ *
+ * The index is only built once a large enough shape has been queried a few times, so that
+ * temporary shapes never pay for it.  Building is thread-safe; the owner must call Invalidate()
+ * whenever the indexed geometry changes.  Copies start with an empty cache.
+ */
+class EDGE_RTREE_CACHE
+{
+public:
+    /// Number of queries on a shape before its index gets built
+    static constexpr int WARMUP_QUERIES = 4;
+
+    EDGE_RTREE_CACHE() = default;
+
+    EDGE_RTREE_CACHE( const EDGE_RTREE_CACHE& ) {}
+
+    EDGE_RTREE_CACHE& operator=( const EDGE_RTREE_CACHE& )
+    {
+        Invalidate();
+        return *this;
+    }
+
+    void Invalidate()
+    {
+        if( m_queries.load( std::memory_order_relaxed ) )
+        {
+            m_ready.store( nullptr );
+            m_index.reset();
+            m_queries.store( 0 );
+        }
+    }
+
+    /**
+     * @return the index for the contour \a aPoints, or nullptr if there should be none (yet).
+     */
+    const EDGE_RTREE* Get( const std::vector<VECTOR2I>& aPoints, bool aClosed ) const;
+
+private:
+    mutable std::mutex                  m_mutex;
+    mutable std::unique_ptr<EDGE_RTREE> m_index;
+    mutable std::atomic<EDGE_RTREE*>    m_ready = nullptr;
+    mutable std::atomic<int>            m_queries = 0;
+};
+
+#endif // GEOMETRY_EDGE_RTREE_H_
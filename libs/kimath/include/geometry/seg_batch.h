@@ -0,0 +1,183 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GEOMETRY_SEG_BATCH_H_
+#define GEOMETRY_SEG_BATCH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <geometry/seg.h>
+
+/**
+ * A batch of line segments stored as a structure of arrays, for bulk distance and collision
+ * queries against a single point or segment.
+ *
+ * The batch kernels use AVX2 or SSE2 on x86-64, NEON on AArch64 and a scalar loop elsewhere.
+ * They compute approximate (floating point) distances which are only used to discard segments
+ * that cannot be the nearest one; the remaining candidates are resolved with the exact integer
+ * SEG routines.  Results are therefore identical to testing each segment in turn with
+ * SEG::SquaredDistance(), including the tie-break on the lowest index.
+ */
+class SEG_BATCH
+{
+public:
+    struct NEAREST
+    {
+        SEG::ecoord m_SquaredDistance = VECTOR2I::ECOORD_MAX;
+        int         m_Index = -1;  ///< Caller index of the nearest segment, or -1 if empty
+    };
+
+    /// Below this many segments a plain loop is cheaper than filling a batch
+    static constexpr size_t MIN_BATCH_SIZE = 16;
+
+    SEG_BATCH() = default;
+
+    void Clear();
+
+    void Reserve( size_t aCount );
+
+    /**
+     * Append a segment to the batch.
+     *
+     * @param aIndex is the index reported back by queries (typically the index of the segment
+     *               in the parent shape).  Defaults to the position in the batch.
+     */
+    void Add( const VECTOR2I& aA, const VECTOR2I& aB, int aIndex = -1 );
+
+    void Add( const SEG& aSeg, int aIndex = -1 ) { Add( aSeg.A, aSeg.B, aIndex ); }
+
+    size_t Size() const { return m_ids.size(); }
+
+    bool Empty() const { return m_ids.empty(); }
+
+    /**
+     * @return the segment stored at position \a aSlot of the batch.
+     */
+    SEG Segment( size_t aSlot ) const
+    {
+        return SEG( VECTOR2I( m_ax[aSlot], m_ay[aSlot] ), VECTOR2I( m_bx[aSlot], m_by[aSlot] ),
+                    m_ids[aSlot] );
+    }
+
+    /**
+     * Find the segment of the batch nearest to \a aP.
+     *
+     * @param aStopBelow stops the search as soon as a segment closer than this (squared)
+     *                   distance has been found.  The result is then a colliding segment, but
+     *                   not necessarily the nearest one.
+     */
+    NEAREST Nearest( const VECTOR2I& aP, SEG::ecoord aStopBelow = 0 ) const;
+
+    /**
+     * Find the segment of the batch nearest to \a aSeg.  See above for \a aStopBelow.
+     */
+    NEAREST Nearest( const SEG& aSeg, SEG::ecoord aStopBelow = 0 ) const;
+
+    /**
+     * Check if any segment of the batch is closer than \a aClearance to \a aP.
+     *
+     * @param aActual [out] receives the distance to the nearest segment.
+     * @param aIndex [out] receives the index of the nearest segment.
+     */
+    bool Collide( const VECTOR2I& aP, int aClearance, int* aActual = nullptr,
+                  int* aIndex = nullptr ) const;
+
+    bool Collide( const SEG& aSeg, int aClearance, int* aActual = nullptr,
+                  int* aIndex = nullptr ) const;
+
+    /**
+     * @return the name of the kernel selected at build time ("avx2", "sse2", "neon" or
+     *         "scalar").  Used by the QA tests and for diagnostics.
+     */
+    static const char* KernelName();
+
+private:
+    std::vector<int32_t> m_ax;
+    std::vector<int32_t> m_ay;
+    std::vector<int32_t> m_bx;
+    std::vector<int32_t> m_by;
+    std::vector<int>     m_ids;
+};
+
+
+/**
+ * A lazily built SEG_BATCH of the segments of a shape, meant to be a member of that shape so
+ * that repeated queries reuse the batch instead of filling a new one each time.
+ *
+ * Building is thread-safe; the owner must call Invalidate() whenever its geometry changes.
+ * Copies start with an empty cache.
+ */
+class SEG_BATCH_CACHE
+{
+public:
+    SEG_BATCH_CACHE() = default;
+
+    SEG_BATCH_CACHE( const SEG_BATCH_CACHE& ) {}
+
+    SEG_BATCH_CACHE& operator=( const SEG_BATCH_CACHE& )
+    {
+        Invalidate();
+        return *this;
+    }
+
+    void Invalidate()
+    {
+        if( m_ready.load( std::memory_order_relaxed ) )
+        {
+            m_ready.store( nullptr );
+            m_batch.reset();
+        }
+    }
+
+    /**
+     * @return the cached batch, filled by \a aFill( SEG_BATCH& ) if there is none yet.
+     */
+    template <typename FILL_FUNC>
+    const SEG_BATCH& Get( FILL_FUNC aFill ) const
+    {
+        if( SEG_BATCH* batch = m_ready.load( std::memory_order_acquire ) )
+            return *batch;
+
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        if( !m_batch )
+        {
+            m_batch = std::make_unique<SEG_BATCH>();
+            aFill( *m_batch );
+            m_ready.store( m_batch.get(), std::memory_order_release );
+        }
+
+        return *m_batch;
+    }
+
+private:
+    mutable std::mutex                 m_mutex;
+    mutable std::unique_ptr<SEG_BATCH> m_batch;
+    mutable std::atomic<SEG_BATCH*>    m_ready = nullptr;
+};
+
+#endif // GEOMETRY_SEG_BATCH_H_
@@ -29,7 +29,9 @@
 
 #include <clipper.hpp>
 #include <clipper2/clipper.h>
+#include <geometry/edge_rtree.h>
 #include <geometry/seg.h>
+#include <geometry/seg_batch.h>
 #include <geometry/shape.h>
 #include <geometry/shape_arc.h>
 #include <geometry/corner_strategy.h>
@@ -220,6 +222,15 @@ public:
 
     SHAPE_LINE_CHAIN& operator=( const SHAPE_LINE_CHAIN& ) = default;
 
+    /**
+     * Check if point \a aPt lies inside the closed line chain.  See
+     * SHAPE_LINE_CHAIN_BASE::PointInside().
+     *
+     * Overridden to use the edge index of large chains.
+     */
+    bool PointInside( const VECTOR2I& aPt, int aAccuracy = 0,
+                      bool aUseBBoxCache = false ) const override;
+
     SHAPE* Clone() const override;
 
     /**
@@ -231,6 +242,7 @@ public:
         m_arcs.clear();
         m_shapes.clear();
         m_closed = false;
+        invalidateIndices();
     }
 
     /**
@@ -242,6 +254,7 @@ public:
     void SetClosed( bool aClosed )
     {
         m_closed = aClosed;
+        invalidateIndices();
         mergeFirstLastPointIfNeeded();
     }
 
@@ -493,6 +506,7 @@ public:
             m_points.push_back( aP );
             m_shapes.push_back( SHAPES_ARE_PT );
             m_bbox.Merge( aP );
+            invalidateIndices();
         }
     }
 
@@ -713,6 +727,7 @@ public:
             arc.Move( aVector );
 
         m_bbox.Move( aVector );
+        invalidateIndices();
     }
 
     /**
@@ -827,6 +842,30 @@ public:
     virtual size_t GetPointCount() const override { return PointCount(); }
     virtual size_t GetSegmentCount() const override { return SegmentCount(); }
 
+    /**
+     * Append the line segments of the chain to \a aBatch, indexed by their segment index.
+     *
+     * @param aSkipArcs excludes the segments which belong to arcs.
+     */
+    void AppendToSegBatch( SEG_BATCH& aBatch, bool aSkipArcs = false ) const;
+
+    /**
+     * Return the spatial index of the segments of the chain.
+     *
+     * The index is built lazily, only for large chains and only once they have been queried a
+     * few times.  It is discarded when the chain is modified.
+     *
+     * @return the index, or nullptr if there is none (yet).
+     */
+    const EDGE_RTREE* EdgeIndex() const { return m_edgeIndex.Get( m_points, m_closed ); }
+
+    /**
+     * Return a batch of all the segments of the chain, indexed by their segment index.
+     *
+     * The batch is built on first use and discarded when the chain is modified.
+     */
+    const SEG_BATCH& SegBatch() const;
+
     void TransformToPolygon( SHAPE_POLY_SET& aBuffer, int aError,
                              ERROR_LOC aErrorLoc ) const override;
 
@@ -901,6 +940,19 @@ protected:
      */
     void mergeFirstLastPointIfNeeded();
 
+    /// Drop the lazily built edge index and segment batch after a change of the geometry
+    void invalidateIndices()
+    {
+        m_edgeIndex.Invalidate();
+        m_segBatch.Invalidate();
+    }
+
+    /**
+     * Return the line segments of the chain (without the arc segments) as a batch: the cached
+     * batch when it can be used, otherwise \a aTemp, filled here.
+     */
+    const SEG_BATCH& lineSegBatch( SEG_BATCH& aTemp ) const;
+
 private:
 
     static const ssize_t SHAPE_IS_PT;
@@ -940,6 +992,12 @@ private:
 
     /// cached bounding box
     mutable BOX2I m_bbox;
+
+    /// lazily built spatial index of the segments, for large chains
+    EDGE_RTREE_CACHE m_edgeIndex;
+
+    /// lazily built batch of the segments, for chains too small for an edge index
+    SEG_BATCH_CACHE  m_segBatch;
 };
 
 
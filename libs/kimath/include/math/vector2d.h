@@ -586,6 +586,7 @@ std::ostream& operator<<( std::ostream& aStream, const VECTOR2<T>& aVector )
 /* Default specializations */
 typedef VECTOR2<double>       VECTOR2D;
 typedef VECTOR2<int>          VECTOR2I;
+typedef VECTOR2<float>        VECTOR2F;
 
 /* KiROUND specialization for vectors */
 inline VECTOR2I KiROUND( const VECTOR2D& vec )
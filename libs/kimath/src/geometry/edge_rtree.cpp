@@ -0,0 +1,314 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/edge_rtree.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include <math/util.h>      // for rescale
+
+
+namespace
+{
+
+SEG::ecoord axisGap( int32_t aMin, int32_t aMax, int32_t aValue )
+{
+    if( aValue < aMin )
+        return SEG::ecoord( aMin ) - aValue;
+    else if( aValue > aMax )
+        return SEG::ecoord( aValue ) - aMax;
+
+    return 0;
+}
+
+
+SEG::ecoord rangeGap( int32_t aMinA, int32_t aMaxA, int32_t aMinB, int32_t aMaxB )
+{
+    if( aMaxB < aMinA )
+        return SEG::ecoord( aMinA ) - aMaxB;
+    else if( aMinB > aMaxA )
+        return SEG::ecoord( aMinB ) - aMaxA;
+
+    return 0;
+}
+
+} // namespace
+
+
+EDGE_RTREE::EDGE_RTREE( const std::vector<VECTOR2I>& aPoints, bool aClosed )
+{
+    size_t count = aPoints.size() < 2 ? 0 : aPoints.size() - ( aClosed ? 0 : 1 );
+
+    m_segs.reserve( count );
+
+    for( size_t ii = 0; ii < count; ii++ )
+        m_segs.push_back( { aPoints[ii], aPoints[( ii + 1 ) % aPoints.size()], (int) ii } );
+
+    // Sort-Tile-Recursive packing: sort by x, cut into vertical slices, sort each slice by y.
+    auto centerX = []( const EDGE& aEdge ) { return int64_t( aEdge.m_A.x ) + aEdge.m_B.x; };
+    auto centerY = []( const EDGE& aEdge ) { return int64_t( aEdge.m_A.y ) + aEdge.m_B.y; };
+
+    std::sort( m_segs.begin(), m_segs.end(),
+               [&]( const EDGE& a, const EDGE& b )
+               {
+                   return centerX( a ) < centerX( b );
+               } );
+
+    size_t leafCount = ( count + NODE_SIZE - 1 ) / NODE_SIZE;
+    size_t sliceCount = std::max<size_t>( 1, std::ceil( std::sqrt( (double) leafCount ) ) );
+    size_t sliceSize = sliceCount * NODE_SIZE;
+
+    for( size_t start = 0; start < count; start += sliceSize )
+    {
+        auto first = m_segs.begin() + start;
+        auto last = m_segs.begin() + std::min( count, start + sliceSize );
+
+        std::sort( first, last,
+                   [&]( const EDGE& a, const EDGE& b )
+                   {
+                       return centerY( a ) < centerY( b );
+                   } );
+    }
+
+    // Leaf level boxes, then each upper level groups NODE_SIZE consecutive nodes below it.
+    std::vector<BOX> level;
+
+    for( size_t start = 0; start < count; start += NODE_SIZE )
+    {
+        BOX box = { INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN };
+
+        for( size_t ii = start; ii < std::min( count, start + NODE_SIZE ); ii++ )
+        {
+            const EDGE& edge = m_segs[ii];
+
+            box.m_MinX = std::min( { box.m_MinX, edge.m_A.x, edge.m_B.x } );
+            box.m_MinY = std::min( { box.m_MinY, edge.m_A.y, edge.m_B.y } );
+            box.m_MaxX = std::max( { box.m_MaxX, edge.m_A.x, edge.m_B.x } );
+            box.m_MaxY = std::max( { box.m_MaxY, edge.m_A.y, edge.m_B.y } );
+        }
+
+        level.push_back( box );
+    }
+
+    while( !level.empty() )
+    {
+        m_levels.push_back( level );
+
+        if( level.size() == 1 )
+            break;
+
+        std::vector<BOX> parent;
+
+        for( size_t start = 0; start < level.size(); start += NODE_SIZE )
+        {
+            BOX box = level[start];
+
+            for( size_t ii = start + 1; ii < std::min( level.size(), start + NODE_SIZE ); ii++ )
+            {
+                box.m_MinX = std::min( box.m_MinX, level[ii].m_MinX );
+                box.m_MinY = std::min( box.m_MinY, level[ii].m_MinY );
+                box.m_MaxX = std::max( box.m_MaxX, level[ii].m_MaxX );
+                box.m_MaxY = std::max( box.m_MaxY, level[ii].m_MaxY );
+            }
+
+            parent.push_back( box );
+        }
+
+        level = std::move( parent );
+    }
+}
+
+
+bool EDGE_RTREE::rayCrossingParity( const VECTOR2I& aPt, size_t aLevel, size_t aNode ) const
+{
+    const BOX& box = m_levels[aLevel][aNode];
+
+    // An edge can only toggle the parity if it spans aPt.y (lower end inclusive) and reaches
+    // aPt.x; see SHAPE_LINE_CHAIN_BASE::PointInside().
+    if( box.m_MinY > aPt.y || box.m_MaxY <= aPt.y || box.m_MaxX < aPt.x )
+        return false;
+
+    bool   inside = false;
+    size_t first = aNode * NODE_SIZE;
+
+    if( aLevel == 0 )
+    {
+        for( size_t ii = first; ii < std::min( m_segs.size(), first + NODE_SIZE ); ii++ )
+        {
+            const VECTOR2I& p1 = m_segs[ii].m_A;
+            const VECTOR2I& p2 = m_segs[ii].m_B;
+            const VECTOR2I  diff = p2 - p1;
+
+            if( diff.y != 0 )
+            {
+                const int d = rescale( diff.x, ( aPt.y - p1.y ), diff.y );
+
+                if( ( ( p1.y > aPt.y ) != ( p2.y > aPt.y ) ) && ( aPt.x - p1.x < d ) )
+                    inside = !inside;
+            }
+        }
+    }
+    else
+    {
+        for( size_t ii = first; ii < std::min( m_levels[aLevel - 1].size(), first + NODE_SIZE ); ii++ )
+        {
+            if( rayCrossingParity( aPt, aLevel - 1, ii ) )
+                inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+
+bool EDGE_RTREE::RayCrossingParity( const VECTOR2I& aPt ) const
+{
+    if( m_levels.empty() )
+        return false;
+
+    return rayCrossingParity( aPt, m_levels.size() - 1, 0 );
+}
+
+
+template <typename QUERY, typename BOUND_FUNC>
+int EDGE_RTREE::nearest( const QUERY& aQuery, BOUND_FUNC aBound,
+                         SEG::ecoord* aSquaredDistance ) const
+{
+    struct CANDIDATE
+    {
+        SEG::ecoord m_Bound;
+        size_t      m_Level;
+        size_t      m_Node;
+
+        bool operator>( const CANDIDATE& aOther ) const { return m_Bound > aOther.m_Bound; }
+    };
+
+    std::priority_queue<CANDIDATE, std::vector<CANDIDATE>, std::greater<CANDIDATE>> queue;
+
+    SEG::ecoord best = VECTOR2I::ECOORD_MAX;
+    int         bestIndex = -1;
+
+    if( !m_levels.empty() )
+        queue.push( { aBound( m_levels.back()[0] ), m_levels.size() - 1, 0 } );
+
+    // Nodes are visited by increasing lower bound.  Keep going while a node could still hold an
+    // edge at the same distance as the best one, so that ties go to the lowest edge index.
+    while( !queue.empty() && queue.top().m_Bound <= best )
+    {
+        CANDIDATE candidate = queue.top();
+        size_t    first = candidate.m_Node * NODE_SIZE;
+
+        queue.pop();
+
+        if( candidate.m_Level == 0 )
+        {
+            for( size_t ii = first; ii < std::min( m_segs.size(), first + NODE_SIZE ); ii++ )
+            {
+                const EDGE& edge = m_segs[ii];
+                SEG::ecoord dist = SEG( edge.m_A, edge.m_B ).SquaredDistance( aQuery );
+
+                if( dist < best || ( dist == best && edge.m_Index < bestIndex ) )
+                {
+                    best = dist;
+                    bestIndex = edge.m_Index;
+                }
+            }
+        }
+        else
+        {
+            const std::vector<BOX>& children = m_levels[candidate.m_Level - 1];
+
+            for( size_t ii = first; ii < std::min( children.size(), first + NODE_SIZE ); ii++ )
+            {
+                SEG::ecoord bound = aBound( children[ii] );
+
+                if( bound <= best )
+                    queue.push( { bound, candidate.m_Level - 1, ii } );
+            }
+        }
+    }
+
+    if( aSquaredDistance )
+        *aSquaredDistance = best;
+
+    return bestIndex;
+}
+
+
+int EDGE_RTREE::Nearest( const VECTOR2I& aP, SEG::ecoord* aSquaredDistance ) const
+{
+    return nearest( aP,
+                    [&]( const BOX& aBox )
+                    {
+                        SEG::ecoord dx = axisGap( aBox.m_MinX, aBox.m_MaxX, aP.x );
+                        SEG::ecoord dy = axisGap( aBox.m_MinY, aBox.m_MaxY, aP.y );
+
+                        return dx * dx + dy * dy;
+                    },
+                    aSquaredDistance );
+}
+
+
+int EDGE_RTREE::Nearest( const SEG& aSeg, SEG::ecoord* aSquaredDistance ) const
+{
+    int32_t minX = std::min( aSeg.A.x, aSeg.B.x );
+    int32_t maxX = std::max( aSeg.A.x, aSeg.B.x );
+    int32_t minY = std::min( aSeg.A.y, aSeg.B.y );
+    int32_t maxY = std::max( aSeg.A.y, aSeg.B.y );
+
+    return nearest( aSeg,
+                    [&]( const BOX& aBox )
+                    {
+                        SEG::ecoord dx = rangeGap( aBox.m_MinX, aBox.m_MaxX, minX, maxX );
+                        SEG::ecoord dy = rangeGap( aBox.m_MinY, aBox.m_MaxY, minY, maxY );
+
+                        return dx * dx + dy * dy;
+                    },
+                    aSquaredDistance );
+}
+
+
+const EDGE_RTREE* EDGE_RTREE_CACHE::Get( const std::vector<VECTOR2I>& aPoints,
+                                         bool aClosed ) const
+{
+    if( aPoints.size() < EDGE_RTREE::MIN_SEGMENTS )
+        return nullptr;
+
+    if( EDGE_RTREE* index = m_ready.load( std::memory_order_acquire ) )
+        return index;
+
+    if( m_queries.fetch_add( 1 ) < WARMUP_QUERIES )
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    if( !m_index )
+    {
+        m_index = std::make_unique<EDGE_RTREE>( aPoints, aClosed );
+        m_ready.store( m_index.get(), std::memory_order_release );
+    }
+
+    return m_index.get();
+}
@@ -0,0 +1,520 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/seg_batch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#endif
+
+
+namespace
+{
+
+// Number of approximate distances computed before the candidates are refined.  Small enough to
+// live on the stack, large enough to amortise the refinement bookkeeping.
+constexpr size_t BLOCK_SIZE = 256;
+
+// The exact integer routines round the projected point to the grid, so the exact distance can
+// differ from the floating point one by a little under one unit.  Any segment whose approximate
+// distance is within this margin of the best exact one found so far must be checked exactly.
+constexpr double REFINE_MARGIN = 4.0;
+
+// Relative tolerance used when deciding if two segments might cross.  Much larger than the
+// rounding error of the orientation products, so that a crossing is never missed.
+constexpr double CROSS_TOLERANCE = 1e-12;
+
+
+struct SCALAR_LANES
+{
+    using V = double;
+    using M = bool;
+    static constexpr size_t N = 1;
+
+    static V    Load( const int32_t* p )       { return *p; }
+    static void Store( double* p, V a )        { *p = a; }
+    static V    Set( double a )                { return a; }
+    static V    Add( V a, V b )                { return a + b; }
+    static V    Sub( V a, V b )                { return a - b; }
+    static V    Mul( V a, V b )                { return a * b; }
+    static V    Div( V a, V b )                { return a / b; }
+    static V    Min( V a, V b )                { return std::min( a, b ); }
+    static V    Max( V a, V b )                { return std::max( a, b ); }
+    static V    Abs( V a )                     { return std::abs( a ); }
+    static M    Le( V a, V b )                 { return a <= b; }
+    static M    Ge( V a, V b )                 { return a >= b; }
+    static M    And( M a, M b )                { return a && b; }
+    static V    Select( M m, V a, V b )        { return m ? a : b; }
+};
+
+
+#if defined( __AVX2__ )
+
+struct VECTOR_LANES
+{
+    using V = __m256d;
+    using M = __m256d;
+    static constexpr size_t N = 4;
+    static constexpr const char* NAME = "avx2";
+
+    static V Load( const int32_t* p )
+    {
+        return _mm256_cvtepi32_pd( _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ) );
+    }
+
+    static void Store( double* p, V a )        { _mm256_storeu_pd( p, a ); }
+    static V    Set( double a )                { return _mm256_set1_pd( a ); }
+    static V    Add( V a, V b )                { return _mm256_add_pd( a, b ); }
+    static V    Sub( V a, V b )                { return _mm256_sub_pd( a, b ); }
+    static V    Mul( V a, V b )                { return _mm256_mul_pd( a, b ); }
+    static V    Div( V a, V b )                { return _mm256_div_pd( a, b ); }
+    static V    Min( V a, V b )                { return _mm256_min_pd( a, b ); }
+    static V    Max( V a, V b )                { return _mm256_max_pd( a, b ); }
+    static V    Abs( V a )                     { return _mm256_andnot_pd( _mm256_set1_pd( -0.0 ), a ); }
+    static M    Le( V a, V b )                 { return _mm256_cmp_pd( a, b, _CMP_LE_OQ ); }
+    static M    Ge( V a, V b )                 { return _mm256_cmp_pd( a, b, _CMP_GE_OQ ); }
+    static M    And( M a, M b )                { return _mm256_and_pd( a, b ); }
+    static V    Select( M m, V a, V b )        { return _mm256_blendv_pd( b, a, m ); }
+};
+
+#elif defined( __SSE2__ ) || defined( _M_X64 )
+
+struct VECTOR_LANES
+{
+    using V = __m128d;
+    using M = __m128d;
+    static constexpr size_t N = 2;
+    static constexpr const char* NAME = "sse2";
+
+    static V Load( const int32_t* p )
+    {
+        return _mm_cvtepi32_pd( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( p ) ) );
+    }
+
+    static void Store( double* p, V a )        { _mm_storeu_pd( p, a ); }
+    static V    Set( double a )                { return _mm_set1_pd( a ); }
+    static V    Add( V a, V b )                { return _mm_add_pd( a, b ); }
+    static V    Sub( V a, V b )                { return _mm_sub_pd( a, b ); }
+    static V    Mul( V a, V b )                { return _mm_mul_pd( a, b ); }
+    static V    Div( V a, V b )                { return _mm_div_pd( a, b ); }
+    static V    Min( V a, V b )                { return _mm_min_pd( a, b ); }
+    static V    Max( V a, V b )                { return _mm_max_pd( a, b ); }
+    static V    Abs( V a )                     { return _mm_andnot_pd( _mm_set1_pd( -0.0 ), a ); }
+    static M    Le( V a, V b )                 { return _mm_cmple_pd( a, b ); }
+    static M    Ge( V a, V b )                 { return _mm_cmpge_pd( a, b ); }
+    static M    And( M a, M b )                { return _mm_and_pd( a, b ); }
+
+    static V Select( M m, V a, V b )
+    {
+        return _mm_or_pd( _mm_and_pd( m, a ), _mm_andnot_pd( m, b ) );
+    }
+};
+
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+
+struct VECTOR_LANES
+{
+    using V = float64x2_t;
+    using M = uint64x2_t;
+    static constexpr size_t N = 2;
+    static constexpr const char* NAME = "neon";
+
+    static V    Load( const int32_t* p )       { return vcvtq_f64_s64( vmovl_s32( vld1_s32( p ) ) ); }
+    static void Store( double* p, V a )        { vst1q_f64( p, a ); }
+    static V    Set( double a )                { return vdupq_n_f64( a ); }
+    static V    Add( V a, V b )                { return vaddq_f64( a, b ); }
+    static V    Sub( V a, V b )                { return vsubq_f64( a, b ); }
+    static V    Mul( V a, V b )                { return vmulq_f64( a, b ); }
+    static V    Div( V a, V b )                { return vdivq_f64( a, b ); }
+    static V    Min( V a, V b )                { return vminq_f64( a, b ); }
+    static V    Max( V a, V b )                { return vmaxq_f64( a, b ); }
+    static V    Abs( V a )                     { return vabsq_f64( a ); }
+    static M    Le( V a, V b )                 { return vcleq_f64( a, b ); }
+    static M    Ge( V a, V b )                 { return vcgeq_f64( a, b ); }
+    static M    And( M a, M b )                { return vandq_u64( a, b ); }
+    static V    Select( M m, V a, V b )        { return vbslq_f64( m, a, b ); }
+};
+
+#else
+
+struct VECTOR_LANES : public SCALAR_LANES
+{
+    static constexpr const char* NAME = "scalar";
+};
+
+#endif
+
+
+/**
+ * Squared distance from point (px, py) to segment (ax, ay)-(bx, by).
+ */
+template <typename L>
+typename L::V pointToSeg( typename L::V ax, typename L::V ay, typename L::V bx, typename L::V by,
+                          typename L::V px, typename L::V py )
+{
+    using V = typename L::V;
+
+    const V zero = L::Set( 0.0 );
+    const V one = L::Set( 1.0 );
+
+    V dx = L::Sub( bx, ax );
+    V dy = L::Sub( by, ay );
+    V vx = L::Sub( px, ax );
+    V vy = L::Sub( py, ay );
+
+    // Non-degenerate integer segments have a squared length of at least 1, and for degenerate
+    // ones the numerator is zero, so clamping the denominator avoids a division by zero.
+    V l2 = L::Max( L::Add( L::Mul( dx, dx ), L::Mul( dy, dy ) ), one );
+    V t = L::Div( L::Add( L::Mul( dx, vx ), L::Mul( dy, vy ) ), l2 );
+
+    t = L::Min( L::Max( t, zero ), one );
+
+    V ex = L::Sub( vx, L::Mul( t, dx ) );
+    V ey = L::Sub( vy, L::Mul( t, dy ) );
+
+    return L::Add( L::Mul( ex, ex ), L::Mul( ey, ey ) );
+}
+
+
+/**
+ * Orientation of point (px, py) with respect to the line through a and b, together with a
+ * bound on its rounding error.
+ */
+template <typename L>
+void orientation( typename L::V ax, typename L::V ay, typename L::V bx, typename L::V by,
+                  typename L::V px, typename L::V py, typename L::V& aOrient, typename L::V& aTol )
+{
+    using V = typename L::V;
+
+    V p1 = L::Mul( L::Sub( bx, ax ), L::Sub( py, ay ) );
+    V p2 = L::Mul( L::Sub( by, ay ), L::Sub( px, ax ) );
+
+    aOrient = L::Sub( p1, p2 );
+    aTol = L::Mul( L::Add( L::Abs( p1 ), L::Abs( p2 ) ), L::Set( CROSS_TOLERANCE ) );
+}
+
+
+template <typename L>
+typename L::M straddles( typename L::V o1, typename L::V t1, typename L::V o2, typename L::V t2 )
+{
+    using V = typename L::V;
+
+    V tol = L::Max( t1, t2 );
+
+    return L::And( L::Le( L::Min( o1, o2 ), tol ),
+                   L::Ge( L::Max( o1, o2 ), L::Sub( L::Set( 0.0 ), tol ) ) );
+}
+
+
+/**
+ * Lower bound (up to rounding) of the squared distance between segments a-b and q-r.  Returns
+ * zero whenever the segments might intersect.
+ */
+template <typename L>
+typename L::V segToSeg( typename L::V ax, typename L::V ay, typename L::V bx, typename L::V by,
+                        typename L::V qx, typename L::V qy, typename L::V rx, typename L::V ry )
+{
+    using V = typename L::V;
+
+    V d = L::Min( L::Min( pointToSeg<L>( ax, ay, bx, by, qx, qy ),
+                          pointToSeg<L>( ax, ay, bx, by, rx, ry ) ),
+                  L::Min( pointToSeg<L>( qx, qy, rx, ry, ax, ay ),
+                          pointToSeg<L>( qx, qy, rx, ry, bx, by ) ) );
+
+    V o1, t1, o2, t2, o3, t3, o4, t4;
+
+    orientation<L>( ax, ay, bx, by, qx, qy, o1, t1 );
+    orientation<L>( ax, ay, bx, by, rx, ry, o2, t2 );
+    orientation<L>( qx, qy, rx, ry, ax, ay, o3, t3 );
+    orientation<L>( qx, qy, rx, ry, bx, by, o4, t4 );
+
+    typename L::M crossing = L::And( straddles<L>( o1, t1, o2, t2 ),
+                                     straddles<L>( o3, t3, o4, t4 ) );
+
+    return L::Select( crossing, L::Set( 0.0 ), d );
+}
+
+
+struct BATCH_VIEW
+{
+    const int32_t* ax;
+    const int32_t* ay;
+    const int32_t* bx;
+    const int32_t* by;
+};
+
+
+template <typename L>
+void pointDistances( const BATCH_VIEW& aBatch, size_t aCount, const VECTOR2I& aP, double* aOut )
+{
+    const typename L::V px = L::Set( aP.x );
+    const typename L::V py = L::Set( aP.y );
+    size_t              i = 0;
+
+    for( ; i + L::N <= aCount; i += L::N )
+    {
+        L::Store( aOut + i, pointToSeg<L>( L::Load( aBatch.ax + i ), L::Load( aBatch.ay + i ),
+                                           L::Load( aBatch.bx + i ), L::Load( aBatch.by + i ),
+                                           px, py ) );
+    }
+
+    for( ; i < aCount; i++ )
+    {
+        aOut[i] = pointToSeg<SCALAR_LANES>( aBatch.ax[i], aBatch.ay[i], aBatch.bx[i],
+                                            aBatch.by[i], aP.x, aP.y );
+    }
+}
+
+
+template <typename L>
+void segDistances( const BATCH_VIEW& aBatch, size_t aCount, const SEG& aSeg, double* aOut )
+{
+    const typename L::V qx = L::Set( aSeg.A.x );
+    const typename L::V qy = L::Set( aSeg.A.y );
+    const typename L::V rx = L::Set( aSeg.B.x );
+    const typename L::V ry = L::Set( aSeg.B.y );
+    size_t              i = 0;
+
+    for( ; i + L::N <= aCount; i += L::N )
+    {
+        L::Store( aOut + i, segToSeg<L>( L::Load( aBatch.ax + i ), L::Load( aBatch.ay + i ),
+                                         L::Load( aBatch.bx + i ), L::Load( aBatch.by + i ),
+                                         qx, qy, rx, ry ) );
+    }
+
+    for( ; i < aCount; i++ )
+    {
+        aOut[i] = segToSeg<SCALAR_LANES>( aBatch.ax[i], aBatch.ay[i], aBatch.bx[i], aBatch.by[i],
+                                          aSeg.A.x, aSeg.A.y, aSeg.B.x, aSeg.B.y );
+    }
+}
+
+
+double refineLimit( SEG::ecoord aBestExact )
+{
+    if( aBestExact == VECTOR2I::ECOORD_MAX )
+        return std::numeric_limits<double>::max();
+
+    double r = std::sqrt( static_cast<double>( aBestExact ) ) + REFINE_MARGIN;
+
+    return r * r;
+}
+
+
+/**
+ * Block-wise search: approximate distances (lower bounds) for a block of segments, then exact
+ * distances for the segments which could still beat the best one.
+ *
+ * The approximation is only a lower bound (possible crossings are reported as zero), so the
+ * refinement limit is derived from exact distances only.  The lowest approximation of each
+ * block is refined first to get a good limit early.  Ties are resolved on the lowest slot.
+ */
+template <typename APPROX_FUNC, typename EXACT_FUNC>
+SEG_BATCH::NEAREST findNearest( size_t aCount, const std::vector<int>& aIds,
+                                SEG::ecoord aStopBelow, APPROX_FUNC aApprox, EXACT_FUNC aExact )
+{
+    SEG_BATCH::NEAREST best;
+    size_t             bestSlot = aCount;
+    double             approx[BLOCK_SIZE];
+
+    auto refine =
+            [&]( size_t aSlot )
+            {
+                SEG::ecoord dist_sq = aExact( aSlot );
+
+                if( dist_sq < best.m_SquaredDistance
+                        || ( dist_sq == best.m_SquaredDistance && aSlot < bestSlot ) )
+                {
+                    best.m_SquaredDistance = dist_sq;
+                    best.m_Index = aIds[aSlot];
+                    bestSlot = aSlot;
+                }
+            };
+
+    for( size_t start = 0; start < aCount; start += BLOCK_SIZE )
+    {
+        size_t count = std::min( BLOCK_SIZE, aCount - start );
+        size_t first = 0;
+
+        aApprox( start, count, approx );
+
+        for( size_t i = 1; i < count; i++ )
+        {
+            if( approx[i] < approx[first] )
+                first = i;
+        }
+
+        if( approx[first] <= refineLimit( best.m_SquaredDistance ) )
+            refine( start + first );
+
+        double limit = refineLimit( best.m_SquaredDistance );
+
+        for( size_t i = 0; i < count; i++ )
+        {
+            if( i == first || approx[i] > limit )
+                continue;
+
+            // Nothing after the current best can win once it is a hit
+            if( best.m_SquaredDistance == 0 && start + i > bestSlot )
+                break;
+
+            refine( start + i );
+
+            if( best.m_SquaredDistance < aStopBelow )
+                return best;
+
+            limit = refineLimit( best.m_SquaredDistance );
+        }
+
+        if( best.m_SquaredDistance == 0 || best.m_SquaredDistance < aStopBelow )
+            return best;
+    }
+
+    return best;
+}
+
+} // namespace
+
+
+void SEG_BATCH::Clear()
+{
+    m_ax.clear();
+    m_ay.clear();
+    m_bx.clear();
+    m_by.clear();
+    m_ids.clear();
+}
+
+
+void SEG_BATCH::Reserve( size_t aCount )
+{
+    m_ax.reserve( aCount );
+    m_ay.reserve( aCount );
+    m_bx.reserve( aCount );
+    m_by.reserve( aCount );
+    m_ids.reserve( aCount );
+}
+
+
+void SEG_BATCH::Add( const VECTOR2I& aA, const VECTOR2I& aB, int aIndex )
+{
+    m_ids.push_back( aIndex >= 0 ? aIndex : static_cast<int>( m_ids.size() ) );
+    m_ax.push_back( aA.x );
+    m_ay.push_back( aA.y );
+    m_bx.push_back( aB.x );
+    m_by.push_back( aB.y );
+}
+
+
+SEG_BATCH::NEAREST SEG_BATCH::Nearest( const VECTOR2I& aP, SEG::ecoord aStopBelow ) const
+{
+    BATCH_VIEW view{ m_ax.data(), m_ay.data(), m_bx.data(), m_by.data() };
+
+    return findNearest( Size(), m_ids, aStopBelow,
+            [&]( size_t aStart, size_t aCount, double* aOut )
+            {
+                BATCH_VIEW block{ view.ax + aStart, view.ay + aStart, view.bx + aStart,
+                                  view.by + aStart };
+
+                pointDistances<VECTOR_LANES>( block, aCount, aP, aOut );
+            },
+            [&]( size_t aSlot )
+            {
+                return Segment( aSlot ).SquaredDistance( aP );
+            } );
+}
+
+
+SEG_BATCH::NEAREST SEG_BATCH::Nearest( const SEG& aSeg, SEG::ecoord aStopBelow ) const
+{
+    BATCH_VIEW view{ m_ax.data(), m_ay.data(), m_bx.data(), m_by.data() };
+
+    return findNearest( Size(), m_ids, aStopBelow,
+            [&]( size_t aStart, size_t aCount, double* aOut )
+            {
+                BATCH_VIEW block{ view.ax + aStart, view.ay + aStart, view.bx + aStart,
+                                  view.by + aStart };
+
+                segDistances<VECTOR_LANES>( block, aCount, aSeg, aOut );
+            },
+            [&]( size_t aSlot )
+            {
+                return Segment( aSlot ).SquaredDistance( aSeg );
+            } );
+}
+
+
+bool SEG_BATCH::Collide( const VECTOR2I& aP, int aClearance, int* aActual, int* aIndex ) const
+{
+    SEG::ecoord clearance_sq = SEG::Square( aClearance );
+    NEAREST     nearest = Nearest( aP, ( aActual || aIndex ) ? 0 : clearance_sq );
+
+    if( nearest.m_Index >= 0
+            && ( nearest.m_SquaredDistance == 0 || nearest.m_SquaredDistance < clearance_sq ) )
+    {
+        if( aActual )
+            *aActual = sqrt( nearest.m_SquaredDistance );
+
+        if( aIndex )
+            *aIndex = nearest.m_Index;
+
+        return true;
+    }
+
+    return false;
+}
+
+
+bool SEG_BATCH::Collide( const SEG& aSeg, int aClearance, int* aActual, int* aIndex ) const
+{
+    SEG::ecoord clearance_sq = SEG::Square( aClearance );
+    NEAREST     nearest = Nearest( aSeg, ( aActual || aIndex ) ? 0 : clearance_sq );
+
+    if( nearest.m_Index >= 0
+            && ( nearest.m_SquaredDistance == 0 || nearest.m_SquaredDistance < clearance_sq ) )
+    {
+        if( aActual )
+            *aActual = sqrt( nearest.m_SquaredDistance );
+
+        if( aIndex )
+            *aIndex = nearest.m_Index;
+
+        return true;
+    }
+
+    return false;
+}
+
+
+const char* SEG_BATCH::KernelName()
+{
+    return VECTOR_LANES::NAME;
+}
@@ -33,6 +33,7 @@
 #include <clipper2/clipper.h>
 #include <core/kicad_algo.h> // for alg::run_on_pair
 #include <geometry/seg.h>    // for SEG, OPT_VECTOR2I
+#include <geometry/seg_batch.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
 #include <math/box2.h>       // for BOX2I
@@ -235,6 +236,8 @@ Clipper2Lib::Path64 SHAPE_LINE_CHAIN::convertToClipper2( bool aRequiredOrientati
 
 void SHAPE_LINE_CHAIN::fixIndicesRotation()
 {
+    invalidateIndices();
+
     wxCHECK( m_shapes.size() == m_points.size(), /*void*/ );
 
     if( m_shapes.size() <= 1 )
@@ -258,6 +261,8 @@ void SHAPE_LINE_CHAIN::fixIndicesRotation()
 
 void SHAPE_LINE_CHAIN::mergeFirstLastPointIfNeeded()
 {
+    invalidateIndices();
+
     if( m_closed )
     {
         if( m_points.size() > 1 && m_points.front() == m_points.back() )
@@ -320,6 +325,8 @@ void SHAPE_LINE_CHAIN::convertArc( ssize_t aArcIndex )
 void SHAPE_LINE_CHAIN::amendArc( size_t aArcIndex, const VECTOR2I& aNewStart,
                                  const VECTOR2I& aNewEnd )
 {
+    invalidateIndices();
+
     wxCHECK_MSG( aArcIndex <  m_arcs.size(), /* void */,
                  wxT( "Invalid arc index requested." ) );
 
@@ -487,26 +494,52 @@ bool SHAPE_LINE_CHAIN::Collide( const VECTOR2I& aP, int aClearance, int* aActual
     VECTOR2I    nearest;
 
     // Collide line segments
-    for( size_t i = 0; i < GetSegmentCount(); i++ )
+    const EDGE_RTREE* index = m_arcs.empty() ? EdgeIndex() : nullptr;
+
+    if( index )
     {
-        if( IsArcSegment( i ) )
-            continue;
+        int seg = index->Nearest( aP, &closest_dist_sq );
 
-        const SEG&  s = GetSegment( i );
-        VECTOR2I    pn = s.NearestPoint( aP );
-        SEG::ecoord dist_sq = ( pn - aP ).SquaredEuclideanNorm();
+        if( seg >= 0 )
+            nearest = CSegment( seg ).NearestPoint( aP );
+    }
+    else if( GetSegmentCount() >= SEG_BATCH::MIN_BATCH_SIZE )
+    {
+        SEG_BATCH        temp;
+        const SEG_BATCH& batch = lineSegBatch( temp );
 
-        if( dist_sq < closest_dist_sq )
+        // If we're not looking for aActual then any collision will do
+        SEG_BATCH::NEAREST hit = batch.Nearest( aP, aActual ? 0 : clearance_sq );
+
+        if( hit.m_Index >= 0 )
         {
-            nearest = pn;
-            closest_dist_sq = dist_sq;
+            nearest = CSegment( hit.m_Index ).NearestPoint( aP );
+            closest_dist_sq = hit.m_SquaredDistance;
+        }
+    }
+    else
+    {
+        for( size_t i = 0; i < GetSegmentCount(); i++ )
+        {
+            if( IsArcSegment( i ) )
+                continue;
 
-            if( closest_dist_sq == 0 )
-                break;
+            const SEG&  s = GetSegment( i );
+            VECTOR2I    pn = s.NearestPoint( aP );
+            SEG::ecoord dist_sq = ( pn - aP ).SquaredEuclideanNorm();
 
-            // If we're not looking for aActual then any collision will do
-            if( closest_dist_sq < clearance_sq && !aActual )
-                break;
+            if( dist_sq < closest_dist_sq )
+            {
+                nearest = pn;
+                closest_dist_sq = dist_sq;
+
+                if( closest_dist_sq == 0 )
+                    break;
+
+                // If we're not looking for aActual then any collision will do
+                if( closest_dist_sq < clearance_sq && !aActual )
+                    break;
+            }
         }
     }
 
@@ -539,6 +572,8 @@ bool SHAPE_LINE_CHAIN::Collide( const VECTOR2I& aP, int aClearance, int* aActual
 
 void SHAPE_LINE_CHAIN::Rotate( const EDA_ANGLE& aAngle, const VECTOR2I& aCenter )
 {
+    invalidateIndices();
+
     for( VECTOR2I& pt : m_points )
         RotatePoint( pt, aCenter, aAngle );
 
@@ -547,6 +582,44 @@ void SHAPE_LINE_CHAIN::Rotate( const EDA_ANGLE& aAngle, const VECTOR2I& aCenter
 }
 
 
+void SHAPE_LINE_CHAIN::AppendToSegBatch( SEG_BATCH& aBatch, bool aSkipArcs ) const
+{
+    int count = SegmentCount();
+
+    aBatch.Reserve( aBatch.Size() + count );
+
+    for( int i = 0; i < count; i++ )
+    {
+        if( aSkipArcs && IsArcSegment( i ) )
+            continue;
+
+        aBatch.Add( m_points[i], m_points[( i + 1 ) % m_points.size()], i );
+    }
+}
+
+
+const SEG_BATCH& SHAPE_LINE_CHAIN::SegBatch() const
+{
+    return m_segBatch.Get(
+            [this]( SEG_BATCH& aBatch )
+            {
+                AppendToSegBatch( aBatch );
+            } );
+}
+
+
+const SEG_BATCH& SHAPE_LINE_CHAIN::lineSegBatch( SEG_BATCH& aTemp ) const
+{
+    // Large chains get an edge index after a few queries, so don't keep a batch for them too.
+    // The cached batch also has the arc segments, which are collided with the arcs instead.
+    if( m_arcs.empty() && m_points.size() < EDGE_RTREE::MIN_SEGMENTS )
+        return SegBatch();
+
+    AppendToSegBatch( aTemp, true );
+    return aTemp;
+}
+
+
 bool SHAPE_LINE_CHAIN_BASE::Collide( const SEG& aSeg, int aClearance, int* aActual,
                                      VECTOR2I* aLocation ) const
 {
@@ -620,27 +693,55 @@ bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance, int* aActual,
     VECTOR2I    nearest;
 
     // Collide line segments
-    for( size_t i = 0; i < GetSegmentCount(); i++ )
+    const EDGE_RTREE* index = m_arcs.empty() ? EdgeIndex() : nullptr;
+
+    if( index )
     {
-        if( IsArcSegment( i ) )
-            continue;
+        int seg = index->Nearest( aSeg, &closest_dist_sq );
 
-        const SEG&  s = GetSegment( i );
-        SEG::ecoord dist_sq = s.SquaredDistance( aSeg );
+        if( seg >= 0 && aLocation )
+            nearest = CSegment( seg ).NearestPoint( aSeg );
+    }
+    else if( GetSegmentCount() >= SEG_BATCH::MIN_BATCH_SIZE )
+    {
+        SEG_BATCH        temp;
+        const SEG_BATCH& batch = lineSegBatch( temp );
 
-        if( dist_sq < closest_dist_sq )
+        // If we're not looking for aActual then any collision will do
+        SEG_BATCH::NEAREST hit = batch.Nearest( aSeg, aActual ? 0 : clearance_sq );
+
+        if( hit.m_Index >= 0 )
         {
             if( aLocation )
-                nearest = s.NearestPoint( aSeg );
+                nearest = CSegment( hit.m_Index ).NearestPoint( aSeg );
 
-            closest_dist_sq = dist_sq;
+            closest_dist_sq = hit.m_SquaredDistance;
+        }
+    }
+    else
+    {
+        for( size_t i = 0; i < GetSegmentCount(); i++ )
+        {
+            if( IsArcSegment( i ) )
+                continue;
 
-            if( closest_dist_sq == 0 )
-                break;
+            const SEG&  s = GetSegment( i );
+            SEG::ecoord dist_sq = s.SquaredDistance( aSeg );
 
-            // If we're not looking for aActual then any collision will do
-            if( closest_dist_sq < clearance_sq && !aActual )
-                break;
+            if( dist_sq < closest_dist_sq )
+            {
+                if( aLocation )
+                    nearest = s.NearestPoint( aSeg );
+
+                closest_dist_sq = dist_sq;
+
+                if( closest_dist_sq == 0 )
+                    break;
+
+                // If we're not looking for aActual then any collision will do
+                if( closest_dist_sq < clearance_sq && !aActual )
+                    break;
+            }
         }
     }
 
@@ -761,6 +862,8 @@ long long int SHAPE_LINE_CHAIN::Length() const
 
 void SHAPE_LINE_CHAIN::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
+    invalidateIndices();
+
     for( auto& pt : m_points )
     {
         if( aX )
@@ -777,6 +880,8 @@ void SHAPE_LINE_CHAIN::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
 void SHAPE_LINE_CHAIN::Mirror( const SEG& axis )
 {
+    invalidateIndices();
+
     for( auto& pt : m_points )
         pt = axis.ReflectPoint( pt );
 
@@ -795,6 +900,8 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I&
 
 void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const SHAPE_LINE_CHAIN& aLine )
 {
+    invalidateIndices();
+
     if( aEndIndex < 0 )
         aEndIndex += PointCount();
 
@@ -865,6 +972,8 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const SHAPE_LINE
 
 void SHAPE_LINE_CHAIN::Remove( int aStartIndex, int aEndIndex )
 {
+    invalidateIndices();
+
     wxCHECK( m_shapes.size() == m_points.size(), /*void*/ );
 
     // Unwrap the chain first (correctly handling removing arc at
@@ -969,6 +1078,8 @@ SEG::ecoord SHAPE_LINE_CHAIN_BASE::SquaredDistance( const VECTOR2I& aP, bool aOu
 
 int SHAPE_LINE_CHAIN::Split( const VECTOR2I& aP, bool aExact )
 {
+    invalidateIndices();
+
     int ii = -1;
     int min_dist = 2;
 
@@ -1148,6 +1259,8 @@ int SHAPE_LINE_CHAIN::NextShape( int aPointIndex ) const
 
 void SHAPE_LINE_CHAIN::SetPoint( int aIndex, const VECTOR2I& aPos )
 {
+    invalidateIndices();
+
     if( aIndex < 0 )
         aIndex += PointCount();
     else if( aIndex >= PointCount() )
@@ -1325,6 +1438,8 @@ const SHAPE_LINE_CHAIN SHAPE_LINE_CHAIN::Slice( int aStartIndex, int aEndIndex )
 
 void SHAPE_LINE_CHAIN::Append( const SHAPE_LINE_CHAIN& aOtherLine )
 {
+    invalidateIndices();
+
     assert( m_shapes.size() == m_points.size() );
 
     if( aOtherLine.PointCount() == 0 )
@@ -1397,6 +1512,8 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc )
 
 void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc, double aAccuracy )
 {
+    invalidateIndices();
+
     SHAPE_LINE_CHAIN chain = aArc.ConvertToPolyline( aAccuracy );
 
     if( chain.PointCount() > 2 )
@@ -1416,6 +1533,8 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc, double aAccuracy )
 
 void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const VECTOR2I& aP )
 {
+    invalidateIndices();
+
     if( aVertex == m_points.size() )
     {
         Append( aP );
@@ -1437,6 +1556,8 @@ void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const VECTOR2I& aP )
 
 void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const SHAPE_ARC& aArc )
 {
+    invalidateIndices();
+
     wxCHECK( aVertex < m_points.size(), /* void */ );
 
     if( aVertex > 0 && IsPtOnArc( aVertex ) )
@@ -1722,6 +1843,31 @@ bool SHAPE_LINE_CHAIN_BASE::PointInside( const VECTOR2I& aPt, int aAccuracy,
 }
 
 
+bool SHAPE_LINE_CHAIN::PointInside( const VECTOR2I& aPt, int aAccuracy,
+                                    bool aUseBBoxCache ) const
+{
+    const EDGE_RTREE* index = m_closed ? EdgeIndex() : nullptr;
+
+    if( !index )
+        return SHAPE_LINE_CHAIN_BASE::PointInside( aPt, aAccuracy, aUseBBoxCache );
+
+    if( aUseBBoxCache && !m_bbox.Contains( aPt ) )
+        return false;
+
+    if( index->RayCrossingParity( aPt ) )
+        return true;
+
+    // Same as the PointOnEdge() fallback of the base class: an edge counts if its (truncated)
+    // distance is at most aAccuracy + 1.
+    if( aAccuracy <= 1 )
+        return false;
+
+    SEG::ecoord dist_sq;
+
+    return index->Nearest( aPt, &dist_sq ) >= 0 && dist_sq < SEG::Square( aAccuracy + 2 );
+}
+
+
 bool SHAPE_LINE_CHAIN_BASE::PointOnEdge( const VECTOR2I& aPt, int aAccuracy ) const
 {
 	return EdgeContainingPoint( aPt, aAccuracy ) >= 0;
@@ -1993,6 +2139,8 @@ SHAPE* SHAPE_LINE_CHAIN::Clone() const
 
 bool SHAPE_LINE_CHAIN::Parse( std::stringstream& aStream )
 {
+    invalidateIndices();
+
     size_t n_pts;
     size_t n_arcs;
 
@@ -2090,6 +2238,8 @@ double SHAPE_LINE_CHAIN::Area( bool aAbsolute ) const
 
 void SHAPE_LINE_CHAIN::RemoveDuplicatePoints()
 {
+    invalidateIndices();
+
     std::vector<VECTOR2I> pts_unique;
     std::vector<std::pair<ssize_t, ssize_t>> shapes_unique;
 
@@ -2152,6 +2302,8 @@ void SHAPE_LINE_CHAIN::RemoveDuplicatePoints()
 
 void SHAPE_LINE_CHAIN::Simplify( int aMaxError )
 {
+    invalidateIndices();
+
     if( PointCount() < 3 )
         return;
 
@@ -44,9 +44,11 @@
 
 #include <clipper.hpp>                       // for Clipper, PolyNode, Clipp...
 #include <clipper2/clipper.h>
+#include <geometry/edge_rtree.h>
 #include <geometry/geometry_utils.h>
 #include <geometry/polygon_triangulation.h>
 #include <geometry/seg.h>                    // for SEG, OPT_VECTOR2I
+#include <geometry/seg_batch.h>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
@@ -2780,6 +2782,80 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::FilletPolygon( unsigned int aRadius, int
 }
 
 
+namespace
+{
+
+/**
+ * Squared distance from \a aQuery (a point or a segment) to the contours of \a aPoly, using the
+ * edge index of large contours and the cached SEG_BATCH of the others.
+ *
+ * @return false if the polygon is too small for this to pay off; the caller should then do a
+ *         plain scan.
+ */
+template <typename QUERY>
+bool squaredDistanceToContours( const SHAPE_POLY_SET::POLYGON& aPoly, const QUERY& aQuery,
+                                SEG::ecoord& aDistance, VECTOR2I* aNearest )
+{
+    size_t segCount = 0;
+
+    for( const SHAPE_LINE_CHAIN& contour : aPoly )
+        segCount += contour.SegmentCount();
+
+    if( segCount < SEG_BATCH::MIN_BATCH_SIZE )
+        return false;
+
+    // Large contours whose edge index is not built yet
+    SEG_BATCH batch;
+
+    aDistance = VECTOR2I::ECOORD_MAX;
+
+    for( const SHAPE_LINE_CHAIN& contour : aPoly )
+    {
+        SEG::ecoord dist = VECTOR2I::ECOORD_MAX;
+        int         seg = -1;
+
+        if( const EDGE_RTREE* index = contour.EdgeIndex() )
+        {
+            seg = index->Nearest( aQuery, &dist );
+        }
+        else if( contour.PointCount() < (int) EDGE_RTREE::MIN_SEGMENTS )
+        {
+            SEG_BATCH::NEAREST hit = contour.SegBatch().Nearest( aQuery );
+
+            seg = hit.m_Index;
+            dist = hit.m_SquaredDistance;
+        }
+        else
+        {
+            for( int ii = 0; ii < contour.SegmentCount(); ii++ )
+                batch.Add( contour.CSegment( ii ) );
+        }
+
+        if( seg >= 0 && dist < aDistance )
+        {
+            aDistance = dist;
+
+            if( aNearest )
+                *aNearest = contour.CSegment( seg ).NearestPoint( aQuery );
+        }
+    }
+
+    SEG_BATCH::NEAREST hit = batch.Nearest( aQuery );
+
+    if( hit.m_Index >= 0 && hit.m_SquaredDistance < aDistance )
+    {
+        aDistance = hit.m_SquaredDistance;
+
+        if( aNearest )
+            *aNearest = batch.Segment( hit.m_Index ).NearestPoint( aQuery );
+    }
+
+    return true;
+}
+
+} // namespace
+
+
 SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex,
                                                       VECTOR2I* aNearest ) const
 {
@@ -2795,9 +2871,14 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPoly
         return 0;
     }
 
+    SEG::ecoord minDistance;
+
+    if( squaredDistanceToContours( m_polys[aPolygonIndex], aPoint, minDistance, aNearest ) )
+        return minDistance;
+
     CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
 
-    SEG::ecoord minDistance = (*iterator).SquaredDistance( aPoint );
+    minDistance = (*iterator).SquaredDistance( aPoint );
 
     for( iterator++; iterator && minDistance > 0; iterator++ )
     {
@@ -2829,8 +2910,14 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment, int a
         return 0;
     }
 
+    SEG::ecoord minDistance;
+
+    if( squaredDistanceToContours( m_polys[aPolygonIndex], aSegment, minDistance, aNearest ) )
+        return minDistance;
+
     CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
-    SEG::ecoord            minDistance = (*iterator).SquaredDistance( aSegment );
+
+    minDistance = (*iterator).SquaredDistance( aSegment );
 
     if( aNearest && minDistance == 0 )
         *aNearest = ( *iterator ).NearestPoint( aSegment );
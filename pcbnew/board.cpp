@@ -37,6 +37,7 @@
 #include <core/kicad_algo.h>
 #include <connectivity/connectivity_data.h>
 #include <convert_shape_list_to_polygon.h>
+#include <font/glyph_cache.h>
 #include <footprint.h>
 #include <pcb_base_frame.h>
 #include <pcb_track.h>
@@ -174,6 +175,9 @@ BOARD::~BOARD()
     // cause call chains that query the containers
     for( BOARD_ITEM* item : ownedItems )
         delete item;
+
+    // Release the outline glyphs only this board's texts were using
+    KIFONT::GLYPH_CACHE::Instance().Purge();
 }
 
 
@@ -531,6 +531,8 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
     //
     int ii = zitems.size();
 
+    m_itemList.BeginBulkLoad();
+
     for( CN_ZONE_LAYER* zitem : zitems )
     {
         m_itemList.Add( zitem );
@@ -564,6 +566,8 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
         report( ++ii );
     }
 
+    m_itemList.EndBulkLoad();
+
     if( aReporter )
     {
         aReporter->SetCurrentProgress( (double) ii / (double) size );
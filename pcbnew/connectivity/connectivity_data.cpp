@@ -41,6 +41,7 @@
 #include <ratsnest/ratsnest_data.h>
 #include <progress_reporter.h>
 #include <core/thread_pool.h>
+#include <frame_tracer.h>
 #include <trigo.h>
 #include <drc/drc_rtree.h>
 
@@ -97,6 +98,8 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 
 bool CONNECTIVITY_DATA::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 {
+    KI_TRACE_ZONE( "CONNECTIVITY_DATA::Build", "connectivity" );
+
     aBoard->CacheTriangulation( aReporter );
 
     std::unique_lock<KISPINLOCK> lock( m_lock, std::try_to_lock );
@@ -217,6 +220,7 @@ void CONNECTIVITY_DATA::addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& a
 
 void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 {
+    KI_TRACE_ZONE( "CONNECTIVITY_DATA::RecalculateRatsnest", "connectivity" );
 
     // We can take over the lock here if called in the same thread
     // This is to prevent redraw during a RecalculateRatsnets process
@@ -335,6 +339,8 @@ void CONNECTIVITY_DATA::ComputeLocalRatsnest( const std::vector<BOARD_ITEM*>& aI
     if( !aDynamicData )
         return;
 
+    KI_TRACE_ZONE( "CONNECTIVITY_DATA::ComputeLocalRatsnest", "connectivity" );
+
     m_dynamicRatsnest.clear();
     std::mutex dynamic_ratsnest_mutex;
 
@@ -24,6 +24,8 @@
 #ifndef PCBNEW_CONNECTIVITY_RTREE_H_
 #define PCBNEW_CONNECTIVITY_RTREE_H_
 
+#include <vector>
+
 #include <math/box2.h>
 #include <router/pns_layerset.h>
 
@@ -65,6 +67,38 @@ public:
         m_tree->Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Inserts many items at once.  Much faster than inserting them one by one, and the
+     * resulting tree is better packed.
+     */
+    void BulkLoad( const std::vector<T>& aItems )
+    {
+        using RECT = typename RTree<T, int, 3, double>::Rect;
+
+        std::vector<std::pair<RECT, T>> entries;
+
+        entries.reserve( aItems.size() );
+
+        for( T item : aItems )
+        {
+            const BOX2I&        bbox    = item->BBox();
+            const LAYER_RANGE   layers  = item->Layers();
+            RECT                rect;
+
+            rect.m_min[0] = layers.Start();
+            rect.m_min[1] = bbox.GetX();
+            rect.m_min[2] = bbox.GetY();
+            rect.m_max[0] = layers.End();
+            rect.m_max[1] = bbox.GetRight();
+            rect.m_max[2] = bbox.GetBottom();
+
+            entries.emplace_back( rect, item );
+        }
+
+        m_tree->BulkLoad( entries );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attempting
@@ -142,7 +142,9 @@ bool DRC_CACHE_GENERATOR::Run()
                 if( !m_board->m_CopperItemRTreeCache )
                     m_board->m_CopperItemRTreeCache = std::make_shared<DRC_RTREE>();
 
+                m_board->m_CopperItemRTreeCache->BeginBulkLoad();
                 forEachGeometryItem( itemTypes, LSET::AllCuMask(), addToCopperTree );
+                m_board->m_CopperItemRTreeCache->EndBulkLoad();
             } );
 
     std::future_status status = retn.wait_for( std::chrono::milliseconds( 250 ) );
@@ -179,12 +181,16 @@ bool DRC_CACHE_GENERATOR::Run()
                 {
                    std::unique_ptr<DRC_RTREE> rtree = std::make_unique<DRC_RTREE>();
 
+                   rtree->BeginBulkLoad();
+
                    for( PCB_LAYER_ID layer : aZone->GetLayerSet().Seq() )
                    {
                        if( IsCopperLayer( layer ) )
                            rtree->Insert( aZone, layer );
                    }
 
+                   rtree->EndBulkLoad();
+
                    {
                        std::unique_lock<std::shared_mutex> writeLock( m_board->m_CachesMutex );
                        m_board->m_CopperZoneRTreeCache[ aZone ] = std::move( rtree );
@@ -28,11 +28,15 @@
 #include <board_item.h>
 #include <pad.h>
 #include <pcb_text.h>
+#include <algorithm>
+#include <future>
+#include <map>
 #include <memory>
 #include <unordered_set>
 #include <set>
 #include <vector>
 
+#include <core/thread_pool.h>
 #include <geometry/rtree.h>
 #include <geometry/shape.h>
 #include <geometry/shape_segment.h>
@@ -85,6 +89,7 @@ public:
             m_tree[layer] = new drc_rtree();
 
         m_count = 0;
+        m_bulkLoading = false;
     }
 
     ~DRC_RTREE()
@@ -96,6 +101,8 @@ public:
 
             delete tree;
         }
+
+        clearPending();
     }
 
     /**
@@ -138,12 +145,7 @@ public:
 
             bbox.Inflate( aWorstClearance );
 
-            const int        mmin[2] = { bbox.GetX(), bbox.GetY() };
-            const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
-            ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, subshape, shape );
-
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+            insert( aTargetLayer, bbox, new ITEM_WITH_SHAPE( aItem, subshape, shape ) );
         }
 
         if( aItem->Type() == PCB_PAD_T && aItem->HasHole() )
@@ -153,14 +155,27 @@ public:
 
             bbox.Inflate( aWorstClearance );
 
-            const int        mmin[2] = { bbox.GetX(), bbox.GetY() };
-            const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
-            ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, hole, shape );
+            insert( aTargetLayer, bbox, new ITEM_WITH_SHAPE( aItem, hole, shape ) );
+        }
+    }
+
+    /**
+     * Queue the items given to Insert() until EndBulkLoad(), which packs them into the trees all
+     * at once.  This is much faster than building the trees one item at a time and gives better
+     * packed trees.  The tree must not be queried in between.
+     */
+    void BeginBulkLoad()
+    {
+        m_bulkLoading = true;
+    }
 
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+    void EndBulkLoad()
+    {
+        for( auto& [ layer, entries ] : m_pending )
+            m_tree[layer]->BulkLoad( entries );
 
-        }
+        m_pending.clear();
+        m_bulkLoading = false;
     }
 
     /**
@@ -171,6 +186,7 @@ public:
         for( auto tree : m_tree )
             tree->RemoveAll();
 
+        clearPending();
         m_count = 0;
     }
 
@@ -437,41 +453,55 @@ public:
         ITEM_WITH_SHAPE* testItem;
     };
 
-    int QueryCollidingPairs( DRC_RTREE* aRefTree, std::vector<LAYER_PAIR> aLayerPairs,
-                             std::function<bool( const LAYER_PAIR&, ITEM_WITH_SHAPE*,
-                                                 ITEM_WITH_SHAPE*, bool* aCollision )> aVisitor,
-                             int aMaxClearance,
-                             std::function<bool(int, int )> aProgressReporter ) const
+    /**
+     * Gather the pairs of items from \a aRefTree and this tree, on each of \a aLayerPairs, whose
+     * bounding boxes are within \a aMaxClearance of each other.  Pairs of shapes belonging to the
+     * same item are skipped.
+     *
+     * Each layer pair is handled as a single sweep-and-prune join of the two layer trees (rather
+     * than one tree search per reference item), and the layer pairs are processed in parallel.
+     * The pairs come in a stable order: by layer pair, then by reference item and then by test
+     * item, both in tree order.
+     */
+    std::vector<PAIR_INFO> QueryCandidatePairs( DRC_RTREE* aRefTree,
+                                                const std::vector<LAYER_PAIR>& aLayerPairs,
+                                                int aMaxClearance ) const
     {
-        std::vector<PAIR_INFO> pairsToVisit;
+        thread_pool&                                     tp = GetKiCadThreadPool();
+        std::vector<std::future<std::vector<PAIR_INFO>>> returns;
 
-        for( LAYER_PAIR& layerPair : aLayerPairs )
-        {
-            const PCB_LAYER_ID refLayer = layerPair.first;
-            const PCB_LAYER_ID targetLayer = layerPair.second;
+        returns.reserve( aLayerPairs.size() );
 
-            for( ITEM_WITH_SHAPE* refItem : aRefTree->OnLayer( refLayer ) )
-            {
-                BOX2I box = refItem->shape->BBox();
-                box.Inflate( aMaxClearance );
+        for( const LAYER_PAIR& layerPair : aLayerPairs )
+        {
+            returns.emplace_back( tp.submit(
+                    [this, aRefTree, layerPair, aMaxClearance]()
+                    {
+                        return sweepLayerPair( aRefTree->m_tree[layerPair.first],
+                                               m_tree[layerPair.second], layerPair,
+                                               aMaxClearance );
+                    } ) );
+        }
 
-                int min[2] = { box.GetX(),     box.GetY() };
-                int max[2] = { box.GetRight(), box.GetBottom() };
+        std::vector<PAIR_INFO> pairs;
 
-                auto visit =
-                        [&]( ITEM_WITH_SHAPE* aItemToTest ) -> bool
-                        {
-                            // don't collide items against themselves
-                            if( aItemToTest->parent == refItem->parent )
-                                return true;
+        for( std::future<std::vector<PAIR_INFO>>& ret : returns )
+        {
+            std::vector<PAIR_INFO> layerPairPairs = ret.get();
+            pairs.insert( pairs.end(), layerPairPairs.begin(), layerPairPairs.end() );
+        }
 
-                            pairsToVisit.emplace_back( layerPair, refItem, aItemToTest );
-                            return true;
-                        };
+        return pairs;
+    }
 
-                this->m_tree[targetLayer]->Search( min, max, visit );
-            };
-        }
+    int QueryCollidingPairs( DRC_RTREE* aRefTree, std::vector<LAYER_PAIR> aLayerPairs,
+                             std::function<bool( const LAYER_PAIR&, ITEM_WITH_SHAPE*,
+                                                 ITEM_WITH_SHAPE*, bool* aCollision )> aVisitor,
+                             int aMaxClearance,
+                             std::function<bool(int, int )> aProgressReporter ) const
+    {
+        std::vector<PAIR_INFO> pairsToVisit = QueryCandidatePairs( aRefTree, aLayerPairs,
+                                                                   aMaxClearance );
 
         // keep track of BOARD_ITEMs pairs that have been already found to collide (some items
         // might be build of COMPOUND/triangulated shapes and a single subshape collision
@@ -580,8 +610,162 @@ public:
 
 
 private:
+    void insert( PCB_LAYER_ID aLayer, const BOX2I& aBox, ITEM_WITH_SHAPE* aItemShape )
+    {
+        drc_rtree::Rect rect;
+
+        rect.m_min[0] = aBox.GetX();
+        rect.m_min[1] = aBox.GetY();
+        rect.m_max[0] = aBox.GetRight();
+        rect.m_max[1] = aBox.GetBottom();
+
+        if( m_bulkLoading )
+            m_pending[aLayer].emplace_back( rect, aItemShape );
+        else
+            m_tree[aLayer]->Insert( rect.m_min, rect.m_max, aItemShape );
+
+        m_count++;
+    }
+
+    void clearPending()
+    {
+        for( auto& [ layer, entries ] : m_pending )
+        {
+            for( const auto& [ rect, itemShape ] : entries )
+                delete itemShape;
+        }
+
+        m_pending.clear();
+    }
+
+    struct SWEEP_ENTRY
+    {
+        int              m_MinX;
+        int              m_MinY;
+        int              m_MaxX;
+        int              m_MaxY;
+        ITEM_WITH_SHAPE* m_Item;
+        size_t           m_Order;     ///< Position in tree order
+    };
+
+    /**
+     * Collect the entries of \a aTree with their bounding boxes, sorted by their left edge.
+     *
+     * @param aRefInflate if non-negative, use the bounding boxes of the shapes themselves inflated
+     *                    by this amount (as for the reference box of a tree search) instead of the
+     *                    boxes stored in the tree.
+     */
+    static std::vector<SWEEP_ENTRY> sweepEntries( drc_rtree* aTree, int aRefInflate )
+    {
+        std::vector<SWEEP_ENTRY> entries;
+
+        for( auto it = aTree->begin(); it != aTree->end(); ++it )
+        {
+            int min[2];
+            int max[2];
+
+            if( aRefInflate >= 0 )
+            {
+                BOX2I box = ( *it )->shape->BBox();
+                box.Inflate( aRefInflate );
+
+                min[0] = box.GetX();
+                min[1] = box.GetY();
+                max[0] = box.GetRight();
+                max[1] = box.GetBottom();
+            }
+            else
+            {
+                it.GetBounds( min, max );
+            }
+
+            entries.push_back( { min[0], min[1], max[0], max[1], *it, entries.size() } );
+        }
+
+        std::sort( entries.begin(), entries.end(),
+                   []( const SWEEP_ENTRY& a, const SWEEP_ENTRY& b )
+                   {
+                       return a.m_MinX < b.m_MinX;
+                   } );
+
+        return entries;
+    }
+
+    /**
+     * Sweep-and-prune join of the reference layer tree \a aRefTree against \a aTestTree.  Boxes
+     * overlap under the same (inclusive) rules as RTree::Search().
+     */
+    static std::vector<PAIR_INFO> sweepLayerPair( drc_rtree* aRefTree, drc_rtree* aTestTree,
+                                                  const LAYER_PAIR& aLayerPair,
+                                                  int aMaxClearance )
+    {
+        std::vector<SWEEP_ENTRY> refs = sweepEntries( aRefTree, std::max( 0, aMaxClearance ) );
+        std::vector<SWEEP_ENTRY> tests = sweepEntries( aTestTree, -1 );
+
+        std::vector<std::pair<const SWEEP_ENTRY*, const SWEEP_ENTRY*>> hits;
+
+        auto check =
+                [&]( const SWEEP_ENTRY& aRef, const SWEEP_ENTRY& aTest )
+                {
+                    if( aRef.m_MinY <= aTest.m_MaxY && aTest.m_MinY <= aRef.m_MaxY
+                            && aRef.m_Item->parent != aTest.m_Item->parent )
+                    {
+                        hits.emplace_back( &aRef, &aTest );
+                    }
+                };
+
+        size_t ii = 0;
+        size_t jj = 0;
+
+        // Each pair overlapping along x is found exactly once: from whichever of the two boxes
+        // starts first.
+        while( ii < refs.size() && jj < tests.size() )
+        {
+            if( refs[ii].m_MinX <= tests[jj].m_MinX )
+            {
+                for( size_t kk = jj; kk < tests.size() && tests[kk].m_MinX <= refs[ii].m_MaxX;
+                     ++kk )
+                {
+                    check( refs[ii], tests[kk] );
+                }
+
+                ++ii;
+            }
+            else
+            {
+                for( size_t kk = ii; kk < refs.size() && refs[kk].m_MinX <= tests[jj].m_MaxX;
+                     ++kk )
+                {
+                    check( refs[kk], tests[jj] );
+                }
+
+                ++jj;
+            }
+        }
+
+        std::sort( hits.begin(), hits.end(),
+                   []( const auto& a, const auto& b )
+                   {
+                       if( a.first->m_Order != b.first->m_Order )
+                           return a.first->m_Order < b.first->m_Order;
+
+                       return a.second->m_Order < b.second->m_Order;
+                   } );
+
+        std::vector<PAIR_INFO> pairs;
+        pairs.reserve( hits.size() );
+
+        for( const auto& [ref, test] : hits )
+            pairs.emplace_back( aLayerPair, ref->m_Item, test->m_Item );
+
+        return pairs;
+    }
+
     drc_rtree*  m_tree[PCB_LAYER_ID_COUNT];
     size_t      m_count;
+
+    bool        m_bulkLoading;
+    std::map<PCB_LAYER_ID, std::vector<std::pair<drc_rtree::Rect, ITEM_WITH_SHAPE*>>> m_pending;
 };
 
 
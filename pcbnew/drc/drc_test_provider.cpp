@@ -29,6 +29,10 @@
 #include <pad.h>
 #include <zone.h>
 #include <pcb_text.h>
+#include <core/thread_pool.h>
+
+#include <atomic>
+#include <future>
 
 
 // A list of all basic (ie: non-compound) board geometry items
@@ -84,6 +88,84 @@ void DRC_TEST_PROVIDER::reportViolation( std::shared_ptr<DRC_ITEM>& item,
 }
 
 
+void DRC_TEST_PROVIDER::reportViolations( DRC_VIOLATION_BUFFER& aBuffer )
+{
+    for( DRC_VIOLATION_BUFFER::VIOLATION& violation : aBuffer.m_violations )
+    {
+        // The loop which found these couldn't see the error limits being used up
+        if( m_drcEngine->IsErrorLimitExceeded( violation.m_Item->GetErrorCode() ) )
+            continue;
+
+        reportViolation( violation.m_Item, violation.m_MarkerPos, violation.m_MarkerLayer );
+    }
+
+    aBuffer.m_violations.clear();
+}
+
+
+bool DRC_TEST_PROVIDER::forEachParallel(
+        size_t aCount, const std::function<void( size_t, DRC_VIOLATION_BUFFER& )>& aFunc )
+{
+    if( aCount == 0 )
+        return !m_drcEngine->IsCancelled();
+
+    thread_pool& tp = GetKiCadThreadPool();
+    size_t       threadCount = std::max<size_t>( 1, tp.get_thread_count() );
+
+    // Small blocks handed out on demand keep the threads busy even when the cost of the items
+    // varies a lot (such as in triangular item-against-later-items loops).
+    size_t blockSize = std::max<size_t>( 1, aCount / ( threadCount * 16 ) );
+    size_t blockCount = ( aCount + blockSize - 1 ) / blockSize;
+
+    std::vector<DRC_VIOLATION_BUFFER> buffers( blockCount );
+    std::atomic<size_t>               nextBlock( 0 );
+    std::atomic<size_t>               done( 0 );
+
+    auto worker =
+            [&]()
+            {
+                for( size_t block = nextBlock++; block < blockCount; block = nextBlock++ )
+                {
+                    size_t first = block * blockSize;
+                    size_t last = std::min( aCount, first + blockSize );
+
+                    for( size_t ii = first; ii < last; ++ii )
+                    {
+                        if( m_drcEngine->IsCancelled() )
+                            return;
+
+                        aFunc( ii, buffers[block] );
+                        done.fetch_add( 1 );
+                    }
+                }
+            };
+
+    std::vector<std::future<void>> returns;
+
+    for( size_t ii = 0; ii < std::min( threadCount, blockCount ); ++ii )
+        returns.emplace_back( tp.submit( worker ) );
+
+    for( const std::future<void>& ret : returns )
+    {
+        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+
+        while( status != std::future_status::ready )
+        {
+            reportProgress( done, aCount );
+            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+        }
+    }
+
+    if( m_drcEngine->IsCancelled() )
+        return false;
+
+    for( DRC_VIOLATION_BUFFER& buffer : buffers )
+        reportViolations( buffer );
+
+    return true;
+}
+
+
 bool DRC_TEST_PROVIDER::reportProgress( size_t aCount, size_t aSize, size_t aDelta )
 {
     if( ( aCount % aDelta ) == 0 || aCount == aSize -  1 )
@@ -29,12 +29,15 @@
 #include <pcb_marker.h>
 
 #include <functional>
+#include <memory>
 #include <set>
+#include <vector>
 
 class DRC_ENGINE;
 class DRC_TEST_PROVIDER;
 class DRC_RULE;
 class DRC_CONSTRAINT;
+class DRC_ITEM;
 
 class DRC_TEST_PROVIDER_REGISTRY
 {
@@ -67,6 +70,38 @@ public:
 };
 
 
+/**
+ * Violations found by one block of a parallel item loop (see
+ * DRC_TEST_PROVIDER::forEachParallel()).
+ *
+ * They are held back until the whole loop is done and then reported block by block, so that
+ * the order of the reports does not depend on thread scheduling.
+ */
+class DRC_VIOLATION_BUFFER
+{
+public:
+    void Add( const std::shared_ptr<DRC_ITEM>& aItem, const VECTOR2I& aMarkerPos,
+              int aMarkerLayer )
+    {
+        m_violations.push_back( { aItem, aMarkerPos, aMarkerLayer } );
+    }
+
+    bool Empty() const { return m_violations.empty(); }
+
+private:
+    friend class DRC_TEST_PROVIDER;
+
+    struct VIOLATION
+    {
+        std::shared_ptr<DRC_ITEM> m_Item;
+        VECTOR2I                  m_MarkerPos;
+        int                       m_MarkerLayer;
+    };
+
+    std::vector<VIOLATION> m_violations;
+};
+
+
 /**
  * Represent a DRC "provider" which runs some DRC functions over a #BOARD and spits out
  * #DRC_ITEM and positions as needed.
@@ -103,6 +138,20 @@ protected:
     int forEachGeometryItem( const std::vector<KICAD_T>& aTypes, LSET aLayers,
                              const std::function<bool(BOARD_ITEM*)>& aFunc );
 
+    /**
+     * Call \a aFunc for each index in [0, aCount) from the KiCad thread pool.
+     *
+     * Indices are handed out to the threads in small blocks, each with its own violation buffer.
+     * Once all blocks are done the buffers are reported in index order, skipping violations
+     * whose error limit has been reached, so the results are the same as for a sequential loop.
+     * \a aFunc must therefore not call reportViolation() itself, and must be safe to run
+     * concurrently with itself.
+     *
+     * @return false if DRC was cancelled.
+     */
+    bool forEachParallel( size_t aCount,
+                          const std::function<void( size_t, DRC_VIOLATION_BUFFER& )>& aFunc );
+
     // Do not use a wxString with a vararg list: it is a complex thing and can create issues.
     // So prefer using a wxChar* item in this case:
     void reportAux( const wxString& aMsg ) { reportAux( (const wxChar*) aMsg.wchar_str() ); }
@@ -110,6 +159,11 @@ protected:
 
     virtual void reportViolation( std::shared_ptr<DRC_ITEM>& item, const VECTOR2I& aMarkerPos,
                                   int aMarkerLayer );
+
+    /**
+     * Report the violations held in \a aBuffer, in the order they were added, and clear it.
+     */
+    void reportViolations( DRC_VIOLATION_BUFFER& aBuffer );
     virtual bool reportProgress( size_t aCount, size_t aSize, size_t aDelta = 1 );
     virtual bool reportPhase( const wxString& aStageName );
 
@@ -77,8 +77,6 @@ bool DRC_TEST_PROVIDER_ANNULAR_WIDTH::Run()
         return true;    // continue with other tests
     }
 
-    const int progressDelta = 500;
-
     if( !m_drcEngine->HasRulesForConstraintType( ANNULAR_WIDTH_CONSTRAINT ) )
     {
         reportAux( wxT( "No annular width constraints found. Tests not run." ) );
@@ -90,55 +88,11 @@ bool DRC_TEST_PROVIDER_ANNULAR_WIDTH::Run()
 
     int maxError = m_drcEngine->GetBoard()->GetDesignSettings().m_MaxError;
 
-    auto calcEffort =
-            []( BOARD_ITEM* item )
-            {
-                switch( item->Type() )
-                {
-                case PCB_VIA_T:
-                    return 1;
-
-                case PCB_PAD_T:
-                {
-                    PAD* pad = static_cast<PAD*>( item );
-
-                    if( !pad->HasHole() || pad->GetAttribute() != PAD_ATTRIB::PTH )
-                        return 0;
-
-                    if( pad->GetOffset() == VECTOR2I( 0, 0 ) )
-                    {
-                        switch( pad->GetShape() )
-                        {
-                        case PAD_SHAPE::CHAMFERED_RECT:
-                            if( pad->GetChamferRectRatio() > 0.30 )
-                                break;
-
-                            KI_FALLTHROUGH;
-
-                        case PAD_SHAPE::CIRCLE:
-                        case PAD_SHAPE::OVAL:
-                        case PAD_SHAPE::RECTANGLE:
-                        case PAD_SHAPE::ROUNDRECT:
-                            return 1;
-
-                        default:
-                            break;
-                        }
-                    }
-
-                    return 5;
-                }
-
-                default:
-                    return 0;
-                }
-            };
-
     auto checkAnnularWidth =
-            [&]( BOARD_ITEM* item ) -> bool
+            [&]( BOARD_ITEM* item, DRC_VIOLATION_BUFFER& aViolations )
             {
                 if( m_drcEngine->IsErrorLimitExceeded( DRCE_ANNULAR_WIDTH ) )
-                    return false;
+                    return;
 
                 int annularWidth = 0;
 
@@ -157,7 +111,7 @@ bool DRC_TEST_PROVIDER_ANNULAR_WIDTH::Run()
                     bool handled = false;
 
                     if( !pad->HasHole() || pad->GetAttribute() != PAD_ATTRIB::PTH )
-                        return true;
+                        return;
 
                     if( pad->GetOffset() == VECTOR2I( 0, 0 ) )
                     {
@@ -212,7 +166,7 @@ bool DRC_TEST_PROVIDER_ANNULAR_WIDTH::Run()
                 }
 
                 default:
-                    return true;
+                    return;
                 }
 
                 // PADSTACKS TODO: once we have padstacks we'll need to run this per-layer....
@@ -224,7 +178,7 @@ bool DRC_TEST_PROVIDER_ANNULAR_WIDTH::Run()
                 bool fail_max = false;
 
                 if( constraint.GetSeverity() == RPT_SEVERITY_IGNORE )
-                    return true;
+                    return;
 
                 if( constraint.Value().HasMin() )
                 {
@@ -263,50 +217,34 @@ bool DRC_TEST_PROVIDER_ANNULAR_WIDTH::Run()
                     drcItem->SetItems( item );
                     drcItem->SetViolatingRule( constraint.GetParentRule() );
 
-                    reportViolation( drcItem, item->GetPosition(), item->GetLayer() );
+                    aViolations.Add( drcItem, item->GetPosition(), item->GetLayer() );
                 }
-
-                return true;
             };
 
-    BOARD* board = m_drcEngine->GetBoard();
-    size_t ii = 0;
-    size_t total = 0;
+    BOARD*                   board = m_drcEngine->GetBoard();
+    std::vector<BOARD_ITEM*> items;
 
     for( PCB_TRACK* item : board->Tracks() )
-        total += calcEffort( item );
-
-    for( FOOTPRINT* footprint : board->Footprints() )
     {
-        for( PAD* pad : footprint->Pads() )
-            total += calcEffort( pad );
-    }
-
-    for( PCB_TRACK* item : board->Tracks() )
-    {
-        ii += calcEffort( item );
-
-        if( !reportProgress( ii, total, progressDelta ) )
-            return false;   // DRC cancelled
-
-        if( !checkAnnularWidth( item ) )
-            break;
+        if( item->Type() == PCB_VIA_T )
+            items.push_back( item );
     }
 
     for( FOOTPRINT* footprint : board->Footprints() )
     {
         for( PAD* pad : footprint->Pads() )
         {
-            ii += calcEffort( pad );
-
-            if( !reportProgress( ii, total, progressDelta ) )
-                return false;   // DRC cancelled
-
-            if( !checkAnnularWidth( pad ) )
-                break;
+            if( pad->HasHole() && pad->GetAttribute() == PAD_ATTRIB::PTH )
+                items.push_back( pad );
         }
     }
 
+    forEachParallel( items.size(),
+            [&]( size_t ii, DRC_VIOLATION_BUFFER& aViolations )
+            {
+                checkAnnularWidth( items[ii], aViolations );
+            } );
+
     reportRuleStatistics();
 
     return !m_drcEngine->IsCancelled();
@@ -30,6 +30,9 @@
 #include <drc/drc_test_provider_clearance_base.h>
 #include <footprint.h>
 
+#include <algorithm>
+#include <numeric>
+
 /*
     Couartyard clearance. Tests for malformed component courtyards and overlapping footprints.
     Generated errors:
@@ -71,6 +74,13 @@ private:
 
     bool testCourtyardClearances();
 
+    /**
+     * Test the footprint at \a aIndex against the footprints in \a aCandidates, all of which
+     * follow it on the board.
+     */
+    void testFootprintAgainstLaterOnes( size_t aIndex, const std::vector<size_t>& aCandidates,
+                                        DRC_VIOLATION_BUFFER& aViolations );
+
 private:
     int  m_largestCourtyardClearance;
 };
@@ -96,80 +106,87 @@ bool DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testFootprintCourtyardDefinitions()
         return true;        // continue with other tests
     }
 
-    const int progressDelta = 500;
-    int       ii = 0;
+    const FOOTPRINTS& footprints = m_board->Footprints();
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
-    {
-        if( !reportProgress( ii++, m_board->Footprints().size(), progressDelta ) )
-            return false;   // DRC cancelled
-
-        if( ( footprint->GetFlags() & MALFORMED_COURTYARDS ) != 0 )
-        {
-            if( m_drcEngine->IsErrorLimitExceeded( DRCE_MALFORMED_COURTYARD) )
-                continue;
+    // Each footprint only touches its own courtyard caches, so they can be built in parallel
+    return forEachParallel( footprints.size(),
+            [&]( size_t ii, DRC_VIOLATION_BUFFER& aViolations )
+            {
+                FOOTPRINT* footprint = footprints[ii];
 
-            OUTLINE_ERROR_HANDLER errorHandler =
-                    [&]( const wxString& msg, BOARD_ITEM*, BOARD_ITEM*, const VECTOR2I& pt )
-                    {
-                        std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_MALFORMED_COURTYARD );
-                        drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " ) + msg );
-                        drcItem->SetItems( footprint );
-                        reportViolation( drcItem, pt, UNDEFINED_LAYER );
-                    };
-
-            // Re-run courtyard tests to generate DRC_ITEMs
-            footprint->BuildCourtyardCaches( &errorHandler );
-        }
-        else if( footprint->GetCourtyard( F_CrtYd ).OutlineCount() == 0
-                && footprint->GetCourtyard( B_CrtYd ).OutlineCount() == 0 )
-        {
-            if( m_drcEngine->IsErrorLimitExceeded( DRCE_MISSING_COURTYARD ) )
-                continue;
+                if( ( footprint->GetFlags() & MALFORMED_COURTYARDS ) != 0 )
+                {
+                    if( m_drcEngine->IsErrorLimitExceeded( DRCE_MALFORMED_COURTYARD) )
+                        return;
 
-            if( footprint->GetAttributes() & FP_ALLOW_MISSING_COURTYARD )
-                continue;
+                    OUTLINE_ERROR_HANDLER errorHandler =
+                            [&]( const wxString& msg, BOARD_ITEM*, BOARD_ITEM*,
+                                 const VECTOR2I& pt )
+                            {
+                                std::shared_ptr<DRC_ITEM> drcItem =
+                                        DRC_ITEM::Create( DRCE_MALFORMED_COURTYARD );
+                                drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " )
+                                                          + msg );
+                                drcItem->SetItems( footprint );
+                                aViolations.Add( drcItem, pt, UNDEFINED_LAYER );
+                            };
+
+                    // Re-run courtyard tests to generate DRC_ITEMs
+                    footprint->BuildCourtyardCaches( &errorHandler );
+                }
+                else if( footprint->GetCourtyard( F_CrtYd ).OutlineCount() == 0
+                        && footprint->GetCourtyard( B_CrtYd ).OutlineCount() == 0 )
+                {
+                    if( m_drcEngine->IsErrorLimitExceeded( DRCE_MISSING_COURTYARD ) )
+                        return;
 
-            std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_MISSING_COURTYARD );
-            drcItem->SetItems( footprint );
-            reportViolation( drcItem, footprint->GetPosition(), UNDEFINED_LAYER );
-        }
-        else
-        {
-            footprint->GetCourtyard( F_CrtYd ).BuildBBoxCaches();
-            footprint->GetCourtyard( B_CrtYd ).BuildBBoxCaches();
-        }
-    }
+                    if( footprint->GetAttributes() & FP_ALLOW_MISSING_COURTYARD )
+                        return;
 
-    return !m_drcEngine->IsCancelled();
+                    std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_MISSING_COURTYARD );
+                    drcItem->SetItems( footprint );
+                    aViolations.Add( drcItem, footprint->GetPosition(), UNDEFINED_LAYER );
+                }
+                else
+                {
+                    footprint->GetCourtyard( F_CrtYd ).BuildBBoxCaches();
+                    footprint->GetCourtyard( B_CrtYd ).BuildBBoxCaches();
+                }
+            } );
 }
 
 
-bool DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testCourtyardClearances()
+void DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testFootprintAgainstLaterOnes(
+        size_t aIndex, const std::vector<size_t>& aCandidates, DRC_VIOLATION_BUFFER& aViolations )
 {
-    if( !reportPhase( _( "Checking footprints for overlapping courtyards..." ) ) )
-        return false;   // DRC cancelled
+    const FOOTPRINTS&     footprints = m_board->Footprints();
+    FOOTPRINT*            fpA = footprints[aIndex];
+    const SHAPE_POLY_SET& frontA = fpA->GetCourtyard( F_CrtYd );
+    const SHAPE_POLY_SET& backA = fpA->GetCourtyard( B_CrtYd );
+
+    if( frontA.OutlineCount() == 0 && backA.OutlineCount() == 0
+         && m_drcEngine->IsErrorLimitExceeded( DRCE_PTH_IN_COURTYARD )
+         && m_drcEngine->IsErrorLimitExceeded( DRCE_NPTH_IN_COURTYARD ) )
+    {
+        // No courtyards defined and no hole testing against other footprint's courtyards
+        return;
+    }
 
-    const int progressDelta = 100;
-    int       ii = 0;
+    BOX2I frontA_worstCaseBBox = frontA.BBoxFromCaches();
+    BOX2I backA_worstCaseBBox = backA.BBoxFromCaches();
 
-    for( auto itA = m_board->Footprints().begin(); itA != m_board->Footprints().end(); itA++ )
-    {
-        if( !reportProgress( ii++, m_board->Footprints().size(), progressDelta ) )
-            return false;   // DRC cancelled
+    frontA_worstCaseBBox.Inflate( m_largestCourtyardClearance );
+    backA_worstCaseBBox.Inflate( m_largestCourtyardClearance );
 
-        if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_FOOTPRINTS)
-            && m_drcEngine->IsErrorLimitExceeded( DRCE_PTH_IN_COURTYARD )
-            && m_drcEngine->IsErrorLimitExceeded( DRCE_NPTH_IN_COURTYARD ) )
-        {
-            return true;   // continue with other tests
-        }
+    BOX2I fpA_bbox = fpA->GetBoundingBox();
 
-        FOOTPRINT*            fpA = *itA;
-        const SHAPE_POLY_SET& frontA = fpA->GetCourtyard( F_CrtYd );
-        const SHAPE_POLY_SET& backA = fpA->GetCourtyard( B_CrtYd );
+    for( size_t ii : aCandidates )
+    {
+        FOOTPRINT*            fpB = footprints[ii];
+        const SHAPE_POLY_SET& frontB = fpB->GetCourtyard( F_CrtYd );
+        const SHAPE_POLY_SET& backB = fpB->GetCourtyard( B_CrtYd );
 
-        if( frontA.OutlineCount() == 0 && backA.OutlineCount() == 0
+        if( frontB.OutlineCount() == 0 && backB.OutlineCount() == 0
              && m_drcEngine->IsErrorLimitExceeded( DRCE_PTH_IN_COURTYARD )
              && m_drcEngine->IsErrorLimitExceeded( DRCE_NPTH_IN_COURTYARD ) )
         {
@@ -177,169 +194,226 @@ bool DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testCourtyardClearances()
             continue;
         }
 
-        BOX2I frontA_worstCaseBBox = frontA.BBoxFromCaches();
-        BOX2I backA_worstCaseBBox = backA.BBoxFromCaches();
+        BOX2I frontB_worstCaseBBox = frontB.BBoxFromCaches();
+        BOX2I backB_worstCaseBBox = backB.BBoxFromCaches();
 
-        frontA_worstCaseBBox.Inflate( m_largestCourtyardClearance );
-        backA_worstCaseBBox.Inflate( m_largestCourtyardClearance );
+        frontB_worstCaseBBox.Inflate( m_largestCourtyardClearance );
+        backB_worstCaseBBox.Inflate( m_largestCourtyardClearance );
 
-        BOX2I fpA_bbox = fpA->GetBoundingBox();
+        BOX2I          fpB_bbox = fpB->GetBoundingBox();
+        DRC_CONSTRAINT constraint;
+        int            clearance;
+        int            actual;
+        VECTOR2I       pos;
 
-        for( auto itB = itA + 1; itB != m_board->Footprints().end(); itB++ )
+        //
+        // Check courtyard-to-courtyard collisions on front of board.
+        //
+
+        if( frontA.OutlineCount() > 0 && frontB.OutlineCount() > 0
+                && frontA_worstCaseBBox.Intersects( frontB.BBoxFromCaches() ) )
         {
-            FOOTPRINT*            fpB = *itB;
-            const SHAPE_POLY_SET& frontB = fpB->GetCourtyard( F_CrtYd );
-            const SHAPE_POLY_SET& backB = fpB->GetCourtyard( B_CrtYd );
+            constraint = m_drcEngine->EvalRules( COURTYARD_CLEARANCE_CONSTRAINT, fpA, fpB, F_Cu );
+            clearance = constraint.GetValue().Min();
 
-            if( frontB.OutlineCount() == 0 && backB.OutlineCount() == 0
-                 && m_drcEngine->IsErrorLimitExceeded( DRCE_PTH_IN_COURTYARD )
-                 && m_drcEngine->IsErrorLimitExceeded( DRCE_NPTH_IN_COURTYARD ) )
+            if( constraint.GetSeverity() != RPT_SEVERITY_IGNORE && clearance >= 0 )
             {
-                // No courtyards defined and no hole testing against other footprint's courtyards
-                continue;
-            }
+                if( frontA.Collide( &frontB, clearance, &actual, &pos ) )
+                {
+                    auto drce = DRC_ITEM::Create( DRCE_OVERLAPPING_FOOTPRINTS );
 
-            BOX2I frontB_worstCaseBBox = frontB.BBoxFromCaches();
-            BOX2I backB_worstCaseBBox = backB.BBoxFromCaches();
+                    if( clearance > 0 )
+                    {
+                        wxString msg = formatMsg( _( "(%s clearance %s; actual %s)" ),
+                                                  constraint.GetName(),
+                                                  clearance,
+                                                  actual );
+
+                        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
+                    }
 
-            frontB_worstCaseBBox.Inflate( m_largestCourtyardClearance );
-            backB_worstCaseBBox.Inflate( m_largestCourtyardClearance );
+                    drce->SetViolatingRule( constraint.GetParentRule() );
+                    drce->SetItems( fpA, fpB );
+                    aViolations.Add( drce, pos, F_CrtYd );
+                }
+            }
+        }
 
-            BOX2I          fpB_bbox = fpB->GetBoundingBox();
-            DRC_CONSTRAINT constraint;
-            int            clearance;
-            int            actual;
-            VECTOR2I       pos;
+        //
+        // Check courtyard-to-courtyard collisions on back of board.
+        //
 
-            //
-            // Check courtyard-to-courtyard collisions on front of board.
-            //
+        if( backA.OutlineCount() > 0 && backB.OutlineCount() > 0
+                && backA_worstCaseBBox.Intersects( backB.BBoxFromCaches() ) )
+        {
+            constraint = m_drcEngine->EvalRules( COURTYARD_CLEARANCE_CONSTRAINT, fpA, fpB, B_Cu );
+            clearance = constraint.GetValue().Min();
 
-            if( frontA.OutlineCount() > 0 && frontB.OutlineCount() > 0
-                    && frontA_worstCaseBBox.Intersects( frontB.BBoxFromCaches() ) )
+            if( constraint.GetSeverity() != RPT_SEVERITY_IGNORE && clearance >= 0 )
             {
-                constraint = m_drcEngine->EvalRules( COURTYARD_CLEARANCE_CONSTRAINT, fpA, fpB, F_Cu );
-                clearance = constraint.GetValue().Min();
-
-                if( constraint.GetSeverity() != RPT_SEVERITY_IGNORE && clearance >= 0 )
+                if( backA.Collide( &backB, clearance, &actual, &pos ) )
                 {
-                    if( frontA.Collide( &frontB, clearance, &actual, &pos ) )
-                    {
-                        auto drce = DRC_ITEM::Create( DRCE_OVERLAPPING_FOOTPRINTS );
+                    auto drce = DRC_ITEM::Create( DRCE_OVERLAPPING_FOOTPRINTS );
 
-                        if( clearance > 0 )
-                        {
-                            wxString msg = formatMsg( _( "(%s clearance %s; actual %s)" ),
-                                                      constraint.GetName(),
-                                                      clearance,
-                                                      actual );
-
-                            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
-                        }
+                    if( clearance > 0 )
+                    {
+                        wxString msg = formatMsg( _( "(%s clearance %s; actual %s)" ),
+                                                  constraint.GetName(),
+                                                  clearance,
+                                                  actual );
 
-                        drce->SetViolatingRule( constraint.GetParentRule() );
-                        drce->SetItems( fpA, fpB );
-                        reportViolation( drce, pos, F_CrtYd );
+                        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
                     }
+
+                    drce->SetViolatingRule( constraint.GetParentRule() );
+                    drce->SetItems( fpA, fpB );
+                    aViolations.Add( drce, pos, B_CrtYd );
                 }
             }
+        }
 
-            //
-            // Check courtyard-to-courtyard collisions on back of board.
-            //
-
-            if( backA.OutlineCount() > 0 && backB.OutlineCount() > 0
-                    && backA_worstCaseBBox.Intersects( backB.BBoxFromCaches() ) )
-            {
-                constraint = m_drcEngine->EvalRules( COURTYARD_CLEARANCE_CONSTRAINT, fpA, fpB, B_Cu );
-                clearance = constraint.GetValue().Min();
+        //
+        // Check pad-hole-to-courtyard collisions on front and back of board.
+        //
+        // NB: via holes are not checked.  There is a presumption that a physical object goes
+        // through a pad hole, which is not the case for via holes.
+        //
 
-                if( constraint.GetSeverity() != RPT_SEVERITY_IGNORE && clearance >= 0 )
+        auto testPadAgainstCourtyards =
+                [&]( const PAD* pad, const FOOTPRINT* fp )
                 {
-                    if( backA.Collide( &backB, clearance, &actual, &pos ) )
+                    int errorCode = 0;
+
+                    if( pad->GetAttribute() == PAD_ATTRIB::PTH )
+                        errorCode = DRCE_PTH_IN_COURTYARD;
+                    else if( pad->GetAttribute() == PAD_ATTRIB::NPTH )
+                        errorCode = DRCE_NPTH_IN_COURTYARD;
+                    else
+                        return;
+
+                    if( m_drcEngine->IsErrorLimitExceeded( errorCode ) )
+                        return;
+
+                    if( pad->HasHole() )
                     {
-                        auto drce = DRC_ITEM::Create( DRCE_OVERLAPPING_FOOTPRINTS );
+                        std::shared_ptr<SHAPE_SEGMENT> hole = pad->GetEffectiveHoleShape();
+                        const SHAPE_POLY_SET&          front = fp->GetCourtyard( F_CrtYd );
+                        const SHAPE_POLY_SET&          back = fp->GetCourtyard( B_CrtYd );
 
-                        if( clearance > 0 )
+                        if( front.OutlineCount() > 0 && front.Collide( hole.get(), 0 ) )
                         {
-                            wxString msg = formatMsg( _( "(%s clearance %s; actual %s)" ),
-                                                      constraint.GetName(),
-                                                      clearance,
-                                                      actual );
-
-                            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
+                            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( errorCode );
+                            drce->SetItems( pad, fp );
+                            aViolations.Add( drce, pad->GetPosition(), F_CrtYd );
+                        }
+                        else if( back.OutlineCount() > 0 && back.Collide( hole.get(), 0 ) )
+                        {
+                            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( errorCode );
+                            drce->SetItems( pad, fp );
+                            aViolations.Add( drce, pad->GetPosition(), B_CrtYd );
                         }
-
-                        drce->SetViolatingRule( constraint.GetParentRule() );
-                        drce->SetItems( fpA, fpB );
-                        reportViolation( drce, pos, B_CrtYd );
                     }
-                }
-            }
+                };
 
-            //
-            // Check pad-hole-to-courtyard collisions on front and back of board.
-            //
-            // NB: via holes are not checked.  There is a presumption that a physical object goes
-            // through a pad hole, which is not the case for via holes.
-            //
+        if( ( frontA.OutlineCount() > 0 && frontA_worstCaseBBox.Intersects( fpB_bbox ) )
+            || ( backA.OutlineCount() > 0 && backA_worstCaseBBox.Intersects( fpB_bbox ) ) )
+        {
+            for( const PAD* padB : fpB->Pads() )
+                testPadAgainstCourtyards( padB, fpA );
+        }
 
-            auto testPadAgainstCourtyards =
-                    [&]( const PAD* pad, const FOOTPRINT* fp )
-                    {
-                        int errorCode = 0;
+        if( ( frontB.OutlineCount() > 0 && frontB.BBoxFromCaches().Intersects( fpA_bbox ) )
+            || ( backB.OutlineCount() > 0 && backB.BBoxFromCaches().Intersects( fpA_bbox ) ) )
+        {
+            for( const PAD* padA : fpA->Pads() )
+                testPadAgainstCourtyards( padA, fpB );
+        }
 
-                        if( pad->GetAttribute() == PAD_ATTRIB::PTH )
-                            errorCode = DRCE_PTH_IN_COURTYARD;
-                        else if( pad->GetAttribute() == PAD_ATTRIB::NPTH )
-                            errorCode = DRCE_NPTH_IN_COURTYARD;
-                        else
-                            return;
+        if( m_drcEngine->IsCancelled() )
+            return;
+    }
+}
 
-                        if( m_drcEngine->IsErrorLimitExceeded( errorCode ) )
-                            return;
 
-                        if( pad->HasHole() )
-                        {
-                            std::shared_ptr<SHAPE_SEGMENT> hole = pad->GetEffectiveHoleShape();
-                            const SHAPE_POLY_SET&          front = fp->GetCourtyard( F_CrtYd );
-                            const SHAPE_POLY_SET&          back = fp->GetCourtyard( B_CrtYd );
+bool DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testCourtyardClearances()
+{
+    if( !reportPhase( _( "Checking footprints for overlapping courtyards..." ) ) )
+        return false;   // DRC cancelled
 
-                            if( front.OutlineCount() > 0 && front.Collide( hole.get(), 0 ) )
-                            {
-                                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( errorCode );
-                                drce->SetItems( pad, fp );
-                                reportViolation( drce, pad->GetPosition(), F_CrtYd );
-                            }
-                            else if( back.OutlineCount() > 0 && back.Collide( hole.get(), 0 ) )
-                            {
-                                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( errorCode );
-                                drce->SetItems( pad, fp );
-                                reportViolation( drce, pad->GetPosition(), B_CrtYd );
-                            }
-                        }
-                    };
+    if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_FOOTPRINTS)
+        && m_drcEngine->IsErrorLimitExceeded( DRCE_PTH_IN_COURTYARD )
+        && m_drcEngine->IsErrorLimitExceeded( DRCE_NPTH_IN_COURTYARD ) )
+    {
+        return true;   // continue with other tests
+    }
+
+    const FOOTPRINTS&  footprints = m_board->Footprints();
+    std::vector<BOX2I> boxes;
+
+    // Each footprint's courtyard and bounding box caches are read from several threads below,
+    // so make sure they're all up to date first.  While at it, gather a box which covers
+    // everything about the footprint that the tests below can hit.
+    for( FOOTPRINT* footprint : footprints )
+    {
+        BOX2I box = footprint->GetBoundingBox();
+
+        for( PCB_LAYER_ID layer : { F_CrtYd, B_CrtYd } )
+        {
+            const SHAPE_POLY_SET& courtyard = footprint->GetCourtyard( layer );
 
-            if( ( frontA.OutlineCount() > 0 && frontA_worstCaseBBox.Intersects( fpB_bbox ) )
-                || ( backA.OutlineCount() > 0 && backA_worstCaseBBox.Intersects( fpB_bbox ) ) )
+            if( courtyard.OutlineCount() > 0 )
             {
-                for( const PAD* padB : fpB->Pads() )
-                    testPadAgainstCourtyards( padB, fpA );
+                BOX2I courtyardBox = courtyard.BBoxFromCaches();
+                courtyardBox.Inflate( m_largestCourtyardClearance );
+                box.Merge( courtyardBox );
             }
+        }
+
+        boxes.push_back( box );
+    }
 
-            if( ( frontB.OutlineCount() > 0 && frontB.BBoxFromCaches().Intersects( fpA_bbox ) )
-                || ( backB.OutlineCount() > 0 && backB.BBoxFromCaches().Intersects( fpA_bbox ) ) )
+    // Sweep-and-prune over those boxes to find the pairs of footprints which need testing,
+    // rather than testing every footprint against every later one.
+    std::vector<size_t> order( footprints.size() );
+    std::iota( order.begin(), order.end(), 0 );
+
+    std::sort( order.begin(), order.end(),
+               [&]( size_t a, size_t b )
+               {
+                   return boxes[a].GetLeft() < boxes[b].GetLeft();
+               } );
+
+    std::vector<std::vector<size_t>> candidates( footprints.size() );
+
+    for( size_t ii = 0; ii < order.size(); ++ii )
+    {
+        const BOX2I& boxA = boxes[order[ii]];
+
+        for( size_t jj = ii + 1; jj < order.size(); ++jj )
+        {
+            const BOX2I& boxB = boxes[order[jj]];
+
+            if( boxB.GetLeft() > boxA.GetRight() )
+                break;
+
+            if( boxA.Intersects( boxB ) )
             {
-                for( const PAD* padA : fpA->Pads() )
-                    testPadAgainstCourtyards( padA, fpB );
-            }
+                size_t first = std::min( order[ii], order[jj] );
+                size_t second = std::max( order[ii], order[jj] );
 
-            if( m_drcEngine->IsCancelled() )
-                return false;
+                candidates[first].push_back( second );
+            }
         }
     }
 
-    return !m_drcEngine->IsCancelled();
+    for( std::vector<size_t>& list : candidates )
+        std::sort( list.begin(), list.end() );
+
+    return forEachParallel( footprints.size(),
+            [&]( size_t ii, DRC_VIOLATION_BUFFER& aViolations )
+            {
+                testFootprintAgainstLaterOnes( ii, candidates[ii], aViolations );
+            } );
 }
 
 
@@ -67,7 +67,8 @@ public:
 
 private:
     bool testAgainstEdge( BOARD_ITEM* item, SHAPE* itemShape, BOARD_ITEM* other,
-                          DRC_CONSTRAINT_T aConstraintType, PCB_DRC_CODE aErrorCode );
+                          DRC_CONSTRAINT_T aConstraintType, PCB_DRC_CODE aErrorCode,
+                          DRC_VIOLATION_BUFFER& aViolations );
 
 private:
     std::vector<PAD*> m_castellatedPads;
@@ -78,7 +79,8 @@ private:
 bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::testAgainstEdge( BOARD_ITEM* item, SHAPE* itemShape,
                                                         BOARD_ITEM* edge,
                                                         DRC_CONSTRAINT_T aConstraintType,
-                                                        PCB_DRC_CODE aErrorCode )
+                                                        PCB_DRC_CODE aErrorCode,
+                                                        DRC_VIOLATION_BUFFER& aViolations )
 {
     std::shared_ptr<SHAPE> shape;
 
@@ -126,7 +128,7 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::testAgainstEdge( BOARD_ITEM* item, SHAPE*
             drce->SetItems( edge->m_Uuid, item->m_Uuid );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, pos, Edge_Cuts );
+            aViolations.Add( drce, pos, Edge_Cuts );
 
             if( item->Type() == PCB_TRACE_T || item->Type() == PCB_ARC_T )
             {
@@ -267,31 +269,27 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
     /*
      * Test copper and silk items against the set of edges.
      */
-    const int progressDelta = 200;
-    int       count = 0;
-    int       ii = 0;
+    std::vector<BOARD_ITEM*> items;
 
     forEachGeometryItem( s_allBasicItemsButZones, LSET::AllLayersMask(),
             [&]( BOARD_ITEM *item ) -> bool
             {
-                count++;
+                items.push_back( item );
                 return true;
             } );
 
-    forEachGeometryItem( s_allBasicItemsButZones, LSET::AllLayersMask(),
-            [&]( BOARD_ITEM *item ) -> bool
+    forEachParallel( items.size(),
+            [&]( size_t ii, DRC_VIOLATION_BUFFER& aViolations )
             {
+                BOARD_ITEM* item = items[ii];
                 bool testCopper = !m_drcEngine->IsErrorLimitExceeded( DRCE_EDGE_CLEARANCE );
                 bool testSilk = !m_drcEngine->IsErrorLimitExceeded( DRCE_SILK_EDGE_CLEARANCE );
 
                 if( !testCopper && !testSilk )
-                    return false;       // All limits exceeded; we're done
-
-                if( !reportProgress( ii++, count, progressDelta ) )
-                    return false;       // DRC cancelled; we're done
+                    return;             // All limits exceeded; we're done
 
                 if( isInvisibleText( item ) )
-                    return true;        // Continue with other items
+                    return;             // Continue with other items
 
                 if( item->Type() == PCB_PAD_T )
                 {
@@ -300,7 +298,7 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
                     if( pad->GetProperty() == PAD_PROP::CASTELLATED
                         || pad->GetAttribute() == PAD_ATTRIB::CONN )
                     {
-                        return true;    // Continue with other items
+                        return;         // Continue with other items
                     }
                 }
 
@@ -315,7 +313,7 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
                                 {
                                     return testAgainstEdge( item, itemShape.get(), edge,
                                                             EDGE_CLEARANCE_CONSTRAINT,
-                                                            DRCE_EDGE_CLEARANCE );
+                                                            DRCE_EDGE_CLEARANCE, aViolations );
                                 },
                                 m_largestEdgeClearance );
                     }
@@ -327,7 +325,8 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
                                 {
                                     return testAgainstEdge( item, itemShape.get(), edge,
                                                             SILK_CLEARANCE_CONSTRAINT,
-                                                            DRCE_SILK_EDGE_CLEARANCE );
+                                                            DRCE_SILK_EDGE_CLEARANCE,
+                                                            aViolations );
                                 },
                                 m_largestEdgeClearance ) )
                         {
@@ -339,8 +338,6 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
                         }
                     }
                 }
-
-                return true;
             } );
 
     reportRuleStatistics();
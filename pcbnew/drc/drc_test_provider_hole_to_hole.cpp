@@ -68,7 +68,15 @@ public:
     }
 
 private:
-    bool testHoleAgainstHole( BOARD_ITEM* aItem, SHAPE_CIRCLE* aHole, BOARD_ITEM* aOther );
+    /**
+     * Test the holes of \a aItems against all the holes in m_holeTree.
+     *
+     * @return false if DRC was cancelled.
+     */
+    bool testHoles( const std::vector<BOARD_ITEM*>& aItems );
+
+    bool testHoleAgainstHole( BOARD_ITEM* aItem, SHAPE_CIRCLE* aHole, BOARD_ITEM* aOther,
+                              DRC_VIOLATION_BUFFER& aViolations );
 
     BOARD*    m_board;
     DRC_RTREE m_holeTree;
@@ -133,8 +141,6 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::Run()
                 return true;
             } );
 
-    count *= 2;  // One for adding to the rtree; one for checking
-
     forEachGeometryItem( { PCB_PAD_T, PCB_VIA_T }, LSET::AllLayersMask(),
             [&]( BOARD_ITEM* item ) -> bool
             {
@@ -159,113 +165,79 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::Run()
                 return true;
             } );
 
-    std::unordered_map<PTR_PTR_CACHE_KEY, int> checkedPairs;
+    // We only care about mechanically drilled (ie: non-laser) holes.  These include both
+    // blind/buried via holes (drilled prior to lamination) and through-via and drilled pad
+    // holes (which are generally drilled post laminataion).
+    std::vector<BOARD_ITEM*> vias;
 
     for( PCB_TRACK* track : m_board->Tracks() )
     {
-        if( track->Type() != PCB_VIA_T )
-            continue;
-
-        PCB_VIA* via = static_cast<PCB_VIA*>( track );
-
-        if( !reportProgress( ii++, count, progressDelta ) )
-            return false;   // DRC cancelled
-
-        // We only care about mechanically drilled (ie: non-laser) holes.  These include both
-        // blind/buried via holes (drilled prior to lamination) and through-via and drilled pad
-        // holes (which are generally drilled post laminataion).
-        if( via->GetViaType() != VIATYPE::MICROVIA )
+        if( track->Type() == PCB_VIA_T
+                && static_cast<PCB_VIA*>( track )->GetViaType() != VIATYPE::MICROVIA )
         {
-            std::shared_ptr<SHAPE_CIRCLE> holeShape = getDrilledHoleShape( via );
-
-            m_holeTree.QueryColliding( via, Edge_Cuts, Edge_Cuts,
-                    // Filter:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        BOARD_ITEM* a = via;
-                        BOARD_ITEM* b = other;
-
-                        // store canonical order so we don't collide in both directions
-                        // (a:b and b:a)
-                        if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                            std::swap( a, b );
-
-                        if( checkedPairs.find( { a, b } ) != checkedPairs.end() )
-                        {
-                            return false;
-                        }
-                        else
-                        {
-                            checkedPairs[ { a, b } ] = 1;
-                            return true;
-                        }
-                    },
-                    // Visitor:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        return testHoleAgainstHole( via, holeShape.get(), other );
-                    },
-                    m_largestHoleToHoleClearance );
+            vias.push_back( track );
         }
     }
 
-    checkedPairs.clear();
+    // We only care about drilled (ie: round) holes
+    std::vector<BOARD_ITEM*> pads;
 
     for( FOOTPRINT* footprint : m_board->Footprints() )
     {
         for( PAD* pad : footprint->Pads() )
         {
-            if( !reportProgress( ii++, count, progressDelta ) )
-                return false;   // DRC cancelled
-
-            // We only care about drilled (ie: round) holes
             if( pad->GetDrillSize().x && pad->GetDrillSize().x == pad->GetDrillSize().y )
+                pads.push_back( pad );
+        }
+    }
+
+    if( !testHoles( vias ) )
+        return false;   // DRC cancelled
+
+    if( !testHoles( pads ) )
+        return false;   // DRC cancelled
+
+    reportRuleStatistics();
+
+    return !m_drcEngine->IsCancelled();
+}
+
+
+bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::testHoles( const std::vector<BOARD_ITEM*>& aItems )
+{
+    // A pair of holes which both come from aItems is only tested from the first of the two.
+    std::unordered_map<BOARD_ITEM*, size_t> indices;
+
+    for( size_t ii = 0; ii < aItems.size(); ++ii )
+        indices[ aItems[ii] ] = ii;
+
+    return forEachParallel( aItems.size(),
+            [&]( size_t aIndex, DRC_VIOLATION_BUFFER& aViolations )
             {
-                std::shared_ptr<SHAPE_CIRCLE> holeShape = getDrilledHoleShape( pad );
+                BOARD_ITEM*                   item = aItems[aIndex];
+                std::shared_ptr<SHAPE_CIRCLE> holeShape = getDrilledHoleShape( item );
 
-                m_holeTree.QueryColliding( pad, Edge_Cuts, Edge_Cuts,
+                m_holeTree.QueryColliding( item, Edge_Cuts, Edge_Cuts,
                         // Filter:
                         [&]( BOARD_ITEM* other ) -> bool
                         {
-                            BOARD_ITEM* a = pad;
-                            BOARD_ITEM* b = other;
-
-                            // store canonical order so we don't collide in both directions
-                            // (a:b and b:a)
-                            if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                                std::swap( a, b );
-
-                            if( checkedPairs.find( { a, b } ) != checkedPairs.end() )
-                            {
-                                return false;
-                            }
-                            else
-                            {
-                                checkedPairs[ { a, b } ] = 1;
-                                return true;
-                            }
+                            auto it = indices.find( other );
+                            return it == indices.end() || it->second > aIndex;
                         },
                         // Visitor:
                         [&]( BOARD_ITEM* other ) -> bool
                         {
-                            return testHoleAgainstHole( pad, holeShape.get(), other );
+                            return testHoleAgainstHole( item, holeShape.get(), other,
+                                                        aViolations );
                         },
                         m_largestHoleToHoleClearance );
-            }
-        }
-
-        if( m_drcEngine->IsCancelled() )
-            return false;
-    }
-
-    reportRuleStatistics();
-
-    return !m_drcEngine->IsCancelled();
+            } );
 }
 
 
 bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::testHoleAgainstHole( BOARD_ITEM* aItem, SHAPE_CIRCLE* aHole,
-                                                          BOARD_ITEM* aOther )
+                                                          BOARD_ITEM* aOther,
+                                                          DRC_VIOLATION_BUFFER& aViolations )
 {
     bool reportCoLocation = !m_drcEngine->IsErrorLimitExceeded( DRCE_DRILLED_HOLES_COLOCATED );
     bool reportHole2Hole = !m_drcEngine->IsErrorLimitExceeded( DRCE_DRILLED_HOLES_TOO_CLOSE );
@@ -293,7 +265,7 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::testHoleAgainstHole( BOARD_ITEM* aItem, SHA
         {
             std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_DRILLED_HOLES_COLOCATED );
             drce->SetItems( aItem, aOther );
-            reportViolation( drce, aHole->GetCenter(), UNDEFINED_LAYER );
+            aViolations.Add( drce, aHole->GetCenter(), UNDEFINED_LAYER );
         }
     }
     else if( reportHole2Hole )
@@ -319,7 +291,7 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::testHoleAgainstHole( BOARD_ITEM* aItem, SHA
             drce->SetItems( aItem, aOther );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, aHole->GetCenter(), UNDEFINED_LAYER );
+            aViolations.Add( drce, aHole->GetCenter(), UNDEFINED_LAYER );
         }
     }
 
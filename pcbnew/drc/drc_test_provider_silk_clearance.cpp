@@ -141,12 +141,18 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
                          LSET::FrontMask() | LSET::BackMask() | LSET( 2, Edge_Cuts, Margin ),
                          countItems );
 
+    silkTree.BeginBulkLoad();
+    targetTree.BeginBulkLoad();
+
     forEachGeometryItem( s_allBasicItems, LSET( 2, F_SilkS, B_SilkS ), addToSilkTree );
 
     forEachGeometryItem( s_allBasicItems,
                          LSET::FrontMask() | LSET::BackMask() | LSET( 2, Edge_Cuts, Margin ),
                          addToTargetTree );
 
+    silkTree.EndBulkLoad();
+    targetTree.EndBulkLoad();
+
     reportAux( wxT( "Testing %d silkscreen features against %d board items." ),
                silkTree.size(),
                targetTree.size() );
@@ -173,22 +179,47 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
         DRC_RTREE::LAYER_PAIR( B_SilkS, Margin )
     };
 
-    targetTree.QueryCollidingPairs( &silkTree, layerPairs,
-            [&]( const DRC_RTREE::LAYER_PAIR& aLayers, DRC_RTREE::ITEM_WITH_SHAPE* aRefItemShape,
-                 DRC_RTREE::ITEM_WITH_SHAPE* aTestItemShape, bool* aCollisionDetected ) -> bool
+    std::vector<DRC_RTREE::PAIR_INFO> candidates;
+
+    candidates = targetTree.QueryCandidatePairs( &silkTree, layerPairs, m_largestClearance );
+
+    // Group the candidates by the pair of items they belong to.  Items can be made of several
+    // shapes (compound or triangulated), but a pair of items only gets one violation, so the
+    // shapes of a pair are tested in turn until one of them collides.
+    std::unordered_map<PTR_PTR_CACHE_KEY, size_t>   groupIndices;
+    std::vector<std::vector<DRC_RTREE::PAIR_INFO*>> groups;
+
+    for( DRC_RTREE::PAIR_INFO& candidate : candidates )
+    {
+        BOARD_ITEM* a = candidate.refItem->parent;
+        BOARD_ITEM* b = candidate.testItem->parent;
+
+        // store canonical order so we don't collide in both directions (a:b and b:a)
+        if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+            std::swap( a, b );
+
+        auto [it, inserted] = groupIndices.emplace( PTR_PTR_CACHE_KEY{ a, b }, groups.size() );
+
+        if( inserted )
+            groups.emplace_back();
+
+        groups[it->second].push_back( &candidate );
+    }
+
+    // Returns true if the shapes collide (and a violation has been buffered)
+    auto testPair =
+            [&]( const DRC_RTREE::PAIR_INFO& aPair, DRC_VIOLATION_BUFFER& aViolations ) -> bool
             {
-                BOARD_ITEM*  refItem = aRefItemShape->parent;
-                const SHAPE* refShape = aRefItemShape->shape;
-                BOARD_ITEM*  testItem = aTestItemShape->parent;
-                const SHAPE* testShape = aTestItemShape->shape;
+                PCB_LAYER_ID layer = aPair.layerPair.second;
+                BOARD_ITEM*  refItem = aPair.refItem->parent;
+                const SHAPE* refShape = aPair.refItem->shape;
+                BOARD_ITEM*  testItem = aPair.testItem->parent;
+                const SHAPE* testShape = aPair.testItem->shape;
 
                 std::shared_ptr<SHAPE> hole;
 
-                if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_SILK ) )
-                    return false;
-
                 if( isInvisibleText( refItem ) || isInvisibleText( testItem ) )
-                    return true;
+                    return false;
 
                 if( testItem->IsTented() )
                 {
@@ -199,21 +230,20 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
                     }
                     else
                     {
-                        return true;
+                        return false;
                     }
                 }
 
                 DRC_CONSTRAINT constraint = m_drcEngine->EvalRules( SILK_CLEARANCE_CONSTRAINT,
-                                                                    refItem, testItem,
-                                                                    aLayers.second );
+                                                                    refItem, testItem, layer );
 
                 if( constraint.IsNull() || constraint.GetSeverity() == RPT_SEVERITY_IGNORE )
-                    return true;
+                    return false;
 
                 int minClearance = constraint.GetValue().Min();
 
                 if( minClearance < 0 )
-                    return true;
+                    return false;
 
                 int      actual;
                 VECTOR2I pos;
@@ -223,7 +253,7 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
                 if( refItem->Type() == PCB_SHAPE_T && testItem->Type() == PCB_SHAPE_T
                          && refItem->GetParentFootprint() == testItem->GetParentFootprint() )
                 {
-                    return true;
+                    return false;
                 }
 
                 if( refShape->Collide( testShape, minClearance, &actual, &pos ) )
@@ -243,18 +273,38 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
                     drcItem->SetItems( refItem, testItem );
                     drcItem->SetViolatingRule( constraint.GetParentRule() );
 
-                    reportViolation( drcItem, pos, aLayers.second );
-
-                    *aCollisionDetected = true;
+                    aViolations.Add( drcItem, pos, layer );
+                    return true;
                 }
 
-                return true;
-            },
-            m_largestClearance,
-            [&]( int aCount, int aSize ) -> bool
-            {
-                return reportProgress( aCount, aSize, progressDelta );
-            } );
+                return false;
+            };
+
+    // The violations of a parallel loop are only reported, and counted against the error limit,
+    // once the loop is done.  Testing the pairs in batches lets the error limit check skip the
+    // remaining pairs of boards with many overlaps.
+    const size_t groupsPerBatch = 4096;
+
+    for( size_t first = 0; first < groups.size(); first += groupsPerBatch )
+    {
+        size_t count = std::min( groupsPerBatch, groups.size() - first );
+
+        bool running = forEachParallel( count,
+                [&]( size_t aGroup, DRC_VIOLATION_BUFFER& aViolations )
+                {
+                    if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_SILK ) )
+                        return;
+
+                    for( const DRC_RTREE::PAIR_INFO* pair : groups[first + aGroup] )
+                    {
+                        if( testPair( *pair, aViolations ) )
+                            break;
+                    }
+                } );
+
+        if( !running )
+            break;
+    }
 
     reportRuleStatistics();
 
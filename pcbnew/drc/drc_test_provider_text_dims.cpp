@@ -160,11 +160,26 @@ bool DRC_TEST_PROVIDER_TEXT_DIMS::Run()
                     for( const std::unique_ptr<KIFONT::GLYPH>& glyph : *glyphs )
                     {
                         // Ensure the glyph is a OUTLINE_GLYPH (for instance, overbars in outline
-                        // font text are represented as STROKE_GLYPHs).
-                        if( !glyph->IsOutline() )
+                        // font text are represented as STROKE_GLYPHs).  Shared glyphs are cached
+                        // in font units, so they are instantiated at the text's size.
+                        const KIFONT::OUTLINE_GLYPH*           outlineGlyph = nullptr;
+                        std::unique_ptr<KIFONT::OUTLINE_GLYPH> instance;
+
+                        if( glyph->IsOutline() )
+                        {
+                            outlineGlyph = static_cast<KIFONT::OUTLINE_GLYPH*>( glyph.get() );
+                        }
+                        else if( glyph->IsSharedOutline() )
+                        {
+                            instance = static_cast<KIFONT::SHARED_OUTLINE_GLYPH*>(
+                                               glyph.get() )->Instantiate();
+                            outlineGlyph = instance.get();
+                        }
+                        else
+                        {
                             continue;
+                        }
 
-                        auto outlineGlyph = static_cast<KIFONT::OUTLINE_GLYPH*>( glyph.get() );
                         int  outlineCount = outlineGlyph->OutlineCount();
                         int  holeCount = 0;
 
@@ -175,6 +190,8 @@ bool DRC_TEST_PROVIDER_TEXT_DIMS::Run()
                             holeCount += outlineGlyph->HoleCount( ii );
 
                         SHAPE_POLY_SET poly = outlineGlyph->CloneDropTriangulation();
+                        double         glyphArea = poly.Area();
+
                         poly.Deflate( constraint.Value().Min() / 2,
                                       CORNER_STRATEGY::CHAMFER_ALL_CORNERS, ARC_LOW_DEF );
                         poly.Simplify( SHAPE_POLY_SET::PM_FAST );
@@ -192,8 +209,6 @@ bool DRC_TEST_PROVIDER_TEXT_DIMS::Run()
                             break;
                         }
 
-                        double glyphArea = outlineGlyph->Area();
-
                         if( glyphArea == 0 )
                             continue;
 
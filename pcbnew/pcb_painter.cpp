@@ -64,13 +64,22 @@
 #include <geometry/shape_simple.h>
 #include <geometry/shape_circle.h>
 #include <bezier_curves.h>
+#include <hash.h>
+#include <hash_eda.h>
 #include <kiface_base.h>
 #include <gr_text.h>
 #include <pgm_base.h>
+#include <advanced_config.h>
 
 using namespace KIGFX;
 
 
+// Simplified drawings (see PCB_PAINTER::DrawLOD()) may stray this far from the real shapes,
+// and are used as long as this stays below LOD_MAX_ERROR_PIXELS on screen
+static const int    LOD_MAX_ERROR = pcbIUScale.mmToIU( 0.1 );
+static const double LOD_MAX_ERROR_PIXELS = 0.5;
+
+
 PCBNEW_SETTINGS* pcbconfig()
 {
     return dynamic_cast<PCBNEW_SETTINGS*>( Kiface().KifaceSettings() );
@@ -695,6 +704,234 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+std::unique_ptr<PAINTER> PCB_PAINTER::Clone( GAL* aGal )
+{
+    // Look the viewer settings up here, so that the lookups done by the copies on worker
+    // threads only read the settings manager's cache
+    viewer_settings();
+
+    std::unique_ptr<PCB_PAINTER> painter = std::make_unique<PCB_PAINTER>( *this );
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
+bool PCB_PAINTER::CanDrawConcurrently( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    // Net names and other texts go through the fonts, which are not thread-safe
+    if( IsNetnameLayer( aLayer ) )
+        return false;
+
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item )
+        return false;
+
+    switch( item->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+    case PCB_SHAPE_T:
+    case PCB_ZONE_T:
+        return true;
+
+    case PCB_PAD_T:
+        // Pads with differential mask or paste margins are drawn through a temporary duplicate,
+        // which touches the parent group
+        return aLayer != F_Mask && aLayer != B_Mask && aLayer != F_Paste && aLayer != B_Paste;
+
+    default:
+        return false;
+    }
+}
+
+
+double PCB_PAINTER::GetLODScale( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item || m_pcbSettings.IsPrinting() )
+        return 0.0;
+
+    switch( item->Type() )
+    {
+    case PCB_PAD_T:
+        // Round pads are a single primitive already
+        if( static_cast<const PAD*>( item )->GetShape() == PAD_SHAPE::CIRCLE )
+            return 0.0;
+
+        if( aLayer != LAYER_PADS_TH && aLayer != LAYER_PADS_SMD_FR && aLayer != LAYER_PADS_SMD_BK
+                && !IsCopperLayer( aLayer ) )
+        {
+            return 0.0;
+        }
+
+        break;
+
+    case PCB_ZONE_T:
+        if( !IsZoneFillLayer( aLayer )
+                || m_pcbSettings.m_ZoneDisplayMode != ZONE_DISPLAY_MODE::SHOW_FILLED )
+        {
+            return 0.0;
+        }
+
+        break;
+
+    default:
+        return 0.0;
+    }
+
+    // Screen pixels per internal unit at a view scale of 1
+    double pixelsPerIU = m_gal->GetWorldScale() / m_gal->GetZoomFactor();
+
+    return LOD_MAX_ERROR_PIXELS / ( LOD_MAX_ERROR * pixelsPerIU );
+}
+
+
+bool PCB_PAINTER::DrawLOD( const VIEW_ITEM* aItem, int aLayer )
+{
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item )
+        return false;
+
+    switch( item->Type() )
+    {
+    case PCB_PAD_T:
+        return drawLOD( static_cast<const PAD*>( item ), aLayer );
+
+    case PCB_ZONE_T:
+        return drawLOD( static_cast<const ZONE*>( item ), aLayer );
+
+    default:
+        return false;
+    }
+}
+
+
+bool PCB_PAINTER::GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, size_t& aKey,
+                                  VECTOR2I& aOffset )
+{
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item || !item->GetBoard() || m_pcbSettings.IsPrinting() )
+        return false;
+
+    const BOARD* board = item->GetBoard();
+    LSET         shownLayers = board->GetVisibleLayers() & board->GetEnabledLayers();
+
+    switch( item->Type() )
+    {
+    case PCB_VIA_T:
+    {
+        const PCB_VIA* via = static_cast<const PCB_VIA*>( item );
+
+        if( aLayer != LAYER_VIA_THROUGH && aLayer != LAYER_VIA_BBLIND
+                && aLayer != LAYER_VIA_MICROVIA && aLayer != LAYER_VIA_HOLES
+                && aLayer != LAYER_VIA_HOLEWALLS )
+        {
+            return false;
+        }
+
+        // Clearance outlines depend on the via net
+        if( pcbconfig() && pcbconfig()->m_Display.m_TrackClearance == SHOW_WITH_VIA_ALWAYS )
+            return false;
+
+        PCB_LAYER_ID layerTop, layerBottom;
+        via->LayerPair( &layerTop, &layerBottom );
+
+        aKey = hash_fp_item( via, HASH_LAYER );
+        hash_combine( aKey, getViaDrillSize( via ), via->FlashLayer( shownLayers ),
+                      via->IsSelected(), pcbconfig() && !pcbconfig()->m_Display.m_DisplayViaFill );
+        hash_combine( aKey, m_pcbSettings.GetColor( via, aLayer ),
+                      m_pcbSettings.GetColor( via, layerTop ),
+                      m_pcbSettings.GetColor( via, layerBottom ) );
+        break;
+    }
+
+    case PCB_PAD_T:
+    {
+        const PAD* pad = static_cast<const PAD*>( item );
+
+        if( aLayer != LAYER_PADS_TH && aLayer != LAYER_PADS_SMD_FR && aLayer != LAYER_PADS_SMD_BK
+                && aLayer != LAYER_PAD_PLATEDHOLES && aLayer != LAYER_NON_PLATEDHOLES
+                && aLayer != LAYER_PAD_HOLEWALLS && !IsCopperLayer( aLayer ) )
+        {
+            return false;
+        }
+
+        // Clearance outlines depend on the pad net and on the active layer
+        if( pcbconfig() && pcbconfig()->m_Display.m_PadClearance )
+            return false;
+
+        SHAPE_SEGMENT hole = getPadHoleShape( pad );
+
+        aKey = hash_fp_item( pad, HASH_ROT | HASH_LAYER );
+        hash_combine( aKey, hole.GetSeg().A.x - pad->GetPosition().x,
+                      hole.GetSeg().A.y - pad->GetPosition().y,
+                      hole.GetSeg().B.x - pad->GetPosition().x,
+                      hole.GetSeg().B.y - pad->GetPosition().y, hole.GetWidth() );
+        hash_combine( aKey, pad->FlashLayer( shownLayers ), pad->IsSelected(),
+                      viewer_settings()->m_ViewersDisplay.m_DisplayPadFill,
+                      m_pcbSettings.m_ForcePadSketchModeOn );
+        hash_combine( aKey, m_pcbSettings.GetColor( pad, aLayer ) );
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    hash_combine( aKey, item->Type(), m_pcbSettings.m_outlineWidth, m_holePlatingThickness,
+                  m_maxError );
+    aOffset = item->GetPosition();
+
+    return true;
+}
+
+
+BOX2I PCB_PAINTER::GetInstanceBBox( const VIEW_ITEM* aItem, int aLayer, const VECTOR2I& aOffset )
+{
+    // The view bounding box also covers the mask and paste margins, which are not drawn here
+    BOX2I bbox = static_cast<const BOARD_ITEM*>( aItem )->GetBoundingBox();
+
+    bbox.Move( -aOffset );
+    return bbox;
+}
+
+
+/**
+ * Reduce the vertex count of \a aPolySet, keeping it within LOD_MAX_ERROR of the original.
+ * Outlines too small to be seen when the simplified drawing is used are removed.
+ */
+static void simplifyForLOD( SHAPE_POLY_SET& aPolySet )
+{
+    aPolySet.ClearArcs();
+
+    for( int ii = aPolySet.OutlineCount() - 1; ii >= 0; --ii )
+    {
+        BOX2I bbox = aPolySet.COutline( ii ).BBox();
+        int   minSize = std::min( bbox.GetWidth(), bbox.GetHeight() );
+
+        if( bbox.GetWidth() < LOD_MAX_ERROR && bbox.GetHeight() < LOD_MAX_ERROR )
+        {
+            aPolySet.DeletePolygon( ii );
+            continue;
+        }
+
+        // Don't let thin outlines collapse
+        int maxError = std::min( LOD_MAX_ERROR, minSize / 4 );
+
+        aPolySet.Outline( ii ).Simplify( maxError );
+
+        for( int jj = 0; jj < aPolySet.HoleCount( ii ); ++jj )
+            aPolySet.Hole( ii, jj ).Simplify( maxError );
+    }
+}
+
+
 void PCB_PAINTER::draw( const PCB_TRACK* aTrack, int aLayer )
 {
     VECTOR2I start( aTrack->GetStart() );
@@ -2657,11 +2894,96 @@ void PCB_PAINTER::draw( const ZONE* aZone, int aLayer )
         if( m_gal->IsOpenGlEngine() && !polySet->IsTriangulationUpToDate() )
             polySet->CacheTriangulation( true, true );
 
+        // The triangles are handed to the GAL in a single call, which copies them to its vertex
+        // buffers in one go.  They are not kept, as the GAL caches what it has drawn.
+        if( m_gal->IsOpenGlEngine() && displayMode == ZONE_DISPLAY_MODE::SHOW_FILLED
+                && !ADVANCED_CFG::GetCfg().m_DrawTriangulationOutlines )
+        {
+            std::vector<VECTOR2F> triangles;
+
+            if( aZone->BuildFillTriangles( layer, triangles ) )
+            {
+                m_gal->DrawTriangles( triangles );
+                return;
+            }
+        }
+
         m_gal->DrawPolygon( *polySet, displayMode == ZONE_DISPLAY_MODE::SHOW_TRIANGULATION );
     }
 }
 
 
+bool PCB_PAINTER::drawLOD( const PAD* aPad, int aLayer )
+{
+    const BOARD* board = aPad->GetBoard();
+
+    // Outlines, and pads only drawn because they are selected, keep their full drawing
+    if( !board || !viewer_settings()->m_ViewersDisplay.m_DisplayPadFill
+            || m_pcbSettings.m_ForcePadSketchModeOn
+            || !aPad->FlashLayer( board->GetVisibleLayers() & board->GetEnabledLayers() ) )
+    {
+        return false;
+    }
+
+    // The clearance outline is left out: at the scales the proxy is used, it is within a pixel
+    // of the pad shape
+    SHAPE_POLY_SET proxy = *aPad->GetEffectivePolygon();
+
+    simplifyForLOD( proxy );
+
+    if( proxy.OutlineCount() == 0 )
+        return false;
+
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->SetFillColor( m_pcbSettings.GetColor( aPad, aLayer ) );
+    m_gal->DrawPolygon( proxy );
+
+    return true;
+}
+
+
+bool PCB_PAINTER::drawLOD( const ZONE* aZone, int aLayer )
+{
+    PCB_LAYER_ID layer = ToLAYER_ID( aLayer - LAYER_ZONE_START );
+
+    if( !aZone->IsOnLayer( layer ) )
+        return false;
+
+    const std::shared_ptr<SHAPE_POLY_SET>& polySet = aZone->GetFilledPolysList( layer );
+
+    if( polySet->OutlineCount() == 0 )
+        return false;
+
+    SHAPE_POLY_SET proxy = *polySet;
+
+    simplifyForLOD( proxy );
+
+    if( proxy.OutlineCount() == 0 )
+        return false;
+
+    if( m_gal->IsOpenGlEngine() )
+    {
+        proxy.CacheTriangulation( true, true );
+
+        // Better draw the full fill than nothing
+        if( !proxy.IsTriangulationUpToDate() )
+            return false;
+    }
+
+    COLOR4D color = m_pcbSettings.GetColor( aZone, layer );
+
+    m_gal->SetFillColor( color );
+    m_gal->SetStrokeColor( color );
+    m_gal->SetLineWidth( 0 );
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->DrawPolygon( proxy );
+
+    return true;
+}
+
+
 void PCB_PAINTER::draw( const PCB_DIMENSION_BASE* aDimension, int aLayer )
 {
     const COLOR4D& color = m_pcbSettings.GetColor( aDimension, aLayer );
@@ -174,6 +174,26 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual std::unique_ptr<PAINTER> Clone( GAL* aGal ) override;
+
+    /// @copydoc PAINTER::CanDrawConcurrently()
+    virtual bool CanDrawConcurrently( const VIEW_ITEM* aItem, int aLayer ) const override;
+
+    /// @copydoc PAINTER::GetLODScale()
+    virtual double GetLODScale( const VIEW_ITEM* aItem, int aLayer ) const override;
+
+    /// @copydoc PAINTER::DrawLOD()
+    virtual bool DrawLOD( const VIEW_ITEM* aItem, int aLayer ) override;
+
+    /// @copydoc PAINTER::GetInstanceKey()
+    virtual bool GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, size_t& aKey,
+                                 VECTOR2I& aOffset ) override;
+
+    /// @copydoc PAINTER::GetInstanceBBox()
+    virtual BOX2I GetInstanceBBox( const VIEW_ITEM* aItem, int aLayer,
+                                   const VECTOR2I& aOffset ) override;
+
 protected:
     PCB_VIEWERS_SETTINGS_BASE* viewer_settings();
 
@@ -194,6 +214,10 @@ protected:
     void draw( const PCB_TARGET* aTarget );
     void draw( const PCB_MARKER* aMarker, int aLayer );
 
+    // Simplified drawing functions, used when zoomed out (see DrawLOD())
+    bool drawLOD( const PAD* aPad, int aLayer );
+    bool drawLOD( const ZONE* aZone, int aLayer );
+
     /**
      * Get the thickness to draw for a line (e.g. 0 thickness lines get a minimum value).
      *
@@ -305,6 +305,17 @@ KIGFX::PCB_PRINT_PAINTER::PCB_PRINT_PAINTER( GAL* aGal ) :
 { }
 
 
+std::unique_ptr<KIGFX::PAINTER> KIGFX::PCB_PRINT_PAINTER::Clone( GAL* aGal )
+{
+    viewer_settings();
+
+    std::unique_ptr<PCB_PRINT_PAINTER> painter = std::make_unique<PCB_PRINT_PAINTER>( *this );
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
 int KIGFX::PCB_PRINT_PAINTER::getDrillShape( const PAD* aPad ) const
 {
     return m_drillMarkReal ? KIGFX::PCB_PAINTER::getDrillShape( aPad ) : PAD_DRILL_SHAPE_CIRCLE;
@@ -96,6 +96,8 @@ public:
         m_drillMarkSize = aSize;
     }
 
+    std::unique_ptr<PAINTER> Clone( GAL* aGal ) override;
+
 protected:
     int getDrillShape( const PAD* aPad ) const override;
 
@@ -48,6 +48,7 @@
 #include <tool/tool_manager.h>
 #include <tools/pcb_tool_base.h>
 #include <view/view.h>
+#include <view/view_query_cache.h>
 
 PCB_GRID_HELPER::PCB_GRID_HELPER( TOOL_MANAGER* aToolMgr, MAGNETIC_SETTINGS* aMagneticSettings ) :
     GRID_HELPER( aToolMgr ),
@@ -490,7 +491,8 @@ std::set<BOARD_ITEM*> PCB_GRID_HELPER::queryVisible( const BOX2I& aArea,
     const std::set<int>& activeLayers = settings->GetHighContrastLayers();
     bool                 isHighContrast = settings->GetHighContrast();
 
-    view->Query( aArea, selectedItems );
+    // Called on each mouse move, so the items around the cursor are kept between calls
+    view->GetQueryCache().Query( aArea, selectedItems );
 
     for( const auto& [ viewItem, layer ] : selectedItems )
     {
@@ -55,6 +55,7 @@ using namespace std::placeholders;
 #include <dialogs/dialog_locked_items_query.h>
 #include <class_draw_panel_gal.h>
 #include <view/view_controls.h>
+#include <view/view_query_cache.h>
 #include <preview_items/selection_area.h>
 #include <gal/painter.h>
 #include <router/router_tool.h>
@@ -1124,12 +1125,46 @@ bool PCB_SELECTION_TOOL::selectMultiple()
                     group_items.emplace( group_item );
             }
 
-            for( const KIGFX::VIEW::LAYER_ITEM_PAIR& candidate : candidates )
+            // Tracks, vias and pads make up most of the candidates in dense areas and keep no
+            // unguarded caches, so they are hit-tested on worker threads.  Other items may
+            // share caches with their parent or children, and are tested below.
+            auto testedConcurrently =
+                    []( const BOARD_ITEM* aItem )
+                    {
+                        switch( aItem->Type() )
+                        {
+                        case PCB_TRACE_T:
+                        case PCB_ARC_T:
+                        case PCB_VIA_T:
+                        case PCB_PAD_T:
+                            return true;
+
+                        default:
+                            return false;
+                        }
+                    };
+
+            std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> hits;
+
+            KIGFX::VIEW_QUERY_CACHE::FilterHits( candidates,
+                    [&]( KIGFX::VIEW_ITEM* aItem, int aLayer )
+                    {
+                        BOARD_ITEM* item = static_cast<BOARD_ITEM*>( aItem );
+
+                        if( !item || !testedConcurrently( item ) )
+                            return true;
+
+                        return item->HitTest( selectionRect, !greedySelection );
+                    },
+                    hits );
+
+            for( const KIGFX::VIEW::LAYER_ITEM_PAIR& candidate : hits )
             {
                 BOARD_ITEM* item = static_cast<BOARD_ITEM*>( candidate.first );
 
-
-                if( item && Selectable( item ) && item->HitTest( selectionRect, !greedySelection )
+                if( item && Selectable( item )
+                        && ( testedConcurrently( item )
+                             || item->HitTest( selectionRect, !greedySelection ) )
                         && ( greedySelection || !group_items.count( item ) ) )
                 {
                     if( item->Type() == PCB_PAD_T && !m_isFootprintEditor )
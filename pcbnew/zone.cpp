@@ -1085,6 +1085,42 @@ void ZONE::CacheTriangulation( PCB_LAYER_ID aLayer )
 }
 
 
+bool ZONE::BuildFillTriangles( PCB_LAYER_ID aLayer, std::vector<VECTOR2F>& aVertices ) const
+{
+    aVertices.clear();
+
+    auto it = m_FilledPolysList.find( aLayer );
+
+    if( it == m_FilledPolysList.end() || !it->second || !it->second->IsTriangulationUpToDate() )
+        return false;
+
+    const SHAPE_POLY_SET& fill = *it->second;
+    size_t                count = 0;
+
+    for( unsigned int ii = 0; ii < fill.TriangulatedPolyCount(); ++ii )
+        count += fill.TriangulatedPolygon( ii )->GetTriangleCount();
+
+    VECTOR2I a, b, c;
+
+    aVertices.reserve( 3 * count );
+
+    for( unsigned int ii = 0; ii < fill.TriangulatedPolyCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* triPoly = fill.TriangulatedPolygon( ii );
+
+        for( size_t jj = 0; jj < triPoly->GetTriangleCount(); ++jj )
+        {
+            triPoly->GetTriangle( jj, a, b, c );
+            aVertices.emplace_back( a.x, a.y );
+            aVertices.emplace_back( b.x, b.y );
+            aVertices.emplace_back( c.x, c.y );
+        }
+    }
+
+    return true;
+}
+
+
 bool ZONE::IsIsland( PCB_LAYER_ID aLayer, int aPolyIdx ) const
 {
     if( GetNetCode() < 1 )
@@ -630,6 +630,17 @@ public:
      */
     void CacheTriangulation( PCB_LAYER_ID aLayer = UNDEFINED_LAYER );
 
+    /**
+     * Build the list of triangle vertices (three per triangle) drawn by the GAL for the filled
+     * area on \a aLayer, from its triangulation.
+     *
+     * The list is built on demand and not kept: it is only needed until it has been copied to
+     * the GAL vertex buffers.
+     *
+     * @return false if the fill on \a aLayer has no up to date triangulation.
+     */
+    bool BuildFillTriangles( PCB_LAYER_ID aLayer, std::vector<VECTOR2F>& aVertices ) const;
+
     /**
      * Set the list of filled polygons.
      */
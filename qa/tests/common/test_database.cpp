@@ -22,10 +22,17 @@
 * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
 */
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <fmt/core.h>
 #include <boost/test/unit_test.hpp>
 
+#include <wx/filename.h>
+
 #include <database/database_connection.h>
+#include <database/database_snapshot.h>
 
 BOOST_AUTO_TEST_SUITE( Database )
 
@@ -75,4 +82,137 @@ BOOST_AUTO_TEST_CASE( Connect )
     BOOST_CHECK_EQUAL( std::any_cast<std::string>( result.at( "Cost" ) ), "1.95" );
 }
 
+
+BOOST_AUTO_TEST_CASE( Prefetch )
+{
+    std::string cs = fmt::format( "Driver={{SQLite3}};Database={}/database.sqlite",
+                                  QA_DATABASE_FILE_LOCATION );
+
+    DATABASE_CONNECTION dc( cs, 2 );
+    dc.CacheTableInfo( "Resistors", { "Part ID", "MPN" } );
+    dc.SetCacheParams( 10, 60 );
+    BOOST_CHECK( dc.IsConnected() );
+
+    DATABASE_CONNECTION::ROW result;
+
+    BOOST_CHECK( dc.SelectOne( "Resistors", std::make_pair( "Part ID", "RES-001" ), result ) );
+    BOOST_CHECK_EQUAL( std::any_cast<std::string>( result.at( "MPN" ) ), "RC0603FR-0710KL" );
+
+    // The first lookup fetched the whole table, so the next ones don't need the database
+    dc.Disconnect();
+    BOOST_CHECK( !dc.IsConnected() );
+
+    BOOST_CHECK( dc.SelectOne( "Resistors", std::make_pair( "Part ID", "RES-002" ), result ) );
+    BOOST_CHECK_EQUAL( std::any_cast<std::string>( result.at( "MPN" ) ), "RC0603FR-0712KL" );
+}
+
+
+BOOST_AUTO_TEST_CASE( Snapshot )
+{
+    std::string cs = fmt::format( "Driver={{SQLite3}};Database={}/database.sqlite",
+                                  QA_DATABASE_FILE_LOCATION );
+
+    DATABASE_CONNECTION dc( cs, 2 );
+    dc.CacheTableInfo( "Resistors", { "Part ID", "MPN" } );
+    BOOST_CHECK( dc.IsConnected() );
+
+    DATABASE_SNAPSHOT::TABLE table;
+    table.key = "Part ID";
+    table.columns = { "Part ID", "MPN" };
+
+    BOOST_CHECK( dc.SelectCount( "Resistors", table.count ) );
+    BOOST_CHECK_EQUAL( table.count, 581 );
+
+    BOOST_CHECK( dc.SelectMax( "Resistors", "Part ID", table.stamp ) );
+    BOOST_CHECK_EQUAL( table.stamp, "RES-581" );
+
+    // Only cached columns can be queried
+    std::string stamp;
+    BOOST_CHECK( !dc.SelectMax( "Resistors", "Value", stamp ) );
+
+    BOOST_CHECK( dc.SelectAll( "Resistors", "Part ID", table.rows ) );
+    BOOST_CHECK_EQUAL( table.rows.size(), table.count );
+
+    wxString fileName = wxFileName::CreateTempFileName( wxS( "qa_dblib" ) );
+
+    {
+        DATABASE_SNAPSHOT snapshot( fileName );
+        snapshot.SetTable( "Resistors", table );
+        BOOST_CHECK( snapshot.Save() );
+    }
+
+    DATABASE_SNAPSHOT snapshot( fileName );
+    BOOST_CHECK( snapshot.Load() );
+    BOOST_CHECK( !snapshot.GetTable( "Capacitors" ) );
+
+    const DATABASE_SNAPSHOT::TABLE* loaded = snapshot.GetTable( "Resistors" );
+    BOOST_REQUIRE( loaded );
+
+    BOOST_CHECK_EQUAL( loaded->key, table.key );
+    BOOST_CHECK( loaded->columns == table.columns );
+    BOOST_CHECK_EQUAL( loaded->count, table.count );
+    BOOST_CHECK_EQUAL( loaded->stamp, table.stamp );
+    BOOST_REQUIRE_EQUAL( loaded->rows.size(), table.rows.size() );
+
+    for( size_t i = 0; i < table.rows.size(); ++i )
+    {
+        BOOST_CHECK_EQUAL( std::any_cast<std::string>( loaded->rows[i].at( "MPN" ) ),
+                           std::any_cast<std::string>( table.rows[i].at( "MPN" ) ) );
+    }
+
+    wxRemoveFile( fileName );
+}
+
+
+BOOST_AUTO_TEST_CASE( ConcurrentSnapshotSave )
+{
+    DATABASE_SNAPSHOT::TABLE table;
+    table.key = "Part ID";
+    table.columns = { "Part ID", "MPN" };
+
+    for( int i = 0; i < 100; ++i )
+    {
+        DATABASE_CONNECTION::ROW row;
+        row["Part ID"] = fmt::format( "RES-{:03}", i );
+        row["MPN"] = fmt::format( "MPN-{}", i );
+        table.rows.push_back( row );
+    }
+
+    table.count = table.rows.size();
+
+    wxString fileName = wxFileName::CreateTempFileName( wxS( "qa_dblib" ) );
+
+    DATABASE_SNAPSHOT snapshot( fileName );
+    snapshot.SetTable( "Resistors", table );
+
+    // Several instances can save the snapshot of the same library at once
+    std::atomic<int>         failures( 0 );
+    std::vector<std::thread> threads;
+
+    for( int i = 0; i < 4; ++i )
+    {
+        threads.emplace_back(
+                [&]()
+                {
+                    for( int j = 0; j < 10; ++j )
+                    {
+                        if( !snapshot.Save() )
+                            failures++;
+                    }
+                } );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    BOOST_CHECK_EQUAL( failures.load(), 0 );
+
+    DATABASE_SNAPSHOT loaded( fileName );
+    BOOST_REQUIRE( loaded.Load() );
+    BOOST_REQUIRE( loaded.GetTable( "Resistors" ) );
+    BOOST_CHECK_EQUAL( loaded.GetTable( "Resistors" )->rows.size(), table.rows.size() );
+
+    wxRemoveFile( fileName );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
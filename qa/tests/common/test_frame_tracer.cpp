@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the frame tracer
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <frame_tracer.h>
+
+
+BOOST_AUTO_TEST_SUITE( FrameTracer )
+
+
+/**
+ * A disabled tracer records nothing, even zones recorded directly before it has a ring buffer.
+ */
+BOOST_AUTO_TEST_CASE( Disabled )
+{
+    FRAME_TRACER tracer( 16 );
+
+    {
+        FRAME_TRACE_ZONE zone( "zone", "test", tracer );
+    }
+
+    tracer.Record( "zone", "test", 0, 10 );
+
+    BOOST_CHECK_EQUAL( tracer.GetCount(), 0 );
+    BOOST_CHECK_EQUAL( tracer.ToChromeTrace().find( "\"zone\"" ), std::string::npos );
+
+    // Disabling again keeps the zones recorded while enabled
+    tracer.Enable( true );
+    tracer.Record( "zone", "test", 0, 10 );
+    tracer.Enable( false );
+
+    {
+        FRAME_TRACE_ZONE zone( "zone", "test", tracer );
+    }
+
+    BOOST_CHECK_EQUAL( tracer.GetCount(), 1 );
+}
+
+
+/**
+ * Nested zones are recorded as complete events, inner zones first.
+ */
+BOOST_AUTO_TEST_CASE( ChromeTrace )
+{
+    FRAME_TRACER tracer( 16 );
+
+    tracer.Enable( true );
+
+    {
+        FRAME_TRACE_ZONE outer( "outer", "test", tracer );
+        FRAME_TRACE_ZONE inner( "inner", "test", tracer );
+    }
+
+    nlohmann::json trace = nlohmann::json::parse( tracer.ToChromeTrace() );
+    nlohmann::json events = trace["traceEvents"];
+
+    BOOST_REQUIRE_EQUAL( events.size(), 2 );
+    BOOST_CHECK_EQUAL( events[0]["name"], "inner" );
+    BOOST_CHECK_EQUAL( events[1]["name"], "outer" );
+    BOOST_CHECK_EQUAL( events[1]["cat"], "test" );
+    BOOST_CHECK_EQUAL( events[1]["ph"], "X" );
+    BOOST_CHECK( events[1]["ts"] <= events[0]["ts"] );
+    BOOST_CHECK( events[1]["dur"] >= events[0]["dur"] );
+
+    tracer.Clear();
+
+    BOOST_CHECK_EQUAL( tracer.GetCount(), 0 );
+}
+
+
+/**
+ * The ring buffer keeps the last zones recorded by all threads.
+ */
+BOOST_AUTO_TEST_CASE( RingBuffer )
+{
+    FRAME_TRACER             tracer( 1000 );
+    std::vector<std::thread> threads;
+
+    tracer.Enable( true );
+
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        threads.emplace_back(
+                [&]()
+                {
+                    for( int jj = 0; jj < 10000; ++jj )
+                        FRAME_TRACE_ZONE zone( "worker", "test", tracer );
+                } );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    BOOST_CHECK_EQUAL( tracer.GetCount(), 1000 );
+
+    nlohmann::json events = nlohmann::json::parse( tracer.ToChromeTrace() )["traceEvents"];
+
+    BOOST_CHECK_EQUAL( events.size(), 1000 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
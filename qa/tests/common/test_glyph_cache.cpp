@@ -0,0 +1,249 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the shared outline glyph cache
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <font/glyph_cache.h>
+
+
+namespace
+{
+
+KIFONT::GLYPH_CACHE_KEY makeKey( unsigned int aGlyphIndex )
+{
+    // The face is only used as an identity, it is never dereferenced by the cache
+    static int face;
+
+    return { &face, aGlyphIndex, 16, false, false };
+}
+
+
+std::unique_ptr<KIFONT::OUTLINE_GLYPH> makeSquare( int aSize )
+{
+    SHAPE_LINE_CHAIN outline( { VECTOR2I( 0, 0 ), VECTOR2I( aSize, 0 ), VECTOR2I( aSize, aSize ),
+                                VECTOR2I( 0, aSize ) } );
+    outline.SetClosed( true );
+
+    auto glyph = std::make_unique<KIFONT::OUTLINE_GLYPH>();
+    glyph->AddOutline( outline );
+    glyph->CacheTriangulation( false, false );
+
+    return glyph;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( GlyphCache )
+
+
+/**
+ * A glyph is built once, then handed out to every text using it.
+ */
+BOOST_AUTO_TEST_CASE( BuildsOnce )
+{
+    KIFONT::GLYPH_CACHE& cache = KIFONT::GLYPH_CACHE::Instance();
+    int                  builds = 0;
+
+    cache.Clear();
+
+    auto builder =
+            [&]()
+            {
+                builds++;
+                return makeSquare( 100 );
+            };
+
+    std::shared_ptr<const KIFONT::OUTLINE_GLYPH> first = cache.Get( makeKey( 1 ), builder );
+    std::shared_ptr<const KIFONT::OUTLINE_GLYPH> second = cache.Get( makeKey( 1 ), builder );
+    std::shared_ptr<const KIFONT::OUTLINE_GLYPH> other = cache.Get( makeKey( 2 ), builder );
+
+    BOOST_CHECK_EQUAL( builds, 2 );
+    BOOST_CHECK( first == second );
+    BOOST_CHECK( first != other );
+
+    KIFONT::GLYPH_CACHE_STATS stats = cache.GetStats();
+
+    BOOST_CHECK_EQUAL( stats.m_glyphs, 2 );
+    BOOST_CHECK_EQUAL( stats.m_bytes, 2 * KIFONT::GLYPH_CACHE::GlyphBytes( *first ) );
+    BOOST_CHECK_GT( stats.m_bytes, 0 );
+
+    // Glyphs in use outlive the cache entries
+    cache.Clear();
+
+    BOOST_CHECK_EQUAL( cache.GetStats().m_glyphs, 0 );
+    BOOST_CHECK_EQUAL( first->OutlineCount(), 1 );
+}
+
+
+/**
+ * Shared glyphs draw and instantiate as the cached glyph mapped through their transform.
+ */
+BOOST_AUTO_TEST_CASE( SharedGlyphTransform )
+{
+    std::shared_ptr<const KIFONT::OUTLINE_GLYPH> square = makeSquare( 100 );
+
+    // Half size, mirrored in X, placed at (1000, 2000)
+    MATRIX3x3D                   transform( -0.5, 0.0, 1000.0,
+                                            0.0,  0.5, 2000.0,
+                                            0.0,  0.0, 1.0 );
+    KIFONT::SHARED_OUTLINE_GLYPH glyph( square, transform );
+
+    glyph.Move( VECTOR2I( 10, 20 ) );
+
+    BOOST_CHECK( glyph.IsSharedOutline() );
+    BOOST_CHECK( !glyph.IsOutline() );
+    BOOST_CHECK_EQUAL( glyph.GetTransform().GetTranslation(), VECTOR2D( 1010, 2020 ) );
+    BOOST_CHECK_EQUAL( glyph.Transform( VECTOR2I( 100, 100 ) ), VECTOR2I( 960, 2070 ) );
+
+    BOX2D bbox = glyph.BoundingBox();
+
+    BOOST_CHECK_EQUAL( bbox.GetOrigin(), VECTOR2D( 960, 2020 ) );
+    BOOST_CHECK_EQUAL( bbox.GetEnd(), VECTOR2D( 1010, 2070 ) );
+
+    std::unique_ptr<KIFONT::OUTLINE_GLYPH> instance = glyph.Instantiate();
+
+    BOOST_CHECK_EQUAL( instance->OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( instance->BBox().GetOrigin(), VECTOR2I( 960, 2020 ) );
+    BOOST_CHECK_EQUAL( instance->BBox().GetEnd(), VECTOR2I( 1010, 2070 ) );
+
+    int triangles = 0;
+
+    glyph.Triangulate(
+            [&]( const VECTOR2I& aPt1, const VECTOR2I& aPt2, const VECTOR2I& aPt3 )
+            {
+                for( const VECTOR2I& pt : { aPt1, aPt2, aPt3 } )
+                {
+                    BOOST_CHECK( pt.x >= 960 && pt.x <= 1010 );
+                    BOOST_CHECK( pt.y >= 2020 && pt.y <= 2070 );
+                }
+
+                triangles++;
+            } );
+
+    BOOST_CHECK_EQUAL( triangles, 2 );
+
+    // The cached glyph itself is untouched
+    BOOST_CHECK_EQUAL( square->BBox().GetOrigin(), VECTOR2I( 0, 0 ) );
+    BOOST_CHECK_EQUAL( square->BBox().GetEnd(), VECTOR2I( 100, 100 ) );
+}
+
+
+/**
+ * Purging drops the glyphs no text uses any more, and keeps the others.
+ */
+BOOST_AUTO_TEST_CASE( Purge )
+{
+    KIFONT::GLYPH_CACHE& cache = KIFONT::GLYPH_CACHE::Instance();
+    int                  builds = 0;
+
+    cache.Clear();
+
+    auto builder =
+            [&]()
+            {
+                builds++;
+                return makeSquare( 100 );
+            };
+
+    std::shared_ptr<const KIFONT::OUTLINE_GLYPH> used = cache.Get( makeKey( 1 ), builder );
+    cache.Get( makeKey( 2 ), builder );
+
+    BOOST_CHECK_EQUAL( cache.GetStats().m_glyphs, 2 );
+
+    // The counters are cumulative
+    size_t purged = cache.GetStats().m_purged;
+
+    cache.Purge();
+
+    KIFONT::GLYPH_CACHE_STATS stats = cache.GetStats();
+
+    BOOST_CHECK_EQUAL( stats.m_glyphs, 1 );
+    BOOST_CHECK_EQUAL( stats.m_purged, purged + 1 );
+    BOOST_CHECK_EQUAL( stats.m_bytes, KIFONT::GLYPH_CACHE::GlyphBytes( *used ) );
+
+    // The glyph in use is still shared, the purged one is built again
+    BOOST_CHECK( cache.Get( makeKey( 1 ), builder ) == used );
+    cache.Get( makeKey( 2 ), builder );
+
+    BOOST_CHECK_EQUAL( builds, 3 );
+
+    cache.Clear();
+}
+
+
+/**
+ * Threads asking for the same glyphs at the same time all get the same copy of each.
+ */
+BOOST_AUTO_TEST_CASE( Concurrent )
+{
+    KIFONT::GLYPH_CACHE& cache = KIFONT::GLYPH_CACHE::Instance();
+    const int            glyphCount = 64;
+    const int            threadCount = 8;
+
+    cache.Clear();
+
+    std::vector<std::vector<std::shared_ptr<const KIFONT::OUTLINE_GLYPH>>> results( threadCount );
+    std::vector<std::thread>                                               threads;
+
+    for( int ii = 0; ii < threadCount; ii++ )
+    {
+        threads.emplace_back(
+                [&, ii]()
+                {
+                    for( int jj = 0; jj < glyphCount; jj++ )
+                    {
+                        results[ii].push_back( cache.Get( makeKey( jj ),
+                                                          [&]()
+                                                          {
+                                                              return makeSquare( jj + 1 );
+                                                          } ) );
+                    }
+                } );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    BOOST_CHECK_EQUAL( cache.GetStats().m_glyphs, glyphCount );
+
+    for( int ii = 1; ii < threadCount; ii++ )
+    {
+        for( int jj = 0; jj < glyphCount; jj++ )
+            BOOST_CHECK( results[ii][jj] == results[0][jj] );
+    }
+
+    cache.Clear();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
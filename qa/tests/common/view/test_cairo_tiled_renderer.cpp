@@ -0,0 +1,330 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <cstring>
+
+#include <wx/image.h>
+
+#include <gal/cairo/cairo_tiled_renderer.h>
+#include <gal/painter.h>
+#include <render_settings.h>
+#include <view/view.h>
+#include <view/view_item.h>
+
+
+using namespace KIGFX;
+
+
+namespace
+{
+
+/**
+ * A GAL standing for the view canvas: only its view parameters are used.
+ */
+class CANVAS_GAL : public GAL
+{
+public:
+    CANVAS_GAL( GAL_DISPLAY_OPTIONS& aOptions ) :
+            GAL( aOptions )
+    {
+        ResizeScreen( 1000, 1000 );
+        ComputeWorldScreenMatrix();
+    }
+
+    void ResizeScreen( int aWidth, int aHeight ) override
+    {
+        m_screenSize = VECTOR2I( aWidth, aHeight );
+    }
+};
+
+
+/**
+ * A disc drawn on a single layer, with a stroke crossing it.
+ */
+class TEST_ITEM : public VIEW_ITEM
+{
+public:
+    TEST_ITEM( const VECTOR2I& aPosition, int aRadius, int aLayer, const COLOR4D& aColor ) :
+            m_position( aPosition ),
+            m_radius( aRadius ),
+            m_layer( aLayer ),
+            m_color( aColor )
+    {}
+
+    const BOX2I ViewBBox() const override
+    {
+        return BOX2I( m_position - VECTOR2I( m_radius, m_radius ),
+                      VECTOR2I( 2 * m_radius, 2 * m_radius ) );
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = m_layer;
+        aCount = 1;
+    }
+
+    void ViewDraw( int aLayer, VIEW* aView ) const override
+    {
+        GAL* gal = aView->GetGAL();
+
+        gal->SetIsFill( true );
+        gal->SetIsStroke( false );
+        gal->SetFillColor( m_color );
+        gal->DrawCircle( m_position, m_radius );
+    }
+
+    VECTOR2I m_position;
+    int      m_radius;
+    int      m_layer;
+    COLOR4D  m_color;
+    bool     m_selfDrawn = false;   ///< Left to ViewDraw() by the painter
+    bool     m_negative = false;    ///< Drawn as a negative shape
+};
+
+
+class TEST_SETTINGS : public RENDER_SETTINGS
+{
+public:
+    COLOR4D GetColor( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        return static_cast<const TEST_ITEM*>( aItem )->m_color;
+    }
+
+    const COLOR4D& GetBackgroundColor() const override { return m_backgroundColor; }
+    void SetBackgroundColor( const COLOR4D& aColor ) override { m_backgroundColor = aColor; }
+    const COLOR4D& GetGridColor() override { return m_backgroundColor; }
+    const COLOR4D& GetCursorColor() override { return m_backgroundColor; }
+};
+
+
+class TEST_PAINTER : public PAINTER
+{
+public:
+    TEST_PAINTER( GAL* aGal ) :
+            PAINTER( aGal )
+    {}
+
+    RENDER_SETTINGS* GetSettings() override { return &m_settings; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        const TEST_ITEM* item = static_cast<const TEST_ITEM*>( aItem );
+        VECTOR2D         offset( item->m_radius * 0.7, item->m_radius * 0.7 );
+
+        if( item->m_selfDrawn )
+            return false;
+
+        if( item->m_negative )
+        {
+            m_gal->SetNegativeDrawMode( true );
+            m_gal->SetIsFill( true );
+            m_gal->SetIsStroke( false );
+            m_gal->DrawCircle( item->m_position, item->m_radius );
+            m_gal->SetNegativeDrawMode( false );
+            return true;
+        }
+
+        m_gal->SetIsFill( true );
+        m_gal->SetIsStroke( false );
+        m_gal->SetFillColor( m_settings.GetColor( aItem, aLayer ) );
+        m_gal->DrawCircle( item->m_position, item->m_radius );
+
+        m_gal->SetIsStroke( true );
+        m_gal->SetStrokeColor( COLOR4D( 1.0, 1.0, 1.0, 0.5 ) );
+        m_gal->SetLineWidth( item->m_radius / 10.0 );
+        m_gal->DrawLine( item->m_position - offset, item->m_position + offset );
+
+        return true;
+    }
+
+    std::unique_ptr<PAINTER> Clone( GAL* aGal ) override
+    {
+        return std::make_unique<TEST_PAINTER>( aGal );
+    }
+
+    bool CanDrawConcurrently( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        // Mix items recorded on the thread pool and items recorded by the view painter
+        return static_cast<const TEST_ITEM*>( aItem )->m_radius % 2 == 0;
+    }
+
+private:
+    TEST_SETTINGS m_settings;
+};
+
+
+struct TILED_FIXTURE
+{
+    TILED_FIXTURE() :
+            m_gal( m_options ),
+            m_painter( &m_gal )
+    {
+        m_view.SetGAL( &m_gal );
+        m_view.SetPainter( &m_painter );
+
+        // A grid of discs of various sizes, straddling the tile edges
+        for( int ii = 0; ii < 200; ii++ )
+        {
+            VECTOR2I position( ( ii % 20 ) * 5000 + 1234, ( ii / 20 ) * 6000 + 2345 );
+
+            add( position, 1000 + ( ii * 37 ) % 2000, 2, COLOR4D( 0.0, 0.8, 0.2, 0.7 ) );
+        }
+
+        // Two stacked discs in the middle, the lowest rendering order is on top
+        add( VECTOR2I( 50000, 30000 ), 3000, 2, COLOR4D( 0.0, 1.0, 0.0, 1.0 ) );
+        add( VECTOR2I( 50000, 30000 ), 2001, 1, COLOR4D( 1.0, 0.0, 0.0, 1.0 ) );
+    }
+
+    void add( const VECTOR2I& aPosition, int aRadius, int aLayer, const COLOR4D& aColor,
+              bool aSelfDrawn = false, bool aNegative = false )
+    {
+        m_items.push_back( std::make_unique<TEST_ITEM>( aPosition, aRadius, aLayer, aColor ) );
+        m_items.back()->m_selfDrawn = aSelfDrawn;
+        m_items.back()->m_negative = aNegative;
+        m_view.Add( m_items.back().get() );
+    }
+
+    wxImage render( int aTileSize )
+    {
+        CAIRO_TILED_RENDERER renderer( m_view );
+
+        renderer.SetTileSize( aTileSize );
+        renderer.SetBackgroundColor( COLOR4D( 0.0, 0.0, 0.0, 1.0 ) );
+
+        return renderer.Render( BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( 100000, 60000 ) ),
+                                VECTOR2I( 640, 384 ) );
+    }
+
+    GAL_DISPLAY_OPTIONS                     m_options;
+    CANVAS_GAL                              m_gal;
+    TEST_PAINTER                            m_painter;
+    VIEW                                    m_view;
+    std::vector<std::unique_ptr<TEST_ITEM>> m_items;
+};
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( CairoTiledRenderer )
+
+
+/**
+ * Rendering in many small tiles gives the same bitmap as rendering in a single tile.
+ */
+BOOST_AUTO_TEST_CASE( TilesMatchSingleRender )
+{
+    TILED_FIXTURE fixture;
+
+    wxImage single = fixture.render( 1024 );
+    wxImage tiled = fixture.render( 48 );
+
+    BOOST_REQUIRE( single.IsOk() && tiled.IsOk() );
+    BOOST_REQUIRE_EQUAL( tiled.GetWidth(), 640 );
+    BOOST_REQUIRE_EQUAL( tiled.GetHeight(), 384 );
+
+    size_t pixels = 640 * 384;
+
+    BOOST_CHECK( std::memcmp( single.GetData(), tiled.GetData(), pixels * 3 ) == 0 );
+    BOOST_CHECK( std::memcmp( single.GetAlpha(), tiled.GetAlpha(), pixels ) == 0 );
+}
+
+
+/**
+ * Items are drawn where the view would draw them, layers in rendering order.
+ */
+BOOST_AUTO_TEST_CASE( Placement )
+{
+    TILED_FIXTURE fixture;
+
+    wxImage image = fixture.render( 64 );
+
+    // The area is 100000x60000 fitted in 640x384 pixels, centered on (50000, 30000).  The red
+    // disc is on top of the green one.
+    BOOST_CHECK_EQUAL( image.GetRed( 320 - 10, 192 + 5 ), 255 );
+    BOOST_CHECK_EQUAL( image.GetGreen( 320 - 10, 192 + 5 ), 0 );
+
+    // The green disc is larger
+    BOOST_CHECK_EQUAL( image.GetRed( 320 - 16, 192 ), 0 );
+    BOOST_CHECK_EQUAL( image.GetGreen( 320 - 16, 192 ), 255 );
+
+    // Nothing outside the grid
+    BOOST_CHECK_EQUAL( image.GetRed( 639, 383 ), 0 );
+    BOOST_CHECK_EQUAL( image.GetGreen( 639, 383 ), 0 );
+    BOOST_CHECK_EQUAL( image.GetAlpha( 639, 383 ), 255 );
+}
+
+
+/**
+ * Items the painter does not draw are drawn by their own ViewDraw().
+ */
+BOOST_AUTO_TEST_CASE( ViewDrawFallback )
+{
+    TILED_FIXTURE fixture;
+
+    fixture.add( VECTOR2I( 50000, 30000 ), 1000, 0, COLOR4D( 0.0, 0.0, 1.0, 1.0 ), true );
+
+    wxImage image = fixture.render( 64 );
+
+    // The blue disc is on top of the red one, away from the strokes crossing them
+    BOOST_CHECK_EQUAL( image.GetRed( 320 - 3, 192 + 3 ), 0 );
+    BOOST_CHECK_EQUAL( image.GetBlue( 320 - 3, 192 + 3 ), 255 );
+}
+
+
+/**
+ * Differential layers are added to the lower layers.
+ */
+BOOST_AUTO_TEST_CASE( DifferentialLayer )
+{
+    TILED_FIXTURE fixture;
+
+    fixture.add( VECTOR2I( 50000, 30000 ), 1000, 0, COLOR4D( 0.0, 0.0, 1.0, 1.0 ) );
+    fixture.m_view.SetLayerDiff( 0 );
+
+    wxImage image = fixture.render( 64 );
+
+    BOOST_CHECK_EQUAL( image.GetRed( 320 - 3, 192 + 3 ), 255 );
+    BOOST_CHECK_EQUAL( image.GetBlue( 320 - 3, 192 + 3 ), 255 );
+}
+
+
+/**
+ * Negative shapes only clear their own layer.
+ */
+BOOST_AUTO_TEST_CASE( NegativesLayer )
+{
+    TILED_FIXTURE fixture;
+
+    fixture.add( VECTOR2I( 50000, 30000 ), 1000, 0, COLOR4D::BLACK, false, true );
+    fixture.m_view.SetLayerHasNegatives( 0 );
+
+    wxImage image = fixture.render( 64 );
+
+    BOOST_CHECK_EQUAL( image.GetRed( 320 - 3, 192 + 3 ), 255 );
+    BOOST_CHECK_EQUAL( image.GetAlpha( 320 - 3, 192 + 3 ), 255 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,332 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <cmath>
+
+#include <gal/graphics_abstraction_layer.h>
+#include <gal/painter.h>
+#include <gal/recording_gal.h>
+#include <geometry/shape_poly_set.h>
+#include <render_settings.h>
+#include <view/view.h>
+#include <view/view_item.h>
+
+
+using namespace KIGFX;
+
+
+namespace
+{
+
+/**
+ * A GAL that does not draw, but logs the calls made to it.
+ */
+class LOGGING_GAL : public GAL
+{
+public:
+    LOGGING_GAL( GAL_DISPLAY_OPTIONS& aOptions ) :
+            GAL( aOptions )
+    {}
+
+    void DrawSegment( const VECTOR2D& aStart, const VECTOR2D& aEnd, double aWidth ) override
+    {
+        log( "segment", aStart.x, aStart.y, aEnd.x, aEnd.y, aWidth );
+    }
+
+    void DrawCircle( const VECTOR2D& aCenter, double aRadius ) override
+    {
+        log( "circle", aCenter.x, aCenter.y, aRadius );
+    }
+
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet, bool aStrokeTriangulation ) override
+    {
+        log( "polygon", aPolySet.FullPointCount(), aPolySet.TriangulatedPolyCount(),
+             aPolySet.IsTriangulationUpToDate() );
+    }
+
+    void SetFillColor( const COLOR4D& aColor ) override
+    {
+        GAL::SetFillColor( aColor );
+        log( "fill", aColor.r, aColor.g, aColor.b );
+    }
+
+    void SetLineWidth( float aLineWidth ) override
+    {
+        GAL::SetLineWidth( aLineWidth );
+        log( "width", aLineWidth );
+    }
+
+    void Translate( const VECTOR2D& aTranslation ) override
+    {
+        log( "translate", aTranslation.x, aTranslation.y );
+    }
+
+    int BeginGroup() override
+    {
+        log( "group", ++m_groups );
+        return m_groups;
+    }
+
+    void EndGroup() override { log( "end" ); }
+
+    std::vector<std::string> m_log;
+
+private:
+    template <typename... ARGS>
+    void log( const std::string& aName, ARGS... aArgs )
+    {
+        std::string entry = aName;
+        ( ( entry += " " + std::to_string( aArgs ) ), ... );
+        m_log.push_back( entry );
+    }
+
+    int m_groups = 0;
+};
+
+
+class TEST_ITEM : public VIEW_ITEM
+{
+public:
+    TEST_ITEM( int aId ) :
+            m_id( aId )
+    {}
+
+    const BOX2I ViewBBox() const override
+    {
+        return BOX2I( VECTOR2I( m_id * 1000, 0 ), VECTOR2I( 1000, 1000 ) );
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 1;
+        aLayers[1] = 2;
+        aCount = 2;
+    }
+
+    int m_id;
+};
+
+
+class TEST_SETTINGS : public RENDER_SETTINGS
+{
+public:
+    COLOR4D GetColor( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        return COLOR4D( aLayer / 4.0, 0.5, 0.5, 1.0 );
+    }
+
+    const COLOR4D& GetBackgroundColor() const override { return m_backgroundColor; }
+    void SetBackgroundColor( const COLOR4D& aColor ) override { m_backgroundColor = aColor; }
+    const COLOR4D& GetGridColor() override { return m_backgroundColor; }
+    const COLOR4D& GetCursorColor() override { return m_backgroundColor; }
+};
+
+
+/**
+ * Draws TEST_ITEMs as a few primitives and a triangulated polygon, so that there is some real
+ * work to spread over the threads.  Layer 2 is drawn serially.  Layer 1 also has a simplified
+ * drawing, used below a view scale of 0.5.
+ */
+class TEST_PAINTER : public PAINTER
+{
+public:
+    TEST_PAINTER( GAL* aGal, bool aConcurrent ) :
+            PAINTER( aGal ),
+            m_concurrent( aConcurrent )
+    {}
+
+    RENDER_SETTINGS* GetSettings() override { return &m_settings; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        const TEST_ITEM* item = dynamic_cast<const TEST_ITEM*>( aItem );
+
+        if( !item )
+            return false;
+
+        SHAPE_LINE_CHAIN outline;
+
+        for( int ii = 0; ii < 64; ii++ )
+        {
+            double angle = 2 * M_PI * ii / 64;
+            double radius = ( ii % 2 ) ? 300 : 500;
+
+            outline.Append( VECTOR2I( item->m_id * 1000 + radius * std::cos( angle ),
+                                      radius * std::sin( angle ) ) );
+        }
+
+        outline.SetClosed( true );
+
+        SHAPE_POLY_SET poly( outline );
+        poly.CacheTriangulation();
+
+        m_gal->SetFillColor( m_settings.GetColor( aItem, aLayer ) );
+        m_gal->SetLineWidth( aLayer * 10 );
+        m_gal->Translate( VECTOR2D( item->m_id, aLayer ) );
+        m_gal->DrawSegment( VECTOR2D( item->m_id * 1000, 0 ), VECTOR2D( item->m_id * 1000, 10 ),
+                            aLayer );
+        m_gal->DrawCircle( VECTOR2D( item->m_id * 1000, 0 ), item->m_id );
+        m_gal->DrawPolygon( poly, false );
+
+        return true;
+    }
+
+    std::unique_ptr<PAINTER> Clone( GAL* aGal ) override
+    {
+        return std::make_unique<TEST_PAINTER>( aGal, m_concurrent );
+    }
+
+    bool CanDrawConcurrently( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        return m_concurrent && aLayer == 1;
+    }
+
+    double GetLODScale( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        return aLayer == 1 ? 0.5 : 0.0;
+    }
+
+    bool DrawLOD( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        const TEST_ITEM* item = dynamic_cast<const TEST_ITEM*>( aItem );
+
+        if( !item )
+            return false;
+
+        m_gal->SetFillColor( m_settings.GetColor( aItem, aLayer ) );
+        m_gal->DrawCircle( VECTOR2D( item->m_id * 1000, 0 ), 500 );
+
+        return true;
+    }
+
+private:
+    TEST_SETTINGS m_settings;
+    bool          m_concurrent;
+};
+
+
+/**
+ * Draw \a aCount items through a VIEW and return the GAL log.
+ */
+std::vector<std::string> drawItems( int aCount, bool aConcurrent )
+{
+    GAL_DISPLAY_OPTIONS options;
+    LOGGING_GAL         gal( options );
+    TEST_PAINTER        painter( &gal, aConcurrent );
+    VIEW                view;
+
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+
+    std::vector<std::unique_ptr<TEST_ITEM>> items;
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        items.push_back( std::make_unique<TEST_ITEM>( ii ) );
+        view.Add( items.back().get() );
+    }
+
+    view.UpdateItems();
+
+    return gal.m_log;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( RecordingGal )
+
+
+/**
+ * Replaying a recording must make the same calls as drawing directly.
+ */
+BOOST_AUTO_TEST_CASE( ReplayMatchesDirectDrawing )
+{
+    GAL_DISPLAY_OPTIONS options;
+    LOGGING_GAL         direct( options );
+    LOGGING_GAL         replayed( options );
+    RECORDING_GAL       recorder( direct );
+    TEST_ITEM           item( 3 );
+    TEST_PAINTER        directPainter( &direct, true );
+    TEST_PAINTER        recordingPainter( &recorder, true );
+    float               initialWidth = direct.GetLineWidth();
+
+    directPainter.Draw( &item, 1 );
+    recordingPainter.Draw( &item, 1 );
+
+    RECORDING_GAL::RECORDING recording = recorder.TakeRecording();
+
+    BOOST_CHECK( recorder.TakeRecording().empty() );
+    BOOST_CHECK_EQUAL( recorder.GetLineWidth(), initialWidth );
+
+    RECORDING_GAL::Replay( recording, replayed );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( replayed.m_log.begin(), replayed.m_log.end(),
+                                   direct.m_log.begin(), direct.m_log.end() );
+}
+
+
+/**
+ * Items drawn on worker threads must end up in the same groups, with the same contents, as
+ * when they are drawn on the calling thread.
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentUpdateMatchesSerial )
+{
+    std::vector<std::string> serial = drawItems( 2000, false );
+    std::vector<std::string> concurrent = drawItems( 2000, true );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( concurrent.begin(), concurrent.end(), serial.begin(),
+                                   serial.end() );
+}
+
+
+/**
+ * Layers with a simplified drawing get a second group holding it, right after the full one.
+ */
+BOOST_AUTO_TEST_CASE( LodGroups )
+{
+    std::vector<std::string> log = drawItems( 10, false );
+    int                      groups = 0;
+    int                      lodGroups = 0;
+
+    for( size_t ii = 0; ii < log.size(); ii++ )
+    {
+        if( log[ii].rfind( "group", 0 ) != 0 )
+            continue;
+
+        groups++;
+
+        // A simplified drawing is a fill colour and a single circle
+        if( ii + 3 < log.size() && log[ii + 2].rfind( "circle", 0 ) == 0 && log[ii + 3] == "end" )
+            lodGroups++;
+    }
+
+    // Two layers and one simplified drawing per item
+    BOOST_CHECK_EQUAL( groups, 30 );
+    BOOST_CHECK_EQUAL( lodGroups, 10 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,368 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <algorithm>
+
+#include <gal/graphics_abstraction_layer.h>
+#include <gal/painter.h>
+#include <hash.h>
+#include <render_settings.h>
+#include <view/view.h>
+#include <view/view_item.h>
+
+
+using namespace KIGFX;
+
+
+namespace
+{
+
+/**
+ * A GAL that does not draw, but logs the group handling and the primitives drawn.
+ */
+class INSTANCING_GAL : public GAL
+{
+public:
+    INSTANCING_GAL( GAL_DISPLAY_OPTIONS& aOptions, bool aInstancing ) :
+            GAL( aOptions ),
+            m_instancing( aInstancing )
+    {
+        ResizeScreen( 1000, 1000 );
+    }
+
+    void ResizeScreen( int aWidth, int aHeight ) override
+    {
+        m_screenSize = VECTOR2I( aWidth, aHeight );
+    }
+
+    void DrawCircle( const VECTOR2D& aCenter, double aRadius ) override
+    {
+        log( "circle", m_translation.x + aCenter.x, m_translation.y + aCenter.y, aRadius );
+    }
+
+    void Translate( const VECTOR2D& aTranslation ) override { m_translation += aTranslation; }
+
+    void Save() override { m_savedTranslation = m_translation; }
+
+    void Restore() override { m_translation = m_savedTranslation; }
+
+    int BeginGroup() override
+    {
+        log( "group", ++m_groups );
+        return m_groups;
+    }
+
+    void EndGroup() override { log( "end" ); }
+
+    void DrawGroup( int aGroupNumber ) override { log( "draw", aGroupNumber ); }
+
+    bool SupportsGroupInstancing() const override { return m_instancing; }
+
+    void DrawGroupInstance( int aGroupNumber, const VECTOR2D& aOffset ) override
+    {
+        log( "instance", aGroupNumber, aOffset.x, aOffset.y );
+    }
+
+    void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor ) override
+    {
+        log( "color", aGroupNumber );
+    }
+
+    void DeleteGroup( int aGroupNumber ) override { log( "delete", aGroupNumber ); }
+
+    int count( const std::string& aName ) const
+    {
+        return std::count_if( m_log.begin(), m_log.end(),
+                              [&]( const std::string& aEntry )
+                              {
+                                  return aEntry.rfind( aName + " ", 0 ) == 0;
+                              } );
+    }
+
+    std::vector<std::string> m_log;
+
+private:
+    template <typename... ARGS>
+    void log( const std::string& aName, ARGS... aArgs )
+    {
+        std::string entry = aName;
+        ( ( entry += " " + std::to_string( static_cast<long long>( aArgs ) ) ), ... );
+        m_log.push_back( entry );
+    }
+
+    bool     m_instancing;
+    int      m_groups = 0;
+    VECTOR2D m_translation;
+    VECTOR2D m_savedTranslation;
+};
+
+
+/**
+ * A round pad-like item, drawn on a single layer.
+ */
+class TEST_ITEM : public VIEW_ITEM
+{
+public:
+    TEST_ITEM( const VECTOR2I& aPosition, int aRadius ) :
+            m_position( aPosition ),
+            m_radius( aRadius ),
+            m_highlighted( false )
+    {}
+
+    const BOX2I ViewBBox() const override
+    {
+        return BOX2I( m_position - VECTOR2I( m_radius, m_radius ),
+                      VECTOR2I( 2 * m_radius, 2 * m_radius ) );
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 1;
+        aCount = 1;
+    }
+
+    VECTOR2I m_position;
+    int      m_radius;
+    bool     m_highlighted;
+};
+
+
+class TEST_SETTINGS : public RENDER_SETTINGS
+{
+public:
+    COLOR4D GetColor( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        const TEST_ITEM* item = static_cast<const TEST_ITEM*>( aItem );
+
+        return item && item->m_highlighted ? COLOR4D( 1.0, 1.0, 1.0, 1.0 )
+                                           : COLOR4D( 0.5, 0.5, 0.5, 1.0 );
+    }
+
+    const COLOR4D& GetBackgroundColor() const override { return m_backgroundColor; }
+    void SetBackgroundColor( const COLOR4D& aColor ) override { m_backgroundColor = aColor; }
+    const COLOR4D& GetGridColor() override { return m_backgroundColor; }
+    const COLOR4D& GetCursorColor() override { return m_backgroundColor; }
+};
+
+
+class TEST_PAINTER : public PAINTER
+{
+public:
+    TEST_PAINTER( GAL* aGal, bool aCollidingKeys ) :
+            PAINTER( aGal ),
+            m_collidingKeys( aCollidingKeys )
+    {}
+
+    RENDER_SETTINGS* GetSettings() override { return &m_settings; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        const TEST_ITEM* item = static_cast<const TEST_ITEM*>( aItem );
+
+        m_gal->SetFillColor( m_settings.GetColor( aItem, aLayer ) );
+        m_gal->DrawCircle( item->m_position, item->m_radius );
+
+        return true;
+    }
+
+    bool GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, size_t& aKey,
+                         VECTOR2I& aOffset ) override
+    {
+        const TEST_ITEM* item = static_cast<const TEST_ITEM*>( aItem );
+
+        // Colliding keys leave the radius out, as if two different drawings had the same hash
+        aKey = hash_val( m_collidingKeys ? 0 : item->m_radius,
+                         m_settings.GetColor( aItem, aLayer ) );
+        aOffset = item->m_position;
+
+        return true;
+    }
+
+private:
+    TEST_SETTINGS m_settings;
+    bool          m_collidingKeys;
+};
+
+
+struct INSTANCING_FIXTURE
+{
+    INSTANCING_FIXTURE( bool aInstancing = true, bool aCollidingKeys = false ) :
+            m_gal( m_options, aInstancing ),
+            m_painter( &m_gal, aCollidingKeys )
+    {
+        m_view.SetGAL( &m_gal );
+        m_view.SetPainter( &m_painter );
+
+        // Ten small items and ten large ones
+        for( int ii = 0; ii < 20; ii++ )
+        {
+            m_items.push_back( std::make_unique<TEST_ITEM>( VECTOR2I( ii * 1000, 500 ),
+                                                            ii < 10 ? 100 : 200 ) );
+            m_view.Add( m_items.back().get() );
+        }
+
+        m_view.UpdateItems();
+    }
+
+    GAL_DISPLAY_OPTIONS                     m_options;
+    INSTANCING_GAL                          m_gal;
+    TEST_PAINTER                            m_painter;
+    VIEW                                    m_view;
+    std::vector<std::unique_ptr<TEST_ITEM>> m_items;
+};
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( ViewInstancing )
+
+
+/**
+ * Items with the same instance key share a single group, drawn around the origin.
+ */
+BOOST_AUTO_TEST_CASE( SharedGroups )
+{
+    INSTANCING_FIXTURE fixture;
+    INSTANCING_GAL&    gal = fixture.m_gal;
+
+    BOOST_CHECK_EQUAL( gal.count( "group" ), 2 );
+    BOOST_CHECK_EQUAL( gal.count( "circle" ), 2 );
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "circle 0 0 100" ) == 1 );
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "circle 0 0 200" ) == 1 );
+
+    gal.m_log.clear();
+    fixture.m_view.Redraw();
+
+    BOOST_CHECK_EQUAL( gal.count( "instance" ), 20 );
+    BOOST_CHECK_EQUAL( gal.count( "draw" ), 0 );
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "instance 1 3000 500" ) == 1 );
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "instance 2 15000 500" ) == 1 );
+}
+
+
+/**
+ * A GAL without instancing gets a group per item.
+ */
+BOOST_AUTO_TEST_CASE( NoInstancing )
+{
+    INSTANCING_FIXTURE fixture( false );
+    INSTANCING_GAL&    gal = fixture.m_gal;
+
+    BOOST_CHECK_EQUAL( gal.count( "group" ), 20 );
+
+    gal.m_log.clear();
+    fixture.m_view.Redraw();
+
+    BOOST_CHECK_EQUAL( gal.count( "instance" ), 0 );
+    BOOST_CHECK_EQUAL( gal.count( "draw" ), 20 );
+}
+
+
+/**
+ * Items whose keys collide but whose drawings differ are not drawn as each other.
+ */
+BOOST_AUTO_TEST_CASE( KeyCollision )
+{
+    INSTANCING_FIXTURE fixture( true, true );
+    INSTANCING_GAL&    gal = fixture.m_gal;
+
+    // The items of the first size drawn share a group, the others get one each
+    BOOST_CHECK_EQUAL( gal.count( "group" ), 11 );
+    BOOST_CHECK_EQUAL( gal.count( "circle" ), 11 );
+    BOOST_CHECK_EQUAL( gal.count( "circle 0 0" ), 1 );
+
+    gal.m_log.clear();
+    fixture.m_view.Redraw();
+
+    BOOST_CHECK_EQUAL( gal.count( "instance" ), 10 );
+    BOOST_CHECK_EQUAL( gal.count( "draw" ), 10 );
+}
+
+
+/**
+ * Shared groups are never recolored: an item changing color moves to another group.
+ */
+BOOST_AUTO_TEST_CASE( ColorChange )
+{
+    INSTANCING_FIXTURE fixture;
+    INSTANCING_GAL&    gal = fixture.m_gal;
+
+    gal.m_log.clear();
+    fixture.m_items[3]->m_highlighted = true;
+    fixture.m_view.Update( fixture.m_items[3].get(), COLOR );
+    fixture.m_view.UpdateItems();
+
+    BOOST_CHECK_EQUAL( gal.count( "color" ), 0 );
+    BOOST_CHECK_EQUAL( gal.count( "group" ), 1 );
+    BOOST_CHECK_EQUAL( gal.count( "delete" ), 0 );
+
+    gal.m_log.clear();
+    fixture.m_view.Redraw();
+
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "instance 3 3000 500" ) == 1 );
+    BOOST_CHECK_EQUAL( gal.count( "instance 1" ), 9 );
+
+    // Back to the original color, the item goes back to the first group
+    gal.m_log.clear();
+    fixture.m_items[3]->m_highlighted = false;
+    fixture.m_view.Update( fixture.m_items[3].get(), COLOR );
+    fixture.m_view.UpdateItems();
+
+    BOOST_CHECK_EQUAL( gal.count( "group" ), 0 );
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "delete 3" ) == 1 );
+}
+
+
+/**
+ * A shared group is deleted with the last item using it.
+ */
+BOOST_AUTO_TEST_CASE( Release )
+{
+    INSTANCING_FIXTURE fixture;
+    INSTANCING_GAL&    gal = fixture.m_gal;
+
+    gal.m_log.clear();
+
+    for( int ii = 10; ii < 19; ii++ )
+        fixture.m_view.Remove( fixture.m_items[ii].get() );
+
+    BOOST_CHECK_EQUAL( gal.count( "delete" ), 0 );
+
+    fixture.m_view.Remove( fixture.m_items[19].get() );
+
+    BOOST_CHECK_EQUAL( gal.count( "delete" ), 1 );
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "delete 2" ) == 1 );
+
+    // A new item recreates the group
+    gal.m_log.clear();
+    fixture.m_view.Add( fixture.m_items[19].get() );
+    fixture.m_view.UpdateItems();
+
+    BOOST_CHECK_EQUAL( gal.count( "group" ), 1 );
+    BOOST_CHECK( std::count( gal.m_log.begin(), gal.m_log.end(), "circle 0 0 200" ) == 1 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
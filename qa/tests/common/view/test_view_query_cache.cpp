@@ -0,0 +1,214 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <random>
+
+#include <view/view.h>
+#include <view/view_item.h>
+#include <view/view_query_cache.h>
+
+
+using namespace KIGFX;
+
+
+namespace
+{
+
+class TEST_ITEM : public VIEW_ITEM
+{
+public:
+    TEST_ITEM( const BOX2I& aBox, std::vector<int> aLayers ) :
+            m_box( aBox ),
+            m_layers( std::move( aLayers ) )
+    {}
+
+    const BOX2I ViewBBox() const override { return m_box; }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aCount = 0;
+
+        for( int layer : m_layers )
+            aLayers[aCount++] = layer;
+    }
+
+    BOX2I            m_box;
+    std::vector<int> m_layers;
+};
+
+
+struct QUERY_CACHE_FIXTURE
+{
+    QUERY_CACHE_FIXTURE()
+    {
+        std::mt19937 rng( 42 );
+
+        for( int ii = 0; ii < 5000; ii++ )
+        {
+            VECTOR2I         pos( rng() % 1000000, rng() % 1000000 );
+            VECTOR2I         size( rng() % 20000, rng() % 20000 );
+            std::vector<int> layers = { 1 + int( rng() % 3 ) };
+
+            // Some items on several layers, like through-hole pads
+            if( rng() % 4 == 0 && layers[0] != 4 )
+                layers.push_back( 4 );
+
+            m_items.push_back( std::make_unique<TEST_ITEM>( BOX2I( pos, size ), layers ) );
+            m_view.Add( m_items.back().get() );
+        }
+    }
+
+    /// Compare the result of the cache and of the view, ignoring the order of items within
+    /// a layer (the R-tree does not define it).
+    void check( const BOX2I& aRect )
+    {
+        std::vector<VIEW::LAYER_ITEM_PAIR> cached;
+        std::vector<VIEW::LAYER_ITEM_PAIR> expected;
+
+        m_cache.Query( aRect, cached );
+        m_view.Query( aRect, expected );
+
+        auto layersOf =
+                []( const std::vector<VIEW::LAYER_ITEM_PAIR>& aItems )
+                {
+                    std::vector<int> layers;
+
+                    for( const auto& [item, layer] : aItems )
+                        layers.push_back( layer );
+
+                    return layers;
+                };
+
+        BOOST_CHECK( layersOf( cached ) == layersOf( expected ) );
+
+        std::sort( cached.begin(), cached.end() );
+        std::sort( expected.begin(), expected.end() );
+
+        BOOST_CHECK( cached == expected );
+    }
+
+    VIEW                                    m_view;
+    VIEW_QUERY_CACHE                        m_cache{ &m_view };
+    std::vector<std::unique_ptr<TEST_ITEM>> m_items;
+};
+
+} // namespace
+
+
+BOOST_FIXTURE_TEST_SUITE( ViewQueryCache, QUERY_CACHE_FIXTURE )
+
+
+/**
+ * A cursor wandering over the view gets the same items as from VIEW::Query().
+ */
+BOOST_AUTO_TEST_CASE( MatchesViewQuery )
+{
+    std::mt19937 rng( 7 );
+    VECTOR2I     cursor( 500000, 500000 );
+
+    for( int ii = 0; ii < 2000; ii++ )
+    {
+        cursor += VECTOR2I( int( rng() % 20001 ) - 10000, int( rng() % 20001 ) - 10000 );
+
+        // Jump somewhere else from time to time
+        if( ii % 250 == 0 )
+            cursor = VECTOR2I( rng() % 1000000, rng() % 1000000 );
+
+        int size = 100 + rng() % 10000;
+
+        check( BOX2I( cursor - VECTOR2I( size, size ), VECTOR2I( 2 * size, 2 * size ) ) );
+    }
+}
+
+
+/**
+ * Adding, removing items and hiding layers drops the cached items.
+ */
+BOOST_AUTO_TEST_CASE( Invalidation )
+{
+    BOX2I rect( VECTOR2I( 400000, 400000 ), VECTOR2I( 20000, 20000 ) );
+
+    check( rect );
+
+    TEST_ITEM added( BOX2I( VECTOR2I( 405000, 405000 ), VECTOR2I( 100, 100 ) ), { 2 } );
+    m_view.Add( &added );
+    check( rect );
+
+    m_view.Remove( &added );
+    check( rect );
+
+    m_view.SetLayerVisible( 2, false );
+    check( rect );
+
+    m_view.SetLayerDisplayOnly( 1 );
+    check( rect );
+
+    // Hidden layers are not searched anymore
+    std::vector<VIEW::LAYER_ITEM_PAIR> found;
+    m_cache.Query( BOX2I( VECTOR2I( 0, 0 ), VECTOR2I( 1000000, 1000000 ) ), found );
+
+    BOOST_CHECK( std::none_of( found.begin(), found.end(),
+                               []( const VIEW::LAYER_ITEM_PAIR& aPair )
+                               {
+                                   return aPair.second == 1 || aPair.second == 2;
+                               } ) );
+}
+
+
+/**
+ * Hit tests keep the order of the candidates, whether run on one or several threads.
+ */
+BOOST_AUTO_TEST_CASE( HitTests )
+{
+    for( int size : { 10000, 1000000 } )
+    {
+        BOX2I                              rect( VECTOR2I( 0, 0 ), VECTOR2I( size, size ) );
+        std::vector<VIEW::LAYER_ITEM_PAIR> candidates;
+        std::vector<VIEW::LAYER_ITEM_PAIR> expected;
+        std::vector<VIEW::LAYER_ITEM_PAIR> hits;
+
+        auto hitTest =
+                []( VIEW_ITEM* aItem, int aLayer )
+                {
+                    return static_cast<TEST_ITEM*>( aItem )->m_box.GetWidth() > 10000;
+                };
+
+        m_cache.Query( rect, candidates );
+
+        for( const VIEW::LAYER_ITEM_PAIR& candidate : candidates )
+        {
+            if( hitTest( candidate.first, candidate.second ) )
+                expected.push_back( candidate );
+        }
+
+        m_cache.Query( rect, hits, hitTest );
+
+        BOOST_CHECK( hits == expected );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <schematic_utils/schematic_file_util.h>
+
+#include <connection_graph.h>
+#include <core/thread_pool.h>
+#include <schematic.h>
+#include <erc_settings.h>
+#include <erc.h>
+#include <erc_item.h>
+#include <scoped_set_reset.h>
+#include <settings/settings_manager.h>
+#include <locale_io.h>
+
+
+struct ERC_PARALLEL_TEST_FIXTURE
+{
+    ERC_PARALLEL_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    /**
+     * Load \a aName, run all the ERC tests and return a description of each marker, in the
+     * order the markers are found in the schematic.
+     */
+    std::vector<wxString> runErc( const wxString& aName )
+    {
+        KI_TEST::LoadSchematic( m_settingsManager, aName, m_schematic );
+
+        SHEETLIST_ERC_ITEMS_PROVIDER errors( m_schematic.get() );
+        ERC_TESTER                   tester( m_schematic.get() );
+
+        m_schematic->ConnectionGraph()->Recalculate( m_schematic->GetSheets(), true );
+        tester.RunTests( nullptr, nullptr, nullptr, &m_schematic->Prj(), nullptr );
+
+        errors.SetSeverities( RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING );
+
+        std::vector<wxString> markers;
+
+        for( int ii = 0; ii < errors.GetCount(); ++ii )
+        {
+            std::shared_ptr<RC_ITEM> item = errors.GetItem( ii );
+
+            markers.push_back( wxString::Format( wxS( "%d %s %s %s" ), item->GetErrorCode(),
+                                                 item->GetErrorMessage(),
+                                                 item->GetMainItemID().AsString(),
+                                                 item->GetAuxItemID().AsString() ) );
+        }
+
+        return markers;
+    }
+
+    SETTINGS_MANAGER           m_settingsManager;
+    std::unique_ptr<SCHEMATIC> m_schematic;
+};
+
+
+/**
+ * The tests run on the thread pool give the same markers, in the same order, as when they run
+ * one after another.
+ */
+BOOST_FIXTURE_TEST_CASE( ERCParallelMatchesSerial, ERC_PARALLEL_TEST_FIXTURE )
+{
+    LOCALE_IO dummy;
+
+    thread_pool& tp = GetKiCadThreadPool();
+    unsigned     poolThreads = tp.get_thread_count();
+    unsigned     threads = std::max( 4u, poolThreads );
+
+    // Whatever happens, leave the pool as it was for the other tests
+    auto restorePool = [&]() { tp.reset( poolThreads ); };
+    SCOPED_EXECUTION<std::function<void()>> poolGuard( []() {}, restorePool );
+
+    for( const wxString& name : { wxS( "issue9367" ), wxS( "issue10430" ), wxS( "issue6588" ),
+                                  wxS( "ERC_dynamic_power_symbol_test" ) } )
+    {
+        tp.reset( 1 );
+        std::vector<wxString> serial = runErc( name );
+
+        tp.reset( threads );
+        std::vector<wxString> parallel = runErc( name );
+
+        BOOST_TEST_CONTEXT( name )
+        {
+            BOOST_CHECK( !serial.empty() );
+            BOOST_CHECK_EQUAL_COLLECTIONS( serial.begin(), serial.end(), parallel.begin(),
+                                           parallel.end() );
+        }
+    }
+}
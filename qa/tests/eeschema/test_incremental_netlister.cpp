@@ -27,6 +27,7 @@
 
 #include <connection_graph.h>
 #include <schematic.h>
+#include <sch_label.h>
 #include <sch_sheet.h>
 #include <sch_screen.h>
 #include <settings/settings_manager.h>
@@ -161,4 +162,44 @@ BOOST_FIXTURE_TEST_CASE( RemoveAddItems, INCREMENTAL_NETLIST_TEST_FIXTURE )
             }
         }
     }
-}
\ No newline at end of file
+}
+
+
+BOOST_FIXTURE_TEST_CASE( RenameGlobalLabel, INCREMENTAL_NETLIST_TEST_FIXTURE )
+{
+    LOCALE_IO dummy;
+
+    KI_TEST::LoadSchematic( m_settingsManager, "issue9367", m_schematic );
+
+    SCH_SHEET_LIST    sheets = m_schematic->GetSheets();
+    CONNECTION_GRAPH* graph = m_schematic->ConnectionGraph();
+    SCH_GLOBALLABEL*  label = nullptr;
+
+    for( SCH_ITEM* item : sheets[0].LastScreen()->Items().OfType( SCH_GLOBAL_LABEL_T ) )
+    {
+        if( static_cast<SCH_GLOBALLABEL*>( item )->GetText() == wxS( "GL3" ) )
+            label = static_cast<SCH_GLOBALLABEL*>( item );
+    }
+
+    BOOST_REQUIRE( label );
+
+    // Renaming the label joins it to the nets of the existing "GL4" labels, which are not
+    // connected to it by anything else; they must be part of the incremental update.
+    label->SetText( wxS( "GL4" ) );
+
+    std::set<std::pair<SCH_SHEET_PATH, SCH_ITEM*>> all_items =
+            graph->ExtractAffectedItems( { label } );
+    all_items.insert( { sheets[0], label } );
+
+    CONNECTION_GRAPH new_graph( m_schematic.get() );
+
+    new_graph.SetLastCodes( graph );
+
+    for( auto&[ path, item ] : all_items )
+        item->SetConnectivityDirty();
+
+    new_graph.Recalculate( sheets, false );
+    graph->Merge( new_graph );
+
+    BOOST_CHECK_EQUAL( graph->VerifyIncremental( sheets ), 0 );
+}
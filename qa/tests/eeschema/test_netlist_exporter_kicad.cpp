@@ -20,6 +20,204 @@
 #include <qa_utils/wx_utils/unit_test_utils.h>
 #include <eeschema_test_utils.h>
 
+#include <regex>
+
+#include <connection_graph.h>
+#include <core/kicad_algo.h>
+#include <core/thread_pool.h>
+#include <richio.h>
+#include <scoped_set_reset.h>
+#include <sch_pin.h>
+#include <string_utils.h>
+#include <symbol.h>
+#include <xnode.h>
+
+
+/**
+ * Format the netlist the way it was written before it was streamed: the whole document tree
+ * is built and formatted at once, and its nets section comes from a copy of the previous net
+ * code rather than from visitNets().
+ */
+class NETLIST_EXPORTER_KICAD_REFERENCE : public NETLIST_EXPORTER_KICAD
+{
+public:
+    NETLIST_EXPORTER_KICAD_REFERENCE( SCHEMATIC* aSchematic ) :
+            NETLIST_EXPORTER_KICAD( aSchematic )
+    {}
+
+    void FormatReference( OUTPUTFORMATTER* aOut, int aCtl )
+    {
+        std::unique_ptr<XNODE> xroot( node( wxT( "export" ) ) );
+
+        xroot->AddAttribute( wxT( "version" ), wxT( "E" ) );
+
+        if( aCtl & GNL_HEADER )
+            xroot->AddChild( makeDesignHeader() );
+
+        if( aCtl & GNL_SYMBOLS )
+            xroot->AddChild( makeSymbols( aCtl ) );
+
+        if( aCtl & GNL_PARTS )
+            xroot->AddChild( makeLibParts() );
+
+        if( aCtl & GNL_LIBRARIES )
+            xroot->AddChild( makeLibraries() );
+
+        if( aCtl & GNL_NETS )
+            xroot->AddChild( makeReferenceNets( aCtl ) );
+
+        xroot->Format( aOut, 0 );
+    }
+
+private:
+    XNODE* makeReferenceNets( unsigned aCtl )
+    {
+        struct REF_NET_NODE
+        {
+            SCH_PIN*       m_Pin;
+            SCH_SHEET_PATH m_Sheet;
+        };
+
+        struct REF_NET_RECORD
+        {
+            wxString                  m_Name;
+            bool                      m_HasNoConnect = false;
+            std::vector<REF_NET_NODE> m_Nodes;
+        };
+
+        XNODE*                      xnets = node( wxT( "nets" ) );
+        std::vector<REF_NET_RECORD> nets;
+
+        for( const auto& [ key, subgraphs ] : m_schematic->ConnectionGraph()->GetNetMap() )
+        {
+            if( subgraphs.empty() )
+                continue;
+
+            REF_NET_RECORD& net_record = nets.emplace_back();
+
+            net_record.m_Name = key.Name;
+
+            for( CONNECTION_SUBGRAPH* subgraph : subgraphs )
+            {
+                const SCH_SHEET_PATH& sheet = subgraph->GetSheet();
+
+                if( subgraph->GetNoConnect()
+                        && subgraph->GetNoConnect()->Type() == SCH_NO_CONNECT_T )
+                {
+                    net_record.m_HasNoConnect = true;
+                }
+
+                for( SCH_ITEM* item : subgraph->GetItems() )
+                {
+                    if( item->Type() != SCH_PIN_T )
+                        continue;
+
+                    SCH_PIN* pin = static_cast<SCH_PIN*>( item );
+                    SYMBOL*  symbol = pin->GetParentSymbol();
+
+                    if( !symbol
+                       || ( ( aCtl & GNL_OPT_BOM ) && symbol->GetExcludedFromBOM() )
+                       || ( ( aCtl & GNL_OPT_KICAD ) && symbol->GetExcludedFromBoard() ) )
+                    {
+                        continue;
+                    }
+
+                    net_record.m_Nodes.push_back( { pin, sheet } );
+                }
+            }
+        }
+
+        std::sort( nets.begin(), nets.end(),
+                   []( const REF_NET_RECORD& a, const REF_NET_RECORD& b )
+                   {
+                       return StrNumCmp( a.m_Name, b.m_Name ) < 0;
+                   } );
+
+        auto ref =
+                []( const REF_NET_NODE& aNode )
+                {
+                    return aNode.m_Pin->GetParentSymbol()->GetRef( &aNode.m_Sheet );
+                };
+
+        for( int i = 0; i < (int) nets.size(); ++i )
+        {
+            REF_NET_RECORD& net_record = nets[i];
+            XNODE*          xnet = nullptr;
+
+            std::sort( net_record.m_Nodes.begin(), net_record.m_Nodes.end(),
+                       [&]( const REF_NET_NODE& a, const REF_NET_NODE& b )
+                       {
+                           if( ref( a ) == ref( b ) )
+                               return a.m_Pin->GetShownNumber() < b.m_Pin->GetShownNumber();
+
+                           return ref( a ) < ref( b );
+                       } );
+
+            alg::remove_duplicates( net_record.m_Nodes,
+                    [&]( const REF_NET_NODE& a, const REF_NET_NODE& b )
+                    {
+                        return ref( a ) == ref( b )
+                               && a.m_Pin->GetShownNumber() == b.m_Pin->GetShownNumber();
+                    } );
+
+            bool allNetPinsStacked = true;
+
+            if( net_record.m_Nodes.size() > 1 )
+            {
+                SCH_PIN* firstPin = net_record.m_Nodes.front().m_Pin;
+
+                allNetPinsStacked =
+                        std::all_of( net_record.m_Nodes.begin() + 1, net_record.m_Nodes.end(),
+                                     [=]( const REF_NET_NODE& aNode )
+                                     {
+                                         SCH_PIN* pin = aNode.m_Pin;
+
+                                         return firstPin->GetParent() == pin->GetParent()
+                                             && firstPin->GetPosition() == pin->GetPosition()
+                                             && firstPin->GetName() == pin->GetName();
+                                     } );
+            }
+
+            for( const REF_NET_NODE& netNode : net_record.m_Nodes )
+            {
+                wxString refText = ref( netNode );
+
+                if( refText[0] == wxChar( '#' ) )
+                    continue;
+
+                if( !xnet )
+                {
+                    xnets->AddChild( xnet = node( wxT( "net" ) ) );
+                    xnet->AddAttribute( wxT( "code" ), wxString::Format( wxT( "%d" ), i + 1 ) );
+                    xnet->AddAttribute( wxT( "name" ), net_record.m_Name );
+                }
+
+                XNODE* xnode;
+
+                xnet->AddChild( xnode = node( wxT( "node" ) ) );
+                xnode->AddAttribute( wxT( "ref" ), refText );
+                xnode->AddAttribute( wxT( "pin" ), netNode.m_Pin->GetShownNumber() );
+
+                wxString pinName = netNode.m_Pin->GetShownName();
+                wxString pinType = netNode.m_Pin->GetCanonicalElectricalTypeName();
+
+                if( !pinName.IsEmpty() )
+                    xnode->AddAttribute( wxT( "pinfunction" ), pinName );
+
+                if( net_record.m_HasNoConnect
+                    && ( net_record.m_Nodes.size() == 1 || allNetPinsStacked ) )
+                {
+                    pinType += wxT( "+no_connect" );
+                }
+
+                xnode->AddAttribute( wxT( "pintype" ), pinType );
+            }
+        }
+
+        return xnets;
+    }
+};
+
 
 class TEST_NETLIST_EXPORTER_KICAD_FIXTURE : public TEST_NETLIST_EXPORTER_FIXTURE<NETLIST_EXPORTER_KICAD>
 {
@@ -210,4 +408,60 @@ BOOST_AUTO_TEST_CASE( Issue16439 )
 }
 
 
+/**
+ * The streamed netlist is the same, byte for byte, as the whole tree formatted at once with
+ * the nets gathered by the previous code.
+ */
+BOOST_AUTO_TEST_CASE( StreamedMatchesReference )
+{
+    // The date of the design header is the only thing allowed to differ
+    const std::regex date( "\\(date \"[^\"]*\"\\)" );
+
+    for( const wxString& name : { "video", "complex_hierarchy", "noconnects",
+                                  "test_hier_no_connect", "bus_connection",
+                                  "test_multiunit_reannotate" } )
+    {
+        LoadSchematic( name );
+
+        for( int ctl : { GNL_ALL | GNL_OPT_KICAD,
+                         GNL_SYMBOLS | GNL_PARTS | GNL_LIBRARIES | GNL_OPT_KICAD,
+                         GNL_NETS | GNL_OPT_KICAD } )
+        {
+            STRING_FORMATTER streamed;
+            STRING_FORMATTER reference;
+
+            NETLIST_EXPORTER_KICAD( &m_schematic ).Format( &streamed, ctl );
+            NETLIST_EXPORTER_KICAD_REFERENCE( &m_schematic ).FormatReference( &reference, ctl );
+
+            BOOST_CHECK_EQUAL( std::regex_replace( streamed.GetString(), date, "" ),
+                               std::regex_replace( reference.GetString(), date, "" ) );
+        }
+    }
+
+    m_schematic.Reset();
+}
+
+
+/**
+ * Merging subgraphs and propagating names through the hierarchy run on the thread pool, so
+ * check the nets against the golden netlists with several threads whatever the machine has.
+ */
+BOOST_AUTO_TEST_CASE( ParallelPropagation )
+{
+    thread_pool& tp = GetKiCadThreadPool();
+    unsigned     poolThreads = tp.get_thread_count();
+
+    auto restorePool = [&]() { tp.reset( poolThreads ); };
+    SCOPED_EXECUTION<std::function<void()>> poolGuard( []() {}, restorePool );
+
+    tp.reset( std::max( 4u, poolThreads ) );
+
+    for( const wxString& name : { wxS( "video" ), wxS( "complex_hierarchy" ),
+                                  wxS( "hierarchy_aliases" ), wxS( "bus_connection" ) } )
+    {
+        TestNetlist( name );
+    }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the indexed loading of KiCad symbol libraries.
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+
+#include <lib_symbol.h>
+#include <richio.h>
+#include <sch_io/kicad_sexpr/sch_io_kicad_sexpr_lib_cache.h>
+#include <wildcards_and_files_ext.h>
+
+#include "eeschema_test_utils.h"
+
+
+static std::string formatSymbol( LIB_SYMBOL* aSymbol )
+{
+    STRING_FORMATTER formatter;
+
+    SCH_IO_KICAD_SEXPR_LIB_CACHE::SaveSymbol( aSymbol, formatter );
+
+    return formatter.GetString();
+}
+
+
+static std::string readIndexHeader( const wxString& aIndexFileName )
+{
+    wxFFile file( aIndexFileName, wxS( "rb" ) );
+    wxString content;
+
+    BOOST_REQUIRE( file.IsOpened() && file.ReadAll( &content ) );
+
+    return content.BeforeFirst( '\n' ).ToStdString();
+}
+
+
+BOOST_AUTO_TEST_SUITE( SchIoKicadSexprLibCache )
+
+
+/**
+ * Check that indexed libraries list the same symbols as fully loaded ones, and load them
+ * identically on demand.
+ */
+BOOST_AUTO_TEST_CASE( IndexedLibrary )
+{
+    for( const wxString& name : { wxS( "legacy_pspice/schematic_libspice" ),
+                                  wxS( "legacy_sources/v_i_sources" ) } )
+    {
+        BOOST_TEST_CONTEXT( name )
+        {
+            wxFileName source( KI_TEST::GetEeschemaTestDataDir() );
+            source.AppendDir( "spice_netlists" );
+            source.AppendDir( name.BeforeFirst( '/' ) );
+            source.SetName( name.AfterFirst( '/' ) );
+            source.SetExt( FILEEXT::KiCadSymbolLibFileExtension );
+
+            // The index is saved next to the library, so work on a copy of it
+            wxFileName lib( wxFileName::CreateTempFileName( wxS( "qa_eeschema" ) ) );
+            wxRemoveFile( lib.GetFullPath() );
+            lib.SetExt( FILEEXT::KiCadSymbolLibFileExtension );
+
+            BOOST_REQUIRE( wxCopyFile( source.GetFullPath(), lib.GetFullPath() ) );
+
+            wxString indexFileName =
+                    SCH_IO_KICAD_SEXPR_LIB_CACHE::GetIndexFileName( lib.GetFullPath() );
+
+            SCH_IO_KICAD_SEXPR_LIB_CACHE full( lib.GetFullPath() );
+            full.Load();
+
+            const LIB_SYMBOL_MAP& fullSymbols = full.GetSymbolMap();
+
+            BOOST_REQUIRE( !fullSymbols.empty() );
+
+            std::string indexHeader;
+
+            // Build the index and save it, then load it from the index file
+            for( int pass = 0; pass < 2; ++pass )
+            {
+                SCH_IO_KICAD_SEXPR_LIB_CACHE indexed( lib.GetFullPath() );
+                indexed.LoadIndex();
+
+                BOOST_REQUIRE( wxFileExists( indexFileName ) );
+
+                if( pass == 0 )
+                    indexHeader = readIndexHeader( indexFileName );
+                else
+                    BOOST_CHECK_EQUAL( readIndexHeader( indexFileName ), indexHeader );
+
+                const LIB_SYMBOL_MAP& symbols = indexed.GetSymbolMap();
+
+                BOOST_REQUIRE_EQUAL( symbols.size(), fullSymbols.size() );
+
+                // Everything listed in the symbol chooser is there before loading the symbols
+                for( const auto& [ symbolName, fullSymbol ] : fullSymbols )
+                {
+                    LIB_SYMBOL* symbol = symbols.at( symbolName );
+
+                    BOOST_CHECK_EQUAL( symbol->GetDescription(), fullSymbol->GetDescription() );
+                    BOOST_CHECK_EQUAL( symbol->GetKeyWords(), fullSymbol->GetKeyWords() );
+                    BOOST_CHECK_EQUAL( symbol->GetUnitCount(), fullSymbol->GetUnitCount() );
+                    BOOST_CHECK_EQUAL( symbol->IsPower(), fullSymbol->IsPower() );
+                    BOOST_CHECK_EQUAL( symbol->IsAlias(), fullSymbol->IsAlias() );
+                }
+
+                for( const auto& [ symbolName, fullSymbol ] : fullSymbols )
+                {
+                    LIB_SYMBOL* symbol = symbols.at( symbolName );
+
+                    indexed.LoadSymbol( symbol );
+
+                    BOOST_CHECK( symbols.at( symbolName ) == symbol );
+                    BOOST_CHECK_EQUAL( formatSymbol( symbol ), formatSymbol( fullSymbol ) );
+                    BOOST_CHECK_EQUAL( symbol->GetPinCount(), fullSymbol->GetPinCount() );
+
+                    if( LIB_SYMBOL_SPTR parent = symbol->GetParent().lock() )
+                        BOOST_CHECK( symbols.at( parent->GetName() ) == parent.get() );
+                }
+            }
+
+            // Changing the library makes the index out of date
+            {
+                wxFFile file( lib.GetFullPath(), wxS( "ab" ) );
+                BOOST_REQUIRE( file.IsOpened() && file.Write( wxS( "\n" ) ) );
+            }
+
+            SCH_IO_KICAD_SEXPR_LIB_CACHE indexed( lib.GetFullPath() );
+            indexed.LoadIndex();
+
+            BOOST_CHECK_NE( readIndexHeader( indexFileName ), indexHeader );
+            BOOST_CHECK_EQUAL( indexed.GetSymbolMap().size(), fullSymbols.size() );
+
+            indexed.LoadAllSymbols();
+
+            for( const auto& [ symbolName, fullSymbol ] : fullSymbols )
+            {
+                BOOST_CHECK_EQUAL( formatSymbol( indexed.GetSymbolMap().at( symbolName ) ),
+                                   formatSymbol( fullSymbol ) );
+            }
+
+            wxRemoveFile( indexFileName );
+            wxRemoveFile( lib.GetFullPath() );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include "eeschema_test_utils.h"
+
+#include <sch_painter.h>
+#include <sch_symbol.h>
+#include <sch_screen.h>
+
+
+class TEST_SCH_PAINTER_FIXTURE : public KI_TEST::SCHEMATIC_TEST_FIXTURE
+{};
+
+
+BOOST_FIXTURE_TEST_SUITE( SchPainter, TEST_SCH_PAINTER_FIXTURE )
+
+
+/**
+ * Check that symbols with the same body share their drawing, and that anything changing the
+ * drawing of the body changes the instance key.
+ */
+BOOST_AUTO_TEST_CASE( SymbolInstanceKeys )
+{
+    LoadSchematic( "bus_entries" );
+
+    SCH_SYMBOL* symbol = nullptr;
+
+    for( SCH_ITEM* item : m_schematic.RootScreen()->Items().OfType( SCH_SYMBOL_T ) )
+    {
+        if( static_cast<SCH_SYMBOL*>( item )->GetLibSymbolRef() )
+        {
+            symbol = static_cast<SCH_SYMBOL*>( item );
+            break;
+        }
+    }
+
+    BOOST_REQUIRE( symbol );
+
+    KIGFX::SCH_PAINTER painter( nullptr );
+    painter.SetSchematic( &m_schematic );
+
+    size_t   key = 0;
+    VECTOR2I offset;
+
+    BOOST_REQUIRE( painter.GetInstanceKey( symbol, LAYER_DEVICE, key, offset ) );
+    BOOST_CHECK_EQUAL( offset, symbol->GetPosition() );
+
+    // Fields are drawn per symbol
+    size_t   otherKey = 0;
+    VECTOR2I otherOffset;
+
+    BOOST_CHECK( !painter.GetInstanceKey( symbol, LAYER_REFERENCEPART, otherKey, otherOffset ) );
+
+    // A moved copy is the same drawing at another position
+    SCH_SYMBOL copy( *symbol );
+    copy.Move( VECTOR2I( schIUScale.MilsToIU( 500 ), schIUScale.MilsToIU( 300 ) ) );
+
+    BOOST_REQUIRE( painter.GetInstanceKey( &copy, LAYER_DEVICE, otherKey, otherOffset ) );
+    BOOST_CHECK_EQUAL( otherKey, key );
+    BOOST_CHECK_EQUAL( otherOffset - offset,
+                       VECTOR2I( schIUScale.MilsToIU( 500 ), schIUScale.MilsToIU( 300 ) ) );
+
+    // Other orientations are other drawings
+    copy.SetOrientation( SYM_ORIENT_90 );
+
+    BOOST_REQUIRE( painter.GetInstanceKey( &copy, LAYER_DEVICE, otherKey, otherOffset ) );
+    BOOST_CHECK_NE( otherKey, key );
+
+    copy.SetTransform( symbol->GetTransform() );
+
+    BOOST_REQUIRE( painter.GetInstanceKey( &copy, LAYER_DEVICE, otherKey, otherOffset ) );
+    BOOST_CHECK_EQUAL( otherKey, key );
+
+    // So are dimmed symbols and edited bodies
+    copy.SetDNP( true );
+
+    BOOST_REQUIRE( painter.GetInstanceKey( &copy, LAYER_DEVICE, otherKey, otherOffset ) );
+    BOOST_CHECK_NE( otherKey, key );
+
+    copy.SetDNP( false );
+    copy.SetShowPinNames( !copy.GetShowPinNames() );
+
+    BOOST_REQUIRE( painter.GetInstanceKey( &copy, LAYER_DEVICE, otherKey, otherOffset ) );
+    BOOST_CHECK_NE( otherKey, key );
+
+    // Selected symbols are not shared
+    symbol->SetSelected();
+    BOOST_CHECK( !painter.GetInstanceKey( symbol, LAYER_DEVICE, key, offset ) );
+    symbol->ClearSelected();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
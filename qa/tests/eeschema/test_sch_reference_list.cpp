@@ -296,4 +296,80 @@ BOOST_AUTO_TEST_CASE( ReannotateDuplicates )
 }
 
 
+BOOST_AUTO_TEST_CASE( ReannotateDuplicatesWithIndex )
+{
+    for( const DUPLICATE_REANNOTATION_CASE& c : reannotateDuplicatesCases )
+    {
+        BOOST_TEST_INFO_SCOPE( c.m_caseName );
+
+        loadTestCase( c.m_SchematicRelativePath, c.m_ExpectedReannotations );
+
+        SCH_REFERENCE_LIST  additionalRefs = getAdditionalRefs();
+        SCH_REFERENCE_INDEX index;
+
+        additionalRefs.SplitReferences();
+
+        for( const SCH_REFERENCE& ref : additionalRefs )
+            index.Add( ref );
+
+        m_refsToReannotate.ReannotateByOptions( UNSORTED, INCREMENTAL_BY_REF, 0, index, true,
+                                                nullptr );
+        m_refsToReannotate.UpdateAnnotation();
+
+        checkAnnotation( c.m_ExpectedReannotations );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( ReferenceIndex )
+{
+    LoadSchematic( "test_multiunit_reannotate_5" );
+
+    // U1 (units A, B and C) and twice U2 (units A, B and C)
+    SCH_REFERENCE_LIST refs;
+    m_schematic.GetSheets().GetSymbols( refs );
+    refs.SplitReferences();
+
+    SCH_REFERENCE_INDEX index;
+
+    for( const SCH_REFERENCE& ref : refs )
+        index.Add( ref );
+
+    BOOST_CHECK_EQUAL( index.Count( wxS( "U" ), 1, 1 ), 1 );
+    BOOST_CHECK_EQUAL( index.Count( wxS( "U" ), 2, 2 ), 2 );
+    BOOST_CHECK_EQUAL( index.Count( wxS( "U" ), 3, 1 ), 0 );
+
+    BOOST_CHECK_EQUAL( index.FindFirstFreeNumber( wxS( "U" ), 1 ), 3 );
+    BOOST_CHECK_EQUAL( index.FindFirstFreeNumber( wxS( "u" ), 2 ), 3 );
+    BOOST_CHECK_EQUAL( index.FindFirstFreeNumber( wxS( "U" ), 7 ), 7 );
+    BOOST_CHECK_EQUAL( index.FindFirstFreeNumber( wxS( "R" ), 1 ), 1 );
+
+    // A stacked index sees the numbers of its base
+    SCH_REFERENCE_INDEX stacked( &index );
+
+    BOOST_CHECK_EQUAL( stacked.FindFirstFreeNumber( wxS( "U" ), 1 ), 3 );
+    BOOST_CHECK_EQUAL( stacked.Count( wxS( "U" ), 2, 3 ), 2 );
+
+    // The units of U1 are all used, and the U2 units are used twice
+    BOOST_CHECK_EQUAL( index.FindFirstUnusedReference( refs[0], 1, { 1 } ), 3 );
+
+    // Removing all the units of U1 frees its number
+    for( const SCH_REFERENCE& ref : refs )
+    {
+        if( ref.GetRefNumber() == wxS( "1" ) )
+            index.Remove( ref );
+    }
+
+    BOOST_CHECK_EQUAL( index.Count( wxS( "U" ), 1, 1 ), 0 );
+    BOOST_CHECK_EQUAL( index.FindFirstFreeNumber( wxS( "U" ), 1 ), 1 );
+    BOOST_CHECK_EQUAL( index.FindFirstFreeNumber( wxS( "U" ), 2 ), 3 );
+
+    for( const SCH_REFERENCE& ref : refs )
+        index.RemoveSymbol( ref.GetSymbol() );
+
+    BOOST_CHECK( index.IsEmpty() );
+    BOOST_CHECK_EQUAL( index.FindFirstFreeNumber( wxS( "U" ), 1 ), 1 );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
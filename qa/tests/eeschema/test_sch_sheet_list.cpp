@@ -20,6 +20,8 @@
 #include <qa_utils/wx_utils/unit_test_utils.h>
 #include "eeschema_test_utils.h"
 
+#include <sch_screen.h>
+#include <sch_sheet.h>
 #include <sch_sheet_path.h>
 #include <wildcards_and_files_ext.h>
 
@@ -162,4 +164,44 @@ BOOST_AUTO_TEST_CASE( TestEditPageNumbersInSharedDesign )
     }
 }
 
+
+/**
+ * The sheet files are parsed in parallel before being linked to the hierarchy; check that every
+ * sheet ends up with the single screen of its file, shared by all the sheets using it.
+ */
+BOOST_AUTO_TEST_CASE( TestLoadedHierarchyLinks )
+{
+    for( const wxString& name : { wxS( "video/video" ),
+                                  wxS( "complex_hierarchy_shared/complex_hierarchy" ) } )
+    {
+        LoadSchematic( name );
+
+        SCH_SHEET_LIST                              sheets = m_schematic.GetSheets();
+        std::map<wxString, SCH_SCREEN*>             fileScreens;
+        std::map<SCH_SCREEN*, std::set<SCH_SHEET*>> screenSheets;
+
+        for( const SCH_SHEET_PATH& path : sheets )
+        {
+            SCH_SCREEN* screen = path.LastScreen();
+
+            BOOST_REQUIRE( screen );
+            BOOST_CHECK( screen->FileExists() );
+
+            auto it = fileScreens.emplace( screen->GetFileName(), screen ).first;
+
+            BOOST_CHECK_MESSAGE( it->second == screen,
+                                 screen->GetFileName() << " loaded more than once" );
+
+            screenSheets[screen].insert( path.Last() );
+
+            for( SCH_ITEM* item : screen->Items().OfType( SCH_SHEET_T ) )
+                BOOST_CHECK( static_cast<SCH_SHEET*>( item )->GetScreen() );
+        }
+
+        for( const auto& [ screen, screenSheetSet ] : screenSheets )
+            BOOST_CHECK_EQUAL( screen->GetRefCount(), (int) screenSheetSet.size() );
+    }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
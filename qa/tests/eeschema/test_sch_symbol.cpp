@@ -33,6 +33,13 @@
 
 #include <sch_edit_frame.h>
 
+#include "eeschema_test_utils.h"
+#include <lib_pin.h>
+#include <lib_symbol.h>
+#include <lib_symbol_store.h>
+#include <sch_screen.h>
+#include <wildcards_and_files_ext.h>
+
 class TEST_SCH_SYMBOL_FIXTURE
 {
 public:
@@ -77,4 +84,110 @@ BOOST_AUTO_TEST_CASE( Orientation )
 }
 
 
+BOOST_AUTO_TEST_SUITE_END()
+
+
+class TEST_SCH_SYMBOL_SHARING_FIXTURE : public KI_TEST::SCHEMATIC_TEST_FIXTURE
+{
+protected:
+    wxFileName GetSchematicPath( const wxString& aRelativePath ) override
+    {
+        wxFileName fn( KI_TEST::GetEeschemaTestDataDir() );
+        fn.AppendDir( "netlists" );
+
+        wxString path = fn.GetFullPath();
+        path += aRelativePath + wxT( "." ) + FILEEXT::KiCadSchematicFileExtension;
+
+        return wxFileName( path );
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SchSymbolSharing, TEST_SCH_SYMBOL_SHARING_FIXTURE )
+
+
+/**
+ * Check that symbols using the same library symbol share it, and get their own copy when
+ * changing it.
+ */
+BOOST_AUTO_TEST_CASE( SharedLibSymbol )
+{
+    LoadSchematic( "complex_hierarchy/complex_hierarchy" );
+
+    SCH_SCREENS                 screens( m_schematic.Root() );
+    SCH_SYMBOL*                 first = nullptr;
+    SCH_SYMBOL*                 second = nullptr;
+    size_t                      symbolCount = 0;
+    std::set<const LIB_SYMBOL*> libSymbols;
+
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+    {
+        std::map<wxString, SCH_SYMBOL*> symbolsByLibName;
+
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_SYMBOL_T ) )
+        {
+            SCH_SYMBOL* symbol = static_cast<SCH_SYMBOL*>( item );
+
+            BOOST_REQUIRE( symbol->GetLibSymbolRef() );
+
+            auto [ it, inserted ] = symbolsByLibName.emplace( symbol->GetSchSymbolLibraryName(),
+                                                              symbol );
+
+            if( !inserted )
+            {
+                BOOST_CHECK( it->second->GetLibSymbolRef() == symbol->GetLibSymbolRef() );
+
+                if( !first )
+                {
+                    first = it->second;
+                    second = symbol;
+                }
+            }
+
+            libSymbols.insert( symbol->GetLibSymbolRef() );
+            symbolCount++;
+        }
+    }
+
+    BOOST_REQUIRE( first && second );
+    BOOST_CHECK_LT( libSymbols.size(), symbolCount );
+    BOOST_CHECK_LE( libSymbols.size(), LIB_SYMBOL_STORE::Get().GetCount() );
+
+    // Copies share the library symbol too
+    SCH_SYMBOL copy( *first );
+
+    BOOST_CHECK( copy.GetLibSymbolRef() == first->GetLibSymbolRef() );
+
+    // Changing a setting stored in the library symbol only affects the changed symbol
+    bool showPinNames = first->GetShowPinNames();
+
+    first->SetShowPinNames( !showPinNames );
+
+    BOOST_CHECK( first->GetLibSymbolRef() != second->GetLibSymbolRef() );
+    BOOST_CHECK_EQUAL( first->GetShowPinNames(), !showPinNames );
+    BOOST_CHECK_EQUAL( second->GetShowPinNames(), showPinNames );
+    BOOST_CHECK_EQUAL( copy.GetShowPinNames(), showPinNames );
+
+    // The pins of the changed symbol follow its own library symbol
+    std::vector<LIB_PIN*> libPins;
+    first->GetLibSymbolRef()->GetPins( libPins, first->GetUnit(), first->GetBodyStyle() );
+
+    BOOST_CHECK( !libPins.empty() );
+
+    for( LIB_PIN* libPin : libPins )
+        BOOST_CHECK( first->GetPin( libPin ) );
+
+    // Appending a symbol to a screen keeps sharing its library symbol, and leaves the library
+    // symbol of the other symbols alone
+    const LIB_SYMBOL* secondLibSymbol = second->GetLibSymbolRef();
+    SCH_SCREEN*       screen = static_cast<SCH_SCREEN*>( second->GetParent() );
+    SCH_SYMBOL*       appended = new SCH_SYMBOL( *second );
+
+    screen->Append( appended );
+
+    BOOST_CHECK( second->GetLibSymbolRef() == secondLibSymbol );
+    BOOST_CHECK( appended->GetLibSymbolRef() == secondLibSymbol );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <cmath>
+#include <random>
+
+#include <geometry/edge_rtree.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+namespace
+{
+
+/**
+ * A wavy, star-shaped outline with \a aCount vertices, optionally snapped to a coarse grid so
+ * that there are plenty of horizontal edges and vertex hits.
+ */
+SHAPE_LINE_CHAIN makeOutline( int aCount, std::mt19937& aRng, bool aSnap )
+{
+    SHAPE_LINE_CHAIN                 chain;
+    std::uniform_real_distribution<> noise( 0.0, 0.2 );
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        double   angle = 2 * M_PI * ii / aCount;
+        double   radius = 1e6 * ( 1 + 0.5 * std::sin( angle * 37 ) + noise( aRng ) );
+        VECTOR2I pt( radius * std::cos( angle ), radius * std::sin( angle ) );
+
+        if( aSnap )
+            pt = VECTOR2I( pt.x / 1000 * 1000, pt.y / 1000 * 1000 );
+
+        chain.Append( pt );
+    }
+
+    chain.SetClosed( true );
+    return chain;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( EdgeRTree )
+
+
+/**
+ * Index queries must give exactly the answers of the linear scans.
+ */
+BOOST_AUTO_TEST_CASE( MatchesLinearScan )
+{
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> coord( -2000000, 2000000 );
+
+    for( int iter = 0; iter < 20; iter++ )
+    {
+        SHAPE_LINE_CHAIN chain = makeOutline( 300 + iter * 97, rng, iter % 2 == 0 );
+        EDGE_RTREE       index( chain.CPoints(), true );
+
+        BOOST_REQUIRE_EQUAL( (int) index.SegmentCount(), chain.SegmentCount() );
+
+        for( int q = 0; q < 100; q++ )
+        {
+            VECTOR2I pt( coord( rng ), coord( rng ) );
+
+            // Include some points exactly on (or right next to) a vertex
+            if( q % 10 == 0 )
+                pt = chain.CPoint( rng() % chain.PointCount() );
+            else if( q % 10 == 1 )
+                pt = chain.CPoint( rng() % chain.PointCount() ) + VECTOR2I( 1, 0 );
+
+            SEG query( pt, pt + VECTOR2I( coord( rng ) / 10, coord( rng ) / 10 ) );
+
+            SEG::ecoord ptDist = VECTOR2I::ECOORD_MAX;
+            SEG::ecoord segDist = VECTOR2I::ECOORD_MAX;
+            int         ptIdx = -1;
+            int         segIdx = -1;
+
+            for( int ii = 0; ii < chain.SegmentCount(); ii++ )
+            {
+                if( chain.CSegment( ii ).SquaredDistance( pt ) < ptDist )
+                {
+                    ptDist = chain.CSegment( ii ).SquaredDistance( pt );
+                    ptIdx = ii;
+                }
+
+                if( chain.CSegment( ii ).SquaredDistance( query ) < segDist )
+                {
+                    segDist = chain.CSegment( ii ).SquaredDistance( query );
+                    segIdx = ii;
+                }
+            }
+
+            BOOST_TEST_CONTEXT( "Iteration " << iter << ", query " << q )
+            {
+                SEG::ecoord dist;
+
+                BOOST_CHECK_EQUAL( index.RayCrossingParity( pt ),
+                                   chain.SHAPE_LINE_CHAIN_BASE::PointInside( pt ) );
+
+                BOOST_CHECK_EQUAL( index.Nearest( pt, &dist ), ptIdx );
+                BOOST_CHECK_EQUAL( dist, ptDist );
+
+                BOOST_CHECK_EQUAL( index.Nearest( query, &dist ), segIdx );
+                BOOST_CHECK_EQUAL( dist, segDist );
+            }
+        }
+    }
+}
+
+
+/**
+ * The chain's own index is built lazily and dropped when the chain changes.
+ */
+BOOST_AUTO_TEST_CASE( LazyBuildAndInvalidate )
+{
+    std::mt19937     rng( 7 );
+    SHAPE_LINE_CHAIN chain = makeOutline( 1000, rng, false );
+
+    BOOST_CHECK( chain.EdgeIndex() == nullptr );
+
+    for( int ii = 0; ii < EDGE_RTREE_CACHE::WARMUP_QUERIES; ii++ )
+        chain.PointInside( VECTOR2I( 0, 0 ) );
+
+    BOOST_REQUIRE( chain.EdgeIndex() != nullptr );
+    BOOST_CHECK( chain.PointInside( VECTOR2I( 0, 0 ) ) );
+    BOOST_CHECK( !chain.PointInside( VECTOR2I( 5000000, 0 ) ) );
+
+    // Moving the chain must not leave a stale index behind
+    chain.Move( VECTOR2I( 5000000, 0 ) );
+
+    BOOST_CHECK( chain.EdgeIndex() == nullptr );
+    BOOST_CHECK( !chain.PointInside( VECTOR2I( 0, 0 ) ) );
+
+    for( int ii = 0; ii < EDGE_RTREE_CACHE::WARMUP_QUERIES; ii++ )
+        chain.PointInside( VECTOR2I( 0, 0 ) );
+
+    BOOST_CHECK( chain.PointInside( VECTOR2I( 5000000, 0 ) ) );
+
+    SHAPE_POLY_SET poly;
+    poly.AddOutline( chain );
+
+    for( int ii = 0; ii < 2 * EDGE_RTREE_CACHE::WARMUP_QUERIES; ii++ )
+    {
+        BOOST_CHECK( poly.Contains( VECTOR2I( 5000000, 0 ) ) );
+        BOOST_CHECK( !poly.Contains( VECTOR2I( 0, 0 ) ) );
+        BOOST_CHECK( poly.Collide( VECTOR2I( 0, 0 ), 10000000 ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
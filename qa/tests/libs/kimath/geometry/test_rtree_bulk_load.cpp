@@ -0,0 +1,161 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <climits>
+#include <random>
+#include <set>
+
+#include <geometry/rtree.h>
+
+
+namespace
+{
+
+using TREE = RTree<intptr_t, int, 3, double>;
+using ENTRY = std::pair<TREE::Rect, intptr_t>;
+
+
+/**
+ * Random boxes spread over a board-sized area and 32 layers, sized like tracks and pads.
+ */
+std::vector<ENTRY> makeEntries( size_t aCount, std::mt19937& aRng )
+{
+    std::uniform_int_distribution<int> coord( 0, 300000000 );
+    std::uniform_int_distribution<int> size( 0, 2000000 );
+    std::uniform_int_distribution<int> layer( 0, 31 );
+    std::vector<ENTRY>                 entries;
+
+    for( size_t ii = 0; ii < aCount; ii++ )
+    {
+        TREE::Rect rect;
+
+        // Every seventh entry is on all layers, like a through-hole pad or via
+        rect.m_min[0] = ( ii % 7 == 0 ) ? 0 : layer( aRng );
+        rect.m_max[0] = ( ii % 7 == 0 ) ? 31 : rect.m_min[0];
+        rect.m_min[1] = coord( aRng );
+        rect.m_max[1] = rect.m_min[1] + size( aRng );
+        rect.m_min[2] = coord( aRng );
+        rect.m_max[2] = rect.m_min[2] + size( aRng );
+
+        entries.emplace_back( rect, (intptr_t) ii );
+    }
+
+    return entries;
+}
+
+
+std::set<intptr_t> search( const TREE& aTree, const TREE::Rect& aRect )
+{
+    std::set<intptr_t> found;
+
+    auto visitor =
+            [&]( const intptr_t& aData ) -> bool
+            {
+                found.insert( aData );
+                return true;
+            };
+
+    aTree.Search( aRect.m_min, aRect.m_max, visitor );
+    return found;
+}
+
+
+TREE::Rect makeQuery( std::mt19937& aRng, int aSize )
+{
+    std::uniform_int_distribution<int> coord( 0, 300000000 );
+    std::uniform_int_distribution<int> layer( 0, 31 );
+    TREE::Rect                         rect;
+
+    rect.m_min[0] = rect.m_max[0] = layer( aRng );
+    rect.m_min[1] = coord( aRng );
+    rect.m_max[1] = rect.m_min[1] + aSize;
+    rect.m_min[2] = coord( aRng );
+    rect.m_max[2] = rect.m_min[2] + aSize;
+
+    return rect;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( RTreeBulkLoad )
+
+
+/**
+ * A bulk loaded tree must hold the same entries as one built by inserting them one by one, and
+ * must stay usable for further inserts and removals.
+ */
+BOOST_AUTO_TEST_CASE( MatchesInsert )
+{
+    std::mt19937 rng( 42 );
+
+    for( size_t count : { 0, 1, 8, 9, 64, 65, 1000, 20000 } )
+    {
+        std::vector<ENTRY> entries = makeEntries( count, rng );
+        TREE               inserted;
+        TREE               bulk;
+
+        for( const ENTRY& entry : entries )
+            inserted.Insert( entry.first.m_min, entry.first.m_max, entry.second );
+
+        // Load in two goes to check that existing entries are kept
+        bulk.BulkLoad( std::vector<ENTRY>( entries.begin(), entries.begin() + count / 2 ) );
+        bulk.BulkLoad( std::vector<ENTRY>( entries.begin() + count / 2, entries.end() ) );
+
+        BOOST_REQUIRE_EQUAL( bulk.Count(), (int) count );
+
+        for( size_t ii = 0; ii < count / 10; ii++ )
+        {
+            const ENTRY& entry = entries[ii];
+
+            BOOST_CHECK( !bulk.Remove( entry.first.m_min, entry.first.m_max, entry.second ) );
+            inserted.Remove( entry.first.m_min, entry.first.m_max, entry.second );
+
+            bulk.Insert( entry.first.m_min, entry.first.m_max, entry.second + count );
+            inserted.Insert( entry.first.m_min, entry.first.m_max, entry.second + count );
+        }
+
+        for( int q = 0; q < 200; q++ )
+        {
+            TREE::Rect         query = makeQuery( rng, 20000000 );
+            std::set<intptr_t> iterated;
+
+            for( auto it = bulk.begin( query ); it != bulk.end( query ); ++it )
+                iterated.insert( *it );
+
+            BOOST_TEST_CONTEXT( "Count " << count << ", query " << q )
+            {
+                BOOST_CHECK( search( bulk, query ) == search( inserted, query ) );
+                BOOST_CHECK( iterated == search( inserted, query ) );
+            }
+        }
+
+        bulk.RemoveAll();
+        BOOST_CHECK_EQUAL( bulk.Count(), 0 );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
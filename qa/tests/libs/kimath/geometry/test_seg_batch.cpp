@@ -0,0 +1,209 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <random>
+
+#include <geometry/seg_batch.h>
+#include <geometry/shape_line_chain.h>
+
+
+BOOST_AUTO_TEST_SUITE( SegBatch )
+
+
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    SEG_BATCH batch;
+
+    BOOST_CHECK_EQUAL( batch.Nearest( VECTOR2I( 0, 0 ) ).m_Index, -1 );
+    BOOST_CHECK( !batch.Collide( SEG( 0, 0, 10, 10 ), 100 ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Simple )
+{
+    SEG_BATCH batch;
+
+    batch.Add( SEG( 0, 0, 100, 0 ), 7 );
+    batch.Add( SEG( 0, 50, 100, 50 ), 3 );
+    batch.Add( SEG( 200, 200, 200, 200 ), 5 );   // degenerate
+
+    SEG_BATCH::NEAREST nearest = batch.Nearest( VECTOR2I( 50, 40 ) );
+
+    BOOST_CHECK_EQUAL( nearest.m_Index, 3 );
+    BOOST_CHECK_EQUAL( nearest.m_SquaredDistance, 100 );
+
+    nearest = batch.Nearest( VECTOR2I( 203, 204 ) );
+
+    BOOST_CHECK_EQUAL( nearest.m_Index, 5 );
+    BOOST_CHECK_EQUAL( nearest.m_SquaredDistance, 25 );
+
+    // Crossing the first two segments; the first one wins the tie
+    nearest = batch.Nearest( SEG( 50, -10, 50, 60 ) );
+
+    BOOST_CHECK_EQUAL( nearest.m_Index, 7 );
+    BOOST_CHECK_EQUAL( nearest.m_SquaredDistance, 0 );
+
+    int actual = -1;
+    int index = -1;
+
+    BOOST_CHECK( batch.Collide( SEG( 150, 40, 150, 45 ), 60, &actual, &index ) );
+    BOOST_CHECK_EQUAL( actual, 50 );
+    BOOST_CHECK_EQUAL( index, 3 );
+    BOOST_CHECK( !batch.Collide( SEG( 150, 40, 150, 45 ), 50 ) );
+}
+
+
+/**
+ * The batch kernels are only a filter: results must match the exact per-segment loop,
+ * including which segment wins a tie.
+ */
+BOOST_AUTO_TEST_CASE( MatchesScalar )
+{
+    BOOST_TEST_MESSAGE( "SEG_BATCH kernel: " << SEG_BATCH::KernelName() );
+
+    std::mt19937 rng( 1234 );
+
+    for( int iter = 0; iter < 300; iter++ )
+    {
+        const int range = ( iter % 3 == 0 ) ? 100 : ( iter % 3 == 1 ) ? 100000 : 1000000000;
+        std::uniform_int_distribution<int> coord( -range, range );
+
+        SEG_BATCH        batch;
+        std::vector<SEG> segs;
+        const int        count = 1 + iter * 3;
+
+        for( int ii = 0; ii < count; ii++ )
+        {
+            SEG seg( coord( rng ), coord( rng ), coord( rng ), coord( rng ) );
+
+            if( ii % 17 == 0 )
+                seg.B = seg.A;
+
+            segs.push_back( seg );
+            batch.Add( seg );
+        }
+
+        VECTOR2I pt( coord( rng ), coord( rng ) );
+        SEG      query( coord( rng ), coord( rng ), coord( rng ), coord( rng ) );
+
+        if( iter % 5 == 0 )
+            query.B = query.A;
+
+        SEG::ecoord ptDist = VECTOR2I::ECOORD_MAX;
+        SEG::ecoord segDist = VECTOR2I::ECOORD_MAX;
+        int         ptIdx = -1;
+        int         segIdx = -1;
+
+        for( int ii = 0; ii < count; ii++ )
+        {
+            if( segs[ii].SquaredDistance( pt ) < ptDist )
+            {
+                ptDist = segs[ii].SquaredDistance( pt );
+                ptIdx = ii;
+            }
+
+            if( segs[ii].SquaredDistance( query ) < segDist )
+            {
+                segDist = segs[ii].SquaredDistance( query );
+                segIdx = ii;
+            }
+        }
+
+        BOOST_TEST_CONTEXT( "Iteration " << iter )
+        {
+            SEG_BATCH::NEAREST ptNearest = batch.Nearest( pt );
+            SEG_BATCH::NEAREST segNearest = batch.Nearest( query );
+
+            BOOST_CHECK_EQUAL( ptNearest.m_SquaredDistance, ptDist );
+            BOOST_CHECK_EQUAL( ptNearest.m_Index, ptIdx );
+            BOOST_CHECK_EQUAL( segNearest.m_SquaredDistance, segDist );
+            BOOST_CHECK_EQUAL( segNearest.m_Index, segIdx );
+        }
+    }
+}
+
+
+/**
+ * Long chains go through the batch path; check it against the individual segments.
+ */
+BOOST_AUTO_TEST_CASE( LineChainCollide )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    // Horizontal steps alternating between y = 0 and y = 1000
+    for( int ii = 0; ii < 100; ii++ )
+        chain.Append( VECTOR2I( ii * 1000, ( ( ii / 2 ) % 2 ) * 1000 ) );
+
+    BOOST_REQUIRE_GE( chain.SegmentCount(), (int) SEG_BATCH::MIN_BATCH_SIZE );
+
+    int      actual = -1;
+    VECTOR2I location;
+
+    BOOST_CHECK( chain.Collide( VECTOR2I( 50500, 1200 ), 300, &actual, &location ) );
+    BOOST_CHECK_EQUAL( actual, 200 );
+    BOOST_CHECK_EQUAL( location, VECTOR2I( 50500, 1000 ) );
+
+    BOOST_CHECK( chain.Collide( SEG( 50500, 1200, 50500, 5000 ), 300, &actual, &location ) );
+    BOOST_CHECK_EQUAL( actual, 200 );
+
+    BOOST_CHECK( !chain.Collide( VECTOR2I( 50500, 1200 ), 200 ) );
+    BOOST_CHECK( chain.Collide( SEG( 500, -100, 500, 2000 ), 0, &actual ) );
+    BOOST_CHECK_EQUAL( actual, 0 );
+}
+
+
+/**
+ * The cached batch of a chain is reused between queries and rebuilt after a change.
+ */
+BOOST_AUTO_TEST_CASE( LineChainCachedBatch )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int ii = 0; ii < 20; ii++ )
+        chain.Append( VECTOR2I( ii * 1000, 0 ) );
+
+    const SEG_BATCH* batch = &chain.SegBatch();
+
+    BOOST_CHECK_EQUAL( batch->Size(), (size_t) chain.SegmentCount() );
+    BOOST_CHECK_EQUAL( &chain.SegBatch(), batch );
+    BOOST_CHECK( chain.Collide( VECTOR2I( 5500, 100 ), 200 ) );
+
+    chain.Move( VECTOR2I( 0, 1000 ) );
+
+    BOOST_CHECK( !chain.Collide( VECTOR2I( 5500, 100 ), 200 ) );
+    BOOST_CHECK( chain.Collide( VECTOR2I( 5500, 1100 ), 200 ) );
+
+    chain.Append( VECTOR2I( 20000, 1000 ) );
+
+    BOOST_CHECK_EQUAL( chain.SegBatch().Size(), (size_t) chain.SegmentCount() );
+
+    // Copies don't share the cache
+    SHAPE_LINE_CHAIN copy( chain );
+
+    BOOST_CHECK_NE( &copy.SegBatch(), &chain.SegBatch() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -191,3 +191,45 @@ BOOST_FIXTURE_TEST_CASE( DRCFalseNegativeRegressions, DRC_REGRESSION_TEST_FIXTUR
         }
     }
 }
+
+
+BOOST_FIXTURE_TEST_CASE( DRCReportOrderIsStable, DRC_REGRESSION_TEST_FIXTURE )
+{
+    // Several providers run their tests on the thread pool; the violations they find must still
+    // be reported in the same order every time.
+
+    std::vector<wxString> tests =
+    {
+        "issue2512",
+        "issue7267",
+        "issue12109"
+    };
+
+    for( const wxString& testName : tests )
+    {
+        KI_TEST::LoadBoard( m_settingsManager, testName, m_board );
+
+        BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+        std::vector<wxString>  reports[2];
+
+        for( std::vector<wxString>& report : reports )
+        {
+            bds.m_DRCEngine->SetViolationHandler(
+                    [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+                    {
+                        PCB_MARKER temp( aItem, aPos, aLayer );
+
+                        report.push_back( temp.SerializeToString()
+                                          + wxString::Format( wxS( "|%d|%d" ), aPos.x, aPos.y ) );
+                    } );
+
+            bds.m_DRCEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+        }
+
+        BOOST_TEST_CONTEXT( testName )
+        {
+            BOOST_CHECK_EQUAL_COLLECTIONS( reports[0].begin(), reports[0].end(),
+                                           reports[1].begin(), reports[1].end() );
+        }
+    }
+}
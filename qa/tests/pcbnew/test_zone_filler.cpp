@@ -299,3 +299,33 @@ BOOST_FIXTURE_TEST_CASE( RegressionTeardropFill, ZONE_FILL_TEST_FIXTURE )
     }
 }
 
+
+BOOST_FIXTURE_TEST_CASE( ZoneFillTriangles, ZONE_FILL_TEST_FIXTURE )
+{
+    KI_TEST::LoadBoard( m_settingsManager, "notched_zones", m_board );
+
+    KI_TEST::FillZones( m_board.get() );
+
+    for( ZONE* zone : m_board->Zones() )
+    {
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            const std::shared_ptr<SHAPE_POLY_SET>& fill = zone->GetFilledPolysList( layer );
+
+            if( fill->IsEmpty() )
+                continue;
+
+            // The filler triangulates the fill, so its vertices can be built at once
+            std::vector<VECTOR2F> triangles;
+
+            BOOST_REQUIRE( zone->BuildFillTriangles( layer, triangles ) );
+
+            size_t triangleCount = 0;
+
+            for( unsigned int ii = 0; ii < fill->TriangulatedPolyCount(); ++ii )
+                triangleCount += fill->TriangulatedPolygon( ii )->GetTriangleCount();
+
+            BOOST_CHECK_EQUAL( triangles.size(), 3 * triangleCount );
+        }
+    }
+}
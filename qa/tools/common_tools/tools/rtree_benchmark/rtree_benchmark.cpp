@@ -0,0 +1,225 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <core/profile.h>
+#include <geometry/rtree.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+
+using TREE = RTree<intptr_t, int, 3, double>;
+using ENTRY = std::pair<TREE::Rect, intptr_t>;
+
+
+/**
+ * Random boxes spread over a board-sized area and 32 layers, sized like tracks and pads.
+ */
+static std::vector<ENTRY> makeEntries( long aCount, std::mt19937& aRng )
+{
+    std::uniform_int_distribution<int> coord( 0, 300000000 );
+    std::uniform_int_distribution<int> size( 0, 2000000 );
+    std::uniform_int_distribution<int> layer( 0, 31 );
+    std::vector<ENTRY>                 entries;
+
+    for( long ii = 0; ii < aCount; ii++ )
+    {
+        TREE::Rect rect;
+
+        // Every seventh entry is on all layers, like a through-hole pad or via
+        rect.m_min[0] = ( ii % 7 == 0 ) ? 0 : layer( aRng );
+        rect.m_max[0] = ( ii % 7 == 0 ) ? 31 : rect.m_min[0];
+        rect.m_min[1] = coord( aRng );
+        rect.m_max[1] = rect.m_min[1] + size( aRng );
+        rect.m_min[2] = coord( aRng );
+        rect.m_max[2] = rect.m_min[2] + size( aRng );
+
+        entries.emplace_back( rect, (intptr_t) ii );
+    }
+
+    return entries;
+}
+
+
+/**
+ * Compare build and query times of bulk loading against insert-by-insert construction.
+ */
+static bool runBenchmark( long aCount, long aQueries, long aSeed )
+{
+    std::mt19937                       rng( aSeed );
+    std::vector<ENTRY>                 entries = makeEntries( aCount, rng );
+    std::uniform_int_distribution<int> coord( 0, 300000000 );
+    std::uniform_int_distribution<int> layer( 0, 31 );
+    std::vector<TREE::Rect>            rects;
+
+    for( long q = 0; q < aQueries; q++ )
+    {
+        TREE::Rect rect;
+
+        rect.m_min[0] = rect.m_max[0] = layer( rng );
+        rect.m_min[1] = coord( rng );
+        rect.m_max[1] = rect.m_min[1] + 1000000;
+        rect.m_min[2] = coord( rng );
+        rect.m_max[2] = rect.m_min[2] + 1000000;
+
+        rects.push_back( rect );
+    }
+
+    TREE inserted;
+    TREE bulk;
+
+    PROF_TIMER insertBuild;
+
+    for( const ENTRY& entry : entries )
+        inserted.Insert( entry.first.m_min, entry.first.m_max, entry.second );
+
+    insertBuild.Stop();
+
+    PROF_TIMER bulkBuild;
+    bulk.BulkLoad( entries );
+    bulkBuild.Stop();
+
+    auto runQueries =
+            [&]( const TREE& aTree, PROF_TIMER& aTimer ) -> size_t
+            {
+                size_t hits = 0;
+
+                auto visitor =
+                        [&]( const intptr_t& ) -> bool
+                        {
+                            hits++;
+                            return true;
+                        };
+
+                aTimer.Start();
+
+                for( const TREE::Rect& rect : rects )
+                    aTree.Search( rect.m_min, rect.m_max, visitor );
+
+                aTimer.Stop();
+                return hits;
+            };
+
+    PROF_TIMER insertQuery( "", false );
+    PROF_TIMER bulkQuery( "", false );
+    size_t     insertHits = runQueries( inserted, insertQuery );
+    size_t     bulkHits = runQueries( bulk, bulkQuery );
+
+    std::cout << "R-tree with " << aCount << " entries, " << aQueries << " queries" << std::endl;
+    std::cout << "  insert: build " << insertBuild.msecs() << " ms, query "
+              << insertQuery.msecs() << " ms, " << insertHits << " hits" << std::endl;
+    std::cout << "  bulk:   build " << bulkBuild.msecs() << " ms, query "
+              << bulkQuery.msecs() << " ms, " << bulkHits << " hits" << std::endl;
+
+    return insertHits == bulkHits;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "e",
+            "entries",
+            _( "number of entries in the trees" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "q",
+            "queries",
+            _( "number of box queries run on each tree" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "seed",
+            _( "random seed" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+static int rtree_benchmark_main_func( int argc, char** argv )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "Compare R-tree bulk loading against inserting entries one by "
+                               "one" ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long entries = 500000;
+    long queries = 100000;
+    long seed = 7;
+
+    cl_parser.Found( "entries", &entries );
+    cl_parser.Found( "queries", &queries );
+    cl_parser.Found( "seed", &seed );
+
+    if( entries < 0 || queries < 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    if( !runBenchmark( entries, queries, seed ) )
+    {
+        std::cerr << "Bulk loaded and inserted trees found different entries" << std::endl;
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+static bool registered = UTILITY_REGISTRY::Register( {
+        "rtree_benchmark",
+        "Benchmark R-tree bulk loading",
+        rtree_benchmark_main_func,
+} );
@@ -0,0 +1,263 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2024 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <core/profile.h>
+#include <gal/opengl/cached_container.h>
+#include <gal/opengl/vertex_item.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+
+using namespace KIGFX;
+
+
+/**
+ * A cached container kept in plain memory, so the allocator can be exercised without an
+ * OpenGL context.  It resizes the same way as CACHED_CONTAINER_RAM.
+ */
+class MEMORY_CACHED_CONTAINER : public CACHED_CONTAINER
+{
+public:
+    MEMORY_CACHED_CONTAINER( unsigned int aSize ) :
+            CACHED_CONTAINER( aSize )
+    {
+        m_vertices = static_cast<VERTEX*>( malloc( aSize * VERTEX_SIZE ) );
+
+        if( !m_vertices )
+            throw std::bad_alloc();
+    }
+
+    ~MEMORY_CACHED_CONTAINER() { free( m_vertices ); }
+
+    unsigned int GetBufferHandle() const override { return 0; }
+    bool         IsMapped() const override { return true; }
+    void         Map() override {}
+    void         Unmap() override {}
+
+protected:
+    bool defragmentResize( unsigned int aNewSize ) override
+    {
+        if( usedSpace() > aNewSize )
+            return false;
+
+        VERTEX* newBufferMem = static_cast<VERTEX*>( malloc( aNewSize * VERTEX_SIZE ) );
+
+        if( !newBufferMem )
+            return false;
+
+        defragment( newBufferMem );
+        free( m_vertices );
+        m_vertices = newBufferMem;
+
+        m_freeSpace += aNewSize - m_currentSize;
+        m_currentSize = aNewSize;
+        resetFreeChunks();
+
+        return true;
+    }
+};
+
+
+/**
+ * Simulate a long editing session: load a board worth of items of widely varying sizes, then
+ * repeatedly redraw random items, compacting a little after each update as OPENGL_GAL does.
+ */
+static void runSession( long aItems, long aEdits, long aCompactionStep, long aSeed )
+{
+    // Only used to create the items; a non-cached manager does not need a GL context
+    VERTEX_MANAGER          manager( false );
+    MEMORY_CACHED_CONTAINER container( 1 << 16 );
+
+    std::mt19937                             rng( aSeed );
+    std::uniform_real_distribution<double>   logSize( std::log( 3.0 ), std::log( 20000.0 ) );
+    std::vector<std::unique_ptr<VERTEX_ITEM>> items;
+
+    auto addItem =
+            [&]()
+            {
+                std::unique_ptr<VERTEX_ITEM> item = std::make_unique<VERTEX_ITEM>( manager );
+                unsigned int                 size = std::exp( logSize( rng ) ) / 2;
+                int                          parts = 1 + rng() % 3;
+
+                container.SetItem( item.get() );
+
+                // Items are usually drawn with several primitives
+                for( int ii = 0; ii < parts; ii++ )
+                {
+                    VERTEX* vertices = container.Allocate( size );
+
+                    for( unsigned int jj = 0; jj < size; jj++ )
+                        vertices[jj].x = items.size();
+                }
+
+                container.FinishItem();
+                items.push_back( std::move( item ) );
+            };
+
+    PROF_TIMER loadTimer;
+
+    for( long ii = 0; ii < aItems; ii++ )
+        addItem();
+
+    loadTimer.Stop();
+
+    PROF_TIMER sessionTimer;
+    double     worstEdit = 0.0;
+    double     worstCompaction = 0.0;
+
+    for( long ii = 0; ii < aEdits; ii++ )
+    {
+        PROF_TIMER editTimer;
+        size_t     idx = rng() % items.size();
+
+        container.Delete( items[idx].get() );
+        items[idx] = std::move( items.back() );
+        items.pop_back();
+        addItem();
+
+        worstEdit = std::max( worstEdit, editTimer.msecs() );
+
+        if( ii % 100 == 0 )
+        {
+            PROF_TIMER compactTimer;
+            container.Compact( aCompactionStep );
+            worstCompaction = std::max( worstCompaction, compactTimer.msecs() );
+        }
+    }
+
+    sessionTimer.Stop();
+
+    VERTEX_CACHE_STATS stats = container.GetStats();
+
+    std::cout << "Loaded " << aItems << " items in " << loadTimer.msecs() << " ms" << std::endl;
+    std::cout << "Redrew " << aEdits << " items in " << sessionTimer.msecs() << " ms, worst "
+              << worstEdit << " ms, worst compaction " << worstCompaction << " ms" << std::endl;
+    std::cout << "Container size " << stats.m_size << ", used " << stats.m_used
+              << ", high water " << stats.m_highWater << std::endl;
+    std::cout << "Free chunks " << stats.m_freeChunks << ", largest " << stats.m_largestFreeChunk
+              << ", fragmentation " << stats.Fragmentation() << std::endl;
+    std::cout << "Defragmentations " << stats.m_defragmentations << ", compacted vertices "
+              << stats.m_compactedVertices << std::endl;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "i",
+            "items",
+            _( "number of items initially cached" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "e",
+            "edits",
+            _( "number of items redrawn during the session" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "c",
+            "compaction",
+            _( "vertices moved by each compaction step" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "seed",
+            _( "random seed" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+static int vertex_cache_stress_main_func( int argc, char** argv )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "Stress the OpenGL vertex cache allocator with a simulated "
+                               "editing session" ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long items = 5000;
+    long edits = 200000;
+    long compaction = 65536;
+    long seed = 1;
+
+    cl_parser.Found( "items", &items );
+    cl_parser.Found( "edits", &edits );
+    cl_parser.Found( "compaction", &compaction );
+    cl_parser.Found( "seed", &seed );
+
+    if( items < 1 || edits < 0 || compaction < 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    runSession( items, edits, compaction, seed );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+static bool registered = UTILITY_REGISTRY::Register( {
+        "vertex_cache_stress",
+        "Benchmark the OpenGL vertex cache allocator",
+        vertex_cache_stress_main_func,
+} );
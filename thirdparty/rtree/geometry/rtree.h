@@ -60,6 +60,7 @@
 #include <iterator>
 #include <limits>
 #include <queue>
+#include <utility>
 #include <vector>
 
 #ifdef DEBUG
@@ -205,6 +206,15 @@ public:
         return cnt;
     }
 
+    /// Insert many entries at once.
+    /// The whole tree, including entries already in it, is rebuilt using Sort-Tile-Recursive
+    /// packing, with the nodes of each level in one contiguous block.  This is much faster than
+    /// inserting the entries one by one and gives full nodes with little overlap, which also
+    /// speeds up searches.
+    /// The tree can still be modified afterwards.
+    /// \param a_entries Bounding rects and data of the entries to add
+    void BulkLoad( const std::vector<std::pair<Rect, DATATYPE>>& a_entries );
+
     /// Calculate Statistics
 
     Statistics CalcStats();
@@ -312,6 +322,20 @@ public:
             return &( curTos.m_node->m_branch[curTos.m_branchIndex].m_data );
         }
 
+        /// Get the bounds of the current data element. Caller must be sure iterator is not NULL first.
+        void GetBounds( ELEMTYPE a_min[NUMDIMS], ELEMTYPE a_max[NUMDIMS] ) const
+        {
+            ASSERT( IsNotNull() );
+            const StackElement& curTos = m_stack[m_tos - 1];
+            const Rect&         rect = curTos.m_node->m_branch[curTos.m_branchIndex].m_rect;
+
+            for( int axis = 0; axis < NUMDIMS; ++axis )
+            {
+                a_min[axis] = rect.m_min[axis];
+                a_max[axis] = rect.m_max[axis];
+            }
+        }
+
         /// Prefix ++ operator
         Iterator& operator++()
         {
@@ -610,7 +634,14 @@ protected:
     bool    SaveRec( const Node* a_node, RTFileStream& a_stream ) const;
     bool    LoadRec( const Node* a_node, RTFileStream& a_stream ) const;
 
+    void    CollectRec( const Node* a_node, std::vector<Branch>& a_branches ) const;
+    void    PackSort( Branch* a_first, Branch* a_last, int a_axis,
+                      std::vector<Branch*>& a_groupEnds ) const;
+    void    FreeBulkNodes();
+
     Node*           m_root;                         ///< Root of tree
+    /// Node blocks allocated by BulkLoad() (one per tree level) and their sizes
+    std::vector<std::pair<Node*, size_t>> m_bulkBlocks;
     ELEMTYPEREAL    m_unitSphereVolume;             ///< Unit sphere constant for required number of dimensions
 };
 
@@ -727,6 +758,7 @@ RTREE_TEMPLATE RTREE_QUAL::RTree()
 RTREE_TEMPLATE
 RTREE_QUAL::~RTree() {
     Reset(); // Free, or reset node memory
+    FreeBulkNodes();
 }
 
 
@@ -903,6 +935,202 @@ std::vector<std::pair<ELEMTYPE, DATATYPE>> RTREE_QUAL::NearestNeighbors(
     return result;
 }
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( const std::vector<std::pair<Rect, DATATYPE>>& a_entries )
+{
+    std::vector<Branch> level;
+
+    CollectRec( m_root, level );
+    level.reserve( level.size() + a_entries.size() );
+
+    for( const std::pair<Rect, DATATYPE>& entry : a_entries )
+    {
+        Branch branch;
+        branch.m_rect = entry.first;
+        branch.m_data = entry.second;
+        level.push_back( branch );
+    }
+
+    Reset();
+    FreeBulkNodes();
+
+    if( level.empty() )
+    {
+        m_root = AllocNode();
+        m_root->m_level = 0;
+        return;
+    }
+
+    int nodeLevel = 0;
+
+    do
+    {
+        std::vector<Branch*> groupEnds;
+
+        PackSort( level.data(), level.data() + level.size(), 0, groupEnds );
+
+        // Nodes never straddle two groups, so count them first to size this level's block
+        size_t   nodeCount = 0;
+        Branch*  groupStart = level.data();
+
+        for( Branch* groupEnd : groupEnds )
+        {
+            nodeCount += ( groupEnd - groupStart + MAXNODES - 1 ) / MAXNODES;
+            groupStart = groupEnd;
+        }
+
+        Node* block = new Node[nodeCount];
+        Node* node = block;
+
+        m_bulkBlocks.emplace_back( block, nodeCount );
+
+        std::vector<Branch> parents;
+        parents.reserve( nodeCount );
+        groupStart = level.data();
+
+        for( Branch* groupEnd : groupEnds )
+        {
+            for( Branch* first = groupStart; first < groupEnd; first += MAXNODES, ++node )
+            {
+                InitNode( node );
+                node->m_level = nodeLevel;
+
+                for( Branch* branch = first; branch < std::min( groupEnd, first + MAXNODES ); ++branch )
+                    node->m_branch[node->m_count++] = *branch;
+
+                Branch parent;
+                parent.m_rect = NodeCover( node );
+                parent.m_child = node;
+                parents.push_back( parent );
+            }
+
+            groupStart = groupEnd;
+        }
+
+        level = std::move( parents );
+        ++nodeLevel;
+    } while( level.size() > 1 );
+
+    m_root = level[0].m_child;
+}
+
+
+RTREE_TEMPLATE
+void RTREE_QUAL::CollectRec( const Node* a_node, std::vector<Branch>& a_branches ) const
+{
+    if( a_node->IsInternalNode() )
+    {
+        for( int index = 0; index < a_node->m_count; ++index )
+            CollectRec( a_node->m_branch[index].m_child, a_branches );
+    }
+    else
+    {
+        a_branches.insert( a_branches.end(), a_node->m_branch, a_node->m_branch + a_node->m_count );
+    }
+}
+
+
+/// Sort-Tile-Recursive ordering: sort by the centre along \a a_axis, cut into slices that will
+/// each fill a whole number of nodes, then order each slice along the next axis.  Axes with few
+/// distinct values (such as layers) are sliced by value instead, and other cuts are moved to a
+/// change of value where one is close by, so that different values don't end up mixed in the
+/// same nodes.  The end of each final slice is appended to \a a_groupEnds.
+RTREE_TEMPLATE
+void RTREE_QUAL::PackSort( Branch* a_first, Branch* a_last, int a_axis,
+                           std::vector<Branch*>& a_groupEnds ) const
+{
+    const size_t count = a_last - a_first;
+
+    auto center =
+            [a_axis]( const Branch* a_branch )
+            {
+                return (ELEMTYPEREAL) a_branch->m_rect.m_min[a_axis] + a_branch->m_rect.m_max[a_axis];
+            };
+
+    std::sort( a_first, a_last,
+               [&]( const Branch& a, const Branch& b )
+               {
+                   return center( &a ) < center( &b );
+               } );
+
+    if( a_axis == NUMDIMS - 1 || count <= MAXNODES )
+    {
+        a_groupEnds.push_back( a_last );
+        return;
+    }
+
+    auto isCut =
+            [&]( Branch* a_pos )
+            {
+                return a_pos == a_last || center( a_pos - 1 ) != center( a_pos );
+            };
+
+    size_t runs = 0;
+
+    for( Branch* pos = a_first + 1; pos <= a_last; ++pos )
+    {
+        if( isCut( pos ) )
+            ++runs;
+    }
+
+    // Few distinct values, each worth at least a full node: give every value its own slice
+    if( count / runs >= MAXNODES )
+    {
+        for( Branch* start = a_first; start < a_last; )
+        {
+            Branch* end = start + 1;
+
+            while( !isCut( end ) )
+                ++end;
+
+            PackSort( start, end, a_axis + 1, a_groupEnds );
+            start = end;
+        }
+
+        return;
+    }
+
+    const size_t nodes = ( count + MAXNODES - 1 ) / MAXNODES;
+    const size_t slices = (size_t) std::ceil( std::pow( (double) nodes, 1.0 / ( NUMDIMS - a_axis ) ) );
+    const size_t sliceSize = MAXNODES * ( ( nodes + slices - 1 ) / slices );
+
+    for( Branch* start = a_first; start < a_last; )
+    {
+        Branch* end = start + std::min<size_t>( sliceSize, a_last - start );
+
+        if( !isCut( end ) )
+        {
+            Branch* before = end;
+            Branch* after = end;
+
+            while( before - start > (ptrdiff_t) sliceSize / 2 && !isCut( before ) )
+                --before;
+
+            while( after - end < (ptrdiff_t) sliceSize / 2 && !isCut( after ) )
+                ++after;
+
+            if( isCut( before ) && ( !isCut( after ) || end - before <= after - end ) )
+                end = before;
+            else if( isCut( after ) )
+                end = after;
+        }
+
+        PackSort( start, end, a_axis + 1, a_groupEnds );
+        start = end;
+    }
+}
+
+
+RTREE_TEMPLATE
+void RTREE_QUAL::FreeBulkNodes()
+{
+    for( const std::pair<Node*, size_t>& block : m_bulkBlocks )
+        delete[] block.first;
+
+    m_bulkBlocks.clear();
+}
+
+
 RTREE_TEMPLATE
 int RTREE_QUAL::Count() const
 {
@@ -1120,6 +1348,7 @@ void RTREE_QUAL::RemoveAll()
 {
     // Delete all existing nodes
     Reset();
+    FreeBulkNodes();
 
     m_root = AllocNode();
     m_root->m_level = 0;
@@ -1177,6 +1406,16 @@ void RTREE_QUAL::FreeNode( Node* a_node ) const
 {
     ASSERT( a_node );
 
+    // Nodes from BulkLoad() are freed all at once with their block
+    for( const std::pair<Node*, size_t>& block : m_bulkBlocks )
+    {
+        if( !std::less<Node*>()( a_node, block.first )
+                && std::less<Node*>()( a_node, block.first + block.second ) )
+        {
+            return;
+        }
+    }
+
 #ifdef RTREE_DONT_USE_MEMPOOLS
     delete a_node;
 #else       // RTREE_DONT_USE_MEMPOOLS